@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+CAN Dispatcher - Routing pro Arbitration-ID mit eigenem Reassembly-Kontext
+Passende SocketCAN-Filter (CAN_RAW_FILTER) für den Kernel
+Kopie von sensor_hub/can_dispatcher.py (eigenes Deployment, nur der Import unterscheidet sich);
+Änderungen in beiden Dateien nachziehen, getestet wird die Sensor-Hub-Seite
+"""
+
+import logging
+import time
+from typing import Any, Callable, Dict, List, Optional
+
+from .can_protocol import CANProtocol
+
+STANDARD_ID_MASK = 0x7FF
+EXTENDED_ID_MASK = 0x1FFFFFFF
+
+# Routing-Modi
+MODE_RAW = 'raw'          # Handler bekommt jeden Frame (bytes)
+MODE_MESSAGE = 'message'  # Handler bekommt die reassemblierten Rohdaten (memoryview)
+MODE_JSON = 'json'        # Handler bekommt den reassemblierten UTF-8-String
+
+logger = logging.getLogger(__name__)
+
+
+def parse_filter_spec(spec: str) -> List[Dict[str, Any]]:
+    """Parst zusätzliche Filter 'id[:mask],...' (z.B. '0x180:0x7F0,0x300') in python-can-Form."""
+    filters = []
+    for entry in spec.split(','):
+        entry = entry.strip()
+        if not entry:
+            continue
+        can_id, _, mask = entry.partition(':')
+        can_id = int(can_id, 0)
+        extended = can_id > STANDARD_ID_MASK
+        filters.append({
+            'can_id': can_id,
+            'can_mask': int(mask, 0) if mask else (EXTENDED_ID_MASK if extended else STANDARD_ID_MASK),
+            'extended': extended,
+        })
+    return filters
+
+
+class _Route:
+    """Ziel einer Arbitration-ID (bzw. eines ID-Bereichs über die Maske)."""
+
+    __slots__ = ('can_id', 'mask', 'extended', 'handler', 'mode', 'name', 'protocol', 'frames', 'messages')
+
+    def __init__(self, can_id: int, mask: int, extended: bool, handler: Callable, mode: str, name: str,
+                 protocol: Optional[CANProtocol]):
+        self.can_id = can_id
+        self.mask = mask
+        self.extended = extended
+        self.handler = handler
+        self.mode = mode
+        self.name = name
+        self.protocol = protocol
+        self.frames = 0
+        self.messages = 0
+
+
+class CANDispatcher:
+    """Verteilt empfangene Frames auf registrierte Handler.
+
+    - Exakte IDs über ein Dict (O(1)), ID-Bereiche über Maske als Fallback
+    - Jede Route mit Reassembly hat einen eigenen CANProtocol-Kontext
+    - filters() liefert die python-can `can_filters` für den Bus, damit der
+      Kernel fremde IDs verwirft und der Reader-Thread dafür nicht aufwacht
+    """
+
+    def __init__(self, max_frame_size: int = 6, frame_timeout: float = 1.0, cleanup_interval: float = 0.25,
+                 fd: bool = False):
+        self.max_frame_size = max_frame_size
+        self.fd = fd
+        self.frame_timeout = frame_timeout
+        self.cleanup_interval = cleanup_interval
+        self._exact: Dict[int, _Route] = {}
+        self._masked: List[_Route] = []
+        self._next_cleanup = 0.0
+        self.unrouted_frames = 0
+
+    def register(self, can_id: int, handler: Callable, mode: str = MODE_MESSAGE, mask: Optional[int] = None,
+                 name: str = '', extended: Optional[bool] = None):
+        """Registriert einen Handler für eine Arbitration-ID (mask für ID-Bereiche)."""
+        if mode not in (MODE_RAW, MODE_MESSAGE, MODE_JSON):
+            raise ValueError(f"Unbekannter Routing-Modus: {mode}")
+
+        extended = can_id > STANDARD_ID_MASK if extended is None else extended
+        full_mask = EXTENDED_ID_MASK if extended else STANDARD_ID_MASK
+        mask = full_mask if mask is None else mask
+        protocol = None if mode == MODE_RAW else CANProtocol(self.max_frame_size, self.frame_timeout, fd=self.fd)
+        route = _Route(can_id, mask, extended, handler, mode, name or f"0x{can_id:X}", protocol)
+
+        if mask == full_mask:
+            self._exact[can_id] = route
+        else:
+            self._masked.append(route)
+
+    def filters(self, extra: Optional[List[Dict[str, Any]]] = None) -> List[Dict[str, Any]]:
+        """Kernel-Filter für alle Routen (plus optionale Zusatzfilter)."""
+        filters = [
+            {'can_id': route.can_id, 'can_mask': route.mask, 'extended': route.extended}
+            for route in list(self._exact.values()) + self._masked
+        ]
+        return filters + list(extra or [])
+
+    def _route_for(self, arbitration_id: int) -> Optional[_Route]:
+        route = self._exact.get(arbitration_id)
+        if route is not None:
+            return route
+        for route in self._masked:
+            if arbitration_id & route.mask == route.can_id & route.mask:
+                return route
+        return None
+
+    def dispatch(self, arbitration_id: int, data: bytes) -> Any:
+        """Leitet einen Frame weiter; liefert das Handler-Ergebnis oder None (unvollständig/ohne Route)."""
+        route = self._route_for(arbitration_id)
+        if route is None:
+            self.unrouted_frames += 1
+            return None
+
+        route.frames += 1
+        if route.mode == MODE_RAW:
+            route.messages += 1
+            return route.handler(arbitration_id, data)
+
+        if route.mode == MODE_JSON:
+            payload = route.protocol.decode_frame(arbitration_id, data)
+        else:
+            payload = route.protocol.decode_message(arbitration_id, data)
+        if payload is None:
+            return None
+
+        route.messages += 1
+        return route.handler(arbitration_id, payload)
+
+    def cleanup(self, now: Optional[float] = None):
+        """Räumt abgelaufene Reassembly-Puffer auf (höchstens alle cleanup_interval Sekunden)."""
+        now = time.monotonic() if now is None else now
+        if now < self._next_cleanup:
+            return
+        self._next_cleanup = now + self.cleanup_interval
+        for route in list(self._exact.values()) + self._masked:
+            if route.protocol is not None:
+                route.protocol.cleanup_old_buffers()
+
+    def get_status(self) -> Dict[str, Any]:
+        """Zähler pro Route."""
+        return {
+            'routes': {
+                route.name: {'frames': route.frames, 'messages': route.messages, 'mode': route.mode}
+                for route in list(self._exact.values()) + self._masked
+            },
+            'unrouted_frames': self.unrouted_frames,
+        }
@@ -2,6 +2,7 @@
 """
 CAN Handler - CAN-Bus-Kommunikation mit Sensor Hub
 JSON-basierte Kommunikation mit Multi-Frame-Support
+Binäre Telemetrie auf eigener Arbitration-ID
 """
 
 import json
@@ -17,7 +18,9 @@ except ImportError:
     CAN_AVAILABLE = False
     logging.warning("python-can nicht verfügbar - CAN-Funktionen deaktiviert")
 
-from .can_protocol import CANProtocol
+from .can_dispatcher import MODE_JSON, MODE_MESSAGE, CANDispatcher
+from .can_protocol import (CANProtocol, TELEMETRY_MSG_FUSED_POSE, decode_fused_pose_frame,
+                           decode_telemetry_frame, fd_capable, telemetry_message_type)
 
 
 class CANHandler:
@@ -41,11 +44,22 @@ class CANHandler:
         self.can_bus: Optional[can.interface.Bus] = None
         self.can_enabled = True
         
-        # Protokoll
-        self.protocol = CANProtocol(
+        # Transport: CAN-FD (64-Byte-Frames) oder klassisch (8 Bytes)
+        self.fd = config.fd
+        
+        # Protokoll (Senden)
+        self.protocol = self._create_protocol()
+        
+        # Empfang: eigene Route mit eigenem Reassembly-Kontext pro Arbitration-ID
+        # (ein FD-Empfänger nimmt auch klassische Frames an)
+        self.dispatcher = CANDispatcher(
             max_frame_size=config.max_frame_size,
-            frame_timeout=config.frame_timeout
+            frame_timeout=config.frame_timeout,
+            fd=config.fd
         )
+        self.dispatcher.register(config.sensor_hub_id, self._on_json_message, mode=MODE_JSON, name='sensor_hub')
+        self.dispatcher.register(config.telemetry_id, self._on_telemetry_message, mode=MODE_MESSAGE,
+                                 name='telemetry')
         
         # Reader-Thread
         self.reader_running = False
@@ -55,6 +69,10 @@ class CANHandler:
         # Sensor-Daten
         self._sensor_data: Dict[str, Any] = {}
         self._sensor_data_lock = threading.Lock()
+        # Diagnose des Sensor Hubs (eigene Feldgruppe, ~1 Hz bei Änderung), ersetzt keine Pose
+        self._diagnostics: Optional[Dict[str, Any]] = None
+        # Fusionierte Pose aus dem Pose-Frame, wartet auf das folgende Sensor-Frame (nur Reader-Thread)
+        self._pending_pose: Optional[Dict[str, Any]] = None
         
         # Callbacks
         self.sensor_data_callback: Optional[Callable] = None
@@ -62,14 +80,45 @@ class CANHandler:
         if self.can_available:
             self._init_can_bus()
     
+    def _create_protocol(self) -> CANProtocol:
+        return CANProtocol(
+            max_frame_size=self.config.fd_frame_size if self.fd else self.config.max_frame_size,
+            frame_timeout=self.config.frame_timeout,
+            fd=self.fd
+        )
+    
     def _init_can_bus(self):
         """Initialisiert CAN-Bus"""
+        if self.fd and fd_capable(self.config.interface) is False:
+            self.logger.error(f"❌ {self.config.interface} ist nicht im FD-Modus (ip link ... fd on) "
+                              f"- sende klassische 8-Byte-Frames")
+            self.fd = False
+            self.protocol = self._create_protocol()
+        
         try:
+            # Kernel-Filter (CAN_RAW_FILTER): fremde IDs (ESCs, BMS, ...) erreichen den Reader nicht
+            can_filters = None
+            if self.config.kernel_filters:
+                can_filters = self.dispatcher.filters([
+                    {'can_id': can_id, 'can_mask': 0x7FF, 'extended': can_id > 0x7FF}
+                    for can_id in self.config.extra_filter_ids
+                ])
+            
             self.can_bus = can.interface.Bus(
                 channel=self.config.interface,
-                interface='socketcan'
+                interface='socketcan',
+                can_filters=can_filters,
+                fd=self.fd
             )
-            self.logger.info(f"✅ CAN-Bus initialisiert ({self.config.interface}, {self.config.bitrate} bps)")
+            if self.fd:
+                self.logger.info(f"✅ CAN-FD-Bus initialisiert ({self.config.interface}, {self.config.bitrate} / "
+                                 f"{self.config.data_bitrate} bps, {self.protocol.max_frame_size} Bytes pro Frame"
+                                 f"{', BRS' if self.config.bitrate_switch else ''})")
+            else:
+                self.logger.info(f"✅ CAN-Bus initialisiert ({self.config.interface}, {self.config.bitrate} bps)")
+            if can_filters:
+                ids = ', '.join(f"0x{f['can_id']:X}" for f in can_filters)
+                self.logger.info(f"🔎 CAN-Kernel-Filter aktiv: {ids}")
         
         except Exception as e:
             self.logger.error(f"❌ CAN-Bus Initialisierung fehlgeschlagen: {e}")
@@ -120,25 +169,16 @@ class CANHandler:
                 # CAN-Nachricht empfangen (mit Timeout)
                 msg = self.can_bus.recv(timeout=1.0)
                 
-                if msg is None:
-                    continue
+                if msg is not None:
+                    # Route pro Arbitration-ID (Sensor Hub JSON, Telemetrie, ...)
+                    result = self.dispatcher.dispatch(msg.arbitration_id, msg.data)
+                    if result is True:
+                        error_count = 0  # Reset bei Erfolg
+                    elif result is False:
+                        error_count += 1
                 
-                # Nur Sensor Hub Nachrichten verarbeiten
-                if msg.arbitration_id == self.config.sensor_hub_id:
-                    json_str = self.protocol.decode_frame(msg.arbitration_id, msg.data)
-                    
-                    if json_str:
-                        try:
-                            data = json.loads(json_str)
-                            self._process_sensor_data(data)
-                            error_count = 0  # Reset bei Erfolg
-                        
-                        except json.JSONDecodeError as e:
-                            self.logger.error(f"❌ JSON-Decode Fehler: {e}")
-                            error_count += 1
-                
-                # Alte Buffers aufräumen
-                self.protocol.cleanup_old_buffers()
+                # Alte Buffers aufräumen (zeitgesteuert)
+                self.dispatcher.cleanup()
             
             except Exception as e:
                 self.logger.error(f"❌ CAN-Reader Fehler: {e}")
@@ -155,6 +195,49 @@ class CANHandler:
         
         self.logger.info("CAN-Reader-Loop beendet")
     
+    def _on_json_message(self, arbitration_id: int, json_str: str) -> bool:
+        """
+        Route für JSON-Nachrichten des Sensor Hubs
+        
+        Returns:
+            True bei Erfolg, False bei Decode-Fehler
+        """
+        try:
+            data = json.loads(json_str)
+        except json.JSONDecodeError as e:
+            self.logger.error(f"❌ JSON-Decode Fehler: {e}")
+            return False
+        
+        if 'diag' in data:
+            self._diagnostics = data
+            return True
+        
+        self._process_sensor_data(data)
+        return True
+    
+    def _on_telemetry_message(self, arbitration_id: int, payload: memoryview) -> bool:
+        """
+        Route für binäre Telemetrie-Frames des Sensor Hubs
+        
+        Returns:
+            True bei Erfolg, False bei unbekanntem Frame
+        """
+        if telemetry_message_type(payload) == TELEMETRY_MSG_FUSED_POSE:
+            # Kommt direkt vor dem Sensor-Frame desselben Sendetakts und wird daran angehängt
+            self._pending_pose = decode_fused_pose_frame(payload)
+            return self._pending_pose is not None
+        
+        data = decode_telemetry_frame(payload)
+        if data is None:
+            self.logger.warning("⚠️ Unbekanntes Telemetrie-Frame verworfen")
+            return False
+        
+        pose, self._pending_pose = self._pending_pose, None
+        if pose is not None:
+            data['pose'] = pose
+        self._process_sensor_data(data)
+        return True
+    
     def _process_sensor_data(self, data: Dict[str, Any]):
         """
         Verarbeitet Sensor-Daten vom Sensor Hub (Thread-Safe)
@@ -214,7 +297,9 @@ class CANHandler:
                 msg = can.Message(
                     arbitration_id=self.config.motor_controller_id,
                     data=frame_data,
-                    is_extended_id=False
+                    is_extended_id=False,
+                    is_fd=self.fd,
+                    bitrate_switch=self.fd and self.config.bitrate_switch
                 )
                 self.can_bus.send(msg)
             
@@ -265,7 +350,12 @@ class CANHandler:
             'reader_running': self.reader_running,
             'interface': self.config.interface,
             'bitrate': self.config.bitrate,
-            'protocol_status': self.protocol.get_buffer_status()
+            'fd': self.fd,
+            'data_bitrate': self.config.data_bitrate if self.fd else None,
+            'frame_payload': self.protocol.max_frame_size,
+            'protocol_status': self.protocol.get_buffer_status(),
+            'dispatcher': self.dispatcher.get_status(),
+            'sensor_hub_diagnostics': self._diagnostics
         }
     
     def cleanup(self):
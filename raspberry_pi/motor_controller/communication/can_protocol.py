@@ -1,37 +1,220 @@
 #!/usr/bin/env python3
 """
 CAN Protocol - Multi-Frame JSON-Kommunikation
-Thread-Safe Buffer-Verwaltung für Multi-Frame-Nachrichten
+Lock-freie Multi-Frame-Reassembly für genau einen Reader-Thread (vorallokierte Slots)
+Dekoder für die binären Sensor-Hub-Telemetrie-Frames (Sensoren, fusionierte Pose)
+Klassische 8-Byte-Frames oder CAN-FD-Frames bis 64 Bytes
 """
 
+import bisect
 import json
 import logging
-import threading
+import struct
 import time
-from typing import Optional, Dict, Any
+from collections import deque
+from typing import Optional, Dict, Any, Deque, Tuple
+
+
+# Binäres Telemetrie-Frame des Sensor Hubs (siehe sensor_hub/telemetry_payload.py)
+# Little Endian, 24 Bytes: Header, Flags, Zeitstempel (ms mod 2^32), Lat/Lon (1e-7°),
+# Höhe (0.1 m), Heading (0.01°), Roll/Pitch (0.01°), Yaw (0.01°)
+TELEMETRY_FRAME_VERSION = 1
+TELEMETRY_MSG_POSE = 0x1
+TELEMETRY_FRAME_FORMAT = struct.Struct('<BBIiihHhhH')
+TELEMETRY_FRAME_SIZE = TELEMETRY_FRAME_FORMAT.size
+
+# Fusionierte EKF-Pose, direkt vor dem Sensor-Frame auf derselben ID (24 Bytes): Header, Flags,
+# Zeitstempel der Pose (ms mod 2^32), Lat/Lon (1e-7°), Heading (0.01°), Geschwindigkeit Ost/Nord
+# (mm/s), Positions-Std (mm), Heading-Std (0.1°), Alter beim Senden (ms)
+TELEMETRY_MSG_FUSED_POSE = 0x2
+FUSED_POSE_FRAME_FORMAT = struct.Struct('<BBIiiHhhHBB')
+FUSED_POSE_FRAME_SIZE = FUSED_POSE_FRAME_FORMAT.size
+
+FLAG_RTK_MASK = 0x07
+FLAG_HAS_GPS = 0x08
+FLAG_HAS_IMU = 0x10
+FLAG_IMU_CALIBRATED = 0x20
+
+RTK_STATUS_NAMES = {
+    0: 'NO GPS',
+    1: 'GPS FIX',
+    2: 'DGPS',
+    4: 'RTK FIXED',
+    5: 'RTK FLOAT',
+}
+
+
+def _unwrap_timestamp(timestamp_ms: int, now: Optional[float]) -> float:
+    """32-Bit-Millisekunden gegen lokale Uhr rekonstruieren"""
+    now_ms = int((time.time() if now is None else now) * 1000.0)
+    delta = (timestamp_ms - now_ms) & 0xFFFFFFFF
+    if delta >= 0x80000000:
+        delta -= 0x100000000
+    return round((now_ms + delta) / 1000.0, 3)
+
+
+def telemetry_message_type(data: bytes) -> Optional[int]:
+    """Nachrichtentyp eines binären Telemetrie-Frames (None bei fremder Version)"""
+    if len(data) == 0 or data[0] >> 4 != TELEMETRY_FRAME_VERSION:
+        return None
+    return data[0] & 0x0F
+
+
+def decode_fused_pose_frame(data: bytes, now: Optional[float] = None) -> Optional[Dict[str, Any]]:
+    """
+    Dekodiert ein Pose-Frame in das Format von data['pose'] (lat/lon statt east/north)
+    
+    Args:
+        data: Zusammengesetzte Nutzdaten (mind. FUSED_POSE_FRAME_SIZE Bytes)
+        now: Lokale Referenzzeit für die Zeitstempel-Rekonstruktion
+        
+    Returns:
+        Pose-Dictionary oder None bei unbekannter Version/Typ
+    """
+    if len(data) < FUSED_POSE_FRAME_SIZE or telemetry_message_type(data) != TELEMETRY_MSG_FUSED_POSE:
+        return None
+    
+    (_, _, timestamp_ms, lat, lon, heading, vel_east, vel_north,
+     std_position, std_heading, age_ms) = FUSED_POSE_FRAME_FORMAT.unpack_from(data)
+    return {
+        'timestamp': _unwrap_timestamp(timestamp_ms, now),
+        'lat': lat / 1e7,
+        'lon': lon / 1e7,
+        'heading': heading / 100.0,
+        'vel_east': vel_east / 1000.0,
+        'vel_north': vel_north / 1000.0,
+        'std_position': std_position / 1000.0,
+        'std_heading': std_heading / 10.0,
+        'age': age_ms / 1000.0
+    }
+
+
+def decode_telemetry_frame(data: bytes, now: Optional[float] = None) -> Optional[Dict[str, Any]]:
+    """
+    Dekodiert ein binäres Telemetrie-Frame in das Dict-Format der JSON-Telemetrie
+    
+    Args:
+        data: Zusammengesetzte Nutzdaten (mind. TELEMETRY_FRAME_SIZE Bytes)
+        now: Lokale Referenzzeit für die Zeitstempel-Rekonstruktion
+        
+    Returns:
+        Telemetrie-Dictionary oder None bei unbekannter Version/Typ
+    """
+    if len(data) < TELEMETRY_FRAME_SIZE:
+        return None
+    
+    (header, flags, timestamp_ms, lat, lon, altitude,
+     heading, roll, pitch, yaw) = TELEMETRY_FRAME_FORMAT.unpack_from(data)
+    
+    if header >> 4 != TELEMETRY_FRAME_VERSION or header & 0x0F != TELEMETRY_MSG_POSE:
+        return None
+    
+    payload: Dict[str, Any] = {'timestamp': _unwrap_timestamp(timestamp_ms, now)}
+    
+    if flags & FLAG_HAS_GPS:
+        payload['gps'] = {
+            'lat': round(lat / 1e7, 7),
+            'lon': round(lon / 1e7, 7),
+            'altitude': round(altitude / 10.0, 2)
+        }
+        payload['rtk_status'] = RTK_STATUS_NAMES.get(flags & FLAG_RTK_MASK, 'NO GPS')
+    
+    if flags & FLAG_HAS_IMU:
+        payload['imu'] = {
+            'roll': roll / 100.0,
+            'pitch': pitch / 100.0,
+            'yaw': yaw / 100.0,
+            'heading': yaw / 100.0,
+            'is_calibrated': bool(flags & FLAG_IMU_CALIBRATED)
+        }
+    
+    if flags & (FLAG_HAS_GPS | FLAG_HAS_IMU):
+        payload['heading'] = heading / 100.0
+    
+    return payload
+
+
+MAX_FRAMES_PER_MESSAGE = 255
+HEADER_SIZE = 2
+CLASSIC_FRAME_SIZE = 8
+# Gültige CAN-FD-Datenlängen (DLC 0-15)
+FD_FRAME_LENGTHS = (0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64)
+FD_MAX_PAYLOAD = FD_FRAME_LENGTHS[-1] - HEADER_SIZE
+
+
+def fd_frame_length(length: int) -> int:
+    """Kleinste gültige CAN-FD-Datenlänge >= length"""
+    return FD_FRAME_LENGTHS[bisect.bisect_left(FD_FRAME_LENGTHS, min(length, FD_FRAME_LENGTHS[-1]))]
+
+
+def fd_capable(interface: str) -> Optional[bool]:
+    """
+    Prüft über die MTU (72 = CAN-FD, 16 = klassisch), ob das SocketCAN-Interface FD kann
+    
+    Returns:
+        True/False, None wenn die MTU nicht lesbar ist
+    """
+    try:
+        with open(f"/sys/class/net/{interface}/mtu") as f:
+            return int(f.read().strip()) >= 72
+    except (OSError, ValueError):
+        return None
+
+
+class _ReassemblySlot:
+    """Vorallokierter Reassembly-Kontext für eine Arbitration-ID"""
+    
+    __slots__ = ('buffers', 'active', 'total', 'stride', 'mask', 'complete_mask', 'generation')
+    
+    def __init__(self, capacity: int):
+        # Doppelpuffer: einer wird befüllt, der andere hält die zuletzt übergebene Nachricht
+        self.buffers = [bytearray(capacity), bytearray(capacity)]
+        self.active = False
+        self.total = 0
+        self.stride = 0
+        self.mask = 0
+        self.complete_mask = 0
+        self.generation = 0
 
 
 class CANProtocol:
     """
     CAN-Protokoll für Multi-Frame JSON-Nachrichten
-    Thread-Safe Buffer-Verwaltung
+    Feste Reassembly-Slots pro Arbitration-ID mit Completion-Bitmaske
+    
+    decode_frame()/decode_message() sind für genau einen Reader-Thread ausgelegt
+    und kommen ohne Lock und ohne Allokation pro Frame aus. get_buffer_status()
+    darf aus anderen Threads aufgerufen werden.
+    
+    Die Nutzdaten pro Frame einer Nachricht ergeben sich aus der Länge ihres ersten
+    Frames; ein FD-Empfänger nimmt daher auch klassische Nachrichten an.
     """
     
-    def __init__(self, max_frame_size: int = 6, frame_timeout: float = 1.0):
+    def __init__(self, max_frame_size: int = 6, frame_timeout: float = 1.0, fd: bool = False):
         """
         Initialisiert CAN-Protokoll
         
         Args:
-            max_frame_size: Maximale Nutzdaten pro Frame (Bytes)
+            max_frame_size: Nutzdaten pro Frame beim Senden (klassisch max. 6, FD max. 62 Bytes)
             frame_timeout: Timeout für unvollständige Frames (Sekunden)
+            fd: CAN-FD-Frames senden und empfangen
         """
         self.logger = logging.getLogger(__name__)
-        self.max_frame_size = max_frame_size
+        self.fd = fd
+        if fd:
+            # Auf eine gültige FD-Länge runden, damit alle vollen Frames gleich lang sind
+            self.max_frame_size = fd_frame_length(HEADER_SIZE + max(1, max_frame_size)) - HEADER_SIZE
+        else:
+            self.max_frame_size = min(max_frame_size, CLASSIC_FRAME_SIZE - HEADER_SIZE)
+        self._slot_stride = FD_MAX_PAYLOAD if fd else CLASSIC_FRAME_SIZE - HEADER_SIZE
         self.frame_timeout = frame_timeout
         
-        # Thread-Safe Frame-Buffer
-        self._frame_buffer: Dict[int, Dict[str, Any]] = {}
-        self._buffer_lock = threading.Lock()
+        # Reassembly-Slots (einmal pro Arbitration-ID allokiert, danach wiederverwendet)
+        self._slots: Dict[int, _ReassemblySlot] = {}
+        
+        # Timer-Queue für Timeouts: alle Nachrichten haben denselben Timeout,
+        # die Deadlines sind daher monoton und eine FIFO genügt (O(1) pro Prüfung)
+        self._deadlines: Deque[Tuple[float, int, int]] = deque()
     
     def encode_message(self, data: Dict[str, Any]) -> list:
         """
@@ -49,23 +232,27 @@ class CANProtocol:
             json_bytes = json_str.encode('utf-8')
             
             # In Chunks aufteilen
+            size = self.max_frame_size
             chunks = []
-            for i in range(0, len(json_bytes), self.max_frame_size):
-                chunk = json_bytes[i:i + self.max_frame_size]
+            for i in range(0, len(json_bytes), size):
+                chunk = json_bytes[i:i + size]
                 chunks.append(chunk)
             
             # Frames erstellen
             total_frames = len(chunks)
+            if total_frames > MAX_FRAMES_PER_MESSAGE:
+                self.logger.error(f"❌ Nachricht zu groß für {MAX_FRAMES_PER_MESSAGE} Frames ({len(json_bytes)} Bytes)")
+                return []
             frames = []
             
             for frame_idx, chunk in enumerate(chunks):
-                # Frame-Format: [frame_idx, total_frames, ...data (max 6 bytes)]
+                # Frame-Format: [frame_idx, total_frames, ...data (max_frame_size bytes)]
                 frame_data = bytearray([frame_idx, total_frames])
                 frame_data.extend(chunk)
                 
-                # Auf 8 Bytes auffüllen (CAN-Standard)
-                while len(frame_data) < 8:
-                    frame_data.append(0x00)
+                # Klassisch auf 8 Bytes auffüllen, FD auf die nächste gültige FD-Länge
+                length = fd_frame_length(len(frame_data)) if self.fd else HEADER_SIZE + size
+                frame_data.extend(bytes(length - len(frame_data)))
                 
                 frames.append(bytes(frame_data))
             
@@ -77,7 +264,7 @@ class CANProtocol:
     
     def decode_frame(self, arbitration_id: int, frame_data: bytes) -> Optional[str]:
         """
-        Dekodiert CAN-Frame und gibt vollständige JSON-Nachricht zurück (Thread-Safe)
+        Dekodiert CAN-Frame und gibt vollständige JSON-Nachricht zurück
         
         Args:
             arbitration_id: CAN-Arbitration-ID (zur Buffer-Identifikation)
@@ -86,70 +273,105 @@ class CANProtocol:
         Returns:
             JSON-String wenn vollständig, None sonst
         """
+        full_data = self.decode_message(arbitration_id, frame_data)
+        if full_data is None:
+            return None
+        
+        try:
+            # Null-Bytes (Padding) entfernen
+            return bytes(full_data).rstrip(b'\x00').decode('utf-8')
+        except UnicodeDecodeError as e:
+            self.logger.error(f"❌ UTF-8 Decode Fehler: {e}")
+            return None
+    
+    def decode_message(self, arbitration_id: int, frame_data: bytes) -> Optional[memoryview]:
+        """
+        Dekodiert CAN-Frame und gibt die vollständigen Rohdaten zurück
+        
+        Args:
+            arbitration_id: CAN-Arbitration-ID (zur Buffer-Identifikation)
+            frame_data: CAN-Frame-Daten
+            
+        Returns:
+            memoryview auf die zusammengesetzten Nutzdaten (inkl. Padding) wenn
+            vollständig, None sonst. Gültig bis zur nächsten vollständigen
+            Nachricht derselben Arbitration-ID.
+        """
         if len(frame_data) < 2:
             return None
         
         frame_idx = frame_data[0]
-        total_frames = frame_data[1]
-        chunk = frame_data[2:8]  # Max 6 Bytes Nutzdaten
-        
-        with self._buffer_lock:
-            # Ersten Frame: Buffer initialisieren
-            if frame_idx == 0:
-                self._frame_buffer[arbitration_id] = {
-                    'total': total_frames,
-                    'frames': [None] * total_frames,
-                    'timestamp': time.time()
-                }
+        slot = self._slots.get(arbitration_id)
+        
+        # Ersten Frame: Slot (neu) starten
+        if frame_idx == 0:
+            total_frames = frame_data[1]
+            if total_frames == 0:
+                return None
             
-            # Frame im Buffer speichern
-            if arbitration_id in self._frame_buffer:
-                buffer = self._frame_buffer[arbitration_id]
-                
-                if frame_idx < len(buffer['frames']):
-                    buffer['frames'][frame_idx] = chunk
-                
-                # Prüfen ob alle Frames empfangen
-                if all(f is not None for f in buffer['frames']):
-                    # Alle Frames zusammensetzen
-                    full_data = b''.join(buffer['frames'])
-                    # Null-Bytes entfernen
-                    full_data = full_data.rstrip(b'\x00')
-                    # Buffer leeren
-                    del self._frame_buffer[arbitration_id]
-                    
-                    try:
-                        return full_data.decode('utf-8')
-                    except UnicodeDecodeError as e:
-                        self.logger.error(f"❌ UTF-8 Decode Fehler: {e}")
-                        return None
+            # Volle Frames: Nutzdaten pro Frame = Länge des ersten Frames - Header
+            stride = len(frame_data) - HEADER_SIZE
+            if stride > self._slot_stride:
+                return None
+            if slot is None:
+                slot = _ReassemblySlot(MAX_FRAMES_PER_MESSAGE * self._slot_stride)
+                self._slots[arbitration_id] = slot
+            
+            now = time.monotonic()
+            slot.active = True
+            slot.total = total_frames
+            slot.stride = stride
+            slot.mask = 0
+            slot.complete_mask = (1 << total_frames) - 1
+            slot.generation += 1
+            self._deadlines.append((now + self.frame_timeout, arbitration_id, slot.generation))
         
-        return None
+        elif slot is None or not slot.active or frame_idx >= slot.total:
+            return None
+        
+        # Chunk direkt an seine Position im Slot-Puffer schreiben
+        stride = slot.stride
+        chunk = frame_data[HEADER_SIZE:HEADER_SIZE + stride]
+        offset = frame_idx * stride
+        buffer = slot.buffers[0]
+        buffer[offset:offset + len(chunk)] = chunk
+        if len(chunk) < stride:
+            buffer[offset + len(chunk):offset + stride] = bytes(stride - len(chunk))
+        slot.mask |= 1 << frame_idx
+        
+        # Prüfen ob alle Frames empfangen
+        if slot.mask != slot.complete_mask:
+            return None
+        
+        slot.active = False
+        slot.buffers.reverse()
+        return memoryview(slot.buffers[1])[:slot.total * stride]
     
     def cleanup_old_buffers(self):
-        """Entfernt alte unvollständige Buffers (Thread-Safe)"""
-        current_time = time.time()
-        
-        with self._buffer_lock:
-            expired_ids = [
-                arb_id for arb_id, buffer in self._frame_buffer.items()
-                if current_time - buffer['timestamp'] > self.frame_timeout
-            ]
+        """Verwirft abgelaufene unvollständige Nachrichten (O(1) solange nichts abgelaufen ist)"""
+        deadlines = self._deadlines
+        if not deadlines:
+            return
+        
+        current_time = time.monotonic()
+        while deadlines and deadlines[0][0] <= current_time:
+            _, arb_id, generation = deadlines.popleft()
+            slot = self._slots.get(arb_id)
             
-            for arb_id in expired_ids:
-                del self._frame_buffer[arb_id]
+            if slot is not None and slot.active and slot.generation == generation:
+                slot.active = False
                 self.logger.warning(f"⚠️ Frame-Buffer Timeout für ID 0x{arb_id:X}")
     
     def get_buffer_status(self) -> Dict[str, Any]:
         """
-        Gibt Buffer-Status zurück (Thread-Safe)
+        Gibt Buffer-Status zurück
         
         Returns:
             Dictionary mit Buffer-Informationen
         """
-        with self._buffer_lock:
-            return {
-                'active_buffers': len(self._frame_buffer),
-                'buffer_ids': [f"0x{arb_id:X}" for arb_id in self._frame_buffer.keys()]
-            }
-
+        active_ids = [arb_id for arb_id, slot in list(self._slots.items()) if slot.active]
+        return {
+            'active_buffers': len(active_ids),
+            'buffer_ids': [f"0x{arb_id:X}" for arb_id in active_ids],
+            'allocated_slots': len(self._slots)
+        }
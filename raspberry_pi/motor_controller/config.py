@@ -33,6 +33,7 @@ class RampingConfig:
     deceleration_rate: int = 800  # μs/s
     brake_rate: int = 1500  # μs/s
     update_interval: float = 0.02  # 50Hz
+    realtime_priority: int = 0  # SCHED_FIFO-Priorität (1-99), 0 = aus
 
 
 @dataclass
@@ -43,6 +44,10 @@ class SafetyConfig:
     debounce_time: float = 0.2  # Sekunden
     command_timeout: float = 2.0  # Sekunden
     joystick_timeout: float = 1.0  # Sekunden
+    can_timeout: float = 0.5  # Sekunden ohne Sensor-Daten während der Bahnfolge
+    supervisor_enabled: bool = True  # Not-Halt-Überwachung als eigener Prozess
+    supervisor_period: float = 0.002  # Prüftakt des Supervisors in Sekunden
+    supervisor_priority: int = 0  # SCHED_FIFO-Priorität (1-99), 0 = aus
 
 
 @dataclass
@@ -71,8 +76,15 @@ class CANConfig:
     bitrate: int = 1000000
     motor_controller_id: int = 0x200
     sensor_hub_id: int = 0x100
-    max_frame_size: int = 6  # Bytes Nutzdaten pro Frame
+    telemetry_id: int = 0x101  # Binäre Sensor-Hub-Telemetrie
+    max_frame_size: int = 6  # Bytes Nutzdaten pro Frame (klassisch)
+    fd: bool = False  # CAN-FD (64-Byte-Frames), Interface muss mit "fd on" konfiguriert sein
+    data_bitrate: int = 5000000  # Datenphase bei CAN-FD (dbitrate)
+    bitrate_switch: bool = True  # BRS: Nutzdaten mit data_bitrate senden
+    fd_frame_size: int = 62  # Bytes Nutzdaten pro FD-Frame
     frame_timeout: float = 1.0  # Sekunden
+    kernel_filters: bool = True  # SocketCAN-Filter: nur registrierte IDs empfangen
+    extra_filter_ids: List[int] = field(default_factory=list)  # Zusätzlich durchgelassene IDs
 
 
 @dataclass
@@ -85,6 +97,73 @@ class WebConfig:
     template_folder: str = 'templates'
     static_folder: str = 'static'
     max_speed_percent: float = 100.0
+    joystick_rate: float = 50.0  # Hz, Übernahme des neuesten Joystick-Samples
+    joystick_max_latency: float = 0.25  # Sekunden, verspätete Samples verwerfen
+    pwm_echo_rate: float = 10.0  # Hz, maximale Rate der pwm_update-Events
+    separate_process: bool = True  # Flask/Socket.IO in eigenem Prozess (Shared Memory)
+    process_poll_interval: float = 0.002  # Sekunden, Abfrage der Shared-Memory-Kanäle
+
+
+@dataclass
+class RecorderConfig:
+    """Telemetrie-Aufzeichnung (Ringpuffer + Datei)"""
+    enabled: bool = True
+    capacity: int = 180000  # Zeilen im Speicher (1 h bei 50 Hz, ~9 MB)
+    file: str = ''  # Aufzeichnungsdatei, leer = nur im Speicher
+    flush_interval: float = 5.0  # Sekunden
+    max_file_mb: int = 512  # danach Rotation nach <file>.1
+
+
+@dataclass
+class NavigationConfig:
+    """Bahnplanung (Boustrophedon-Streifen)"""
+    cutting_width: float = 0.5  # Schnittbreite in m
+    overlap: float = 0.05  # Überlappung benachbarter Streifen in m
+    edge_margin: float = 0.0  # Abstand der Streifenenden zur Kontur in m
+    min_stripe_length: float = 0.2  # kürzere Streifenstücke werden verworfen (m)
+    time_budget: float = 0.05  # Sekunden für die Optimierung der Zellreihenfolge
+    site_file: str = ''  # Standort (ENU-Ursprung, Mähgrenzen, No-Go-Zonen) als JSON, leer = ohne Geofence
+    geofence_cell_size: float = 1.0  # Band-/Zellgröße des Geofence-Index in m
+
+
+@dataclass
+class CoverageConfig:
+    """Mähabdeckung (Raster im Standort-Rahmen, PNG-Kacheln unter /api/coverage)"""
+    enabled: bool = True  # braucht navigation.site_file (Fläche + Ursprung)
+    file: str = ''  # Rasterdatei (mmap, übersteht Neustarts), leer = nur im Speicher
+    resolution: float = 0.05  # Zellgröße in m (Breite = navigation.cutting_width)
+    margin: float = 1.0  # Rand um die Standortgrenzen in m
+    tile_size: int = 256  # Zellen pro Kachelkante
+    max_gap: float = 1.0  # größere Positionssprünge werden nicht verbunden (m)
+    rtk_only: bool = True  # nur bei RTK FIXED stempeln
+    blade_offset_forward: float = 0.0  # Messermitte relativ zur GPS-Antenne (m vorwärts)
+    blade_offset_left: float = 0.0  # Messermitte relativ zur GPS-Antenne (m links)
+
+
+@dataclass
+class FollowerConfig:
+    """Bahnfolge (Pure Pursuit im Ramping-Takt)"""
+    enabled: bool = True
+    max_speed: float = 1.0  # m/s bei voller Joystick-Auslenkung (y = 1.0)
+    track_width: float = 0.5  # Spurweite in m
+    mow_speed: float = 0.4  # m/s auf Mähstreifen
+    transit_speed: float = 0.6  # m/s auf Transferfahrten
+    lookahead_min: float = 0.3  # Vorausschau in m
+    lookahead_max: float = 1.5
+    lookahead_gain: float = 0.5  # zusätzliche Vorausschau pro m/s
+    max_turn_rate: float = 1.0  # rad/s
+    pivot_angle: float = 60.0  # ab diesem Winkel zum Zielpunkt auf der Stelle drehen (Grad)
+    deceleration: float = 0.5  # m/s² vor dem Pfadende
+    goal_tolerance: float = 0.05  # m
+    pose_timeout: float = 0.5  # ohne neue Position länger als das: anhalten (s)
+    max_waypoints: int = 20000  # Größe der vorallokierten Pfadpuffer
+
+
+@dataclass
+class StartupConfig:
+    """Hochfahren der Komponenten"""
+    parallel: bool = True  # Safety-Pfad, CAN, Recorder und Standort gleichzeitig initialisieren
+    timeout: float = 10.0  # Sekunden, länger dauernde Stufen gelten als fehlgeschlagen
 
 
 @dataclass
@@ -107,6 +186,11 @@ class Config:
     mower: MowerConfig = field(default_factory=MowerConfig)
     can: CANConfig = field(default_factory=CANConfig)
     web: WebConfig = field(default_factory=WebConfig)
+    recorder: RecorderConfig = field(default_factory=RecorderConfig)
+    navigation: NavigationConfig = field(default_factory=NavigationConfig)
+    coverage: CoverageConfig = field(default_factory=CoverageConfig)
+    follower: FollowerConfig = field(default_factory=FollowerConfig)
+    startup: StartupConfig = field(default_factory=StartupConfig)
     logging: LoggingConfig = field(default_factory=LoggingConfig)
     
     quiet: bool = False
@@ -142,6 +226,16 @@ class Config:
             config.can = CANConfig(**data['can'])
         if 'web' in data:
             config.web = WebConfig(**data['web'])
+        if 'recorder' in data:
+            config.recorder = RecorderConfig(**data['recorder'])
+        if 'navigation' in data:
+            config.navigation = NavigationConfig(**data['navigation'])
+        if 'coverage' in data:
+            config.coverage = CoverageConfig(**data['coverage'])
+        if 'follower' in data:
+            config.follower = FollowerConfig(**data['follower'])
+        if 'startup' in data:
+            config.startup = StartupConfig(**data['startup'])
         if 'logging' in data:
             config.logging = LoggingConfig(**data['logging'])
         
@@ -168,14 +262,19 @@ class Config:
                 'acceleration_rate': self.ramping.acceleration_rate,
                 'deceleration_rate': self.ramping.deceleration_rate,
                 'brake_rate': self.ramping.brake_rate,
-                'update_interval': self.ramping.update_interval
+                'update_interval': self.ramping.update_interval,
+                'realtime_priority': self.ramping.realtime_priority
             },
             'safety': {
                 'pin': self.safety.pin,
                 'enabled': self.safety.enabled,
                 'debounce_time': self.safety.debounce_time,
                 'command_timeout': self.safety.command_timeout,
-                'joystick_timeout': self.safety.joystick_timeout
+                'joystick_timeout': self.safety.joystick_timeout,
+                'can_timeout': self.safety.can_timeout,
+                'supervisor_enabled': self.safety.supervisor_enabled,
+                'supervisor_period': self.safety.supervisor_period,
+                'supervisor_priority': self.safety.supervisor_priority
             },
             'light': {
                 'enabled': self.light.enabled,
@@ -195,8 +294,15 @@ class Config:
                 'bitrate': self.can.bitrate,
                 'motor_controller_id': self.can.motor_controller_id,
                 'sensor_hub_id': self.can.sensor_hub_id,
+                'telemetry_id': self.can.telemetry_id,
                 'max_frame_size': self.can.max_frame_size,
-                'frame_timeout': self.can.frame_timeout
+                'fd': self.can.fd,
+                'data_bitrate': self.can.data_bitrate,
+                'bitrate_switch': self.can.bitrate_switch,
+                'fd_frame_size': self.can.fd_frame_size,
+                'frame_timeout': self.can.frame_timeout,
+                'kernel_filters': self.can.kernel_filters,
+                'extra_filter_ids': self.can.extra_filter_ids
             },
             'web': {
                 'enabled': self.web.enabled,
@@ -205,7 +311,59 @@ class Config:
                 'secret_key': self.web.secret_key,
                 'template_folder': self.web.template_folder,
                 'static_folder': self.web.static_folder,
-                'max_speed_percent': self.web.max_speed_percent
+                'max_speed_percent': self.web.max_speed_percent,
+                'joystick_rate': self.web.joystick_rate,
+                'joystick_max_latency': self.web.joystick_max_latency,
+                'pwm_echo_rate': self.web.pwm_echo_rate,
+                'separate_process': self.web.separate_process,
+                'process_poll_interval': self.web.process_poll_interval
+            },
+            'recorder': {
+                'enabled': self.recorder.enabled,
+                'capacity': self.recorder.capacity,
+                'file': self.recorder.file,
+                'flush_interval': self.recorder.flush_interval,
+                'max_file_mb': self.recorder.max_file_mb
+            },
+            'navigation': {
+                'cutting_width': self.navigation.cutting_width,
+                'overlap': self.navigation.overlap,
+                'edge_margin': self.navigation.edge_margin,
+                'min_stripe_length': self.navigation.min_stripe_length,
+                'time_budget': self.navigation.time_budget,
+                'site_file': self.navigation.site_file,
+                'geofence_cell_size': self.navigation.geofence_cell_size
+            },
+            'coverage': {
+                'enabled': self.coverage.enabled,
+                'file': self.coverage.file,
+                'resolution': self.coverage.resolution,
+                'margin': self.coverage.margin,
+                'tile_size': self.coverage.tile_size,
+                'max_gap': self.coverage.max_gap,
+                'rtk_only': self.coverage.rtk_only,
+                'blade_offset_forward': self.coverage.blade_offset_forward,
+                'blade_offset_left': self.coverage.blade_offset_left
+            },
+            'follower': {
+                'enabled': self.follower.enabled,
+                'max_speed': self.follower.max_speed,
+                'track_width': self.follower.track_width,
+                'mow_speed': self.follower.mow_speed,
+                'transit_speed': self.follower.transit_speed,
+                'lookahead_min': self.follower.lookahead_min,
+                'lookahead_max': self.follower.lookahead_max,
+                'lookahead_gain': self.follower.lookahead_gain,
+                'max_turn_rate': self.follower.max_turn_rate,
+                'pivot_angle': self.follower.pivot_angle,
+                'deceleration': self.follower.deceleration,
+                'goal_tolerance': self.follower.goal_tolerance,
+                'pose_timeout': self.follower.pose_timeout,
+                'max_waypoints': self.follower.max_waypoints
+            },
+            'startup': {
+                'parallel': self.startup.parallel,
+                'timeout': self.startup.timeout
             },
             'logging': {
                 'level': self.logging.level,
@@ -5,6 +5,8 @@ Control-Module für Motor Controller
 
 from .motor_control import MotorControl
 from .joystick_handler import JoystickHandler
+from .control_scheduler import FixedRateScheduler
+from .path_follower import PathFollower
 
-__all__ = ['MotorControl', 'JoystickHandler']
+__all__ = ['MotorControl', 'JoystickHandler', 'FixedRateScheduler', 'PathFollower']
 
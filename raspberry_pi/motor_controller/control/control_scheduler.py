@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""
+Control Scheduler - Deterministischer Fixed-Rate-Takt für Regelschleifen
+Absolute Deadlines auf der monotonen Uhr statt relativer Wartezeiten
+"""
+
+import logging
+import os
+import threading
+import time
+from typing import Callable, Dict, Optional
+
+
+class FixedRateScheduler:
+    """
+    Fixed-Rate-Scheduler für Regelschleifen
+    - Absolute Deadlines (time.monotonic), dadurch kein Drift über die Laufzeit
+    - Jitter-Messung (Abweichung Aufwachzeitpunkt zu Deadline)
+    - Overrun-Erkennung (verpasste Takte werden übersprungen, nicht nachgeholt)
+    - Optional SCHED_FIFO-Priorität für den Scheduler-Thread
+    """
+
+    def __init__(self, interval: float, callback: Callable[[float], None],
+                 name: str = 'control', realtime_priority: int = 0):
+        """
+        Initialisiert den Scheduler
+
+        Args:
+            interval: Taktperiode in Sekunden
+            callback: Wird pro Takt mit der tatsächlichen Zeit seit dem letzten Takt aufgerufen
+            name: Thread-Name (für Logging/ps)
+            realtime_priority: SCHED_FIFO-Priorität (1-99), 0 = normaler Scheduler
+        """
+        self.logger = logging.getLogger(__name__)
+        self.interval = interval
+        self.callback = callback
+        self.name = name
+        self.realtime_priority = realtime_priority
+
+        self.running = False
+        self.realtime_active = False
+        self._thread: Optional[threading.Thread] = None
+        self._stop_event = threading.Event()
+
+        # Statistiken (nur vom Scheduler-Thread geschrieben)
+        self.ticks = 0
+        self.overruns = 0
+        self.missed_ticks = 0
+        self.last_jitter = 0.0
+        self.max_jitter = 0.0
+        self.mean_jitter = 0.0
+        self.last_exec_time = 0.0
+        self.max_exec_time = 0.0
+
+    def start(self):
+        """Startet den Scheduler-Thread"""
+        if self.running:
+            return
+
+        self.running = True
+        self._stop_event.clear()
+        self._thread = threading.Thread(target=self._run, name=self.name, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """Stoppt den Scheduler-Thread"""
+        if not self.running:
+            return
+
+        self.running = False
+        self._stop_event.set()
+
+        if self._thread and self._thread is not threading.current_thread():
+            self._thread.join(timeout=2.0)
+
+    def _apply_realtime_priority(self):
+        """Setzt SCHED_FIFO für den aktuellen Thread (benötigt CAP_SYS_NICE)"""
+        if self.realtime_priority <= 0 or not hasattr(os, 'sched_setscheduler'):
+            return
+
+        try:
+            # pid 0 = aufrufender Thread (Linux)
+            os.sched_setscheduler(0, os.SCHED_FIFO, os.sched_param(self.realtime_priority))
+            self.realtime_active = True
+            self.logger.info(f"✅ {self.name}: SCHED_FIFO Priorität {self.realtime_priority}")
+        except (PermissionError, OSError) as e:
+            self.logger.warning(f"⚠️  {self.name}: SCHED_FIFO nicht möglich ({e}) - normaler Scheduler")
+
+    def _run(self):
+        """Scheduler-Loop mit absoluten Deadlines"""
+        self._apply_realtime_priority()
+
+        interval = self.interval
+        last_tick = time.monotonic()
+        deadline = last_tick + interval
+
+        while not self._stop_event.is_set():
+            remaining = deadline - time.monotonic()
+            if remaining > 0 and self._stop_event.wait(remaining):
+                break
+
+            now = time.monotonic()
+            self._record_jitter(now - deadline)
+
+            try:
+                self.callback(now - last_tick)
+            except Exception as e:
+                self.logger.error(f"❌ {self.name}: Callback-Fehler: {e}")
+
+            finished = time.monotonic()
+            exec_time = finished - now
+            self.last_exec_time = exec_time
+            if exec_time > self.max_exec_time:
+                self.max_exec_time = exec_time
+
+            self.ticks += 1
+            last_tick = now
+            deadline += interval
+
+            # Overrun: nächste Deadline bereits verstrichen -> verpasste Takte überspringen
+            if finished > deadline:
+                skipped = int((finished - deadline) / interval) + 1
+                self.overruns += 1
+                self.missed_ticks += skipped
+                deadline += skipped * interval
+
+    def _record_jitter(self, jitter: float):
+        self.last_jitter = jitter
+        if jitter > self.max_jitter:
+            self.max_jitter = jitter
+        # Gleitender Mittelwert (EWMA), damit keine Historie gespeichert werden muss
+        self.mean_jitter += (jitter - self.mean_jitter) * 0.01
+
+    def reset_stats(self):
+        """Setzt die Jitter-/Overrun-Statistiken zurück"""
+        self.overruns = 0
+        self.missed_ticks = 0
+        self.max_jitter = 0.0
+        self.mean_jitter = 0.0
+        self.max_exec_time = 0.0
+
+    def get_stats(self) -> Dict[str, any]:
+        """
+        Gibt Timing-Statistiken zurück
+
+        Returns:
+            Dictionary mit Takt, Jitter und Overruns (Zeiten in ms)
+        """
+        return {
+            'running': self.running,
+            'interval_ms': round(self.interval * 1000.0, 3),
+            'realtime': self.realtime_active,
+            'ticks': self.ticks,
+            'overruns': self.overruns,
+            'missed_ticks': self.missed_ticks,
+            'jitter_last_ms': round(self.last_jitter * 1000.0, 3),
+            'jitter_mean_ms': round(self.mean_jitter * 1000.0, 3),
+            'jitter_max_ms': round(self.max_jitter * 1000.0, 3),
+            'exec_last_ms': round(self.last_exec_time * 1000.0, 3),
+            'exec_max_ms': round(self.max_exec_time * 1000.0, 3),
+        }
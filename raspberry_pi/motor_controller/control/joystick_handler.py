@@ -7,7 +7,11 @@ Verwaltet Joystick-Status und Timeout-Überwachung
 import logging
 import threading
 import time
-from typing import Optional, Tuple
+from typing import Callable, Optional, Tuple
+
+from ..monitoring.latency_tracer import STAGE_JOYSTICK, STAGE_SOCKETIO, get_tracer
+from .control_scheduler import FixedRateScheduler
+from .joystick_input import JoystickMailbox, JoystickSample
 
 
 class JoystickHandler:
@@ -16,19 +20,23 @@ class JoystickHandler:
     - Joystick-Status-Verwaltung
     - Timeout-Überwachung
     - Thread-Safe Zugriff
+    - Steuerungstakt: pro Tick wird nur das neueste empfangene Sample angewendet
     """
     
-    def __init__(self, motor_control, safety_monitor):
+    def __init__(self, motor_control, safety_monitor, tick_rate: float = 50.0, max_latency: float = 0.25):
         """
         Initialisiert Joystick-Handler
         
         Args:
             motor_control: MotorControl-Instanz
             safety_monitor: SafetyMonitor-Instanz
+            tick_rate: Steuerungstakt in Hz (Übernahme der Samples)
+            max_latency: Samples mit mehr Zusatzverzögerung werden verworfen (Sekunden)
         """
         self.logger = logging.getLogger(__name__)
         self.motor = motor_control
         self.safety = safety_monitor
+        self.tracer = get_tracer()
         
         # Joystick-Status
         self.enabled = False
@@ -39,6 +47,50 @@ class JoystickHandler:
 
         # Thread-Safety
         self._lock = threading.Lock()
+        # Serialisiert Übernahme im Takt und disable(), damit nach einem
+        # Release kein bereits abgeholtes Sample die Motoren wieder anfährt
+        self._tick_lock = threading.Lock()
+        
+        # Latest-wins Postfach + Steuerungstakt
+        self.mailbox = JoystickMailbox(max_latency=max_latency)
+        self.on_applied: Optional[Callable[[], None]] = None
+        self._scheduler = FixedRateScheduler(
+            interval=1.0 / tick_rate,
+            callback=self._control_tick,
+            name='joystick-tick'
+        )
+        self._scheduler.start()
+    
+    def submit(self, sample: JoystickSample, source: str = '') -> bool:
+        """
+        Übergibt ein empfangenes Sample (Socket.IO/REST); angewendet wird im nächsten Takt
+        
+        Args:
+            sample: JoystickSample (mit optionaler Sequenznummer/Client-Zeit)
+            source: Client-Kennung für die Sequenzprüfung
+            
+        Returns:
+            True wenn angenommen, False wenn veraltet verworfen
+        """
+        return self.mailbox.offer(sample, source)
+    
+    def forget_client(self, source: str):
+        """Vergisst den Sequenzstand eines getrennten Clients"""
+        self.mailbox.forget(source)
+    
+    def _control_tick(self, elapsed: float):
+        """Steuerungstakt: neuestes Sample übernehmen"""
+        with self._tick_lock:
+            sample = self.mailbox.take()
+            if sample is None:
+                return
+            self.tracer.begin(sample.received_ns)
+            self.tracer.mark(STAGE_SOCKETIO)
+            self.update(sample.x, sample.y)
+            self.tracer.end()
+        
+        if self.on_applied:
+            self.on_applied()
     
     def update(self, x: float, y: float):
         """
@@ -56,6 +108,7 @@ class JoystickHandler:
         
         # Safety Monitor aktualisieren
         self.safety.update_joystick_time()
+        self.tracer.mark(STAGE_JOYSTICK)
         
         # Motor-Steuerung aktualisieren (ohne Ramping für direkte Kontrolle)
         self.motor.set_joystick(self.x, self.y, use_ramping=False)
@@ -64,13 +117,15 @@ class JoystickHandler:
     
     def disable(self):
         """Deaktiviert Joystick-Steuerung"""
-        with self._lock:
-            self.enabled = False
-            self.x = 0.0
-            self.y = 0.0
-        
-        # Motoren auf Neutral
-        self.motor.emergency_stop()
+        with self._tick_lock:
+            self.mailbox.clear()
+            with self._lock:
+                self.enabled = False
+                self.x = 0.0
+                self.y = 0.0
+            
+            # Motoren auf Neutral
+            self.motor.emergency_stop()
         self.logger.info("Joystick deaktiviert")
     
     def get_position(self) -> Tuple[float, float]:
@@ -113,11 +168,17 @@ class JoystickHandler:
             Dictionary mit Status-Informationen
         """
         with self._lock:
-            return {
+            status = {
                 'enabled': self.enabled,
                 'x': self.x,
                 'y': self.y,
                 'last_update': self.last_update,
                 'max_speed': self.max_speed
             }
+        status['input'] = self.mailbox.get_stats()
+        return status
+    
+    def cleanup(self):
+        """Stoppt den Steuerungstakt"""
+        self._scheduler.stop()
 
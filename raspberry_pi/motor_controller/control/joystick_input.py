@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""
+Joystick Input - Binäres Joystick-Protokoll mit Sequenznummern
+Neuester Sample gewinnt, veraltete/umsortierte Samples werden verworfen
+"""
+
+import struct
+import threading
+import time
+from typing import NamedTuple, Optional
+
+# Paket (13 Bytes, little endian):
+#   u8  version (1)
+#   u32 Sequenznummer (wraparound)
+#   u32 Client-Zeitstempel in ms (monoton, z.B. performance.now())
+#   i16 x * 32767
+#   i16 y * 32767
+JOYSTICK_PACKET_VERSION = 1
+_JOYSTICK_PACKET = struct.Struct('<BIIhh')
+JOYSTICK_PACKET_SIZE = _JOYSTICK_PACKET.size
+_AXIS_SCALE = 32767.0
+_SEQ_MODULO = 1 << 32
+_SEQ_HALF = 1 << 31
+
+
+class JoystickSample(NamedTuple):
+    """Ein Joystick-Sample mit Empfangszeitpunkt (perf_counter_ns für Tracing)"""
+
+    seq: Optional[int]
+    client_ms: Optional[int]
+    x: float
+    y: float
+    received_ns: int
+
+
+def decode_joystick_packet(data: bytes, received_ns: Optional[int] = None) -> Optional[JoystickSample]:
+    """
+    Dekodiert ein binäres Joystick-Paket
+
+    Returns:
+        JoystickSample oder None bei ungültigem Paket
+    """
+    if len(data) != JOYSTICK_PACKET_SIZE:
+        return None
+    version, seq, client_ms, x_raw, y_raw = _JOYSTICK_PACKET.unpack(data)
+    if version != JOYSTICK_PACKET_VERSION:
+        return None
+    return JoystickSample(
+        seq=seq,
+        client_ms=client_ms,
+        x=x_raw / _AXIS_SCALE,
+        y=y_raw / _AXIS_SCALE,
+        received_ns=received_ns if received_ns is not None else time.perf_counter_ns()
+    )
+
+
+def encode_joystick_packet(seq: int, client_ms: int, x: float, y: float) -> bytes:
+    """Kodiert ein Joystick-Paket (Gegenstück zum Web-Client, z.B. für Tests/Tools)"""
+    x_raw = int(round(max(-1.0, min(1.0, x)) * _AXIS_SCALE))
+    y_raw = int(round(max(-1.0, min(1.0, y)) * _AXIS_SCALE))
+    return _JOYSTICK_PACKET.pack(JOYSTICK_PACKET_VERSION, seq % _SEQ_MODULO, client_ms % _SEQ_MODULO, x_raw, y_raw)
+
+
+def _seq_newer(seq: int, last: int) -> bool:
+    """Serial-Number-Arithmetik: seq ist neuer als last (mit Wraparound)"""
+    return 0 < (seq - last) % _SEQ_MODULO < _SEQ_HALF
+
+
+class _SourceState:
+    """Sequenz- und Offset-Zustand pro Client"""
+
+    __slots__ = ('last_seq', 'window_min', 'previous_min', 'window_start_ns', 'late_drops')
+
+    def __init__(self, now_ns: int):
+        self.last_seq: Optional[int] = None
+        self.window_min: Optional[float] = None
+        self.previous_min: Optional[float] = None
+        self.window_start_ns = now_ns
+        self.late_drops = 0  # aufeinanderfolgend als verspätet verworfene Samples
+
+    def rebaseline(self, offset_ms: float, now_ns: int):
+        """Offset-Schätzung neu mit dem aktuellen Sample beginnen"""
+        self.window_min = offset_ms
+        self.previous_min = None
+        self.window_start_ns = now_ns
+        self.late_drops = 0
+
+
+class JoystickMailbox:
+    """
+    Latest-wins Postfach zwischen Socket.IO-Handlern und dem Steuerungstakt
+    - Umsortierte/doppelte Samples (Sequenznummer nicht neuer) werden verworfen
+    - Verspätete Samples (Transportverzögerung deutlich über der besten
+      beobachteten) werden verworfen; der Client-Uhr-Offset wird als Minimum
+      von (Server-Zeit - Client-Zeit) über zwei gleitende Fenster geschätzt
+    - Nach max_late_drops verspäteten Samples in Folge (Uhrsprung, anhaltend höhere
+      Verzögerung) wird die Schätzung neu begonnen und das Sample angenommen, statt
+      die Handsteuerung bis zum Ablauf beider Fenster zu blockieren
+    - Der Steuerungstakt holt pro Tick höchstens ein (das neueste) Sample ab
+    """
+
+    def __init__(self, max_latency: float = 0.25, offset_window: float = 10.0, max_late_drops: int = 10):
+        """
+        Initialisiert das Postfach
+
+        Args:
+            max_latency: Maximal tolerierte Zusatzverzögerung gegenüber der besten (Sekunden)
+            offset_window: Fensterlänge der Offset-Schätzung (Sekunden)
+            max_late_drops: Verspätete Samples in Folge, nach denen neu geschätzt wird
+        """
+        self.max_latency_ms = max_latency * 1000.0
+        self.offset_window_ns = int(offset_window * 1e9)
+        self.max_late_drops = max_late_drops
+        self._lock = threading.Lock()
+        self._pending: Optional[JoystickSample] = None
+        self._sources = {}
+
+        self.accepted = 0
+        self.dropped_stale = 0
+        self.dropped_late = 0
+        self.rebaselined = 0
+        self.coalesced = 0
+        self.applied = 0
+        self.last_latency_ms = 0.0
+
+    def forget(self, source: str):
+        """Vergisst Sequenz und Offset eines Clients (z.B. bei Disconnect)"""
+        with self._lock:
+            self._sources.pop(source, None)
+
+    def clear(self):
+        """Verwirft ein noch nicht angewendetes Sample (z.B. bei Joystick-Release)"""
+        with self._lock:
+            self._pending = None
+
+    def _transport_delay_ms(self, state: _SourceState, sample: JoystickSample) -> float:
+        offset_ms = sample.received_ns / 1e6 - sample.client_ms
+        if sample.received_ns - state.window_start_ns > self.offset_window_ns:
+            # Fenster wechseln, damit sich die Schätzung an Uhr-Drift anpasst
+            state.previous_min = state.window_min
+            state.window_min = None
+            state.window_start_ns = sample.received_ns
+        if state.window_min is None or offset_ms < state.window_min:
+            state.window_min = offset_ms
+        best = state.window_min if state.previous_min is None else min(state.window_min, state.previous_min)
+        return offset_ms - best
+
+    def offer(self, sample: JoystickSample, source: str = '') -> bool:
+        """
+        Übergibt ein neues Sample (aus dem Socket.IO-Thread)
+
+        Args:
+            sample: Dekodiertes Sample
+            source: Client-Kennung (Socket.IO sid), Sequenzen sind pro Client
+
+        Returns:
+            True wenn angenommen, False wenn verworfen
+        """
+        with self._lock:
+            state = self._sources.get(source)
+            if state is None:
+                state = self._sources[source] = _SourceState(sample.received_ns)
+
+            if sample.seq is not None:
+                if state.last_seq is not None and not _seq_newer(sample.seq, state.last_seq):
+                    self.dropped_stale += 1
+                    return False
+                state.last_seq = sample.seq
+
+            if sample.client_ms is not None:
+                self.last_latency_ms = self._transport_delay_ms(state, sample)
+                if self.last_latency_ms > self.max_latency_ms:
+                    if state.late_drops < self.max_late_drops:
+                        state.late_drops += 1
+                        self.dropped_late += 1
+                        return False
+                    state.rebaseline(sample.received_ns / 1e6 - sample.client_ms, sample.received_ns)
+                    self.rebaselined += 1
+                    self.last_latency_ms = 0.0
+                else:
+                    state.late_drops = 0
+
+            if self._pending is not None:
+                self.coalesced += 1
+            self._pending = sample
+            self.accepted += 1
+            return True
+
+    def take(self) -> Optional[JoystickSample]:
+        """Holt das neueste Sample ab (aus dem Steuerungstakt)"""
+        with self._lock:
+            sample, self._pending = self._pending, None
+            if sample is not None:
+                self.applied += 1
+            return sample
+
+    def get_stats(self) -> dict:
+        """
+        Gibt Postfach-Statistiken zurück
+
+        Returns:
+            Dictionary mit Zählern
+        """
+        with self._lock:
+            return {
+                'accepted': self.accepted,
+                'applied': self.applied,
+                'coalesced': self.coalesced,
+                'dropped_stale': self.dropped_stale,
+                'dropped_late': self.dropped_late,
+                'rebaselined': self.rebaselined,
+                'last_latency_ms': round(self.last_latency_ms, 1),
+                'clients': len(self._sources),
+            }
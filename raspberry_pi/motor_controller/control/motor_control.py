@@ -6,16 +6,19 @@ Zentrale Motor-Steuerungslogik mit optionalem Ramping
 
 import logging
 import threading
-import time
 from typing import Dict, Tuple
 
+from .control_scheduler import FixedRateScheduler
+from ..monitoring.latency_tracer import STAGE_MOTOR, get_tracer
+
 
 class MotorControl:
     """
     Motor-Steuerung für Skid Steering
     - Skid Steering Berechnung (Vorwärts/Rückwärts + Drehung)
-    - Optionales Ramping (sanfte Beschleunigung/Bremsung)
-    - Thread-Safe PWM-Verwaltung
+    - Optionales Ramping (sanfte Beschleunigung/Bremsung) im Fixed-Rate-Takt
+    - Thread-Safe PWM-Verwaltung mit Sub-μs-Rampenzustand
+    - Optionale Bahnfolge (PathFollower), die im selben Takt die Zielwerte setzt
     """
     
     def __init__(self, pwm_controller, config):
@@ -28,26 +31,38 @@ class MotorControl:
         """
         self.logger = logging.getLogger(__name__)
         self.pwm = pwm_controller
+        self.tracer = get_tracer()
         self.pwm_config = config.pwm
         self.ramping_config = config.ramping
         
-        # Ramping
+        # Ramping (Ist-Werte als float, damit langsame Rampen nicht wegrunden)
         self.ramping_enabled = config.ramping.enabled
-        self.current_values: Dict[str, int] = {
-            'left': self.pwm_config.neutral_value,
-            'right': self.pwm_config.neutral_value
-        }
-        self.target_values: Dict[str, int] = {
-            'left': self.pwm_config.neutral_value,
-            'right': self.pwm_config.neutral_value
-        }
+        neutral = float(self.pwm_config.neutral_value)
+        self._current_left = neutral
+        self._current_right = neutral
+        self._target_left = neutral
+        self._target_right = neutral
         
-        # Ramping-Thread
+        # Ramping-Takt (absolute Deadlines, Jitter-/Overrun-Messung)
         self.ramping_running = False
-        self.ramping_thread: Optional[threading.Thread] = None
-        self._stop_event = threading.Event()
+        self._scheduler = FixedRateScheduler(
+            interval=self.ramping_config.update_interval,
+            callback=self._ramping_tick,
+            name='motor-ramping',
+            realtime_priority=self.ramping_config.realtime_priority
+        )
+        # Nach Overruns höchstens wenige Takte auf einmal nachholen
+        self._max_tick_dt = self.ramping_config.update_interval * 5
         self._lock = threading.Lock()
         
+        # Bahnfolge: Takt und Stopp serialisiert, damit nach einem Stopp kein Zielwert mehr folgt
+        self.follower = None
+        self._follow_lock = threading.Lock()
+        
+        # Heartbeat pro Motorbefehl (SafetyMonitor.update_command_time) und Safety Supervisor
+        self.command_heartbeat = None
+        self.supervisor = None
+        
         if self.ramping_enabled:
             self.start_ramping()
     
@@ -88,21 +103,26 @@ class MotorControl:
         
         return left_pwm, right_pwm
     
-    def set_motor_direct(self, left: int, right: int):
+    def set_motor_direct(self, left: int, right: int) -> bool:
         """
         Setzt Motor-PWM direkt (ohne Ramping)
         
         Args:
             left: PWM-Wert links in μs
             right: PWM-Wert rechts in μs
+            
+        Returns:
+            True wenn die PWM geschrieben wurde
         """
-        self.pwm.set_motor_pwm_both(left, right)
+        if self.command_heartbeat:
+            self.command_heartbeat()
         
+        # Zustand und Hardware unter demselben Lock wie im Ramping-Takt: gleichzeitige
+        # Aufrufe (Notaus, Joystick) landen in derselben Reihenfolge in Zustand und PWM
         with self._lock:
-            self.current_values['left'] = left
-            self.current_values['right'] = right
-            self.target_values['left'] = left
-            self.target_values['right'] = right
+            self._current_left = self._target_left = float(left)
+            self._current_right = self._target_right = float(right)
+            return self.pwm.set_motor_pwm_both(left, right)
     
     def set_motor_target(self, left: int, right: int):
         """
@@ -113,12 +133,14 @@ class MotorControl:
             right: Ziel-PWM-Wert rechts in μs
         """
         with self._lock:
-            self.target_values['left'] = left
-            self.target_values['right'] = right
+            self._target_left = float(left)
+            self._target_right = float(right)
         
         # Wenn Ramping deaktiviert, direkt setzen
         if not self.ramping_enabled:
             self.set_motor_direct(left, right)
+        elif self.command_heartbeat:
+            self.command_heartbeat()
     
     def set_joystick(self, x: float, y: float, use_ramping: bool = False):
         """
@@ -129,98 +151,162 @@ class MotorControl:
             y: Joystick Y-Achse (-1.0 bis 1.0)
             use_ramping: True für Ramping, False für direkte Steuerung
         """
+        # Manuelle Übernahme beendet die Bahnfolge
+        if self.follower is not None and self.follower.active:
+            self.stop_path_following('manual')
+        
         left_pwm, right_pwm = self.calculate_skid_steering(x, y)
+        self.tracer.mark(STAGE_MOTOR)
         
         if use_ramping:
             self.set_motor_target(left_pwm, right_pwm)
         else:
             self.set_motor_direct(left_pwm, right_pwm)
     
-    def emergency_stop(self):
-        """Notaus - Motoren sofort auf Neutral"""
+    def set_path_follower(self, follower):
+        """
+        Setzt die Bahnfolge, die im Ramping-Takt ausgeführt wird
+        
+        Args:
+            follower: PathFollower-Instanz oder None
+        """
+        self.follower = follower
+    
+    def start_path_following(self, waypoints) -> bool:
+        """
+        Startet die Bahnfolge auf einem Pfad [(x, y, mowing), ...]
+        
+        Returns:
+            True wenn gestartet
+        """
+        if self.follower is None:
+            self.logger.error("❌ Bahnfolge nicht verfügbar")
+            return False
+        
+        with self._follow_lock:
+            if not self.follower.start(waypoints):
+                return False
+            self._set_autonomous(True)
+        
+        # Bahnfolge braucht den Takt auch bei deaktiviertem Ramping
+        if not self.ramping_running:
+            self.start_ramping()
+        return True
+    
+    def stop_path_following(self, reason: str = 'stopped'):
+        """Beendet die Bahnfolge und bremst (mit Ramping) auf Neutral"""
+        if self.follower is None:
+            return
+        
+        with self._follow_lock:
+            self.follower.stop(reason)
+            self._set_autonomous(False)
+        neutral = self.pwm_config.neutral_value
+        self.set_motor_target(neutral, neutral)
+    
+    def _set_autonomous(self, active: bool):
+        """Meldet dem Safety Supervisor, ob der CAN-Heartbeat erforderlich ist"""
+        if self.supervisor is not None:
+            self.supervisor.set_autonomous(active)
+    
+    def emergency_stop(self) -> bool:
+        """
+        Notaus - Motoren sofort auf Neutral
+        
+        Returns:
+            True wenn Neutral auf beiden Kanälen geschrieben wurde
+        """
+        if self.follower is not None:
+            with self._follow_lock:
+                self.follower.stop('emergency_stop')
+                self._set_autonomous(False)
         neutral = self.pwm_config.neutral_value
-        self.set_motor_direct(neutral, neutral)
+        if not self.set_motor_direct(neutral, neutral):
+            self.logger.error("❌ EMERGENCY STOP - Neutral konnte nicht geschrieben werden")
+            return False
         self.logger.warning("🛑 EMERGENCY STOP - Motoren neutral")
+        return True
     
     def start_ramping(self):
-        """Startet Ramping-Thread"""
+        """Startet Ramping-Takt"""
         if self.ramping_running:
             self.logger.warning("Ramping läuft bereits")
             return
         
         self.ramping_running = True
-        self._stop_event.clear()
-        self.ramping_thread = threading.Thread(target=self._ramping_loop, daemon=True)
-        self.ramping_thread.start()
-        self.logger.info("✅ Ramping gestartet")
+        self._scheduler.start()
+        self.logger.info(
+            f"✅ Ramping gestartet ({1.0 / self.ramping_config.update_interval:.0f} Hz)"
+        )
     
     def stop_ramping(self):
-        """Stoppt Ramping-Thread"""
+        """Stoppt Ramping-Takt"""
         if not self.ramping_running:
             return
         
         self.ramping_running = False
-        self._stop_event.set()
+        self._scheduler.stop()
+        self.logger.info("Ramping gestoppt")
+    
+    @staticmethod
+    def _ramp_step(current: float, target: float, neutral: float, dt: float,
+                   acceleration_rate: float, deceleration_rate: float, brake_rate: float) -> float:
+        """
+        Berechnet den nächsten Rampenwert einer Seite
+        
+        Returns:
+            Neuer (ungerundeter) PWM-Wert in μs
+        """
+        if current == target:
+            return current
         
-        if self.ramping_thread:
-            self.ramping_thread.join(timeout=2.0)
+        # Rate bestimmen
+        if target == neutral:
+            # Bremsen zu Neutral
+            rate = brake_rate
+        elif abs(target - neutral) > abs(current - neutral):
+            # Beschleunigen
+            rate = acceleration_rate
+        else:
+            # Verzögern
+            rate = deceleration_rate
         
-        self.logger.info("Ramping gestoppt")
+        # Maximale Änderung berechnen
+        max_change = rate * dt
+        diff = target - current
+        if abs(diff) <= max_change:
+            return target
+        return current + max_change if diff > 0 else current - max_change
     
-    def _ramping_loop(self):
-        """Ramping-Loop - Sanfte Beschleunigung/Bremsung"""
-        self.logger.info("Ramping-Loop gestartet")
-        
-        while not self._stop_event.is_set():
-            try:
-                dt = self.ramping_config.update_interval
-                
-                with self._lock:
-                    for side in ['left', 'right']:
-                        current = self.current_values[side]
-                        target = self.target_values[side]
-                        neutral = self.pwm_config.neutral_value
-                        
-                        if current == target:
-                            continue
-                        
-                        # Rate bestimmen
-                        if target == neutral:
-                            # Bremsen zu Neutral
-                            rate = self.ramping_config.brake_rate
-                        elif abs(target - neutral) > abs(current - neutral):
-                            # Beschleunigen
-                            rate = self.ramping_config.acceleration_rate
-                        else:
-                            # Verzögern
-                            rate = self.ramping_config.deceleration_rate
-                        
-                        # Maximale Änderung berechnen
-                        max_change = rate * dt
-                        
-                        # Neue PWM berechnen
-                        diff = target - current
-                        if abs(diff) <= max_change:
-                            new_value = target
-                        else:
-                            new_value = current + (max_change if diff > 0 else -max_change)
-                        
-                        self.current_values[side] = int(new_value)
-                
-                # PWM setzen
-                self.pwm.set_motor_pwm_both(
-                    self.current_values['left'],
-                    self.current_values['right']
-                )
-                
-                # Wartezeit
-                self._stop_event.wait(dt)
-            
-            except Exception as e:
-                self.logger.error(f"❌ Ramping-Loop Fehler: {e}")
-                time.sleep(0.1)
+    def _ramping_tick(self, elapsed: float):
+        """Ein Ramping-Takt - Sanfte Beschleunigung/Bremsung (vom Scheduler aufgerufen)"""
+        dt = elapsed if elapsed < self._max_tick_dt else self._max_tick_dt
+        ramping = self.ramping_config
+        neutral = self.pwm_config.neutral_value
+        
+        # Bahnfolge: neues Ziel im selben Takt, damit die Rampe es sofort übernimmt
+        follower = self.follower
+        if follower is not None and follower.active:
+            with self._follow_lock:
+                if follower.step(dt):
+                    self.set_motor_target(*self.calculate_skid_steering(follower.cmd_x, follower.cmd_y))
+                    if not follower.active:
+                        self._set_autonomous(False)
         
-        self.logger.info("Ramping-Loop beendet")
+        with self._lock:
+            left = self._ramp_step(self._current_left, self._target_left, neutral, dt,
+                                   ramping.acceleration_rate, ramping.deceleration_rate,
+                                   ramping.brake_rate)
+            right = self._ramp_step(self._current_right, self._target_right, neutral, dt,
+                                    ramping.acceleration_rate, ramping.deceleration_rate,
+                                    ramping.brake_rate)
+            self._current_left = left
+            self._current_right = right
+            
+            # PWM unter demselben Lock setzen (erst hier auf ganze μs runden): ein Notaus
+            # zwischen Berechnung und Schreiben würde sonst nach der Quittierung des
+            # Supervisors noch einen Takt lang den alten Duty ausgeben
+            self.pwm.set_motor_pwm_both(int(round(left)), int(round(right)))
     
     def get_current_values(self) -> Dict[str, int]:
         """
@@ -230,7 +316,7 @@ class MotorControl:
             Dictionary mit 'left' und 'right' PWM-Werten
         """
         with self._lock:
-            return self.current_values.copy()
+            return {'left': int(round(self._current_left)), 'right': int(round(self._current_right))}
     
     def get_target_values(self) -> Dict[str, int]:
         """
@@ -240,7 +326,7 @@ class MotorControl:
             Dictionary mit 'left' und 'right' PWM-Werten
         """
         with self._lock:
-            return self.target_values.copy()
+            return {'left': int(round(self._target_left)), 'right': int(round(self._target_right))}
     
     def get_status(self) -> Dict[str, any]:
         """
@@ -253,7 +339,9 @@ class MotorControl:
             'ramping_enabled': self.ramping_enabled,
             'ramping_running': self.ramping_running,
             'current_values': self.get_current_values(),
-            'target_values': self.get_target_values()
+            'target_values': self.get_target_values(),
+            'scheduler': self._scheduler.get_stats(),
+            'path_following': self.follower.active if self.follower is not None else False
         }
     
     def cleanup(self):
@@ -0,0 +1,386 @@
+#!/usr/bin/env python3
+"""
+Path Follower - Pure Pursuit Bahnfolge für Skid Steering
+Läuft im Ramping-Takt von MotorControl und liefert pro Takt Joystick-äquivalente x/y-Werte
+"""
+
+import logging
+import math
+import threading
+import time
+from array import array
+from typing import Any, Dict, Optional, Sequence
+
+# Über diesen Wert hinaus wird eine Messverzögerung nicht mehr vorausgerechnet (s)
+MAX_POSE_LATENCY = 0.25
+
+# Kriechgeschwindigkeit an Ecken (m/s), damit die Ecke sicher erreicht wird
+CORNER_SPEED = 0.1
+
+
+def _wrap_pi(angle: float) -> float:
+    return (angle + math.pi) % (2.0 * math.pi) - math.pi
+
+
+class PathFollower:
+    """
+    Pure-Pursuit-Regler auf einem Wegpunkt-Pfad im lokalen Rahmen (x = Ost, y = Nord)
+
+    - Pfad in vorallokierten array('d')-Puffern (Index 0 = Startpose beim Aktivieren)
+    - Projektion wandert nur vorwärts: Segmentwechsel bei t >= 1 oder wenn das nächste Segment näher ist
+    - Vorausschaupunkt in Bogenlänge, endet an Ecken (Wende, Wechsel Mähen/Transfer);
+      dort wird abgebremst und auf der Stelle gedreht
+    - Zwischen zwei Positionsmessungen wird die Pose mit dem eigenen Kommando fortgeschrieben,
+      dadurch regelt der Takt mit voller Rate statt mit der Sensorrate
+    - Pro Takt keine neuen Listen/Tupel; Kommando und Metriken liegen in Attributen
+    """
+
+    def __init__(self, config, forward_factor: float, turn_factor: float):
+        """
+        Args:
+            config: FollowerConfig
+            forward_factor: PWMConfig.forward_factor (μs bei y = 1.0)
+            turn_factor: PWMConfig.turn_factor (μs bei x = 1.0)
+        """
+        self.logger = logging.getLogger(__name__)
+        self.max_speed = config.max_speed
+        self.track_width = config.track_width
+        self.mow_speed = config.mow_speed
+        self.transit_speed = config.transit_speed
+        self.lookahead_min = config.lookahead_min
+        self.lookahead_max = config.lookahead_max
+        self.lookahead_gain = config.lookahead_gain
+        self.max_turn_rate = config.max_turn_rate
+        self.pivot_angle = math.radians(config.pivot_angle)
+        self.deceleration = config.deceleration
+        self.goal_tolerance = config.goal_tolerance
+        self.pose_timeout = config.pose_timeout
+        # ω -> Joystick-x: Radgeschwindigkeitsdifferenz relativ zu forward_factor
+        self._turn_scale = self.track_width * forward_factor / (2.0 * turn_factor * self.max_speed)
+
+        # Pfadpuffer (+1 für die Startpose)
+        self.capacity = config.max_waypoints + 1
+        self._xs = array('d', bytes(8 * self.capacity))
+        self._ys = array('d', bytes(8 * self.capacity))
+        self._s = array('d', bytes(8 * self.capacity))    # Bogenlänge bis Punkt i
+        self._mowing = array('B', bytes(self.capacity))   # Segment (i-1 -> i) mäht
+        self._corner = array('B', bytes(self.capacity))   # an Punkt i anhalten/drehen
+        self._count = 0
+        self._lock = threading.Lock()
+
+        # Zustand (nur im Takt geschrieben, außer start/stop unter _lock)
+        self.active = False
+        self.state = 'idle'
+        self._segment = 0
+        self._pivoting = False
+
+        # Pose-Eingang: ein Tupel pro Messung (CAN-Thread), Referenzvergleich im Takt
+        self._pose_in: Optional[tuple] = None
+        self._pose_seen: Optional[tuple] = None
+        self.pose_updates = 0
+        self._x = 0.0
+        self._y = 0.0
+        self._yaw = 0.0
+
+        # Kommando
+        self.speed = 0.0
+        self.turn_rate = 0.0
+        self.cmd_x = 0.0
+        self.cmd_y = 0.0
+
+        # Metriken
+        self.steps = 0
+        self.pose_timeouts = 0
+        self.cross_track_error = 0.0
+        self.heading_error = 0.0
+        self.max_cross_track = 0.0
+        self._xte_sq_sum = 0.0
+        self._xte_samples = 0
+        self.progress = 0.0
+        self.last_step_us = 0.0
+        self.max_step_us = 0.0
+
+    def update_pose(self, x: float, y: float, heading: float, latency: float = 0.0):
+        """
+        Neue Positionsmessung (vom CAN-Reader)
+
+        Args:
+            x, y: Position im lokalen Rahmen (m)
+            heading: Kompass-Heading in Grad (0 = Nord, im Uhrzeigersinn)
+            latency: Alter der Messung in Sekunden
+        """
+        latency = min(max(latency, 0.0), MAX_POSE_LATENCY)
+        self._pose_in = (x, y, math.radians(90.0 - heading), time.monotonic() - latency)
+        self.pose_updates += 1
+
+    def start(self, waypoints: Sequence[Sequence[Any]]) -> bool:
+        """
+        Übernimmt einen Pfad [(x, y, mowing), ...] und startet die Bahnfolge an der aktuellen Pose
+
+        Returns:
+            True wenn gestartet
+        """
+        count = len(waypoints)
+        if count == 0:
+            self.logger.error("❌ Bahnfolge: leerer Pfad")
+            return False
+        if count + 1 > self.capacity:
+            self.logger.error(f"❌ Bahnfolge: {count} Wegpunkte, Puffer für {self.capacity - 1}")
+            return False
+        pose = self._pose_in
+        if pose is None or time.monotonic() - pose[3] > self.pose_timeout:
+            self.logger.error("❌ Bahnfolge: keine aktuelle Position")
+            return False
+
+        with self._lock:
+            xs, ys, s, mowing = self._xs, self._ys, self._s, self._mowing
+            xs[0], ys[0], s[0], mowing[0] = pose[0], pose[1], 0.0, 0
+            for i, waypoint in enumerate(waypoints, 1):
+                xs[i] = float(waypoint[0])
+                ys[i] = float(waypoint[1])
+                mowing[i] = 1 if len(waypoint) > 2 and waypoint[2] else 0
+                s[i] = s[i - 1] + math.hypot(xs[i] - xs[i - 1], ys[i] - ys[i - 1])
+            self._count = count + 1
+            self._mark_corners()
+
+            self._x, self._y, self._yaw = pose[0], pose[1], pose[2]
+            self._pose_seen = pose
+            self._segment = 0
+            self._pivoting = False
+            self.speed = self.turn_rate = self.cmd_x = self.cmd_y = 0.0
+            self.cross_track_error = self.heading_error = self.max_cross_track = 0.0
+            self._xte_sq_sum = 0.0
+            self._xte_samples = 0
+            self.progress = 0.0
+            self.active = True
+            self.state = 'tracking'
+
+        self.logger.info(f"✅ Bahnfolge gestartet: {count} Wegpunkte, {s[self._count - 1]:.1f} m")
+        return True
+
+    def _mark_corners(self):
+        """Ecken: Richtungswechsel über pivot_angle/2, Wechsel Mähen/Transfer, Pfadende"""
+        xs, ys, corner, mowing = self._xs, self._ys, self._corner, self._mowing
+        last = self._count - 1
+        threshold = self.pivot_angle * 0.5
+        for i in range(1, last):
+            heading_in = math.atan2(ys[i] - ys[i - 1], xs[i] - xs[i - 1])
+            heading_out = math.atan2(ys[i + 1] - ys[i], xs[i + 1] - xs[i])
+            sharp = abs(_wrap_pi(heading_out - heading_in)) > threshold
+            corner[i] = 1 if sharp or mowing[i] != mowing[i + 1] else 0
+        corner[0] = 0
+        corner[last] = 1
+
+    def stop(self, reason: str = 'stopped'):
+        """Beendet die Bahnfolge (Kommando 0); MotorControl setzt danach Neutral"""
+        with self._lock:
+            was_active = self.active
+            self.active = False
+            self.state = reason
+            self.speed = self.turn_rate = self.cmd_x = self.cmd_y = 0.0
+        if was_active:
+            self.logger.info(f"Bahnfolge beendet ({reason})")
+
+    def step(self, dt: float) -> bool:
+        """
+        Ein Regeltakt (aus dem Ramping-Takt)
+
+        Returns:
+            True wenn cmd_x/cmd_y neu gesetzt wurden (auch das letzte Null-Kommando)
+        """
+        if not self.active:
+            return False
+        started = time.perf_counter()
+        with self._lock:
+            if not self.active:
+                return False
+            self._step(dt)
+        self.steps += 1
+        elapsed = (time.perf_counter() - started) * 1e6
+        self.last_step_us = elapsed
+        if elapsed > self.max_step_us:
+            self.max_step_us = elapsed
+        return True
+
+    def _propagate(self, dt: float):
+        yaw = self._yaw
+        self._x += self.speed * math.cos(yaw) * dt
+        self._y += self.speed * math.sin(yaw) * dt
+        self._yaw = yaw + self.turn_rate * dt
+
+    def _halt(self, state: str):
+        self.speed = self.turn_rate = self.cmd_x = self.cmd_y = 0.0
+        self.state = state
+
+    def _step(self, dt: float):
+        now = time.monotonic()
+
+        # Pose: neue Messung auf jetzt vorausrechnen, sonst mit eigenem Kommando fortschreiben
+        pose = self._pose_in
+        if pose is not self._pose_seen:
+            self._pose_seen = pose
+            self._x, self._y, self._yaw = pose[0], pose[1], pose[2]
+            self._propagate(now - pose[3])
+        else:
+            self._propagate(dt)
+        if now - pose[3] > self.pose_timeout:
+            if self.state != 'pose_lost':
+                self.pose_timeouts += 1
+                self.logger.warning("⚠️ Bahnfolge: Position veraltet - Halt")
+            self._halt('pose_lost')
+            return
+        self.state = 'tracking'
+
+        xs, ys, s, corner = self._xs, self._ys, self._s, self._corner
+        x, y = self._x, self._y
+        last = self._count - 1
+
+        # Projektion auf das aktuelle Segment, nur vorwärts weiterschalten
+        i = self._segment
+        while True:
+            x0, y0 = xs[i], ys[i]
+            dx, dy = xs[i + 1] - x0, ys[i + 1] - y0
+            length2 = dx * dx + dy * dy
+            t = ((x - x0) * dx + (y - y0) * dy) / length2 if length2 else 1.0
+            if i + 1 >= last:
+                break
+            if t >= 1.0:
+                i += 1
+                continue
+            tc = 0.0 if t < 0.0 else t
+            d2 = (x0 + tc * dx - x) ** 2 + (y0 + tc * dy - y) ** 2
+            nx, ny = xs[i + 1], ys[i + 1]
+            ndx, ndy = xs[i + 2] - nx, ys[i + 2] - ny
+            nlength2 = ndx * ndx + ndy * ndy
+            nt = ((x - nx) * ndx + (y - ny) * ndy) / nlength2 if nlength2 else 0.0
+            nt = 0.0 if nt < 0.0 else 1.0 if nt > 1.0 else nt
+            if (nx + nt * ndx - x) ** 2 + (ny + nt * ndy - y) ** 2 < d2:
+                i += 1
+                continue
+            break
+        self._segment = i
+        t = 0.0 if t < 0.0 else 1.0 if t > 1.0 else t
+        length = math.sqrt(length2)
+        s_proj = s[i] + t * length
+
+        # Querabweichung (links positiv) und Kursfehler zum Segment
+        if length > 0.0:
+            xte = (dx * (y - y0) - dy * (x - x0)) / length
+            self.cross_track_error = xte
+            self.heading_error = _wrap_pi(self._yaw - math.atan2(dy, dx))
+            if self._mowing[i + 1]:
+                self._xte_sq_sum += xte * xte
+                self._xte_samples += 1
+                if abs(xte) > self.max_cross_track:
+                    self.max_cross_track = abs(xte)
+        self.progress = s_proj / s[last] if s[last] > 0.0 else 1.0
+
+        # Ziel erreicht
+        remaining_x = xs[last] - x
+        remaining_y = ys[last] - y
+        if i + 1 >= last and (t >= 1.0 or remaining_x * remaining_x + remaining_y * remaining_y
+                              <= self.goal_tolerance * self.goal_tolerance):
+            self._halt('finished')
+            self.active = False
+            self.progress = 1.0
+            self.logger.info(f"✅ Bahnfolge abgeschlossen (Querabweichung RMS {self._xte_rms():.3f} m)")
+            return
+
+        # Vorausschaupunkt in Bogenlänge, höchstens bis zur nächsten Ecke
+        lookahead = self.lookahead_min + self.lookahead_gain * abs(self.speed)
+        if lookahead > self.lookahead_max:
+            lookahead = self.lookahead_max
+        target = s_proj + lookahead
+        corner_distance = math.inf
+        j = i
+        while True:
+            if corner[j + 1] and s[j + 1] <= target:
+                target = s[j + 1]
+                corner_distance = target - s_proj
+                break
+            if s[j + 1] >= target or j + 1 >= last:
+                break
+            j += 1
+        segment_length = s[j + 1] - s[j]
+        u = (target - s[j]) / segment_length if segment_length > 0.0 else 1.0
+        u = 0.0 if u < 0.0 else 1.0 if u > 1.0 else u
+        lx = xs[j] + u * (xs[j + 1] - xs[j])
+        ly = ys[j] + u * (ys[j + 1] - ys[j])
+
+        # Ecke erreicht: auf das nächste Segment weiterschalten (Drehung folgt im nächsten Takt)
+        to_x, to_y = lx - x, ly - y
+        distance = math.sqrt(to_x * to_x + to_y * to_y)
+        if corner_distance < math.inf and distance <= self.goal_tolerance and j + 1 < last:
+            self._segment = j + 1
+            self._halt('tracking')
+            return
+
+        alpha = _wrap_pi(math.atan2(to_y, to_x) - self._yaw)
+        abs_alpha = abs(alpha)
+        if abs_alpha > self.pivot_angle or (self._pivoting and abs_alpha > self.pivot_angle * 0.25):
+            # Auf der Stelle drehen (Wende am Streifenende)
+            self._pivoting = True
+            speed = 0.0
+            turn_rate = self.max_turn_rate if alpha > 0.0 else -self.max_turn_rate
+        else:
+            self._pivoting = False
+            speed = self.mow_speed if self._mowing[i + 1] else self.transit_speed
+            if corner_distance < math.inf:
+                braking = math.sqrt(CORNER_SPEED * CORNER_SPEED + 2.0 * self.deceleration * corner_distance)
+                if braking < speed:
+                    speed = braking
+            curvature = 2.0 * math.sin(alpha) / distance if distance > 1e-6 else 0.0
+            turn_rate = speed * curvature
+            if abs(turn_rate) > self.max_turn_rate:
+                speed = self.max_turn_rate / abs(curvature)
+                turn_rate = self.max_turn_rate if turn_rate > 0.0 else -self.max_turn_rate
+
+        self.speed = speed
+        self.turn_rate = turn_rate
+        # Joystick-Konvention: y vorwärts, x > 0 dreht nach rechts (im Uhrzeigersinn)
+        cmd_y = speed / self.max_speed
+        cmd_x = -turn_rate * self._turn_scale
+        self.cmd_y = 1.0 if cmd_y > 1.0 else -1.0 if cmd_y < -1.0 else cmd_y
+        self.cmd_x = 1.0 if cmd_x > 1.0 else -1.0 if cmd_x < -1.0 else cmd_x
+
+    def _xte_rms(self) -> float:
+        return math.sqrt(self._xte_sq_sum / self._xte_samples) if self._xte_samples else 0.0
+
+    def get_status(self) -> Dict[str, Any]:
+        """
+        Gibt Bahnfolge-Status und Tracking-Metriken zurück
+
+        Returns:
+            Dictionary (Fehler in m bzw. Grad)
+        """
+        pose = self._pose_in
+        return {
+            'active': self.active,
+            'state': self.state,
+            'waypoints': max(0, self._count - 1),
+            'segment': self._segment,
+            'progress': round(self.progress, 4),
+            'pose': {
+                'x': round(self._x, 3),
+                'y': round(self._y, 3),
+                'heading': round((90.0 - math.degrees(self._yaw)) % 360.0, 2),
+                'age': round(time.monotonic() - pose[3], 3) if pose else None,
+                'updates': self.pose_updates,
+            },
+            'command': {
+                'speed': round(self.speed, 3),
+                'turn_rate': round(self.turn_rate, 3),
+                'x': round(self.cmd_x, 3),
+                'y': round(self.cmd_y, 3),
+            },
+            'tracking': {
+                'cross_track_error': round(self.cross_track_error, 4),
+                'cross_track_rms': round(self._xte_rms(), 4),
+                'cross_track_max': round(self.max_cross_track, 4),
+                'heading_error': round(math.degrees(self.heading_error), 2),
+            },
+            'steps': self.steps,
+            'pose_timeouts': self.pose_timeouts,
+            'step_last_us': round(self.last_step_us, 1),
+            'step_max_us': round(self.max_step_us, 1),
+        }
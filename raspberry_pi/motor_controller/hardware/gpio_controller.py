@@ -76,7 +76,7 @@ class GPIOController:
             self.logger.error(f"❌ pigpio Initialisierung fehlgeschlagen: {e}")
             self.pigpio_instance = None
     
-    def get_pigpio(self) -> Optional[pigpio.pi]:
+    def get_pigpio(self) -> Optional['pigpio.pi']:
         """Gibt pigpio-Instanz zurück (Singleton)"""
         return self.pigpio_instance
     
@@ -6,8 +6,18 @@ Verwendet pigpio für präzise Hardware-PWM-Signale
 
 import logging
 import threading
+import time
 from typing import Dict, Optional
 from ..config import PWMConfig, MowerConfig
+from ..monitoring.latency_tracer import STAGE_PWM, get_tracer
+
+# pigpio Script-Status (pigpio.PI_SCRIPT_*)
+_SCRIPT_INITING = 0
+_SCRIPT_HALTED = 1
+_SCRIPT_RUNNING = 2
+
+# Längste Wartezeit auf das Ende des Scripts (s), danach Abbruch und Einzelbefehle
+_SCRIPT_TIMEOUT = 0.02
 
 
 class PWMController:
@@ -39,6 +49,15 @@ class PWMController:
             'left': pwm_config.neutral_value,
             'right': pwm_config.neutral_value
         }
+        # Zuletzt an pigpio geschriebener Duty Cycle pro Seite (None = unbekannt)
+        self._last_duty: Dict[str, Optional[int]] = {'left': None, 'right': None}
+        # pigpio-Script für atomares Setzen beider Kanäle (None = sequentieller Fallback)
+        self._both_script_id: Optional[int] = None
+        self.skipped_writes = 0
+        self.script_failures = 0
+        self.tracer = get_tracer()
+        # Safety Supervisor: nach einer Auslösung bis zur Quittung nur Neutral
+        self.supervisor = None
         
         # Mäher-PWM-Status
         self.mower_enabled = mower_config.enabled
@@ -61,17 +80,95 @@ class PWMController:
             for side, pin in self.config.pins.items():
                 # Hardware-PWM: 50Hz, 1500μs (neutral)
                 # Duty cycle berechnen: (1500μs / 20000μs) * 1000000 = 75000
-                duty_cycle = int((self.config.neutral_value / 20000.0) * 1000000)
+                duty_cycle = self._duty_cycle(self.config.neutral_value)
                 self.pi.hardware_PWM(
                     pin,
                     self.config.frequency,
                     duty_cycle  # 0-1000000 (0-100%)
                 )
+                self._last_duty[side] = duty_cycle
                 self.logger.info(f"✅ Motor-PWM initialisiert: {side.upper()}=GPIO{pin}")
 
         except Exception as e:
             self.logger.error(f"❌ Motor-PWM Initialisierung fehlgeschlagen: {e}")
             self.motor_enabled = False
+            return
+
+        self._init_both_script()
+    
+    def _init_both_script(self):
+        """
+        Legt ein pigpio-Script an, das beide Motor-Kanäle in einem Daemon-Aufruf setzt
+        
+        Der Daemon führt beide HP-Befehle direkt hintereinander aus. run_script stellt
+        das Script nur ein; geschrieben ist erst, wenn script_status HALTED meldet
+        (siehe _run_both_script).
+        """
+        freq = self.config.frequency
+        script = (
+            f"hp {self.config.pins['left']} {freq} p0 "
+            f"hp {self.config.pins['right']} {freq} p1"
+        ).encode()
+        
+        try:
+            script_id = self.pi.store_script(script)
+            if script_id < 0:
+                raise RuntimeError(f"store_script Fehler {script_id}")
+            
+            # Daemon kompiliert das Script asynchron
+            deadline = time.monotonic() + 1.0
+            while self.pi.script_status(script_id)[0] == _SCRIPT_INITING:
+                if time.monotonic() > deadline:
+                    raise RuntimeError("Script-Initialisierung Timeout")
+                time.sleep(0.005)
+            
+            self._both_script_id = script_id
+            self.logger.info("✅ Motor-PWM: beide Kanäle per pigpio-Script")
+        
+        except Exception as e:
+            self._both_script_id = None
+            self.logger.warning(f"⚠️  pigpio-Script nicht verfügbar ({e}) - setze Kanäle einzeln")
+    
+    def _run_both_script(self, duty_left: int, duty_right: int) -> bool:
+        """
+        Setzt beide Kanäle per Script und wartet, bis der Daemon es beendet hat
+        
+        Ein noch laufendes Script würde einen späteren direkten hardware_PWM-Aufruf
+        (z.B. Neutral des Supervisors) überschreiben. run_script setzt den Status
+        bereits vor der Rückkehr auf RUNNING, HALTED danach heißt: beide HP ausgeführt.
+        
+        Returns:
+            True wenn beide Kanäle geschrieben sind, False = Script abgebrochen
+            (der Aufrufer schreibt dann einzeln)
+        """
+        script_id = self._both_script_id
+        if self.pi.run_script(script_id, [duty_left, duty_right]) < 0:
+            return False
+        deadline = time.monotonic() + _SCRIPT_TIMEOUT
+        while True:
+            status = self.pi.script_status(script_id)[0]
+            if status == _SCRIPT_HALTED:
+                return True
+            if status != _SCRIPT_RUNNING or time.monotonic() > deadline:
+                break
+        # Hängt oder fehlgeschlagen: anhalten, damit es nicht nachträglich schreibt
+        self.pi.stop_script(script_id)
+        self.script_failures += 1
+        return False
+    
+    def set_supervisor(self, supervisor):
+        """
+        Setzt den Safety Supervisor (Sperre nach Auslösung, Meldung "Motoren laufen")
+        
+        Args:
+            supervisor: SafetySupervisor-Instanz oder None
+        """
+        self.supervisor = supervisor
+    
+    def _duty_cycle(self, value: int) -> int:
+        """Pulsbreite in μs -> Hardware-PWM Duty Cycle (0-1000000)"""
+        # (value_μs / Periode_μs) * 1000000 = value_μs * Frequenz
+        return int(value * self.config.frequency)
     
     def _init_mower_pwm(self):
         """Initialisiert Hardware-PWM für Mäher"""
@@ -113,14 +210,26 @@ class PWMController:
         
         # Wert begrenzen
         value = max(self.config.min_value, min(self.config.max_value, value))
+        supervisor = self.supervisor
+        if supervisor is not None and supervisor.tripped():
+            # Supervisor hat selbst Neutral geschrieben - Cache ist ungültig
+            value = self.config.neutral_value
+            self._last_duty[side] = None
+
+        duty_cycle = self._duty_cycle(value)
 
         try:
             with self._lock:
-                pin = self.config.pins[side]
-                # Duty cycle berechnen: (value_μs / 20000μs) * 1000000
-                duty_cycle = int((value / 20000.0) * 1000000)
-                self.pi.hardware_PWM(pin, self.config.frequency, duty_cycle)
+                if duty_cycle == self._last_duty[side]:
+                    self.skipped_writes += 1
+                else:
+                    self.pi.hardware_PWM(self.config.pins[side], self.config.frequency, duty_cycle)
+                    self._last_duty[side] = duty_cycle
                 self.current_values[side] = value
+                if supervisor is not None:
+                    neutral = self.config.neutral_value
+                    supervisor.set_moving(self.current_values['left'] != neutral
+                                          or self.current_values['right'] != neutral)
             return True
         
         except Exception as e:
@@ -131,6 +240,11 @@ class PWMController:
         """
         Setzt beide Motor-PWM-Werte gleichzeitig (Thread-Safe)
         
+        Beide Kanäle werden unter einem Lock gesetzt, wenn beide sich ändern per
+        pigpio-Script. Der Aufruf kehrt erst zurück, wenn die PWM geschrieben ist
+        (Script beendet bzw. hardware_PWM bestätigt). Unveränderte Duty Cycles
+        werden nicht erneut an den Daemon geschickt.
+        
         Args:
             left: PWM-Wert links in μs (1000-2000)
             right: PWM-Wert rechts in μs (1000-2000)
@@ -138,10 +252,56 @@ class PWMController:
         Returns:
             True bei Erfolg, False bei Fehler
         """
-        success = True
-        success &= self.set_motor_pwm('left', left)
-        success &= self.set_motor_pwm('right', right)
-        return success
+        if not self.motor_enabled or not self.pi:
+            return False
+        
+        # Werte begrenzen
+        min_value, max_value = self.config.min_value, self.config.max_value
+        left = max(min_value, min(max_value, left))
+        right = max(min_value, min(max_value, right))
+        supervisor = self.supervisor
+        if supervisor is not None and supervisor.tripped():
+            # Supervisor hat selbst Neutral geschrieben - Cache ist ungültig
+            left = right = self.config.neutral_value
+            self._last_duty['left'] = None
+            self._last_duty['right'] = None
+        duty_left = self._duty_cycle(left)
+        duty_right = self._duty_cycle(right)
+        
+        try:
+            with self._lock:
+                left_changed = duty_left != self._last_duty['left']
+                right_changed = duty_right != self._last_duty['right']
+                
+                if not left_changed and not right_changed:
+                    self.skipped_writes += 1
+                elif (left_changed and right_changed and self._both_script_id is not None
+                      and self._run_both_script(duty_left, duty_right)):
+                    pass
+                else:
+                    # Fallback bzw. nur eine Seite geändert: direkt setzen
+                    frequency = self.config.frequency
+                    if left_changed:
+                        self.pi.hardware_PWM(self.config.pins['left'], frequency, duty_left)
+                    if right_changed:
+                        self.pi.hardware_PWM(self.config.pins['right'], frequency, duty_right)
+                
+                self._last_duty['left'] = duty_left
+                self._last_duty['right'] = duty_right
+                self.current_values['left'] = left
+                self.current_values['right'] = right
+                if supervisor is not None:
+                    neutral = self.config.neutral_value
+                    supervisor.set_moving(left != neutral or right != neutral)
+            self.tracer.mark(STAGE_PWM)
+            return True
+        
+        except Exception as e:
+            self.logger.error(f"❌ Motor-PWM Fehler (beide): {e}")
+            # Zustand unbekannt - nächster Aufruf schreibt beide Kanäle neu
+            self._last_duty['left'] = None
+            self._last_duty['right'] = None
+            return False
     
     def set_motor_neutral(self) -> bool:
         """
@@ -252,6 +412,10 @@ class PWMController:
             if self.mower_enabled and self.pi:
                 self.stop_mower()
                 self.logger.info("Mäher gestoppt")
+            
+            if self._both_script_id is not None and self.pi:
+                self.pi.delete_script(self._both_script_id)
+                self._both_script_id = None
         
         except Exception as e:
             self.logger.error(f"❌ PWM cleanup fehlgeschlagen: {e}")
@@ -9,6 +9,8 @@ import threading
 import time
 from typing import Callable, Optional
 
+from .safety_supervisor import SafetySupervisor
+
 try:
     import RPi.GPIO as GPIO
     GPIO_AVAILABLE = True
@@ -22,15 +24,18 @@ class SafetyMonitor:
     - Sicherheitsschaltleiste (Emergency Stop)
     - Command-Timeout-Überwachung
     - Joystick-Timeout-Überwachung
+    - Optional: Safety Supervisor als eigener Prozess (reagiert unabhängig vom GIL),
+      der Watchdog-Thread synchronisiert dann nur noch dessen Auslösungen
     """
     
-    def __init__(self, config, gpio_controller):
+    def __init__(self, config, gpio_controller, pwm_config=None):
         """
         Initialisiert Safety Monitor
         
         Args:
             config: SafetyConfig-Instanz
             gpio_controller: GPIO-Controller-Instanz
+            pwm_config: PWMConfig für den Safety Supervisor (None = kein Supervisor)
         """
         self.logger = logging.getLogger(__name__)
         self.config = config
@@ -48,6 +53,13 @@ class SafetyMonitor:
         # Emergency Stop Callback
         self.emergency_stop_callback: Optional[Callable] = None
         
+        # Safety Supervisor (eigener Prozess, Start mit dem Watchdog)
+        self.supervisor: Optional[SafetySupervisor] = None
+        if config.supervisor_enabled and pwm_config is not None and pwm_config.enabled:
+            self.supervisor = SafetySupervisor(config, pwm_config)
+        self.supervisor_lost = False
+        self._logged_trip = 0  # zuletzt gemeldete Auslösung (Log einmal pro Auslösung)
+        
         # Watchdog-Thread
         self.watchdog_running = False
         self.watchdog_thread: Optional[threading.Thread] = None
@@ -110,24 +122,41 @@ class SafetyMonitor:
         """
         self.emergency_stop_callback = callback
     
-    def trigger_emergency_stop(self):
-        """Löst Emergency Stop aus"""
-        if self.emergency_stop_callback:
-            try:
-                self.emergency_stop_callback()
-            except Exception as e:
-                self.logger.error(f"❌ Emergency Stop Callback Fehler: {e}")
+    def trigger_emergency_stop(self) -> bool:
+        """
+        Löst Emergency Stop aus
+        
+        Returns:
+            True wenn der Callback Neutral geschrieben hat (ein Callback ohne
+            Rückgabewert zählt als Erfolg), False bei Fehler oder ohne Callback
+        """
+        if not self.emergency_stop_callback:
+            return False
+        try:
+            return self.emergency_stop_callback() is not False
+        except Exception as e:
+            self.logger.error(f"❌ Emergency Stop Callback Fehler: {e}")
+            return False
     
     def update_command_time(self):
         """Aktualisiert letzten Command-Zeitstempel"""
         with self._lock:
             self.last_command_time = time.time()
+        if self.supervisor:
+            self.supervisor.beat_command()
     
     def update_joystick_time(self):
         """Aktualisiert letzten Joystick-Zeitstempel"""
         with self._lock:
             self.last_joystick_time = time.time()
             self.joystick_active = True
+        if self.supervisor:
+            self.supervisor.beat_joystick()
+    
+    def update_can_time(self):
+        """Aktualisiert letzten Empfang von Sensor-Daten über CAN (Heartbeat im Autonom-Betrieb)"""
+        if self.supervisor:
+            self.supervisor.beat_can()
     
     def check_command_timeout(self) -> bool:
         """
@@ -160,6 +189,9 @@ class SafetyMonitor:
             self.logger.warning("Watchdog läuft bereits")
             return
         
+        if self.supervisor and not self.supervisor.start():
+            self.supervisor = None
+        
         self.watchdog_running = True
         self._stop_event.clear()
         self.watchdog_thread = threading.Thread(target=self._watchdog_loop, daemon=True)
@@ -177,6 +209,9 @@ class SafetyMonitor:
         if self.watchdog_thread:
             self.watchdog_thread.join(timeout=2.0)
         
+        if self.supervisor:
+            self.supervisor.stop()
+        
         self.logger.info("Safety Watchdog gestoppt")
     
     def _watchdog_loop(self):
@@ -185,6 +220,11 @@ class SafetyMonitor:
         
         while not self._stop_event.is_set():
             try:
+                if self.supervisor and not self.supervisor_lost:
+                    self._sync_supervisor()
+                    self._stop_event.wait(0.01)
+                    continue
+                
                 # Command-Timeout prüfen
                 if self.check_command_timeout():
                     self.logger.warning("⚠️ Command-Timeout überschritten!")
@@ -208,6 +248,31 @@ class SafetyMonitor:
         
         self.logger.info("Watchdog-Loop beendet")
     
+    def _sync_supervisor(self):
+        """Übernimmt Auslösungen des Supervisors in den Python-Zustand und quittiert sie"""
+        trip = self.supervisor.pending_trip()
+        if trip:
+            trips, reason, reaction_ms = trip
+            if trips != self._logged_trip:
+                self._logged_trip = trips
+                self.logger.warning(f"🚨 Safety Supervisor: {reason} - Motoren neutral nach {reaction_ms:.2f} ms")
+            if reason == 'joystick_timeout':
+                with self._lock:
+                    self.joystick_active = False
+                self.supervisor.set_joystick_active(False)
+            # Erst quittieren, wenn auch der Hauptprozess Neutral geschrieben hat: bis dahin
+            # lässt der PWM-Controller nur Neutral durch, sonst im nächsten Zyklus erneut
+            if self.trigger_emergency_stop():
+                self.supervisor.acknowledge(trips)
+        
+        if not self.supervisor.alive():
+            # Supervisor weg: Motoren stoppen, Watchdog übernimmt wieder im Hauptprozess
+            self.supervisor_lost = True
+            self.logger.error("❌ Safety Supervisor antwortet nicht - Watchdog im Hauptprozess")
+            self.trigger_emergency_stop()
+            with self._lock:
+                self.last_command_time = time.time()
+    
     def get_status(self) -> dict:
         """
         Gibt aktuellen Safety-Status zurück
@@ -223,7 +288,9 @@ class SafetyMonitor:
                 'last_joystick_time': self.last_joystick_time,
                 'joystick_active': self.joystick_active,
                 'command_timeout': self.config.command_timeout,
-                'joystick_timeout': self.config.joystick_timeout
+                'joystick_timeout': self.config.joystick_timeout,
+                'supervisor': self.supervisor.get_stats() if self.supervisor else None,
+                'supervisor_lost': self.supervisor_lost
             }
     
     def cleanup(self):
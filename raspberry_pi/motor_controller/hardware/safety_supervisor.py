@@ -0,0 +1,372 @@
+#!/usr/bin/env python3
+"""
+Safety Supervisor - Eigener Prozess für Not-Halt unabhängig vom GIL der Hauptanwendung
+Heartbeats über Shared Memory, eigene pigpio-Verbindung zum Neutral-Setzen der Motor-PWM
+"""
+
+import logging
+import multiprocessing
+import os
+import threading
+import time
+from multiprocessing import shared_memory
+from typing import Any, Dict, Optional, Tuple
+
+# Felder im Shared-Memory-Block (int64, jedes Feld hat genau einen Schreiber)
+# Hauptprozess schreibt:
+F_COMMAND_NS = 0        # letzter Motorbefehl (monotonic_ns)
+F_JOYSTICK_NS = 1       # letztes Joystick-Sample
+F_JOYSTICK_ACTIVE = 2
+F_CAN_NS = 3            # letzte Sensor-Daten über CAN
+F_AUTONOMOUS = 4        # Bahnfolge aktiv -> CAN-Heartbeat erforderlich
+F_MOVING = 5            # zuletzt geschriebene PWM ungleich Neutral
+F_ACK = 6               # zuletzt verarbeitete Auslösung
+F_SHUTDOWN = 7
+# Supervisor schreibt:
+F_STATE = 8
+F_SUPERVISOR_NS = 9     # Lebenszeichen des Supervisors
+F_TRIPS = 10            # Anzahl Auslösungen (zuletzt geschrieben = Veröffentlichung)
+F_TRIP_REASON = 11
+F_TRIP_NS = 12
+F_LAST_REACTION_NS = 13
+F_WORST_REACTION_NS = 14
+F_CYCLES = 15
+F_MAX_CYCLE_NS = 16
+F_REALTIME = 17
+FIELD_COUNT = 18
+
+STATE_STARTING = 0
+STATE_RUNNING = 1
+STATE_STOPPED = 2
+STATE_FAILED = -1
+
+REASON_COMMAND_TIMEOUT = 1
+REASON_JOYSTICK_TIMEOUT = 2
+REASON_SAFETY_SWITCH = 3
+REASON_CAN_TIMEOUT = 4
+REASON_PARENT_LOST = 5
+
+REASON_NAMES = {
+    0: None,
+    REASON_COMMAND_TIMEOUT: 'command_timeout',
+    REASON_JOYSTICK_TIMEOUT: 'joystick_timeout',
+    REASON_SAFETY_SWITCH: 'safety_switch',
+    REASON_CAN_TIMEOUT: 'can_timeout',
+    REASON_PARENT_LOST: 'parent_lost',
+}
+
+
+class SafetySupervisor:
+    """
+    Hauptprozess-Seite des Safety Supervisors
+
+    Der Supervisor-Prozess prüft alle supervisor_period Sekunden die Heartbeats
+    und reagiert auf die Flanke des Sicherheitsschalters per pigpio-Callback.
+    Bei Auslösung setzt er beide Motor-PWM-Kanäle selbst auf Neutral und
+    veröffentlicht Grund und Reaktionszeit; der Hauptprozess synchronisiert
+    danach seinen Zustand (Emergency-Stop-Callback) und quittiert.
+    Bis zur Quittung lässt der PWM-Controller nur Neutral durch.
+    """
+
+    def __init__(self, safety_config, pwm_config):
+        """
+        Args:
+            safety_config: SafetyConfig (Timeouts, Schalter-Pin, Supervisor-Takt)
+            pwm_config: PWMConfig (Motor-Pins, Frequenz, Neutralwert)
+        """
+        self.logger = logging.getLogger(__name__)
+        self.settings: Dict[str, Any] = {
+            'period': safety_config.supervisor_period,
+            'priority': safety_config.supervisor_priority,
+            'command_timeout_ns': int(safety_config.command_timeout * 1e9),
+            'joystick_timeout_ns': int(safety_config.joystick_timeout * 1e9),
+            'can_timeout_ns': int(safety_config.can_timeout * 1e9),
+            'debounce_ns': int(safety_config.debounce_time * 1e9),
+            'safety_pin': safety_config.pin if safety_config.enabled else None,
+            'motor_pins': [pwm_config.pins['left'], pwm_config.pins['right']],
+            'frequency': pwm_config.frequency,
+            'neutral_duty': int(pwm_config.neutral_value * pwm_config.frequency),
+        }
+        self._shm: Optional[shared_memory.SharedMemory] = None
+        self._fields = None
+        self.process: Optional[multiprocessing.Process] = None
+        self.running = False
+
+    def start(self, timeout: float = 5.0) -> bool:
+        """
+        Startet den Supervisor-Prozess (spawn, nicht fork: der Hauptprozess hat bereits Threads)
+
+        Returns:
+            True wenn der Supervisor läuft
+        """
+        if self.running:
+            return True
+
+        try:
+            self._shm = shared_memory.SharedMemory(create=True, size=FIELD_COUNT * 8)
+            self._fields = self._shm.buf.cast('q')
+            for index in range(FIELD_COUNT):
+                self._fields[index] = 0
+            now = time.monotonic_ns()
+            self._fields[F_COMMAND_NS] = now
+            self._fields[F_CAN_NS] = now
+
+            context = multiprocessing.get_context('spawn')
+            self.process = context.Process(
+                target=run_supervisor,
+                args=(self._shm.name, self.settings, os.getpid()),
+                name='safety-supervisor',
+                daemon=True
+            )
+            self.process.start()
+        except Exception as e:
+            self.logger.error(f"❌ Safety Supervisor konnte nicht gestartet werden: {e}")
+            self._release()
+            return False
+
+        deadline = time.monotonic() + timeout
+        while self._fields[F_STATE] == STATE_STARTING and self.process.is_alive():
+            if time.monotonic() > deadline:
+                break
+            time.sleep(0.01)
+
+        if self._fields[F_STATE] != STATE_RUNNING:
+            self.logger.error("❌ Safety Supervisor nicht bereit (pigpio?) - Watchdog im Hauptprozess")
+            self.stop()
+            return False
+
+        self.running = True
+        self.logger.info(
+            f"✅ Safety Supervisor gestartet (PID {self.process.pid}, "
+            f"{self.settings['period'] * 1000:.1f} ms Takt"
+            f"{', SCHED_FIFO' if self._fields[F_REALTIME] else ''})"
+        )
+        return True
+
+    def stop(self):
+        """Beendet den Supervisor-Prozess"""
+        if self._fields is not None:
+            self._fields[F_SHUTDOWN] = 1
+        if self.process is not None:
+            self.process.join(timeout=2.0)
+            if self.process.is_alive():
+                self.process.terminate()
+            self.process = None
+        if self.running:
+            self.logger.info("Safety Supervisor gestoppt")
+        self.running = False
+        self._release()
+
+    def _release(self):
+        if self._shm is None:
+            return
+        fields, self._fields = self._fields, None
+        if fields is not None:
+            fields.release()
+        try:
+            self._shm.close()
+            self._shm.unlink()
+        except (FileNotFoundError, BufferError):
+            pass
+        self._shm = None
+
+    # --- Heartbeats (Hauptprozess, je eine Speicherung ohne Lock) ---
+
+    def beat_command(self):
+        if self.running:
+            self._fields[F_COMMAND_NS] = time.monotonic_ns()
+
+    def beat_joystick(self):
+        if self.running:
+            self._fields[F_JOYSTICK_NS] = time.monotonic_ns()
+            self._fields[F_JOYSTICK_ACTIVE] = 1
+
+    def set_joystick_active(self, active: bool):
+        if self.running:
+            self._fields[F_JOYSTICK_ACTIVE] = 1 if active else 0
+
+    def beat_can(self):
+        if self.running:
+            self._fields[F_CAN_NS] = time.monotonic_ns()
+
+    def set_autonomous(self, active: bool):
+        if self.running:
+            self._fields[F_AUTONOMOUS] = 1 if active else 0
+
+    def set_moving(self, moving: bool):
+        if self.running:
+            self._fields[F_MOVING] = 1 if moving else 0
+
+    # --- Auslösungen ---
+
+    def tripped(self) -> bool:
+        """True solange eine Auslösung nicht quittiert ist (dann nur Neutral schreiben)"""
+        return self.running and self._fields[F_TRIPS] != self._fields[F_ACK]
+
+    def pending_trip(self) -> Optional[Tuple[int, str, float]]:
+        """
+        Returns:
+            (Zähler, Grund, Reaktionszeit in ms) der neuesten unquittierten Auslösung oder None
+        """
+        if not self.running:
+            return None
+        trips = self._fields[F_TRIPS]
+        if trips == self._fields[F_ACK]:
+            return None
+        return (trips, REASON_NAMES.get(self._fields[F_TRIP_REASON], 'unknown'),
+                self._fields[F_LAST_REACTION_NS] / 1e6)
+
+    def acknowledge(self, trips: int):
+        """Quittiert Auslösungen bis einschließlich trips"""
+        if self.running:
+            self._fields[F_ACK] = trips
+
+    def alive(self, timeout: float = 0.5) -> bool:
+        """Supervisor-Prozess lebt und hat sich innerhalb timeout gemeldet"""
+        if not self.running or self.process is None or not self.process.is_alive():
+            return False
+        return time.monotonic_ns() - self._fields[F_SUPERVISOR_NS] < timeout * 1e9
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Gibt Supervisor-Statistiken zurück
+
+        Returns:
+            Dictionary mit Auslösungen und Reaktionszeiten (ms)
+        """
+        if not self.running:
+            return {'running': False}
+        fields = self._fields
+        return {
+            'running': True,
+            'alive': self.alive(),
+            'pid': self.process.pid if self.process else None,
+            'realtime': bool(fields[F_REALTIME]),
+            'period_ms': round(self.settings['period'] * 1000.0, 3),
+            'cycles': fields[F_CYCLES],
+            'cycle_max_ms': round(fields[F_MAX_CYCLE_NS] / 1e6, 3),
+            'trips': fields[F_TRIPS],
+            'last_trip_reason': REASON_NAMES.get(fields[F_TRIP_REASON], 'unknown'),
+            'reaction_last_ms': round(fields[F_LAST_REACTION_NS] / 1e6, 3),
+            'reaction_worst_ms': round(fields[F_WORST_REACTION_NS] / 1e6, 3),
+            'pending': self.tripped(),
+        }
+
+
+def run_supervisor(shm_name: str, settings: Dict[str, Any], parent_pid: int):
+    """Einstiegspunkt des Supervisor-Prozesses"""
+    shm = shared_memory.SharedMemory(name=shm_name)
+    fields = shm.buf.cast('q')
+    try:
+        _supervise(fields, settings, parent_pid)
+    finally:
+        fields.release()
+        shm.close()
+
+
+def _supervise(fields, settings: Dict[str, Any], parent_pid: int):
+    if settings['priority'] > 0 and hasattr(os, 'sched_setscheduler'):
+        try:
+            os.sched_setscheduler(0, os.SCHED_FIFO, os.sched_param(settings['priority']))
+            fields[F_REALTIME] = 1
+        except (PermissionError, OSError):
+            pass
+
+    try:
+        import pigpio
+        pi = pigpio.pi()
+    except Exception:
+        pi = None
+    if pi is None or not pi.connected:
+        fields[F_STATE] = STATE_FAILED
+        return
+
+    monotonic_ns = time.monotonic_ns
+    pins = settings['motor_pins']
+    frequency = settings['frequency']
+    neutral_duty = settings['neutral_duty']
+    safety_pin = settings['safety_pin']
+    trip_lock = threading.Lock()
+
+    def trip(reason: int, since_ns: int):
+        # Schalter-Callback (pigpio-Thread) und Takt können gleichzeitig auslösen
+        with trip_lock:
+            for pin in pins:
+                pi.hardware_PWM(pin, frequency, neutral_duty)
+            done = monotonic_ns()
+            reaction = max(0, done - since_ns)
+            fields[F_TRIP_REASON] = reason
+            fields[F_TRIP_NS] = done
+            fields[F_LAST_REACTION_NS] = reaction
+            if reaction > fields[F_WORST_REACTION_NS]:
+                fields[F_WORST_REACTION_NS] = reaction
+            fields[F_TRIPS] += 1
+
+    last_edge_ns = [0]
+
+    def on_safety_edge(gpio, level, tick):
+        # Flankenzeitpunkt vom pigpio-Daemon (μs-Tick) in monotonic_ns umrechnen
+        now = monotonic_ns()
+        age_us = (pi.get_current_tick() - tick) & 0xFFFFFFFF
+        since = now - age_us * 1000
+        if since - last_edge_ns[0] < settings['debounce_ns']:
+            return
+        last_edge_ns[0] = since
+        trip(REASON_SAFETY_SWITCH, since)
+
+    callback = None
+    if safety_pin is not None:
+        callback = pi.callback(safety_pin, pigpio.FALLING_EDGE, on_safety_edge)
+
+    period = settings['period']
+    command_timeout = settings['command_timeout_ns']
+    joystick_timeout = settings['joystick_timeout_ns']
+    can_timeout = settings['can_timeout_ns']
+    # Jede Heartbeat-Lücke löst nur einmal aus (bis ein neuer Heartbeat kommt)
+    tripped_command = tripped_joystick = tripped_can = -1
+
+    fields[F_STATE] = STATE_RUNNING
+    previous = monotonic_ns()
+    try:
+        while not fields[F_SHUTDOWN]:
+            now = monotonic_ns()
+            fields[F_SUPERVISOR_NS] = now
+            fields[F_CYCLES] += 1
+            cycle = now - previous
+            previous = now
+            if cycle > fields[F_MAX_CYCLE_NS] and fields[F_CYCLES] > 1:
+                fields[F_MAX_CYCLE_NS] = cycle
+
+            if os.getppid() != parent_pid:
+                trip(REASON_PARENT_LOST, now)
+                break
+
+            moving = fields[F_MOVING]
+            command_ns = fields[F_COMMAND_NS]
+            if moving and command_ns != tripped_command and now - command_ns > command_timeout:
+                tripped_command = command_ns
+                trip(REASON_COMMAND_TIMEOUT, command_ns + command_timeout)
+
+            joystick_ns = fields[F_JOYSTICK_NS]
+            if (fields[F_JOYSTICK_ACTIVE] and joystick_ns != tripped_joystick
+                    and now - joystick_ns > joystick_timeout):
+                tripped_joystick = joystick_ns
+                trip(REASON_JOYSTICK_TIMEOUT, joystick_ns + joystick_timeout)
+
+            can_ns = fields[F_CAN_NS]
+            if (moving and fields[F_AUTONOMOUS] and can_ns != tripped_can
+                    and now - can_ns > can_timeout):
+                tripped_can = can_ns
+                trip(REASON_CAN_TIMEOUT, can_ns + can_timeout)
+
+            # Gedrückter Schalter hält die Motoren auch ohne neue Flanke neutral
+            if moving and safety_pin is not None and pi.read(safety_pin) == 0 \
+                    and fields[F_TRIPS] == fields[F_ACK]:
+                trip(REASON_SAFETY_SWITCH, now)
+
+            time.sleep(period)
+    finally:
+        if callback is not None:
+            callback.cancel()
+        fields[F_STATE] = STATE_STOPPED
+        pi.stop()
@@ -0,0 +1,10 @@
+#!/usr/bin/env python3
+"""
+IPC-Module für Motor Controller
+Lock-freie Shared-Memory-Kanäle zwischen Echtzeit- und UI-Prozess
+"""
+
+from .seqlock import SeqlockBlock
+from .shared_ring import SharedRing
+
+__all__ = ['SeqlockBlock', 'SharedRing']
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Seqlock Block - Zustandsblock mit einem Schreiber und beliebig vielen Lesern in Shared Memory
+Leser blockieren den Schreiber nie; ein zerrissener Lesevorgang wird wiederholt
+"""
+
+import zlib
+from multiprocessing import shared_memory
+from typing import Optional, Tuple
+
+# Kopf: Sequenz (ungerade = Schreiben läuft), Länge, CRC32, Kapazität
+_HEADER_FIELDS = 4
+_HEADER_SIZE = _HEADER_FIELDS * 8
+F_SEQ, F_LENGTH, F_CRC, F_CAPACITY = range(4)
+
+
+class SeqlockBlock:
+    """
+    Seqlock über multiprocessing.shared_memory
+
+    Schreiber: Sequenz ungerade -> Daten, Länge, CRC -> Sequenz gerade.
+    Leser: Sequenz vorher/nachher gleich und gerade, CRC passt -> konsistenter Stand.
+    Das CRC fängt zusätzlich fehlende Speicherbarrieren in CPython ab.
+    """
+
+    def __init__(self, name: Optional[str] = None, capacity: int = 256 * 1024):
+        """
+        Args:
+            name: Name eines bestehenden Blocks, None = neu anlegen
+            capacity: Maximale Nutzdatengröße in Bytes (nur beim Anlegen)
+        """
+        self.owner = name is None
+        if self.owner:
+            self._shm = shared_memory.SharedMemory(create=True, size=_HEADER_SIZE + capacity)
+        else:
+            self._shm = shared_memory.SharedMemory(name=name)
+        self.name = self._shm.name
+        self._buf = self._shm.buf
+        self._fields = self._buf[:_HEADER_SIZE].cast('q')
+        if self.owner:
+            for index in range(_HEADER_FIELDS):
+                self._fields[index] = 0
+            self._fields[F_CAPACITY] = capacity
+        self.capacity = self._fields[F_CAPACITY]
+        self.writes = 0
+        self.retries = 0
+
+    def write(self, data: bytes) -> bool:
+        """
+        Veröffentlicht einen neuen Stand (nur der eine Schreiber)
+
+        Returns:
+            False wenn data größer als die Kapazität ist
+        """
+        length = len(data)
+        if length > self.capacity:
+            return False
+        fields = self._fields
+        seq = fields[F_SEQ]
+        fields[F_SEQ] = seq + 1
+        self._buf[_HEADER_SIZE:_HEADER_SIZE + length] = data
+        fields[F_LENGTH] = length
+        fields[F_CRC] = zlib.crc32(data)
+        fields[F_SEQ] = seq + 2
+        self.writes += 1
+        return True
+
+    def version(self) -> int:
+        """Aktuelle Sequenz (gerade = stabil); ändert sich mit jedem Schreibvorgang"""
+        return self._fields[F_SEQ]
+
+    def read(self, attempts: int = 100) -> Optional[Tuple[int, bytes]]:
+        """
+        Liest den aktuellen Stand
+
+        Returns:
+            (Version, Daten) oder None wenn noch nichts geschrieben wurde bzw. kein
+            konsistenter Stand innerhalb attempts Versuchen gelesen werden konnte
+        """
+        fields = self._fields
+        buf = self._buf
+        for _ in range(attempts):
+            seq = fields[F_SEQ]
+            if seq == 0:
+                return None
+            if seq & 1:
+                self.retries += 1
+                continue
+            length = fields[F_LENGTH]
+            crc = fields[F_CRC]
+            if length > self.capacity:
+                self.retries += 1
+                continue
+            data = bytes(buf[_HEADER_SIZE:_HEADER_SIZE + length])
+            if fields[F_SEQ] == seq and zlib.crc32(data) == crc:
+                return seq, data
+            self.retries += 1
+        return None
+
+    def close(self):
+        """Gibt die Abbildung frei; der Eigentümer entfernt zusätzlich das Segment"""
+        if self._shm is None:
+            return
+        self._fields.release()
+        self._fields = None
+        self._buf = None
+        self._shm.close()
+        if self.owner:
+            try:
+                self._shm.unlink()
+            except FileNotFoundError:
+                pass
+        self._shm = None
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+Shared Ring - Lock-freier Single-Producer/Single-Consumer-Ring in Shared Memory
+Nachrichten beliebiger Länge über aufeinanderfolgende Slots fester Größe
+"""
+
+import struct
+import zlib
+from multiprocessing import shared_memory
+from typing import Optional
+
+# Kopf: head (nur Producer), tail (nur Consumer), capacity, slot_size, dropped (Producer)
+_HEADER_FIELDS = 8
+_HEADER_SIZE = _HEADER_FIELDS * 8
+H_HEAD, H_TAIL, H_CAPACITY, H_SLOT_SIZE, H_DROPPED = range(5)
+
+# Slot-Kopf: Sequenz (absoluter Slot-Index + 1, 0 = wird geschrieben), Fragmentlänge, Flags,
+# CRC32 des Fragments
+_SLOT_HEADER = struct.Struct('<QIII')
+_SLOT_SEQ = struct.Struct('<Q')
+FLAG_LAST = 0x1
+
+
+class SharedRing:
+    """
+    SPSC-Ring über multiprocessing.shared_memory
+
+    - Producer schreibt alle Fragmente einer Nachricht und veröffentlicht sie mit
+      einer einzigen Speicherung von head; Consumer gibt Slots über tail frei
+    - head/tail sind monotone int64-Zähler, jeder hat genau einen Schreiber
+    - CPython hat keine Speicherbarrieren: jeder Slot trägt wie ein Seqlock eine Sequenz
+      (absoluter Index + 1), die der Producer zuerst löscht und zuletzt schreibt; der
+      Consumer prüft sie vor und nach dem Kopieren plus das CRC32 des Fragments. Ein
+      vollständiger Slot aus der vorigen Runde hat eine um capacity kleinere Sequenz und
+      wird ebenso wie ein halb sichtbares Fragment beim nächsten get() erneut gelesen
+    - Ist der Ring voll, verwirft put() die Nachricht (Zähler dropped) statt zu blockieren
+    """
+
+    def __init__(self, name: Optional[str] = None, capacity: int = 256, slot_size: int = 1024):
+        """
+        Args:
+            name: Name eines bestehenden Rings (Consumer/Producer im anderen Prozess), None = neu anlegen
+            capacity: Anzahl Slots (nur beim Anlegen)
+            slot_size: Slot-Größe in Bytes inkl. 20 Byte Kopf (nur beim Anlegen)
+        """
+        self.owner = name is None
+        if self.owner:
+            self._shm = shared_memory.SharedMemory(create=True, size=_HEADER_SIZE + capacity * slot_size)
+        else:
+            self._shm = shared_memory.SharedMemory(name=name)
+        self.name = self._shm.name
+        self._buf = self._shm.buf
+        self._fields = self._buf[:_HEADER_SIZE].cast('q')
+
+        if self.owner:
+            for index in range(_HEADER_FIELDS):
+                self._fields[index] = 0
+            self._fields[H_CAPACITY] = capacity
+            self._fields[H_SLOT_SIZE] = slot_size
+        self.capacity = self._fields[H_CAPACITY]
+        self.slot_size = self._fields[H_SLOT_SIZE]
+        self.payload_size = self.slot_size - _SLOT_HEADER.size
+        self.max_message = self.capacity * self.payload_size
+
+    def _slot_offset(self, index: int) -> int:
+        return _HEADER_SIZE + (index % self.capacity) * self.slot_size
+
+    def put(self, data: bytes) -> bool:
+        """
+        Hängt eine Nachricht an (nur Producer)
+
+        Returns:
+            True wenn geschrieben, False wenn der Ring voll ist
+        """
+        fields = self._fields
+        payload = self.payload_size
+        count = max(1, -(-len(data) // payload))
+        head = fields[H_HEAD]
+        if count > self.capacity - (head - fields[H_TAIL]):
+            fields[H_DROPPED] += 1
+            return False
+
+        buf = self._buf
+        view = memoryview(data)
+        for k in range(count):
+            chunk = view[k * payload:(k + 1) * payload]
+            offset = self._slot_offset(head + k)
+            start = offset + _SLOT_HEADER.size
+            _SLOT_SEQ.pack_into(buf, offset, 0)
+            buf[start:start + len(chunk)] = chunk
+            _SLOT_HEADER.pack_into(buf, offset, 0, len(chunk), FLAG_LAST if k == count - 1 else 0,
+                                   zlib.crc32(chunk))
+            _SLOT_SEQ.pack_into(buf, offset, head + k + 1)
+        fields[H_HEAD] = head + count
+        return True
+
+    def get(self) -> Optional[bytes]:
+        """
+        Entnimmt die älteste Nachricht (nur Consumer)
+
+        Returns:
+            Nachricht oder None wenn (noch) keine vollständige vorliegt
+        """
+        fields = self._fields
+        tail = fields[H_TAIL]
+        head = fields[H_HEAD]
+        if tail == head:
+            return None
+
+        buf = self._buf
+        parts = []
+        index = tail
+        while index < head:
+            offset = self._slot_offset(index)
+            seq, length, flags, crc = _SLOT_HEADER.unpack_from(buf, offset)
+            if seq != index + 1 or length > self.payload_size:
+                return None
+            start = offset + _SLOT_HEADER.size
+            chunk = bytes(buf[start:start + length])
+            if zlib.crc32(chunk) != crc or _SLOT_SEQ.unpack_from(buf, offset)[0] != seq:
+                return None
+            parts.append(chunk)
+            index += 1
+            if flags & FLAG_LAST:
+                fields[H_TAIL] = index
+                return parts[0] if len(parts) == 1 else b''.join(parts)
+        return None
+
+    def pending(self) -> int:
+        """Belegte Slots"""
+        return self._fields[H_HEAD] - self._fields[H_TAIL]
+
+    def get_stats(self) -> dict:
+        return {
+            'capacity': self.capacity,
+            'slot_size': self.slot_size,
+            'pending': self.pending(),
+            'written': self._fields[H_HEAD],
+            'dropped': self._fields[H_DROPPED],
+        }
+
+    def close(self):
+        """Gibt die Abbildung frei; der Eigentümer entfernt zusätzlich das Segment"""
+        if self._shm is None:
+            return
+        self._fields.release()
+        self._fields = None
+        self._buf = None
+        self._shm.close()
+        if self.owner:
+            try:
+                self._shm.unlink()
+            except FileNotFoundError:
+                pass
+        self._shm = None
@@ -19,6 +19,13 @@ from .hardware.safety_monitor import SafetyMonitor
 from .communication.can_handler import CANHandler
 from .control.motor_control import MotorControl
 from .control.joystick_handler import JoystickHandler
+from .control.path_follower import PathFollower
+from .monitoring.telemetry_recorder import TelemetryRecorder
+from .navigation.coverage_raster import CoverageRaster, blade_position
+from .navigation.site import Site
+from .navigation.waypoint_planner import CoveragePlanner
+from .startup import StartupOrchestrator
+from .web.web_process import WebBridge
 from .web.web_server import WebServer
 
 
@@ -45,7 +52,12 @@ class MotorControllerApp:
         self.can: CANHandler = None
         self.motor: MotorControl = None
         self.joystick: JoystickHandler = None
+        self.follower: PathFollower = None
+        self.recorder: TelemetryRecorder = None
+        self.site: Site = None
+        self.coverage: CoverageRaster = None
         self.web: WebServer = None
+        self.startup: StartupOrchestrator = None
         
         # Shutdown-Flag
         self.running = False
@@ -98,65 +110,31 @@ class MotorControllerApp:
         self.shutdown()
     
     def initialize(self):
-        """Initialisiert alle Komponenten"""
+        """Initialisiert alle Komponenten (unabhängige Stufen parallel)"""
         self.logger.info("=" * 60)
         self.logger.info("Quassel UGV Motor Controller v2.0")
         self.logger.info("=" * 60)
         
         try:
-            # GPIO-Controller (Singleton)
-            self.logger.info("Initialisiere GPIO-Controller...")
-            self.gpio = GPIOController()
-
-            # GPIO-Pins für Licht und Mäher-Relais initialisieren
-            if self.config.light.enabled:
-                self.gpio.setup_output(self.config.light.pin, initial_state=0)  # GPIO.LOW
-                self.logger.info(f"✅ Licht-Relais initialisiert (GPIO{self.config.light.pin})")
-
-            if self.config.mower.enabled:
-                self.gpio.setup_output(self.config.mower.relay_pin, initial_state=0)  # GPIO.LOW
-                self.logger.info(f"✅ Mäher-Relais initialisiert (GPIO{self.config.mower.relay_pin})")
-
-            # PWM-Controller
-            self.logger.info("Initialisiere PWM-Controller...")
-            self.pwm = PWMController(
-                self.config.pwm,
-                self.config.mower,
-                self.gpio
-            )
-            
-            # Safety-Monitor
-            self.logger.info("Initialisiere Safety-Monitor...")
-            self.safety = SafetyMonitor(self.config.safety, self.gpio)
-            
-            # CAN-Handler
-            self.logger.info("Initialisiere CAN-Handler...")
-            self.can = CANHandler(self.config.can)
+            # Safety-Pfad (GPIO -> Safety, GPIO -> PWM) und CAN zuerst, langsame Dateien daneben;
+            # jede Stufe ist kritisch wie bisher jede Komponente
+            self.startup = StartupOrchestrator(parallel=self.config.startup.parallel)
+            self.startup.add('gpio', self._init_gpio, critical=True)
+            self.startup.add('safety', self._init_safety, depends=('gpio',), critical=True)
+            self.startup.add('pwm', self._init_pwm, depends=('gpio',), critical=True)
+            self.startup.add('can', self._init_can, critical=True)
+            self.startup.add('motor', self._init_motor, depends=('pwm',), critical=True)
+            self.startup.add('joystick', self._init_joystick, depends=('motor', 'safety'), critical=True)
+            self.startup.add('recorder', self._init_recorder, critical=True)
+            self.startup.add('site', self._init_site, critical=True)
+            self.startup.add('follower', self._init_follower, depends=('motor', 'site'), critical=True)
+            self.startup.add('coverage', self._init_coverage, depends=('site',), critical=True)
+            self.startup.add('web', self._init_web,
+                             depends=('gpio', 'pwm', 'can', 'joystick', 'recorder', 'site', 'coverage'),
+                             critical=True)
             
-            # Motor-Control
-            self.logger.info("Initialisiere Motor-Control...")
-            self.motor = MotorControl(self.pwm, self.config)
-            
-            # Joystick-Handler
-            self.logger.info("Initialisiere Joystick-Handler...")
-            self.joystick = JoystickHandler(self.motor, self.safety)
-            
-            # Web-Server
-            if self.config.web.enabled:
-                self.logger.info("Initialisiere Web-Server...")
-                self.web = WebServer(
-                    self.config.web,
-                    self.motor,
-                    self.joystick,
-                    self.can,
-                    self.gpio
-                )
-                # Hardware-Referenzen setzen
-                self.web.set_hardware_refs(
-                    self.config.light,
-                    self.config.mower,
-                    self.pwm
-                )
+            if not self.startup.run(timeout=self.config.startup.timeout):
+                raise RuntimeError(f"Startup-Stufen fehlgeschlagen: {', '.join(self.startup.failed()) or 'Timeout'}")
             
             # Callbacks verbinden
             self._setup_callbacks()
@@ -169,18 +147,224 @@ class MotorControllerApp:
             self.logger.critical(f"❌ Initialisierung fehlgeschlagen: {e}", exc_info=True)
             raise
     
+    def _init_gpio(self):
+        """GPIO-Controller (Singleton, verbindet pigpio) und Relais-Ausgänge"""
+        self.logger.info("Initialisiere GPIO-Controller...")
+        self.gpio = GPIOController()
+
+        # GPIO-Pins für Licht und Mäher-Relais initialisieren
+        if self.config.light.enabled:
+            self.gpio.setup_output(self.config.light.pin, initial_state=0)  # GPIO.LOW
+            self.logger.info(f"✅ Licht-Relais initialisiert (GPIO{self.config.light.pin})")
+
+        if self.config.mower.enabled:
+            self.gpio.setup_output(self.config.mower.relay_pin, initial_state=0)  # GPIO.LOW
+            self.logger.info(f"✅ Mäher-Relais initialisiert (GPIO{self.config.mower.relay_pin})")
+    
+    def _init_pwm(self):
+        self.logger.info("Initialisiere PWM-Controller...")
+        self.pwm = PWMController(
+            self.config.pwm,
+            self.config.mower,
+            self.gpio
+        )
+    
+    def _init_safety(self):
+        self.logger.info("Initialisiere Safety-Monitor...")
+        self.safety = SafetyMonitor(self.config.safety, self.gpio, self.config.pwm)
+    
+    def _init_can(self):
+        self.logger.info("Initialisiere CAN-Handler...")
+        self.can = CANHandler(self.config.can)
+    
+    def _init_motor(self):
+        self.logger.info("Initialisiere Motor-Control...")
+        self.motor = MotorControl(self.pwm, self.config)
+    
+    def _init_joystick(self):
+        self.logger.info("Initialisiere Joystick-Handler...")
+        self.joystick = JoystickHandler(
+            self.motor,
+            self.safety,
+            tick_rate=self.config.web.joystick_rate,
+            max_latency=self.config.web.joystick_max_latency
+        )
+    
+    def _init_recorder(self):
+        """Telemetrie-Recorder (optional)"""
+        if self.config.recorder.enabled:
+            self.logger.info("Initialisiere Telemetrie-Recorder...")
+            self.recorder = TelemetryRecorder(
+                capacity=self.config.recorder.capacity,
+                filepath=self.config.recorder.file,
+                flush_interval=self.config.recorder.flush_interval,
+                max_file_mb=self.config.recorder.max_file_mb
+            )
+    
+    def _init_site(self):
+        """Standort (ENU-Ursprung + Geofence); Fehler sind nicht fatal"""
+        if self.config.navigation.site_file:
+            try:
+                self.site = Site.from_file(
+                    self.config.navigation.site_file,
+                    cell_size=self.config.navigation.geofence_cell_size
+                )
+                self.logger.info(f"✅ Standort geladen: {self.config.navigation.site_file} "
+                                 f"({self.site.geofence.get_stats()['edges']} Grenzkanten)")
+            except (OSError, ValueError, KeyError) as e:
+                self.logger.error(f"❌ Standort konnte nicht geladen werden: {e}")
+                self.site = None
+    
+    def _init_coverage(self):
+        """Mähabdeckung über der Standortfläche (braucht den Standort); Fehler sind nicht fatal"""
+        if not (self.config.coverage.enabled and self.site and self.site.boundary):
+            return
+        min_x, min_y, max_x, max_y = self.site.geofence.get_stats()['extent']
+        margin = self.config.coverage.margin
+        try:
+            self.coverage = CoverageRaster(
+                min_x - margin, min_y - margin, max_x + margin, max_y + margin,
+                resolution=self.config.coverage.resolution,
+                tile_size=self.config.coverage.tile_size,
+                origin=(self.site.frame.origin_lat, self.site.frame.origin_lon),
+                filepath=self.config.coverage.file,
+                stamp_width=self.config.navigation.cutting_width,
+                max_gap=self.config.coverage.max_gap
+            )
+            self.logger.info(f"✅ Mähabdeckung: {self.coverage.width}x{self.coverage.height} Zellen "
+                             f"({self.coverage.size / (1 << 20):.1f} MB, {self.coverage.mowed_area:.1f} m² gemäht)")
+        except (OSError, ValueError) as e:
+            self.logger.error(f"❌ Mähabdeckung nicht verfügbar: {e}")
+            self.coverage = None
+    
+    def _init_follower(self):
+        """Bahnfolge (braucht den Standort für Positionen im lokalen Rahmen)"""
+        if self.config.follower.enabled and self.site:
+            self.logger.info("Initialisiere Bahnfolge...")
+            self.follower = PathFollower(
+                self.config.follower,
+                forward_factor=self.config.pwm.forward_factor,
+                turn_factor=self.config.pwm.turn_factor
+            )
+            self.motor.set_path_follower(self.follower)
+    
+    def _init_web(self):
+        """Web-Interface (eigener Prozess oder Threads im Hauptprozess)"""
+        # Web-Interface in eigenem Prozess (Shared Memory), Flask blockiert nie den Echtzeitteil
+        if self.config.web.enabled and self.config.web.separate_process:
+            self.logger.info("Initialisiere Web-Prozess...")
+            self.web = WebBridge(
+                self.config,
+                self.motor,
+                self.joystick,
+                self.can,
+                self.gpio
+            )
+            self.web.set_hardware_refs(
+                self.config.light,
+                self.config.mower,
+                self.pwm
+            )
+            self.web.set_recorder(self.recorder)
+            self.web.set_site(self.site)
+            self.web.set_coverage(self.coverage)
+
+        # Web-Server (Threads im Hauptprozess)
+        elif self.config.web.enabled:
+            self.logger.info("Initialisiere Web-Server...")
+            self.web = WebServer(
+                self.config.web,
+                self.motor,
+                self.joystick,
+                self.can,
+                self.gpio
+            )
+            # Hardware-Referenzen setzen
+            self.web.set_hardware_refs(
+                self.config.light,
+                self.config.mower,
+                self.pwm
+            )
+            self.web.set_recorder(self.recorder)
+            self.web.set_planner(CoveragePlanner(
+                cutting_width=self.config.navigation.cutting_width,
+                overlap=self.config.navigation.overlap,
+                edge_margin=self.config.navigation.edge_margin,
+                min_stripe_length=self.config.navigation.min_stripe_length,
+                time_budget=self.config.navigation.time_budget
+            ))
+            self.web.set_site(self.site)
+            self.web.set_coverage(self.coverage)
+    
     def _setup_callbacks(self):
         """Verbindet Callbacks zwischen Komponenten"""
         # Safety Monitor -> Motor Control (Emergency Stop)
         self.safety.set_emergency_stop_callback(self.motor.emergency_stop)
         
-        # CAN Handler -> Sensor Data Logging
-        if self.config.monitor:
-            self.can.set_sensor_data_callback(self._log_sensor_data)
+        # Motor Control -> Safety Monitor (Heartbeat pro Motorbefehl)
+        self.motor.command_heartbeat = self.safety.update_command_time
+        
+        # CAN Handler -> Safety-Heartbeat, Sensor Data Logging/Aufzeichnung
+        self.can.set_sensor_data_callback(self._log_sensor_data)
     
+    def _blade_position(self, x: float, y: float, heading) -> tuple:
+        """Messermitte im Standort-Rahmen: Pose aus _fused_pose plus Messerversatz"""
+        if heading is None:
+            return x, y
+        return blade_position(x, y, heading, self.config.coverage.blade_offset_forward,
+                              self.config.coverage.blade_offset_left)
+
+    def _fused_pose(self, position, data: dict):
+        """
+        (x, y, Heading) für Bahnfolge und Abdeckung: fusionierte EKF-Pose des Sensor Hubs
+        
+        Ohne EKF (POSE_ESTIMATOR_ENABLED=0) bleiben Antennenfix und das Top-Level-Heading
+        der Telemetrie: IMU-Orientierung, ohne IMU das Dual-Antenna-Heading.
+        """
+        pose = data.get('pose')
+        if pose and pose.get('lat') is not None and pose.get('lon') is not None:
+            x, y = self.site.frame.to_local(pose['lat'], pose['lon'])
+            return x, y, pose.get('heading')
+        return position.x, position.y, data.get('heading')
+
     def _log_sensor_data(self, data: dict):
-        """Callback für Sensor-Daten-Logging"""
-        if not self.config.quiet:
+        """Callback für Sensor-Daten-Logging und -Aufzeichnung"""
+        # Empfangszeit auf der eigenen monotonen Uhr (die Wanduhr des Sensor Hubs ist nicht synchron)
+        received = time.monotonic()
+        self.safety.update_can_time()
+        
+        if self.site:
+            # Fix einmal in lokale Meter umrechnen und gegen den Geofence prüfen
+            position = self.site.update_from_sensor(data)
+            if position and not position.inside:
+                self.logger.warning(f"⚠️ Position außerhalb des Geofence ({position.x:.2f}, {position.y:.2f})")
+                # Autonome Fahrt verlässt die Mähfläche oder fährt in eine No-Go-Zone:
+                # Bahnfolge sofort beenden (ohne Mähgrenze ist 'inside' nicht aussagekräftig)
+                if self.follower and self.follower.active and self.site.geofence.has_boundary:
+                    self.logger.error("🛑 Bahnfolge gestoppt: Geofence verletzt")
+                    self.motor.stop_path_following('geofence')
+
+            # Bahnfolge: Position + Heading (fusionierte Pose bevorzugt)
+            if position and self.follower:
+                x, y, heading = self._fused_pose(position, data)
+                if heading is not None:
+                    # Alter = Verarbeitung hier + vom Sensor Hub gemeldetes Alter der Pose
+                    age = (data.get('pose') or {}).get('age') or 0.0
+                    self.follower.update_pose(x, y, heading, latency=time.monotonic() - received + age)
+            
+            # Mähabdeckung: nur mit laufendem Messer (und RTK FIXED) stempeln, sonst Spur unterbrechen
+            if self.coverage:
+                active = (position is not None and self.pwm.get_mower_speed() > 0
+                          and (not self.config.coverage.rtk_only or data.get('rtk_status') == 'RTK FIXED'))
+                if active:
+                    self.coverage.update(*self._blade_position(*self._fused_pose(position, data)))
+                else:
+                    self.coverage.update(0.0, 0.0, active=False)
+        
+        if self.recorder:
+            self.recorder.record(data, self.motor.get_target_values(), self.motor.get_current_values())
+        
+        if self.config.monitor and not self.config.quiet:
             self.logger.info(f"📡 Sensor-Daten: {data}")
     
     def start(self):
@@ -188,13 +372,19 @@ class MotorControllerApp:
         self.logger.info("Starte Komponenten...")
         
         try:
+            # Telemetrie-Aufzeichnung starten
+            if self.recorder:
+                self.recorder.start()
+            
             # CAN-Reader starten
             if self.can:
                 self.can.start_reader()
             
-            # Safety-Watchdog starten
+            # Safety-Watchdog (+ Supervisor-Prozess) starten
             if self.safety:
                 self.safety.start_watchdog()
+                self.pwm.set_supervisor(self.safety.supervisor)
+                self.motor.supervisor = self.safety.supervisor
             
             # Web-Server starten
             if self.web:
@@ -246,6 +436,19 @@ class MotorControllerApp:
                 self.logger.info("Stoppe CAN-Reader...")
                 self.can.cleanup()
             
+            # Telemetrie-Aufzeichnung abschließen
+            if self.recorder:
+                self.logger.info("Stoppe Telemetrie-Recorder...")
+                self.recorder.stop()
+            
+            # Mähabdeckung auf die SD-Karte schreiben
+            if self.coverage:
+                self.coverage.close()
+            
+            # Joystick-Takt stoppen
+            if self.joystick:
+                self.joystick.cleanup()
+            
             # Motor-Control stoppen
             if self.motor:
                 self.logger.info("Stoppe Motor-Control...")
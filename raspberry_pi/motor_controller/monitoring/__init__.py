@@ -0,0 +1,9 @@
+#!/usr/bin/env python3
+"""
+Monitoring-Module für Motor Controller
+"""
+
+from .latency_tracer import LatencyHistogram, LatencyTracer, get_tracer
+from .telemetry_recorder import TelemetryRecorder, iter_recording
+
+__all__ = ['LatencyHistogram', 'LatencyTracer', 'get_tracer', 'TelemetryRecorder', 'iter_recording']
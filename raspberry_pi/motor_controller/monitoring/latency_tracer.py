@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Latency Tracer - End-to-End-Zeitmessung Joystick -> PWM
+Monotone Zeitstempel pro Stufe, logarithmische Histogramme, Prometheus-Export
+"""
+
+import threading
+import time
+from typing import Dict, List, Optional
+
+# Log-lineare Buckets (HDR-ähnlich): 8 Unter-Buckets pro Zweierpotenz,
+# relative Auflösung 12.5%, Werte in μs bis ~2^27 μs (134 s)
+_SUB_BUCKET_BITS = 3
+_SUB_BUCKETS = 1 << _SUB_BUCKET_BITS
+_LINEAR_LIMIT = _SUB_BUCKETS << 1
+_BUCKET_COUNT = 200
+
+# Stufen des Joystick-Pfads in Reihenfolge
+STAGE_SOCKETIO = 'socketio_dispatch'
+STAGE_JOYSTICK = 'joystick_handler'
+STAGE_MOTOR = 'motor_control'
+STAGE_PWM = 'pwm_write'
+STAGE_TOTAL = 'total'
+
+JOYSTICK_STAGES = (STAGE_SOCKETIO, STAGE_JOYSTICK, STAGE_MOTOR, STAGE_PWM, STAGE_TOTAL)
+
+
+def _bucket_index(value_us: int) -> int:
+    """Bucket-Index für einen Wert in μs"""
+    if value_us < _LINEAR_LIMIT:
+        return value_us if value_us > 0 else 0
+    shift = value_us.bit_length() - (_SUB_BUCKET_BITS + 1)
+    index = (shift + 1) * _SUB_BUCKETS + ((value_us >> shift) & (_SUB_BUCKETS - 1))
+    return index if index < _BUCKET_COUNT else _BUCKET_COUNT - 1
+
+
+def _bucket_upper_bound(index: int) -> int:
+    """Größter Wert (μs), der in einen Bucket fällt"""
+    if index < _LINEAR_LIMIT:
+        return index
+    shift = index // _SUB_BUCKETS - 1
+    lower = (_SUB_BUCKETS + index % _SUB_BUCKETS) << shift
+    return lower + (1 << shift) - 1
+
+
+class LatencyHistogram:
+    """
+    Histogramm ohne Lock
+    - record() erhöht nur einen Listeneintrag (unter dem GIL praktisch atomar;
+      bei gleichzeitigen Writern kann im Extremfall ein Sample verloren gehen)
+    - Perzentile werden beim Abfragen aus den Buckets berechnet
+    """
+
+    __slots__ = ('counts', 'count', 'total_us', 'max_us')
+
+    def __init__(self):
+        self.counts: List[int] = [0] * _BUCKET_COUNT
+        self.count = 0
+        self.total_us = 0
+        self.max_us = 0
+
+    def record(self, value_us: int):
+        """Trägt einen Messwert (μs) ein"""
+        self.counts[_bucket_index(value_us)] += 1
+        self.count += 1
+        self.total_us += value_us
+        if value_us > self.max_us:
+            self.max_us = value_us
+
+    def percentile(self, quantile: float) -> int:
+        """
+        Gibt das Perzentil als obere Bucket-Grenze zurück
+
+        Args:
+            quantile: 0.0 - 1.0 (z.B. 0.99)
+
+        Returns:
+            Wert in μs (0 wenn leer)
+        """
+        counts = list(self.counts)
+        total = sum(counts)
+        if total == 0:
+            return 0
+
+        threshold = quantile * total
+        seen = 0
+        for index, bucket_count in enumerate(counts):
+            seen += bucket_count
+            if seen >= threshold and bucket_count:
+                return min(_bucket_upper_bound(index), self.max_us)
+        return self.max_us
+
+    def snapshot(self) -> Dict[str, float]:
+        """Kennzahlen in Millisekunden"""
+        count = self.count
+        return {
+            'count': count,
+            'p50_ms': self.percentile(0.50) / 1000.0,
+            'p99_ms': self.percentile(0.99) / 1000.0,
+            'max_ms': self.max_us / 1000.0,
+            'mean_ms': (self.total_us / count / 1000.0) if count else 0.0,
+        }
+
+    def reset(self):
+        """Setzt das Histogramm zurück"""
+        self.counts = [0] * _BUCKET_COUNT
+        self.count = 0
+        self.total_us = 0
+        self.max_us = 0
+
+
+class LatencyTracer:
+    """
+    Tracer für den Joystick-Pfad (Socket.IO -> JoystickHandler -> MotorControl -> PWM)
+    - begin() startet einen Trace im aktuellen Thread
+    - mark(stage) misst die Zeit seit Trace-Beginn für diese Stufe
+    - end() misst die Gesamtzeit und beendet den Trace
+    Ohne aktiven Trace sind mark()/end() ein einzelner Attribut-Lookup.
+    """
+
+    def __init__(self, stages=JOYSTICK_STAGES):
+        self.histograms: Dict[str, LatencyHistogram] = {stage: LatencyHistogram() for stage in stages}
+        self._local = threading.local()
+        self.started_at = time.time()
+
+    def begin(self, start_ns: Optional[int] = None):
+        """Startet einen Trace (optional mit früherem Startzeitpunkt, perf_counter_ns)"""
+        self._local.start_ns = start_ns if start_ns is not None else time.perf_counter_ns()
+
+    def mark(self, stage: str):
+        """Zeitstempel für eine Stufe des laufenden Traces"""
+        start_ns = getattr(self._local, 'start_ns', None)
+        if start_ns is None:
+            return
+        histogram = self.histograms.get(stage)
+        if histogram is None:
+            histogram = self.histograms.setdefault(stage, LatencyHistogram())
+        histogram.record((time.perf_counter_ns() - start_ns) // 1000)
+
+    def end(self):
+        """Beendet den Trace und erfasst die Gesamtlatenz"""
+        self.mark(STAGE_TOTAL)
+        self._local.start_ns = None
+
+    def get_stats(self) -> Dict[str, Dict[str, float]]:
+        """Kennzahlen aller Stufen"""
+        return {stage: histogram.snapshot() for stage, histogram in list(self.histograms.items())}
+
+    def reset(self):
+        """Setzt alle Histogramme zurück"""
+        for histogram in list(self.histograms.values()):
+            histogram.reset()
+
+    def render_prometheus(self, prefix: str = 'ugv_joystick_latency') -> str:
+        """
+        Exportiert die Histogramme im Prometheus-Textformat (summary)
+
+        Returns:
+            Text für /api/metrics
+        """
+        lines = [
+            f"# HELP {prefix}_seconds Latenz vom Socket.IO-Event bis zur Stufe",
+            f"# TYPE {prefix}_seconds summary",
+        ]
+        max_lines = [
+            f"# HELP {prefix}_max_seconds Maximale beobachtete Latenz",
+            f"# TYPE {prefix}_max_seconds gauge",
+        ]
+        for stage, histogram in list(self.histograms.items()):
+            label = f'stage="{stage}"'
+            for quantile in (0.5, 0.9, 0.99):
+                value = histogram.percentile(quantile) / 1e6
+                lines.append(f'{prefix}_seconds{{{label},quantile="{quantile}"}} {value:.6f}')
+            lines.append(f'{prefix}_seconds_sum{{{label}}} {histogram.total_us / 1e6:.6f}')
+            lines.append(f'{prefix}_seconds_count{{{label}}} {histogram.count}')
+            max_lines.append(f'{prefix}_max_seconds{{{label}}} {histogram.max_us / 1e6:.6f}')
+        return '\n'.join(lines + max_lines) + '\n'
+
+
+_tracer = LatencyTracer()
+
+
+def get_tracer() -> LatencyTracer:
+    """Gibt den prozessweiten Tracer zurück (Singleton)"""
+    return _tracer
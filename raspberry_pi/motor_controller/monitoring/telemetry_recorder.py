@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""
+Telemetry Recorder - Spaltenorientierter Ringpuffer für Sensor-/Motor-Telemetrie
+Feste Kapazität (vorallokiert), periodischer Flush in eine append-only mmap-Datei
+"""
+
+import logging
+import mmap
+import os
+import struct
+import threading
+import time
+from array import array
+from bisect import bisect_left, bisect_right
+from typing import Any, Dict, Iterator, List, Optional
+
+# Spalten: (Name, array-Typecode, struct-Format)
+COLUMNS = (
+    ('timestamp', 'd', 'd'),   # Empfangszeit (time.time)
+    ('lat', 'd', 'd'),
+    ('lon', 'd', 'd'),
+    ('heading', 'f', 'f'),
+    ('roll', 'f', 'f'),
+    ('pitch', 'f', 'f'),
+    ('yaw', 'f', 'f'),
+    ('rtk_status', 'B', 'B'),  # Fix-Qualität wie im Telemetrie-Frame (0 = kein GPS)
+    ('cmd_left', 'H', 'H'),    # Ziel-PWM (μs)
+    ('cmd_right', 'H', 'H'),
+    ('pwm_left', 'H', 'H'),    # Tatsächliche PWM (μs)
+    ('pwm_right', 'H', 'H'),
+)
+COLUMN_NAMES = tuple(name for name, _, _ in COLUMNS)
+
+_ROW = struct.Struct('<' + ''.join(fmt for _, _, fmt in COLUMNS))
+ROW_SIZE = _ROW.size
+
+# Datei-Header: Magic, Zeilengröße, Anzahl gültiger Zeilen
+FILE_MAGIC = b'UGVTREC1'
+_HEADER = struct.Struct('<8sII')
+HEADER_SIZE = _HEADER.size
+
+_GROW_BYTES = 1 << 20  # Datei wächst in 1-MB-Schritten
+
+_RTK_STATUS_CODES = {
+    'NO GPS': 0,
+    'GPS FIX': 1,
+    'DGPS': 2,
+    'RTK FIXED': 4,
+    'RTK FLOAT': 5,
+}
+
+_NAN = float('nan')
+
+
+def _as_float(value) -> float:
+    try:
+        return float(value)
+    except (TypeError, ValueError):
+        return _NAN
+
+
+def iter_recording(filepath: str) -> Iterator[Dict[str, Any]]:
+    """
+    Liest eine Aufzeichnungsdatei zeilenweise
+
+    Args:
+        filepath: Pfad der .trec-Datei
+
+    Yields:
+        Dictionary pro Zeile (Spaltenname -> Wert)
+    """
+    with open(filepath, 'rb') as f:
+        header = f.read(HEADER_SIZE)
+        if len(header) < HEADER_SIZE:
+            return
+        magic, row_size, rows = _HEADER.unpack(header)
+        if magic != FILE_MAGIC or row_size != ROW_SIZE:
+            raise ValueError(f"Unbekanntes Aufzeichnungsformat: {filepath}")
+
+        for _ in range(rows):
+            chunk = f.read(ROW_SIZE)
+            if len(chunk) < ROW_SIZE:
+                return
+            yield dict(zip(COLUMN_NAMES, _ROW.unpack(chunk)))
+
+
+class _RingView:
+    """Sequenz-Sicht auf eine Ringpuffer-Spalte über den logischen Index (für bisect)"""
+
+    __slots__ = ('column', 'capacity')
+
+    def __init__(self, column: array, capacity: int):
+        self.column = column
+        self.capacity = capacity
+
+    def __getitem__(self, index: int):
+        return self.column[index % self.capacity]
+
+
+class _MappedLog:
+    """Append-only Datei mit mmap; Zeilenanzahl steht im Header"""
+
+    def __init__(self, filepath: str, max_bytes: int):
+        self.filepath = filepath
+        self.max_bytes = max_bytes
+        self._fd = -1
+        self._map: Optional[mmap.mmap] = None
+        self.rows = 0
+        self._open()
+
+    def _open(self):
+        self._fd = os.open(self.filepath, os.O_RDWR | os.O_CREAT, 0o644)
+        size = os.fstat(self._fd).st_size
+
+        if size >= HEADER_SIZE:
+            header = os.pread(self._fd, HEADER_SIZE, 0)
+            magic, row_size, rows = _HEADER.unpack(header)
+            if magic == FILE_MAGIC and row_size == ROW_SIZE:
+                self.rows = min(rows, (size - HEADER_SIZE) // ROW_SIZE)
+            else:
+                size = 0  # Fremde/alte Datei überschreiben
+
+        if size < HEADER_SIZE:
+            os.ftruncate(self._fd, 0)
+            size = HEADER_SIZE + _GROW_BYTES
+            os.ftruncate(self._fd, size)
+            self.rows = 0
+
+        self._map = mmap.mmap(self._fd, size)
+        self._write_header()
+
+    def _write_header(self):
+        _HEADER.pack_into(self._map, 0, FILE_MAGIC, ROW_SIZE, self.rows)
+
+    def _ensure_capacity(self, needed: int):
+        if needed <= len(self._map):
+            return
+        new_size = len(self._map)
+        while new_size < needed:
+            new_size += _GROW_BYTES
+        self._map.close()
+        os.ftruncate(self._fd, new_size)
+        self._map = mmap.mmap(self._fd, new_size)
+
+    def is_full(self, extra_rows: int) -> bool:
+        return HEADER_SIZE + (self.rows + extra_rows) * ROW_SIZE > self.max_bytes
+
+    def append(self, data: bytes):
+        """Hängt fertig gepackte Zeilen an (Header erst nach den Daten aktualisiert)"""
+        row_count = len(data) // ROW_SIZE
+        offset = HEADER_SIZE + self.rows * ROW_SIZE
+        self._ensure_capacity(offset + len(data))
+        self._map[offset:offset + len(data)] = data
+        self.rows += row_count
+        self._write_header()
+
+    def sync(self):
+        if self._map:
+            self._map.flush()
+
+    def close(self):
+        if self._map:
+            self._map.flush()
+            self._map.close()
+            self._map = None
+        if self._fd >= 0:
+            # Vorallokierten Rest abschneiden
+            os.ftruncate(self._fd, HEADER_SIZE + self.rows * ROW_SIZE)
+            os.close(self._fd)
+            self._fd = -1
+
+
+class TelemetryRecorder:
+    """
+    Zeitreihen-Recorder
+    - Eine vorallokierte array-Spalte pro Größe (kein Dict pro Sample)
+    - Ringpuffer: bei voller Kapazität werden die ältesten Zeilen überschrieben
+    - Zeitbereichs-Abfragen per Binärsuche auf der Zeitstempel-Spalte
+    - Optionaler Flush-Thread schreibt neue Zeilen gepackt in eine mmap-Datei
+    """
+
+    def __init__(self, capacity: int = 180000, filepath: str = '', flush_interval: float = 5.0,
+                 max_file_mb: int = 512):
+        """
+        Initialisiert den Recorder
+
+        Args:
+            capacity: Anzahl Zeilen im Speicher (180000 = 1 h bei 50 Hz)
+            filepath: Aufzeichnungsdatei ('' = nur im Speicher)
+            flush_interval: Flush-Intervall in Sekunden
+            max_file_mb: Maximale Dateigröße, danach wird nach <datei>.1 rotiert
+        """
+        self.logger = logging.getLogger(__name__)
+        self.capacity = capacity
+        self.filepath = filepath
+        self.flush_interval = flush_interval
+        self.max_file_bytes = max_file_mb * 1024 * 1024
+
+        self._columns: Dict[str, array] = {
+            name: array(typecode, [0]) * capacity for name, typecode, _ in COLUMNS
+        }
+        self._timestamps = _RingView(self._columns['timestamp'], capacity)
+        self._written = 0   # Gesamtzahl geschriebener Zeilen (logischer Index)
+        self._flushed = 0   # Logischer Index bis zu dem geflusht wurde
+        self._lock = threading.Lock()
+
+        self.rows_flushed = 0
+        self.rows_lost = 0  # Vor dem Flush überschrieben
+        self.last_flush_ms = 0.0
+
+        self._log: Optional[_MappedLog] = None
+        self._flush_thread: Optional[threading.Thread] = None
+        self._stop_event = threading.Event()
+
+    def start(self) -> bool:
+        """
+        Öffnet die Aufzeichnungsdatei und startet den Flush-Thread
+
+        Returns:
+            True bei Erfolg (oder ohne Datei), False bei Fehler
+        """
+        if not self.filepath:
+            return True
+
+        try:
+            directory = os.path.dirname(self.filepath)
+            if directory:
+                os.makedirs(directory, exist_ok=True)
+            self._log = _MappedLog(self.filepath, self.max_file_bytes)
+        except OSError as e:
+            self.logger.error(f"❌ Telemetrie-Datei konnte nicht geöffnet werden: {e}")
+            self._log = None
+            return False
+
+        self._stop_event.clear()
+        self._flush_thread = threading.Thread(target=self._flush_loop, name='telemetry-flush', daemon=True)
+        self._flush_thread.start()
+        self.logger.info(f"✅ Telemetrie-Aufzeichnung: {self.filepath} ({self._log.rows} Zeilen vorhanden)")
+        return True
+
+    def stop(self):
+        """Stoppt den Flush-Thread und schreibt ausstehende Zeilen"""
+        self._stop_event.set()
+        if self._flush_thread:
+            self._flush_thread.join(timeout=2.0)
+            self._flush_thread = None
+        if self._log:
+            self.flush()
+            self._log.close()
+            self._log = None
+
+    def record(self, data: Dict[str, Any], commanded: Dict[str, int], actual: Dict[str, int],
+               timestamp: Optional[float] = None):
+        """
+        Zeichnet ein Sensor-Sample zusammen mit den PWM-Werten auf
+
+        Args:
+            data: Sensor-Daten (JSON- oder Binär-Telemetrie-Format)
+            commanded: Ziel-PWM {'left', 'right'}
+            actual: Tatsächliche PWM {'left', 'right'}
+            timestamp: Zeitstempel (Default: time.time())
+        """
+        gps = data.get('gps') or {}
+        imu = data.get('imu') or {}
+        rtk = data.get('rtk_status')
+        rtk_code = rtk if isinstance(rtk, int) else _RTK_STATUS_CODES.get(rtk, 0)
+
+        values = (
+            time.time() if timestamp is None else timestamp,
+            _as_float(gps.get('lat', data.get('lat'))),
+            _as_float(gps.get('lon', data.get('lon'))),
+            _as_float(data.get('heading', imu.get('heading'))),
+            _as_float(imu.get('roll')),
+            _as_float(imu.get('pitch')),
+            _as_float(imu.get('yaw')),
+            rtk_code & 0xFF,
+            int(commanded.get('left', 0)) & 0xFFFF,
+            int(commanded.get('right', 0)) & 0xFFFF,
+            int(actual.get('left', 0)) & 0xFFFF,
+            int(actual.get('right', 0)) & 0xFFFF,
+        )
+        self.append_row(values)
+
+    def append_row(self, values):
+        """Hängt eine Zeile an (Werte in Reihenfolge von COLUMN_NAMES)"""
+        with self._lock:
+            # Zeitstempel müssen für die Binärsuche monoton bleiben (z.B. bei NTP-Sprung)
+            if self._written and values[0] < self._timestamps[self._written - 1]:
+                values = (self._timestamps[self._written - 1],) + tuple(values[1:])
+            slot = self._written % self.capacity
+            for column, value in zip(self._columns.values(), values):
+                column[slot] = value
+            self._written += 1
+
+    def __len__(self) -> int:
+        return min(self._written, self.capacity)
+
+    def _oldest(self) -> int:
+        return max(0, self._written - self.capacity)
+
+    def _search(self, value: float, right: bool) -> int:
+        """Binärsuche über den logischen Index"""
+        search = bisect_right if right else bisect_left
+        return search(self._timestamps, value, self._oldest(), self._written)
+
+    def query(self, start: Optional[float] = None, end: Optional[float] = None,
+              columns: Optional[List[str]] = None, max_points: int = 2000) -> Dict[str, Any]:
+        """
+        Zeitbereichs-Abfrage
+
+        Args:
+            start: Startzeit (time.time), None = ältester Eintrag
+            end: Endzeit, None = neuester Eintrag
+            columns: Gewünschte Spalten (Default: alle)
+            max_points: Maximalzahl Punkte (gleichmäßig ausgedünnt)
+
+        Returns:
+            Dictionary mit 'count', 'step' und einer Liste pro Spalte
+        """
+        names = [name for name in (columns or COLUMN_NAMES) if name in self._columns]
+        if 'timestamp' not in names:
+            names.insert(0, 'timestamp')
+
+        with self._lock:
+            first = self._oldest() if start is None else self._search(start, right=False)
+            last = self._written if end is None else self._search(end, right=True)
+            count = max(0, last - first)
+            step = max(1, -(-count // max_points)) if max_points > 0 else 1
+
+            result: Dict[str, Any] = {'count': count, 'step': step}
+            for name in names:
+                column = self._columns[name]
+                capacity = self.capacity
+                result[name] = [column[index % capacity] for index in range(first, last, step)]
+
+        # NaN ist kein gültiges JSON
+        for name in names:
+            if self._columns[name].typecode in 'fd':
+                result[name] = [None if value != value else value for value in result[name]]
+        return result
+
+    def flush(self):
+        """Schreibt alle neuen Zeilen in die Datei"""
+        if not self._log:
+            return
+
+        started = time.perf_counter()
+        with self._lock:
+            oldest = self._oldest()
+            if self._flushed < oldest:
+                self.rows_lost += oldest - self._flushed
+                self._flushed = oldest
+            first, last = self._flushed, self._written
+            columns = list(self._columns.values())
+            capacity = self.capacity
+            rows = [tuple(column[index % capacity] for column in columns) for index in range(first, last)]
+            self._flushed = last
+
+        if not rows:
+            return
+
+        if self._log.is_full(len(rows)):
+            self._rotate()
+
+        buffer = bytearray(len(rows) * ROW_SIZE)
+        for position, row in enumerate(rows):
+            _ROW.pack_into(buffer, position * ROW_SIZE, *row)
+        self._log.append(buffer)
+        self.rows_flushed += len(rows)
+        self.last_flush_ms = (time.perf_counter() - started) * 1000.0
+
+    def _rotate(self):
+        """Aktuelle Datei nach <datei>.1 verschieben und neu beginnen"""
+        self._log.close()
+        os.replace(self.filepath, self.filepath + '.1')
+        self._log = _MappedLog(self.filepath, self.max_file_bytes)
+        self.logger.info(f"🔄 Telemetrie-Datei rotiert: {self.filepath}.1")
+
+    def _flush_loop(self):
+        while not self._stop_event.wait(self.flush_interval):
+            try:
+                self.flush()
+                self._log.sync()
+            except Exception as e:
+                self.logger.error(f"❌ Telemetrie-Flush Fehler: {e}")
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Gibt Recorder-Statistiken zurück
+
+        Returns:
+            Dictionary mit Füllstand und Flush-Zählern
+        """
+        with self._lock:
+            rows = len(self)
+            oldest = self._timestamps[self._oldest()] if rows else None
+            newest = self._timestamps[self._written - 1] if rows else None
+        return {
+            'capacity': self.capacity,
+            'rows': rows,
+            'total_rows': self._written,
+            'memory_kb': round(self.capacity * ROW_SIZE / 1024.0, 1),
+            'oldest': oldest,
+            'newest': newest,
+            'file': self.filepath or None,
+            'file_rows': self._log.rows if self._log else 0,
+            'rows_flushed': self.rows_flushed,
+            'rows_lost': self.rows_lost,
+            'last_flush_ms': round(self.last_flush_ms, 2),
+        }
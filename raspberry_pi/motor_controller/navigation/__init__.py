@@ -0,0 +1,11 @@
+#!/usr/bin/env python3
+"""
+Navigation-Module für Motor Controller
+"""
+
+from .area_calculator import area_with_holes, point_in_area, polygon_area
+from .path_optimizer import optimize_cell_order
+from .waypoint_planner import CoveragePlan, CoveragePlanner, Waypoint
+
+__all__ = ['area_with_holes', 'point_in_area', 'polygon_area', 'optimize_cell_order',
+           'CoveragePlan', 'CoveragePlanner', 'Waypoint']
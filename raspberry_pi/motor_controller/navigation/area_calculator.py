@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Area Calculator - Flächen- und Geometrie-Hilfsfunktionen für Mähbereiche
+Alle Koordinaten in Metern im lokalen Rahmen (x = Ost, y = Nord)
+"""
+
+import math
+from typing import List, Sequence, Tuple
+
+Point = Tuple[float, float]
+Polygon = Sequence[Point]
+
+
+def signed_area(polygon: Polygon) -> float:
+    """Vorzeichenbehaftete Fläche (Shoelace); positiv bei Umlauf gegen den Uhrzeigersinn"""
+    n = len(polygon)
+    if n < 3:
+        return 0.0
+    total = 0.0
+    x_prev, y_prev = polygon[-1]
+    for x, y in polygon:
+        total += x_prev * y - x * y_prev
+        x_prev, y_prev = x, y
+    return 0.5 * total
+
+
+def polygon_area(polygon: Polygon) -> float:
+    """Fläche eines einfachen Polygons in m²"""
+    return abs(signed_area(polygon))
+
+
+def area_with_holes(outer: Polygon, holes: Sequence[Polygon] = ()) -> float:
+    """Mähfläche: Außenkontur minus Hindernisse (Beete, Teiche, ...) in m²"""
+    return max(0.0, polygon_area(outer) - sum(polygon_area(hole) for hole in holes))
+
+
+def perimeter(polygon: Polygon) -> float:
+    """Umfang eines geschlossenen Polygons in m"""
+    total = 0.0
+    x_prev, y_prev = polygon[-1]
+    for x, y in polygon:
+        total += math.hypot(x - x_prev, y - y_prev)
+        x_prev, y_prev = x, y
+    return total
+
+
+def point_in_polygon(point: Point, polygon: Polygon) -> bool:
+    """Even-Odd-Test (Ray Casting)"""
+    px, py = point
+    inside = False
+    x_prev, y_prev = polygon[-1]
+    for x, y in polygon:
+        if (y > py) != (y_prev > py):
+            x_cross = x + (py - y) * (x_prev - x) / (y_prev - y)
+            if px < x_cross:
+                inside = not inside
+        x_prev, y_prev = x, y
+    return inside
+
+
+def point_in_area(point: Point, outer: Polygon, holes: Sequence[Polygon] = ()) -> bool:
+    """True wenn der Punkt in der Außenkontur und in keinem Hindernis liegt"""
+    return point_in_polygon(point, outer) and not any(point_in_polygon(point, hole) for hole in holes)
+
+
+def convex_hull(points: Polygon) -> List[Point]:
+    """Konvexe Hülle (Monotone Chain), gegen den Uhrzeigersinn"""
+    pts = sorted(set(points))
+    if len(pts) <= 2:
+        return list(pts)
+
+    def cross(o, a, b):
+        return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+
+    lower: List[Point] = []
+    for p in pts:
+        while len(lower) >= 2 and cross(lower[-2], lower[-1], p) <= 0:
+            lower.pop()
+        lower.append(p)
+    upper: List[Point] = []
+    for p in reversed(pts):
+        while len(upper) >= 2 and cross(upper[-2], upper[-1], p) <= 0:
+            upper.pop()
+        upper.append(p)
+    return lower[:-1] + upper[:-1]
+
+
+def min_width_angle(polygon: Polygon) -> float:
+    """
+    Streifenrichtung (rad) mit minimaler Breite quer dazu (= minimale Anzahl Streifen)
+
+    Die optimale Richtung liegt parallel zu einer Kante der konvexen Hülle;
+    der gegenüberliegende Punkt wird per Rotating Calipers nachgeführt (O(n)).
+    """
+    hull = convex_hull(polygon)
+    n = len(hull)
+    if n < 3:
+        return 0.0
+
+    def distance(i: int, k: int) -> float:
+        x0, y0 = hull[i - 1]
+        x1, y1 = hull[i]
+        xk, yk = hull[k % n]
+        return (x1 - x0) * (yk - y0) - (y1 - y0) * (xk - x0)
+
+    best_angle = 0.0
+    best_width = math.inf
+    k = 1
+    for i in range(n):
+        x0, y0 = hull[i - 1]
+        x1, y1 = hull[i]
+        length = math.hypot(x1 - x0, y1 - y0)
+        if length == 0.0:
+            continue
+        while distance(i, k + 1) > distance(i, k):
+            k += 1
+        width = distance(i, k) / length
+        if width < best_width:
+            best_width = width
+            best_angle = math.atan2(y1 - y0, x1 - x0)
+    return best_angle
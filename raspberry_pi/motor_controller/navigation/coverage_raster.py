@@ -0,0 +1,473 @@
+#!/usr/bin/env python3
+"""
+Coverage Raster - Mähabdeckung als Raster fester Auflösung im lokalen ENU-Rahmen
+Jede Position stempelt die Schnittbreite als Kapsel (Strecke zur vorigen Position plus
+Halbkreise) in ein Byte-Raster, pro Rasterzeile ein Slice-Schreiben; das Raster liegt
+memory-mapped in einer Datei oder in Shared Memory, der Web-Prozess blendet es nur lesend ein.
+Kacheln (tile_size x tile_size Zellen) tragen Versionsnummern und werden als Paletten-PNG
+pro (Epoche, Version) zwischengespeichert - über eine schwache Verbindung gehen nur
+geänderte Kacheln, nie die Spur.
+
+Layout: Header (Geometrie + Zähler) | Kachelversionen (uint32) | Zellen (uint8)
+Kachel (tx, ty) deckt die Zellen [tx*ts, (tx+1)*ts) in x und [ty*ts, (ty+1)*ts) in y ab,
+ty wächst nach Norden
+
+Kopie von sensor_hub/coverage_raster.py (eigenes Deployment, gleiches Dateiformat);
+Änderungen in beiden Dateien nachziehen, die Tests liegen auf der Sensor-Hub-Seite
+"""
+
+import logging
+import math
+import mmap
+import os
+import struct
+import threading
+import time
+import zlib
+from multiprocessing import shared_memory
+from typing import Any, Dict, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+FILE_MAGIC = b'UGVCOV1\0'
+
+# Magic, Breite, Höhe (Zellen), Kachelgröße, Auflösung (m), min_x, min_y (m), Ursprung lat/lon
+_GEOMETRY = struct.Struct('<8sIII4xddddd')
+# Epoche (reset), reserviert, gemähte Zellen, Stempel
+_COUNTERS = struct.Struct('<IIQQ')
+_COUNTERS_OFFSET = _GEOMETRY.size
+HEADER_SIZE = 128
+
+CELL_EMPTY = 0
+CELL_MOWED = 1
+
+# Palette: transparent / gemäht (grün, leicht durchscheinend über Luftbild oder Karte)
+_PALETTE = bytes((0, 0, 0, 46, 160, 67))
+_ALPHA = bytes((0, 200))
+
+# WGS84 für den Ursprung des Rasters (lokale Tangentialebene, reicht für Gartenflächen)
+_WGS84_A = 6378137.0
+_WGS84_E2 = 6.69437999014e-3
+
+
+def local_offset(origin_lat: float, origin_lon: float, lat: float, lon: float) -> Tuple[float, float]:
+    """Ost/Nord-Versatz (m) eines Fixes zum Ursprung"""
+    phi = math.radians(origin_lat)
+    factor = 1.0 - _WGS84_E2 * math.sin(phi) ** 2
+    meridian = _WGS84_A * (1.0 - _WGS84_E2) / factor ** 1.5
+    prime_vertical = _WGS84_A / math.sqrt(factor)
+    return (math.radians(lon - origin_lon) * prime_vertical * math.cos(phi),
+            math.radians(lat - origin_lat) * meridian)
+
+
+def blade_position(east: float, north: float, heading: float,
+                   forward: float = 0.0, left: float = 0.0) -> Tuple[float, float]:
+    """Messermitte aus Antennen-/Posenposition, Versatz im Fahrzeugrahmen (Heading in Grad ab Nord, im Uhrzeigersinn)"""
+    psi = math.radians(heading)
+    sin_psi = math.sin(psi)
+    cos_psi = math.cos(psi)
+    return (east + forward * sin_psi - left * cos_psi,
+            north + forward * cos_psi + left * sin_psi)
+
+
+def _png_chunk(kind: bytes, data: bytes) -> bytes:
+    return struct.pack('>I', len(data)) + kind + data + struct.pack('>I', zlib.crc32(kind + data))
+
+
+def encode_png(rows: List[bytes], width: int, level: int = 6) -> bytes:
+    """Paletten-PNG (8 Bit) aus Zeilen mit Zellwerten als Palettenindex"""
+    raw = b''.join(b'\x00' + row for row in rows)
+    return (b'\x89PNG\r\n\x1a\n'
+            + _png_chunk(b'IHDR', struct.pack('>IIBBBBB', width, len(rows), 8, 3, 0, 0, 0))
+            + _png_chunk(b'PLTE', _PALETTE)
+            + _png_chunk(b'tRNS', _ALPHA)
+            + _png_chunk(b'IDAT', zlib.compress(raw, level))
+            + _png_chunk(b'IEND', b''))
+
+
+def _linear_range(slope: float, offset: float, low: float, high: float) -> Optional[Tuple[float, float]]:
+    """x-Bereich mit low <= slope * x + offset <= high (None = leer)"""
+    if slope == 0.0:
+        return (-math.inf, math.inf) if low <= offset <= high else None
+    a = (low - offset) / slope
+    b = (high - offset) / slope
+    return (a, b) if a <= b else (b, a)
+
+
+class CoverageRaster:
+    """Abdeckungsraster mit Kachelversionen und PNG-Cache.
+
+    Schreiber: genau ein Prozess (update()/reset(), intern per Lock serialisiert).
+    Leser: attach() im selben oder einem anderen Prozess, nur tile_png()/get_status().
+    """
+
+    def __init__(self, min_x: float, min_y: float, max_x: float, max_y: float,
+                 resolution: float = 0.05, tile_size: int = 256,
+                 origin: Tuple[float, float] = (0.0, 0.0), filepath: str = '',
+                 stamp_width: float = 0.5, max_gap: float = 1.0):
+        """
+        Args:
+            min_x, min_y, max_x, max_y: Abgedeckter Bereich im lokalen Rahmen (m)
+            resolution: Zellgröße (m)
+            tile_size: Kachelkante in Zellen (Breite/Höhe werden darauf aufgerundet)
+            origin: Geodätischer Ursprung (lat, lon) des lokalen Rahmens; eine Datei mit
+                anderem Ursprung oder anderer Geometrie wird neu angelegt
+            filepath: Datei für mmap, leer = Shared Memory (geht beim Beenden verloren)
+            stamp_width: Gestempelte Breite (Schnittbreite, m)
+            max_gap: Größere Sprünge zwischen zwei Positionen werden nicht verbunden (m)
+        """
+        if resolution <= 0 or tile_size <= 0 or max_x <= min_x or max_y <= min_y:
+            raise ValueError("Ungültige Rastergeometrie")
+        tiles_x = math.ceil((max_x - min_x) / resolution / tile_size)
+        tiles_y = math.ceil((max_y - min_y) / resolution / tile_size)
+        self._set_geometry(tiles_x * tile_size, tiles_y * tile_size, tile_size, resolution,
+                           min_x, min_y, origin[0], origin[1])
+        self.writable = True
+        self.filepath = filepath
+        self.stamp_width = stamp_width
+        self.radius = stamp_width / 2.0
+        self.max_gap = max_gap
+
+        self._fd = -1
+        self._map: Optional[mmap.mmap] = None
+        self._shm: Optional[shared_memory.SharedMemory] = None
+        if filepath:
+            self._open_file(filepath)
+        else:
+            self._shm = shared_memory.SharedMemory(create=True, size=self.size)
+            self._bind(self._shm.buf)
+            self._init_header()
+        self.shm_name = self._shm.name if self._shm else ''
+
+        self._lock = threading.Lock()
+        self._ones = memoryview(bytes([CELL_MOWED]) * self.width)
+        self._last: Optional[Tuple[float, float]] = None
+        self.updates = 0
+        self.gaps = 0
+        self.last_update_us = 0.0
+        self.max_update_us = 0.0
+
+    @classmethod
+    def attach(cls, filepath: str = '', shm_name: str = '') -> 'CoverageRaster':
+        """Blendet ein bestehendes Raster nur lesend ein (Web-Prozess)"""
+        raster = cls.__new__(cls)
+        raster.writable = False
+        raster.filepath = filepath
+        raster.shm_name = shm_name
+        raster._fd = -1
+        raster._map = None
+        raster._shm = None
+        if filepath:
+            raster._fd = os.open(filepath, os.O_RDONLY)
+            raster._map = mmap.mmap(raster._fd, 0, access=mmap.ACCESS_READ)
+            buf = memoryview(raster._map)
+        else:
+            raster._shm = shared_memory.SharedMemory(name=shm_name)
+            buf = raster._shm.buf
+        geometry = _GEOMETRY.unpack_from(buf, 0)
+        if geometry[0] != FILE_MAGIC:
+            buf.release()
+            raster.close()
+            raise ValueError("Kein Abdeckungsraster")
+        raster._set_geometry(*geometry[1:])
+        raster._bind(buf)
+        return raster
+
+    @staticmethod
+    def read_origin(filepath: str) -> Optional[Tuple[float, float]]:
+        """Ursprung (lat, lon) einer bestehenden Rasterdatei, None wenn keine gültige Datei"""
+        try:
+            with open(filepath, 'rb') as f:
+                header = f.read(_GEOMETRY.size)
+        except OSError:
+            return None
+        if len(header) < _GEOMETRY.size:
+            return None
+        geometry = _GEOMETRY.unpack(header)
+        if geometry[0] != FILE_MAGIC:
+            return None
+        return geometry[7], geometry[8]
+
+    # ------------------------------------------------------------------
+    # Speicher
+    # ------------------------------------------------------------------
+
+    def _set_geometry(self, width: int, height: int, tile_size: int, resolution: float,
+                      min_x: float, min_y: float, origin_lat: float, origin_lon: float):
+        self.width = width
+        self.height = height
+        self.tile_size = tile_size
+        self.resolution = resolution
+        self.min_x = min_x
+        self.min_y = min_y
+        self.origin = (origin_lat, origin_lon)
+        self.tiles_x = width // tile_size
+        self.tiles_y = height // tile_size
+        self._versions_offset = HEADER_SIZE
+        self._cells_offset = HEADER_SIZE + (self.tiles_x * self.tiles_y * 4 + 7) // 8 * 8
+        self.size = self._cells_offset + width * height
+
+        self._cache_lock = threading.Lock()
+        self._tile_cache: Dict[int, Tuple[Tuple[int, int], bytes]] = {}
+        self._empty_png: Optional[bytes] = None
+        self.tiles_rendered = 0
+        self.cache_hits = 0
+        self.last_render_ms = 0.0
+
+    def _geometry_header(self) -> bytes:
+        return _GEOMETRY.pack(FILE_MAGIC, self.width, self.height, self.tile_size, self.resolution,
+                              self.min_x, self.min_y, self.origin[0], self.origin[1])
+
+    def _open_file(self, filepath: str):
+        self._fd = os.open(filepath, os.O_RDWR | os.O_CREAT, 0o644)
+        existing = os.fstat(self._fd).st_size
+        reuse = existing == self.size and os.pread(self._fd, _GEOMETRY.size, 0) == self._geometry_header()
+        if not reuse:
+            if existing:
+                logger.warning("⚠️  Abdeckungsraster %s passt nicht zu Standort/Geometrie - wird neu angelegt",
+                               filepath)
+            os.ftruncate(self._fd, 0)
+            os.ftruncate(self._fd, self.size)
+        self._map = mmap.mmap(self._fd, self.size)
+        self._bind(memoryview(self._map))
+        if reuse:
+            logger.info("✅ Abdeckungsraster %s geladen (%.1f m² gemäht)", filepath, self.mowed_area)
+        else:
+            self._init_header()
+
+    def _bind(self, buf: memoryview):
+        self._buf = buf
+        self._versions = buf[self._versions_offset:self._versions_offset + self.tiles_x * self.tiles_y * 4].cast('I')
+
+    def _init_header(self):
+        self._buf[:_GEOMETRY.size] = self._geometry_header()
+        _COUNTERS.pack_into(self._buf, _COUNTERS_OFFSET, 0, 0, 0, 0)
+
+    def _counters(self) -> Tuple[int, int, int, int]:
+        return _COUNTERS.unpack_from(self._buf, _COUNTERS_OFFSET)
+
+    @property
+    def epoch(self) -> int:
+        return self._counters()[0]
+
+    @property
+    def mowed_cells(self) -> int:
+        return self._counters()[2]
+
+    @property
+    def mowed_area(self) -> float:
+        return self.mowed_cells * self.resolution * self.resolution
+
+    # ------------------------------------------------------------------
+    # Schreiben
+    # ------------------------------------------------------------------
+
+    def update(self, x: float, y: float, active: bool = True) -> int:
+        """Neue Position; stempelt die Strecke seit der vorigen aktiven Position.
+
+        Args:
+            x, y: Position im lokalen Rahmen (m)
+            active: False (Messer aus, kein RTK) unterbricht die Spur
+
+        Returns:
+            Anzahl neu gemähter Zellen
+        """
+        if not active or not (math.isfinite(x) and math.isfinite(y)):
+            self._last = None
+            return 0
+        started = time.perf_counter()
+        with self._lock:
+            last = self._last
+            if last is not None and math.hypot(x - last[0], y - last[1]) > self.max_gap:
+                self.gaps += 1
+                last = None
+            self._last = (x, y)
+            new = self._stamp(last or (x, y), (x, y))
+        self.updates += 1
+        self.last_update_us = (time.perf_counter() - started) * 1e6
+        if self.last_update_us > self.max_update_us:
+            self.max_update_us = self.last_update_us
+        return new
+
+    def _stamp(self, start: Tuple[float, float], end: Tuple[float, float]) -> int:
+        """Kapsel mit Radius self.radius um start-end, pro Zeile ein Intervall (Kapsel ist konvex)"""
+        x0, y0 = start
+        x1, y1 = end
+        r = self.radius
+        res = self.resolution
+        dx = x1 - x0
+        dy = y1 - y0
+        length_sq = dx * dx + dy * dy
+        length = math.sqrt(length_sq)
+
+        j_low = max(0, math.ceil((min(y0, y1) - r - self.min_y) / res - 0.5))
+        j_high = min(self.height - 1, math.floor((max(y0, y1) + r - self.min_y) / res - 0.5))
+        dirty = set()
+        new = 0
+        for j in range(j_low, j_high + 1):
+            yc = self.min_y + (j + 0.5) * res
+            low = math.inf
+            high = -math.inf
+            for px, py in (start, end):
+                off = yc - py
+                if -r <= off <= r:
+                    half = math.sqrt(r * r - off * off)
+                    low = min(low, px - half)
+                    high = max(high, px + half)
+            if length_sq > 1e-12:
+                # Rechteck: Projektion auf die Strecke in [0, 1], Querabstand in [-r, r]
+                along = _linear_range(dx / length_sq, (-x0 * dx + (yc - y0) * dy) / length_sq, 0.0, 1.0)
+                across = _linear_range(dy / length, (-x0 * dy - (yc - y0) * dx) / length, -r, r)
+                if along and across:
+                    band_low = max(along[0], across[0])
+                    band_high = min(along[1], across[1])
+                    if band_low <= band_high:
+                        low = min(low, band_low)
+                        high = max(high, band_high)
+            if low > high:
+                continue
+            i_low = max(0, math.ceil((low - self.min_x) / res - 0.5))
+            i_high = min(self.width - 1, math.floor((high - self.min_x) / res - 0.5))
+            if i_low <= i_high:
+                new += self._fill_row(j, i_low, i_high, dirty)
+
+        if dirty:
+            for tile in dirty:
+                self._versions[tile] += 1
+            epoch, reserved, mowed, stamps = self._counters()
+            _COUNTERS.pack_into(self._buf, _COUNTERS_OFFSET, epoch, reserved, mowed + new, stamps + 1)
+        return new
+
+    def _fill_row(self, j: int, i_low: int, i_high: int, dirty: set) -> int:
+        """Setzt Zellen einer Zeile, getrennt an Kachelgrenzen (nur Kacheln mit neuen Zellen zählen)"""
+        ts = self.tile_size
+        base = self._cells_offset + j * self.width
+        tile_row = (j // ts) * self.tiles_x
+        buf = self._buf
+        new = 0
+        i = i_low
+        while i <= i_high:
+            end = min(i_high, (i // ts + 1) * ts - 1)
+            count = end - i + 1
+            fresh = buf[base + i:base + end + 1].tobytes().count(CELL_EMPTY)
+            if fresh:
+                buf[base + i:base + end + 1] = self._ones[:count]
+                dirty.add(tile_row + i // ts)
+                new += fresh
+            i = end + 1
+        return new
+
+    def reset(self):
+        """Löscht die Abdeckung (neue Epoche, alle Kacheln leer)"""
+        with self._lock:
+            start = self._cells_offset
+            chunk = bytes(self.width * self.tile_size)
+            for offset in range(start, self.size, len(chunk)):
+                self._buf[offset:offset + len(chunk)] = chunk[:self.size - offset]
+            for tile in range(len(self._versions)):
+                self._versions[tile] = 0
+            epoch = self._counters()[0]
+            _COUNTERS.pack_into(self._buf, _COUNTERS_OFFSET, epoch + 1, 0, 0, 0)
+            self._last = None
+        logger.info("🧹 Abdeckungsraster zurückgesetzt (Epoche %d)", epoch + 1)
+
+    def sync(self):
+        """Schreibt eine Datei-Abbildung auf die SD-Karte"""
+        if self._map is not None and self.writable:
+            self._map.flush()
+
+    # ------------------------------------------------------------------
+    # Lesen
+    # ------------------------------------------------------------------
+
+    def tile_version(self, tx: int, ty: int) -> int:
+        return self._versions[ty * self.tiles_x + tx]
+
+    def tile_png(self, tx: int, ty: int) -> Optional[Tuple[str, bytes]]:
+        """PNG einer Kachel als (ETag, Daten), None außerhalb des Rasters"""
+        if not (0 <= tx < self.tiles_x and 0 <= ty < self.tiles_y):
+            return None
+        index = ty * self.tiles_x + tx
+        # Version vor den Zellen lesen: ein gleichzeitiger Stempel erhöht sie danach erneut
+        key = (self.epoch, self._versions[index])
+        etag = f"{key[0]}-{key[1]}"
+        with self._cache_lock:
+            if key[1] == 0:
+                if self._empty_png is None:
+                    self._empty_png = encode_png([bytes(self.tile_size)] * self.tile_size, self.tile_size)
+                self.cache_hits += 1
+                return etag, self._empty_png
+            cached = self._tile_cache.get(index)
+            if cached and cached[0] == key:
+                self.cache_hits += 1
+                return etag, cached[1]
+
+        started = time.perf_counter()
+        ts = self.tile_size
+        rows = []
+        for j in range((ty + 1) * ts - 1, ty * ts - 1, -1):  # Norden oben
+            offset = self._cells_offset + j * self.width + tx * ts
+            rows.append(self._buf[offset:offset + ts])
+        png = encode_png(rows, ts)
+        with self._cache_lock:
+            self._tile_cache[index] = (key, png)
+            self.tiles_rendered += 1
+            self.last_render_ms = (time.perf_counter() - started) * 1000.0
+        return etag, png
+
+    def tile_versions(self) -> List[List[int]]:
+        """[tx, ty, version] aller Kacheln mit Abdeckung"""
+        tiles_x = self.tiles_x
+        return [[index % tiles_x, index // tiles_x, version]
+                for index, version in enumerate(self._versions) if version]
+
+    def get_status(self) -> Dict[str, Any]:
+        epoch, _, mowed, stamps = self._counters()
+        return {
+            'epoch': epoch,
+            'resolution': self.resolution,
+            'tile_size': self.tile_size,
+            'tiles': [self.tiles_x, self.tiles_y],
+            'size': [self.width, self.height],
+            'extent': [self.min_x, self.min_y,
+                       self.min_x + self.width * self.resolution, self.min_y + self.height * self.resolution],
+            'origin': {'lat': self.origin[0], 'lon': self.origin[1]},
+            'stamp_width': self.stamp_width if self.writable else None,
+            'mowed_cells': mowed,
+            'mowed_area': round(mowed * self.resolution * self.resolution, 2),
+            'stamps': stamps,
+            'updates': self.updates if self.writable else None,
+            'gaps': self.gaps if self.writable else None,
+            'last_update_us': round(self.last_update_us, 1) if self.writable else None,
+            'max_update_us': round(self.max_update_us, 1) if self.writable else None,
+            'tiles_rendered': self.tiles_rendered,
+            'cache_hits': self.cache_hits,
+            'last_render_ms': round(self.last_render_ms, 2),
+            'file': self.filepath or None,
+            'memory_mb': round(self.size / (1 << 20), 2),
+        }
+
+    def close(self):
+        """Gibt die Abbildung frei; der Schreiber entfernt zusätzlich das Shared-Memory-Segment"""
+        if getattr(self, '_versions', None) is not None:
+            self._versions.release()
+            self._versions = None
+        if getattr(self, '_buf', None) is not None:
+            self._buf.release()
+            self._buf = None
+        if self._map is not None:
+            if self.writable:
+                self._map.flush()
+            self._map.close()
+            self._map = None
+        if self._fd >= 0:
+            os.close(self._fd)
+            self._fd = -1
+        if self._shm is not None:
+            self._shm.close()
+            if self.writable:
+                try:
+                    self._shm.unlink()
+                except FileNotFoundError:
+                    pass
+            self._shm = None
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Geodesy - Lokaler ENU-Rahmen (Ost/Nord/Oben) um einen festen Ursprung pro Standort
+WGS84 -> ECEF -> ENU mit vorberechneter Trigonometrie des Ursprungs
+"""
+
+import math
+from typing import Optional, Tuple
+
+WGS84_A = 6378137.0
+WGS84_F = 1.0 / 298.257223563
+WGS84_E2 = WGS84_F * (2.0 - WGS84_F)
+WGS84_B = WGS84_A * (1.0 - WGS84_F)
+WGS84_EP2 = (WGS84_A ** 2 - WGS84_B ** 2) / WGS84_B ** 2
+
+
+def geodetic_to_ecef(lat: float, lon: float, alt: float = 0.0) -> Tuple[float, float, float]:
+    """WGS84 (Grad, m) -> ECEF (m)"""
+    phi = math.radians(lat)
+    lam = math.radians(lon)
+    sin_phi = math.sin(phi)
+    cos_phi = math.cos(phi)
+    n = WGS84_A / math.sqrt(1.0 - WGS84_E2 * sin_phi * sin_phi)
+    return ((n + alt) * cos_phi * math.cos(lam),
+            (n + alt) * cos_phi * math.sin(lam),
+            (n * (1.0 - WGS84_E2) + alt) * sin_phi)
+
+
+def ecef_to_geodetic(x: float, y: float, z: float) -> Tuple[float, float, float]:
+    """ECEF (m) -> WGS84 (Grad, m), geschlossene Lösung nach Bowring"""
+    p = math.hypot(x, y)
+    theta = math.atan2(z * WGS84_A, p * WGS84_B)
+    sin_t = math.sin(theta)
+    cos_t = math.cos(theta)
+    phi = math.atan2(z + WGS84_EP2 * WGS84_B * sin_t ** 3, p - WGS84_E2 * WGS84_A * cos_t ** 3)
+    sin_phi = math.sin(phi)
+    n = WGS84_A / math.sqrt(1.0 - WGS84_E2 * sin_phi * sin_phi)
+    cos_phi = math.cos(phi)
+    if abs(cos_phi) > 1e-12:
+        alt = p / cos_phi - n
+    else:
+        alt = abs(z) - WGS84_B
+    return math.degrees(phi), math.degrees(math.atan2(y, x)), alt
+
+
+class LocalFrame:
+    """
+    ENU-Tangentialebene um einen festen Ursprung
+
+    Sinus/Kosinus des Ursprungs und dessen ECEF-Position werden einmal berechnet;
+    pro Fix bleiben eine ECEF-Umrechnung und eine 3x3-Rotation.
+    """
+
+    def __init__(self, origin_lat: float, origin_lon: float, origin_alt: float = 0.0):
+        self.origin_lat = origin_lat
+        self.origin_lon = origin_lon
+        self.origin_alt = origin_alt
+
+        phi = math.radians(origin_lat)
+        lam = math.radians(origin_lon)
+        self._sin_phi = math.sin(phi)
+        self._cos_phi = math.cos(phi)
+        self._sin_lam = math.sin(lam)
+        self._cos_lam = math.cos(lam)
+        self._x0, self._y0, self._z0 = geodetic_to_ecef(origin_lat, origin_lon, origin_alt)
+
+    def to_enu(self, lat: float, lon: float, alt: Optional[float] = None) -> Tuple[float, float, float]:
+        """WGS84 -> (Ost, Nord, Oben) in m; ohne Höhe wird die Ursprungshöhe angenommen"""
+        x, y, z = geodetic_to_ecef(lat, lon, self.origin_alt if alt is None else alt)
+        dx = x - self._x0
+        dy = y - self._y0
+        dz = z - self._z0
+        sin_phi, cos_phi, sin_lam, cos_lam = self._sin_phi, self._cos_phi, self._sin_lam, self._cos_lam
+        east = -sin_lam * dx + cos_lam * dy
+        north = -sin_phi * cos_lam * dx - sin_phi * sin_lam * dy + cos_phi * dz
+        up = cos_phi * cos_lam * dx + cos_phi * sin_lam * dy + sin_phi * dz
+        return east, north, up
+
+    def to_local(self, lat: float, lon: float) -> Tuple[float, float]:
+        """WGS84 -> (x = Ost, y = Nord) in m"""
+        east, north, _ = self.to_enu(lat, lon)
+        return east, north
+
+    def from_enu(self, east: float, north: float, up: float = 0.0) -> Tuple[float, float, float]:
+        """(Ost, Nord, Oben) in m -> WGS84 (Grad, m)"""
+        sin_phi, cos_phi, sin_lam, cos_lam = self._sin_phi, self._cos_phi, self._sin_lam, self._cos_lam
+        dx = -sin_lam * east - sin_phi * cos_lam * north + cos_phi * cos_lam * up
+        dy = cos_lam * east - sin_phi * sin_lam * north + cos_phi * sin_lam * up
+        dz = cos_phi * north + sin_phi * up
+        return ecef_to_geodetic(self._x0 + dx, self._y0 + dy, self._z0 + dz)
+
+    def to_dict(self) -> dict:
+        return {'lat': self.origin_lat, 'lon': self.origin_lon, 'alt': self.origin_alt}
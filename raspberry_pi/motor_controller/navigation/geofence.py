@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""
+Geofence - Mähgrenzen und No-Go-Zonen mit räumlichem Index im lokalen Rahmen
+Horizontale Bänder für Point-in-Polygon, gleichmäßiges Gitter für nächste Kante
+"""
+
+import math
+from array import array
+from typing import Dict, List, NamedTuple, Optional, Sequence, Set, Tuple
+
+from .area_calculator import Point, Polygon
+
+ZONE_BOUNDARY = 0  # Außenkontur und Löcher der Mähfläche (Even-Odd)
+ZONE_NO_GO = 1     # Gesperrte Bereiche (innen = verboten)
+
+
+class NearestEdge(NamedTuple):
+    """Nächste Kante zu einem Punkt"""
+    distance: float
+    edge: int
+    zone: int
+    x: float  # Fußpunkt auf der Kante
+    y: float
+
+
+class GeofenceStatus(NamedTuple):
+    """Ergebnis einer Positionsprüfung"""
+    inside: bool           # in der Mähfläche und in keiner No-Go-Zone
+    distance: float        # Abstand zur nächsten Grenze (m), inf ohne Grenzen
+    zone: Optional[int]    # Zonentyp der nächsten Grenze
+
+
+class Geofence:
+    """
+    Räumlicher Index über alle Grenzkanten
+
+    - Bänder der Höhe cell_size enthalten die Kanten, die das Band schneiden;
+      ein Point-in-Polygon-Test prüft nur die Kanten seines Bandes
+    - Gitterzellen cell_size × cell_size enthalten die Kanten, deren Bounding-Box
+      sie berühren; pro Zelle wird einmal per Ringsuche die Kandidatenliste für die
+      nächste Kante bestimmt und zwischengespeichert
+    """
+
+    def __init__(self, boundary: Sequence[Polygon] = (), no_go: Sequence[Polygon] = (), cell_size: float = 1.0):
+        """
+        Args:
+            boundary: Außenkontur + Löcher der Mähfläche
+            no_go: Gesperrte Bereiche
+            cell_size: Band-/Zellgröße in m (etwa die typische Kantenlänge)
+        """
+        self.cell_size = cell_size
+        self._x0 = array('d')
+        self._y0 = array('d')
+        self._x1 = array('d')
+        self._y1 = array('d')
+        self._zone = array('B')
+
+        for ring in boundary:
+            self._add_ring(ring, ZONE_BOUNDARY)
+        for ring in no_go:
+            self._add_ring(ring, ZONE_NO_GO)
+        self.has_boundary = any(zone == ZONE_BOUNDARY for zone in self._zone)
+
+        self._build_index()
+
+    def _add_ring(self, ring: Polygon, zone: int):
+        if len(ring) < 3:
+            return
+        x_prev, y_prev = ring[-1]
+        for x, y in ring:
+            if (x, y) != (x_prev, y_prev):
+                self._x0.append(x_prev)
+                self._y0.append(y_prev)
+                self._x1.append(x)
+                self._y1.append(y)
+                self._zone.append(zone)
+            x_prev, y_prev = x, y
+
+    def _build_index(self):
+        n = len(self._zone)
+        if n == 0:
+            self.min_x = self.min_y = self.max_x = self.max_y = 0.0
+            self._bands: List[List[int]] = []
+            self._grid: Dict[Tuple[int, int], List[int]] = {}
+            self._candidate_cache: Dict[Tuple[int, int], List[int]] = {}
+            return
+
+        self.min_x = min(min(self._x0), min(self._x1))
+        self.max_x = max(max(self._x0), max(self._x1))
+        self.min_y = min(min(self._y0), min(self._y1))
+        self.max_y = max(max(self._y0), max(self._y1))
+
+        size = self.cell_size
+        band_count = int((self.max_y - self.min_y) / size) + 1
+        self._bands = [[] for _ in range(band_count)]
+        self._grid = {}
+        self._candidate_cache = {}
+        for edge in range(n):
+            x0, y0, x1, y1 = self._x0[edge], self._y0[edge], self._x1[edge], self._y1[edge]
+            if y0 != y1:
+                first = int((min(y0, y1) - self.min_y) / size)
+                last = int((max(y0, y1) - self.min_y) / size)
+                for band in range(first, min(last, band_count - 1) + 1):
+                    self._bands[band].append(edge)
+            for cx in range(self._cell(min(x0, x1), self.min_x), self._cell(max(x0, x1), self.min_x) + 1):
+                for cy in range(self._cell(min(y0, y1), self.min_y), self._cell(max(y0, y1), self.min_y) + 1):
+                    self._grid.setdefault((cx, cy), []).append(edge)
+
+    def _cell(self, value: float, origin: float) -> int:
+        return int(math.floor((value - origin) / self.cell_size))
+
+    def contains(self, x: float, y: float) -> bool:
+        """True wenn (x, y) in der Mähfläche und in keiner No-Go-Zone liegt"""
+        if not self.has_boundary or not (self.min_x <= x <= self.max_x and self.min_y <= y <= self.max_y):
+            return False
+
+        band = int((y - self.min_y) / self.cell_size)
+        if band >= len(self._bands):
+            return False
+
+        x0s, y0s, x1s, y1s, zones = self._x0, self._y0, self._x1, self._y1, self._zone
+        parity = [False, False]
+        for edge in self._bands[band]:
+            y0 = y0s[edge]
+            y1 = y1s[edge]
+            if (y0 > y) != (y1 > y):
+                x0 = x0s[edge]
+                if x < x0 + (y - y0) * (x1s[edge] - x0) / (y1 - y0):
+                    zone = zones[edge]
+                    parity[zone] = not parity[zone]
+        return parity[ZONE_BOUNDARY] and not parity[ZONE_NO_GO]
+
+    def _segment_candidates(self, x0: float, y0: float, x1: float, y1: float) -> Set[int]:
+        """Kanten aus allen Gitterzellen, die die Strecke überstreicht (spaltenweise)"""
+        edges = set()
+        grid = self._grid
+        size = self.cell_size
+        min_x = self.min_x
+        min_y = self.min_y
+        if x1 < x0:
+            x0, y0, x1, y1 = x1, y1, x0, y0
+        dx = x1 - x0
+        slope = (y1 - y0) / dx if dx else 0.0
+        for cx in range(int(math.floor((x0 - min_x) / size)), int(math.floor((x1 - min_x) / size)) + 1):
+            if dx:
+                # y-Bereich der Strecke innerhalb der Spalte
+                ya = y0 + (max(x0, min_x + cx * size) - x0) * slope
+                yb = y0 + (min(x1, min_x + (cx + 1) * size) - x0) * slope
+            else:
+                ya, yb = y0, y1
+            if ya > yb:
+                ya, yb = yb, ya
+            for cy in range(int(math.floor((ya - min_y) / size)), int(math.floor((yb - min_y) / size)) + 1):
+                cell = grid.get((cx, cy))
+                if cell:
+                    edges.update(cell)
+        return edges
+
+    def segment_inside(self, x0: float, y0: float, x1: float, y1: float, eps: float = 1e-9) -> bool:
+        """
+        True wenn die Strecke vollständig in der Mähfläche und außerhalb aller No-Go-Zonen liegt
+
+        Die Grenze selbst zählt als innen (Streifenenden bei edge_margin 0, Wenden entlang
+        der Kontur). Ohne Schnitt im Inneren der Strecke entscheidet der Mittelpunkt.
+        """
+        dx = x1 - x0
+        dy = y1 - y0
+        x0s, y0s, x1s, y1s = self._x0, self._y0, self._x1, self._y1
+        for edge in self._segment_candidates(x0, y0, x1, y1):
+            ex = x1s[edge] - x0s[edge]
+            ey = y1s[edge] - y0s[edge]
+            denom = dx * ey - dy * ex
+            if abs(denom) <= 1e-9 * math.hypot(dx, dy) * math.hypot(ex, ey):
+                continue  # (nahezu) parallel: höchstens Fahrt entlang der Grenze
+            qx = x0s[edge] - x0
+            qy = y0s[edge] - y0
+            t = (qx * ey - qy * ex) / denom   # auf der Strecke
+            u = (qx * dy - qy * dx) / denom   # auf der Kante
+            if eps < t < 1.0 - eps and -eps <= u <= 1.0 + eps:
+                return False
+        mx = (x0 + x1) / 2.0
+        my = (y0 + y1) / 2.0
+        return self.contains(mx, my) or self.nearest_edge(mx, my, max_distance=1e-6) is not None
+
+    def _edge_distance(self, edge: int, x: float, y: float) -> Tuple[float, float, float]:
+        x0, y0 = self._x0[edge], self._y0[edge]
+        dx = self._x1[edge] - x0
+        dy = self._y1[edge] - y0
+        length2 = dx * dx + dy * dy
+        t = ((x - x0) * dx + (y - y0) * dy) / length2 if length2 else 0.0
+        t = 0.0 if t < 0.0 else 1.0 if t > 1.0 else t
+        px = x0 + t * dx
+        py = y0 + t * dy
+        return (px - x) * (px - x) + (py - y) * (py - y), px, py
+
+    def _ring_cells(self, cx: int, cy: int, ring: int):
+        for gx in range(cx - ring, cx + ring + 1):
+            if gx in (cx - ring, cx + ring):
+                for gy in range(cy - ring, cy + ring + 1):
+                    yield gx, gy
+            else:
+                yield gx, cy - ring
+                yield gx, cy + ring
+
+    def _candidates(self, cx: int, cy: int) -> List[int]:
+        """
+        Kanten, die für irgendeinen Punkt der Zelle die nächste sein können (einmal pro Zelle)
+
+        Für p in der Zelle gilt |d(p, e) - d(Mitte, e)| <= halbe Diagonale, also genügen
+        alle Kanten mit d(Mitte, e) <= min d(Mitte, ·) + Diagonale.
+        """
+        key = (cx, cy)
+        cached = self._candidate_cache.get(key)
+        if cached is not None:
+            return cached
+
+        size = self.cell_size
+        mx = self.min_x + (cx + 0.5) * size
+        my = self.min_y + (cy + 0.5) * size
+        diagonal = size * math.sqrt(2.0)
+        max_ring = max(self._cell(self.max_x, self.min_x), self._cell(self.max_y, self.min_y)) + 1
+
+        distances: Dict[int, float] = {}
+        best = math.inf
+        ring = 0
+        while ring <= max_ring:
+            for cell in self._ring_cells(cx, cy, ring):
+                for edge in self._grid.get(cell, ()):
+                    if edge not in distances:
+                        d = math.sqrt(self._edge_distance(edge, mx, my)[0])
+                        distances[edge] = d
+                        best = min(best, d)
+            # Zellen ab Ring ring+1 sind mindestens (ring + 0.5) * size von der Mitte entfernt
+            if (ring + 0.5) * size > best + diagonal:
+                break
+            ring += 1
+
+        candidates = [edge for edge, d in distances.items() if d <= best + diagonal]
+        self._candidate_cache[key] = candidates
+        return candidates
+
+    def nearest_edge(self, x: float, y: float, max_distance: float = math.inf) -> Optional[NearestEdge]:
+        """Nächste Grenzkante (Mähgrenze oder No-Go) innerhalb von max_distance"""
+        if not self._zone:
+            return None
+
+        if self.min_x <= x <= self.max_x and self.min_y <= y <= self.max_y:
+            edges = self._candidates(self._cell(x, self.min_x), self._cell(y, self.min_y))
+        else:
+            # Außerhalb des Index (selten, ohnehin ein Alarmfall): alle Kanten prüfen
+            edges = range(len(self._zone))
+
+        best = (math.inf, -1, 0.0, 0.0)
+        for edge in edges:
+            d2, px, py = self._edge_distance(edge, x, y)
+            if d2 < best[0]:
+                best = (d2, edge, px, py)
+
+        distance = math.sqrt(best[0])
+        if best[1] < 0 or distance > max_distance:
+            return None
+        return NearestEdge(distance, best[1], self._zone[best[1]], best[2], best[3])
+
+    def check(self, x: float, y: float) -> GeofenceStatus:
+        """Point-in-Geofence plus Abstand zur nächsten Grenze"""
+        nearest = self.nearest_edge(x, y)
+        if nearest is None:
+            return GeofenceStatus(self.contains(x, y), math.inf, None)
+        return GeofenceStatus(self.contains(x, y), nearest.distance, nearest.zone)
+
+    def get_stats(self) -> dict:
+        return {
+            'edges': len(self._zone),
+            'bands': len(self._bands),
+            'grid_cells': len(self._grid),
+            'cached_cells': len(self._candidate_cache),
+            'cell_size': self.cell_size,
+            'extent': [self.min_x, self.min_y, self.max_x, self.max_y],
+        }
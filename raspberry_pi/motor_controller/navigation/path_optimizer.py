@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+Path Optimizer - Reihenfolge und Einfahrrichtung der Mähzellen
+Minimiert die Transferwege zwischen den Zellen (Greedy + 2-opt + DP über Varianten)
+"""
+
+import math
+import time
+from typing import List, Optional, Sequence, Tuple
+
+Point = Tuple[float, float]
+# Variante einer Zelle: (Einfahrpunkt, Ausfahrpunkt)
+Variant = Tuple[Point, Point]
+
+
+def _dist(a: Point, b: Point) -> float:
+    return math.hypot(a[0] - b[0], a[1] - b[1])
+
+
+def _reverse_variants(variants: Sequence[Variant]) -> List[int]:
+    """Index der Variante, die dieselbe Zelle in Gegenrichtung befährt (sonst die Variante selbst)"""
+    reverse = []
+    for index, (entry, exit_) in enumerate(variants):
+        match = index
+        for other, (other_entry, other_exit) in enumerate(variants):
+            if other_entry == exit_ and other_exit == entry:
+                match = other
+                break
+        reverse.append(match)
+    return reverse
+
+
+def best_variants(order: Sequence[int], cells: Sequence[Sequence[Variant]], start: Optional[Point]) -> Tuple[List[int], float]:
+    """
+    Optimale Variante pro Zelle bei fester Reihenfolge (Viterbi, O(n·v²))
+
+    Returns:
+        (Variante pro Position in order, Summe der Transferwege)
+    """
+    if not order:
+        return [], 0.0
+
+    first = cells[order[0]]
+    costs = [_dist(start, entry) if start is not None else 0.0 for entry, _ in first]
+    back: List[List[int]] = []
+
+    for previous_cell, cell_index in zip(order, order[1:]):
+        previous = cells[previous_cell]
+        current = cells[cell_index]
+        new_costs = []
+        pointers = []
+        for entry, _ in current:
+            best = math.inf
+            best_u = 0
+            for u, (_, exit_) in enumerate(previous):
+                cost = costs[u] + _dist(exit_, entry)
+                if cost < best:
+                    best = cost
+                    best_u = u
+            new_costs.append(best)
+            pointers.append(best_u)
+        costs = new_costs
+        back.append(pointers)
+
+    variant = min(range(len(costs)), key=costs.__getitem__)
+    total = costs[variant]
+    chosen = [variant]
+    for pointers in reversed(back):
+        variant = pointers[variant]
+        chosen.append(variant)
+    chosen.reverse()
+    return chosen, total
+
+
+def optimize_cell_order(cells: Sequence[Sequence[Variant]], start: Optional[Point] = None,
+                        time_budget: float = 0.05) -> Tuple[List[int], List[int], float]:
+    """
+    Bestimmt Reihenfolge und Variante der Zellen
+
+    Args:
+        cells: Pro Zelle die möglichen (Einfahrt, Ausfahrt)-Varianten
+        start: Aktuelle Position (None = beliebiger Start)
+        time_budget: Maximale Zeit für die 2-opt-Verbesserung (s)
+
+    Returns:
+        (Reihenfolge, Variante pro Position, Summe der Transferwege)
+    """
+    n = len(cells)
+    if n == 0:
+        return [], [], 0.0
+
+    reverse = [_reverse_variants(variants) for variants in cells]
+
+    # Greedy: jeweils die nächste Einfahrt vom aktuellen Ausfahrpunkt
+    remaining = set(range(n))
+    order: List[int] = []
+    variants: List[int] = []
+    position = start
+    while remaining:
+        best = None
+        best_cost = math.inf
+        for cell_index in remaining:
+            for v, (entry, _) in enumerate(cells[cell_index]):
+                cost = _dist(position, entry) if position is not None else 0.0
+                if cost < best_cost:
+                    best_cost = cost
+                    best = (cell_index, v)
+        cell_index, v = best
+        remaining.discard(cell_index)
+        order.append(cell_index)
+        variants.append(v)
+        position = cells[cell_index][v][1]
+
+    # 2-opt: Segment umkehren = Zellen in umgekehrter Reihenfolge und Gegenrichtung befahren
+    deadline = time.perf_counter() + time_budget
+    improved = True
+    while improved and time.perf_counter() < deadline:
+        improved = False
+        for i in range(n - 1):
+            before = start if i == 0 else cells[order[i - 1]][variants[i - 1]][1]
+            entry_i = cells[order[i]][variants[i]][0]
+            for j in range(i + 1, n):
+                exit_j = cells[order[j]][variants[j]][1]
+                after = cells[order[j + 1]][variants[j + 1]][0] if j + 1 < n else None
+
+                old = (_dist(before, entry_i) if before is not None else 0.0) + \
+                      (_dist(exit_j, after) if after is not None else 0.0)
+                # Nach der Umkehr: Einfahrt über den alten Ausfahrpunkt von j, Ausfahrt über die alte Einfahrt von i
+                new = (_dist(before, exit_j) if before is not None else 0.0) + \
+                      (_dist(entry_i, after) if after is not None else 0.0)
+                if new < old - 1e-9:
+                    segment = [(order[k], reverse[order[k]][variants[k]]) for k in range(j, i - 1, -1)]
+                    for offset, (cell_index, v) in enumerate(segment):
+                        order[i + offset] = cell_index
+                        variants[i + offset] = v
+                    entry_i = cells[order[i]][variants[i]][0]
+                    improved = True
+            if time.perf_counter() >= deadline:
+                break
+
+    variants, total = best_variants(order, cells, start)
+    return order, variants, total
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+Site - Standort mit festem ENU-Ursprung, Mähgrenzen und No-Go-Zonen
+Jeder RTK-Fix wird einmal in lokale Meter umgerechnet und gegen den Geofence geprüft
+"""
+
+import json
+import logging
+import math
+import time
+from typing import Any, Dict, List, NamedTuple, Optional
+
+from .geodesy import LocalFrame
+from .geofence import Geofence, ZONE_NO_GO
+
+
+class SitePosition(NamedTuple):
+    """Letzte Position im lokalen Rahmen inkl. Geofence-Ergebnis"""
+    x: float
+    y: float
+    lat: float
+    lon: float
+    inside: bool
+    boundary_distance: float
+    near_no_go: bool
+    timestamp: float
+
+
+class Site:
+    """
+    Standort-Datei (JSON, Koordinaten als [lat, lon]):
+
+        {"origin": {"lat": .., "lon": .., "alt": ..},      # optional, sonst erster Punkt
+         "boundary": [[[lat, lon], ...], ...],              # Außenkontur + Löcher
+         "no_go": [[[lat, lon], ...], ...]}                 # optional
+    """
+
+    def __init__(self, origin: LocalFrame, boundary_latlon: List[List[List[float]]] = (),
+                 no_go_latlon: List[List[List[float]]] = (), cell_size: float = 1.0, name: str = ''):
+        self.logger = logging.getLogger(__name__)
+        self.name = name
+        self.frame = origin
+        self.boundary = [[origin.to_local(lat, lon) for lat, lon in ring] for ring in boundary_latlon]
+        self.no_go = [[origin.to_local(lat, lon) for lat, lon in ring] for ring in no_go_latlon]
+        self.geofence = Geofence(self.boundary, self.no_go, cell_size=cell_size)
+
+        # Nur der CAN-Reader schreibt; Leser bekommen die Referenz auf ein unveränderliches Tupel
+        self.position: Optional[SitePosition] = None
+        self.updates = 0
+        self.last_update_us = 0.0
+
+    @classmethod
+    def from_file(cls, filepath: str, cell_size: float = 1.0) -> 'Site':
+        """Lädt eine Standort-Datei"""
+        with open(filepath, 'r') as f:
+            data = json.load(f)
+        return cls.from_dict(data, cell_size=cell_size)
+
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any], cell_size: float = 1.0) -> 'Site':
+        boundary = data.get('boundary', [])
+        origin = data.get('origin')
+        if origin:
+            frame = LocalFrame(origin['lat'], origin['lon'], origin.get('alt', 0.0))
+        elif boundary and boundary[0]:
+            frame = LocalFrame(boundary[0][0][0], boundary[0][0][1])
+        else:
+            raise ValueError("Standort braucht 'origin' oder 'boundary'")
+        return cls(frame, boundary, data.get('no_go', []), cell_size=cell_size, name=data.get('name', ''))
+
+    def update(self, lat: float, lon: float, timestamp: Optional[float] = None) -> SitePosition:
+        """Rechnet einen Fix um und prüft ihn gegen den Geofence"""
+        started = time.perf_counter()
+        x, y = self.frame.to_local(lat, lon)
+        status = self.geofence.check(x, y)
+        position = SitePosition(
+            x=x,
+            y=y,
+            lat=lat,
+            lon=lon,
+            inside=status.inside,
+            boundary_distance=status.distance,
+            near_no_go=status.zone == ZONE_NO_GO,
+            timestamp=time.time() if timestamp is None else timestamp
+        )
+        self.position = position
+        self.updates += 1
+        self.last_update_us = (time.perf_counter() - started) * 1e6
+        return position
+
+    def update_from_sensor(self, data: Dict[str, Any]) -> Optional[SitePosition]:
+        """Übernimmt lat/lon aus den Sensor-Daten des Sensor Hubs (build_telemetry_payload)"""
+        gps = data.get('gps')
+        if not gps or data.get('rtk_status', 'NO GPS') == 'NO GPS':
+            return None
+        lat = gps.get('lat')
+        lon = gps.get('lon')
+        if not lat or not lon:
+            return None
+        return self.update(lat, lon, data.get('timestamp'))
+
+    def get_status(self) -> Dict[str, Any]:
+        position = self.position
+        result: Dict[str, Any] = {
+            'name': self.name,
+            'origin': self.frame.to_dict(),
+            'geofence': self.geofence.get_stats(),
+            'updates': self.updates,
+            'last_update_us': round(self.last_update_us, 1),
+            'position': None,
+        }
+        if position:
+            result['position'] = {
+                'x': round(position.x, 3),
+                'y': round(position.y, 3),
+                'inside': position.inside,
+                'boundary_distance': round(position.boundary_distance, 3)
+                if math.isfinite(position.boundary_distance) else None,
+                'near_no_go': position.near_no_go,
+                'age': round(time.time() - position.timestamp, 2),
+            }
+        return result
@@ -0,0 +1,348 @@
+#!/usr/bin/env python3
+"""
+Waypoint Planner - Flächendeckende Mähbahnen (Boustrophedon) für Polygone mit Hindernissen
+Streifen per Sweep-Line, Zerlegung in Zellen, optimierte Zellreihenfolge,
+Transfers um Hindernisse herum (Sichtbarkeitsgraph)
+"""
+
+import heapq
+import math
+import time
+from typing import Dict, List, NamedTuple, Optional, Sequence, Tuple
+
+from .area_calculator import Point, Polygon, area_with_holes, min_width_angle
+from .geofence import Geofence
+from .path_optimizer import optimize_cell_order
+
+# Streifen im gedrehten Rahmen: (y, x_start, x_end)
+Stripe = Tuple[float, float, float]
+
+
+class Waypoint(NamedTuple):
+    """Wegpunkt im lokalen Rahmen; mowing bezieht sich auf das Segment zum Punkt hin"""
+    x: float
+    y: float
+    mowing: bool
+
+
+class CoveragePlan(NamedTuple):
+    """Ergebnis der Bahnplanung"""
+    waypoints: List[Waypoint]
+    cells: int
+    stripes: int
+    area: float            # Mähfläche laut Polygon (m²)
+    covered_area: float    # Von Streifen überdeckte Fläche (m²)
+    mow_length: float      # Fahrstrecke mit Mähwerk (m)
+    transit_length: float  # Transferstrecke zwischen Zellen (m)
+    stripe_angle: float    # Streifenrichtung (Grad, mathematisch ab Ost)
+    planning_ms: float
+
+
+class CoveragePlanner:
+    """
+    Boustrophedon-Planer für Mähflächen
+
+    Ablauf:
+    1. Drehung, sodass die Streifen parallel zur x-Achse liegen
+    2. Sweep-Line mit aktiver Kantenliste: pro Streifen nur die gerade geschnittenen Kanten
+    3. Zellen = Folgen von Streifenintervallen mit eindeutiger Überlappung zum Nachbarstreifen
+    4. Reihenfolge und Einfahrrichtung der Zellen über den Path Optimizer
+    5. Transfers, die ein Loch/No-Go schneiden oder die Fläche verlassen, laufen über
+       nach innen versetzte Eckpunkte der Konturen (kürzester Weg im Sichtbarkeitsgraph)
+    """
+
+    def __init__(self, cutting_width: float = 0.5, overlap: float = 0.05, edge_margin: float = 0.0,
+                 min_stripe_length: float = 0.2, time_budget: float = 0.05,
+                 transit_clearance: Optional[float] = None):
+        """
+        Args:
+            cutting_width: Schnittbreite des Mähwerks (m)
+            overlap: Überlappung benachbarter Streifen (m)
+            edge_margin: Abstand der Streifenenden zur Kontur (m)
+            min_stripe_length: Kürzere Streifenstücke werden verworfen (m)
+            time_budget: Zeit für die Optimierung der Zellreihenfolge (s)
+            transit_clearance: Abstand der Umfahrungspunkte zu den Ecken (m, None = halbe Schnittbreite)
+        """
+        if cutting_width <= overlap:
+            raise ValueError("Schnittbreite muss größer als die Überlappung sein")
+        self.cutting_width = cutting_width
+        self.overlap = overlap
+        self.spacing = cutting_width - overlap
+        self.edge_margin = edge_margin
+        self.min_stripe_length = min_stripe_length
+        self.time_budget = time_budget
+        self.transit_clearance = cutting_width / 2.0 if transit_clearance is None else transit_clearance
+
+    def plan(self, outer: Polygon, holes: Sequence[Polygon] = (), angle: Optional[float] = None,
+             start: Optional[Point] = None) -> CoveragePlan:
+        """
+        Plant die Mähbahnen
+
+        Args:
+            outer: Außenkontur [(x, y), ...] in Metern
+            holes: Hindernisse/No-Go-Bereiche als Polygone
+            angle: Streifenrichtung in Grad (None = Richtung mit den wenigsten Streifen)
+            start: Aktuelle Position für die Wahl der ersten Zelle (z.B. beim Neuplanen)
+        """
+        started = time.perf_counter()
+        if len(outer) < 3:
+            raise ValueError("Außenkontur braucht mindestens 3 Punkte")
+
+        theta = min_width_angle(outer) if angle is None else math.radians(angle)
+        cos_t = math.cos(theta)
+        sin_t = math.sin(theta)
+
+        def to_rotated(p: Point) -> Point:
+            return (p[0] * cos_t + p[1] * sin_t, -p[0] * sin_t + p[1] * cos_t)
+
+        def to_world(x: float, y: float) -> Point:
+            return (x * cos_t - y * sin_t, x * sin_t + y * cos_t)
+
+        rings = [[to_rotated(p) for p in outer]] + [[to_rotated(p) for p in hole] for hole in holes if len(hole) >= 3]
+        rows = self._sweep(rings)
+        cells = self._decompose(rows)
+
+        # Varianten pro Zelle: Start am ersten/letzten Streifen × links/rechts
+        cell_variants = []
+        for cell in cells:
+            variants = []
+            for first in (True, False):
+                for low in (True, False):
+                    entry, exit_ = self._cell_endpoints(cell, first, low)
+                    variants.append((to_world(*entry), to_world(*exit_)))
+            cell_variants.append(variants)
+
+        order, chosen, _ = optimize_cell_order(cell_variants, start, self.time_budget)
+
+        rings = [list(outer)] + [list(hole) for hole in holes if len(hole) >= 3]
+        router = _TransitRouter(rings, self.transit_clearance)
+
+        waypoints: List[Waypoint] = []
+        mow_length = 0.0
+        stripe_length = 0.0
+        transit_length = 0.0
+        previous: Optional[Point] = start
+        for cell_index, variant in zip(order, chosen):
+            first, low = variant < 2, variant % 2 == 0
+            stripes = cells[cell_index] if first else cells[cell_index][::-1]
+            for number, (y, x0, x1) in enumerate(stripes):
+                forward = low if number % 2 == 0 else not low
+                a = to_world(x0 if forward else x1, y)
+                b = to_world(x1 if forward else x0, y)
+                # Erster Punkt der Zelle wird per Transfer angefahren, Wende innerhalb der Zelle mäht
+                if number == 0:
+                    if previous is None or previous != a:
+                        # Anfahrt von einer Startposition außerhalb der Fläche bleibt direkt
+                        if previous is not None and (previous is not start or router.fence.contains(*start)):
+                            route = router.route(previous, a)
+                            for point in route:
+                                waypoints.append(Waypoint(point[0], point[1], False))
+                            transit_length += _path_length([previous] + route + [a])
+                        waypoints.append(Waypoint(a[0], a[1], False))
+                else:
+                    # Wende: kann an schrägen Kanten eine Ecke eines Hindernisses anschneiden
+                    route = router.route(previous, a)
+                    for point in route:
+                        waypoints.append(Waypoint(point[0], point[1], True))
+                    mow_length += _path_length([previous] + route + [a])
+                    waypoints.append(Waypoint(a[0], a[1], True))
+                waypoints.append(Waypoint(b[0], b[1], True))
+                stripe_length += x1 - x0
+                previous = b
+        mow_length += stripe_length
+
+        return CoveragePlan(
+            waypoints=waypoints,
+            cells=len(cells),
+            stripes=sum(len(cell) for cell in cells),
+            area=area_with_holes(outer, holes),
+            covered_area=stripe_length * self.spacing,
+            mow_length=mow_length,
+            transit_length=transit_length,
+            stripe_angle=math.degrees(theta),
+            planning_ms=(time.perf_counter() - started) * 1000.0
+        )
+
+    def _sweep(self, rings: List[List[Point]]) -> List[List[Stripe]]:
+        """Schneidet alle Streifen mit den Konturen (Even-Odd, Löcher inklusive)"""
+        edges = []
+        y_low = math.inf
+        y_high = -math.inf
+        for ring in rings:
+            x_prev, y_prev = ring[-1]
+            for x, y in ring:
+                if y != y_prev:
+                    if y < y_prev:
+                        edges.append((y, y_prev, x, (x_prev - x) / (y_prev - y)))
+                    else:
+                        edges.append((y_prev, y, x_prev, (x - x_prev) / (y - y_prev)))
+                y_low = min(y_low, y)
+                y_high = max(y_high, y)
+                x_prev, y_prev = x, y
+        edges.sort()
+
+        rows: List[List[Stripe]] = []
+        active = []
+        next_edge = 0
+        margin = self.edge_margin
+        min_length = self.min_stripe_length
+        y = y_low + self.spacing / 2.0
+        while y < y_high:
+            # Kante aktiv für y_min <= y < y_max (halboffen, damit Ecken nicht doppelt zählen)
+            while next_edge < len(edges) and edges[next_edge][0] <= y:
+                active.append(edges[next_edge])
+                next_edge += 1
+            active = [edge for edge in active if edge[1] > y]
+
+            xs = sorted(x0 + (y - e_low) * slope for e_low, _, x0, slope in active)
+            row = []
+            for i in range(0, len(xs) - 1, 2):
+                start, end = xs[i] + margin, xs[i + 1] - margin
+                if end - start >= min_length:
+                    row.append((y, start, end))
+            rows.append(row)
+            y += self.spacing
+        return rows
+
+    @staticmethod
+    def _decompose(rows: List[List[Stripe]]) -> List[List[Stripe]]:
+        """Boustrophedon-Zerlegung: ein Intervall setzt eine Zelle fort, wenn die Überlappung eindeutig ist"""
+        cells: List[List[Stripe]] = []
+        previous_row: List[Stripe] = []
+        previous_cells: List[int] = []
+
+        for row in rows:
+            # Überlappungen zum vorherigen Streifen (beide Listen nach x sortiert)
+            links_down = [[] for _ in row]
+            links_up = [0] * len(previous_row)
+            j = 0
+            for i, (_, start, end) in enumerate(row):
+                while j < len(previous_row) and previous_row[j][2] <= start:
+                    j += 1
+                k = j
+                while k < len(previous_row) and previous_row[k][1] < end:
+                    links_down[i].append(k)
+                    links_up[k] += 1
+                    k += 1
+
+            row_cells = []
+            for i, stripe in enumerate(row):
+                below = links_down[i]
+                if len(below) == 1 and links_up[below[0]] == 1:
+                    cell_index = previous_cells[below[0]]
+                    cells[cell_index].append(stripe)
+                else:
+                    cell_index = len(cells)
+                    cells.append([stripe])
+                row_cells.append(cell_index)
+
+            previous_row = row
+            previous_cells = row_cells
+        return cells
+
+    @staticmethod
+    def _cell_endpoints(cell: List[Stripe], first: bool, low: bool) -> Tuple[Point, Point]:
+        """Einfahr- und Ausfahrpunkt (gedrehter Rahmen) einer Variante"""
+        entry_stripe = cell[0] if first else cell[-1]
+        exit_stripe = cell[-1] if first else cell[0]
+        exit_low = low if len(cell) % 2 == 0 else not low
+        entry = (entry_stripe[1] if low else entry_stripe[2], entry_stripe[0])
+        exit_ = (exit_stripe[1] if exit_low else exit_stripe[2], exit_stripe[0])
+        return entry, exit_
+
+
+def _path_length(points: Sequence[Point]) -> float:
+    return sum(math.hypot(b[0] - a[0], b[1] - a[1]) for a, b in zip(points, points[1:]))
+
+
+class _TransitRouter:
+    """
+    Transferwege innerhalb der Mähfläche
+
+    Knoten sind die Eckpunkte aller Konturen, um clearance entlang der Winkelhalbierenden
+    ins Innere der Fläche versetzt; Kanten sind Verbindungen, die laut Geofence-Index
+    vollständig in der Fläche liegen (lazy berechnet und zwischengespeichert).
+    """
+
+    def __init__(self, rings: Sequence[Polygon], clearance: float):
+        # Grobes Gitter: Transfers sind lang, pro Strecke werden alle überstrichenen Zellen gesammelt
+        xs = [p[0] for ring in rings for p in ring]
+        ys = [p[1] for ring in rings for p in ring]
+        extent = max(max(xs) - min(xs), max(ys) - min(ys))
+        self.fence = Geofence(boundary=rings, cell_size=max(extent / 16.0, clearance * 4.0, 1.0))
+        self.nodes: List[Point] = []
+        for ring in rings:
+            count = len(ring)
+            for index, point in enumerate(ring):
+                node = self._offset_vertex(ring[index - 1], point, ring[(index + 1) % count], clearance)
+                if node is not None:
+                    self.nodes.append(node)
+        self._visible: Dict[Tuple[int, int], bool] = {}
+
+    def _offset_vertex(self, previous: Point, point: Point, following: Point, clearance: float) -> Optional[Point]:
+        ax, ay = point[0] - previous[0], point[1] - previous[1]
+        bx, by = following[0] - point[0], following[1] - point[1]
+        la = math.hypot(ax, ay)
+        lb = math.hypot(bx, by)
+        if la == 0.0 or lb == 0.0:
+            return None
+        # Summe der Kantennormalen = Winkelhalbierende; welche Seite innen ist, entscheidet der Geofence
+        nx = -ay / la - by / lb
+        ny = ax / la + bx / lb
+        length = math.hypot(nx, ny)
+        if length < 1e-9:
+            return None
+        nx /= length
+        ny /= length
+        for sign in (1.0, -1.0):
+            candidate = (point[0] + sign * clearance * nx, point[1] + sign * clearance * ny)
+            if self.fence.contains(*candidate):
+                return candidate
+        return None
+
+    def _clear(self, a: Point, b: Point) -> bool:
+        return self.fence.segment_inside(a[0], a[1], b[0], b[1])
+
+    def route(self, a: Point, b: Point) -> List[Point]:
+        """Zwischenpunkte von a nach b (leer = direkte Fahrt), ValueError ohne Weg um die Hindernisse"""
+        if self._clear(a, b):
+            return []
+
+        # Lazy A* über [a, b] + Knoten: Sichtbarkeit erst prüfen, wenn ein Eintrag
+        # die Warteschlange verlässt (die meisten Paare werden nie untersucht)
+        points = [a, b] + self.nodes
+        goal = 1
+        parent: Dict[int, int] = {}
+        queue = [(math.dist(a, b), 0.0, 0, -1)]
+        while queue:
+            _, cost, current, via = heapq.heappop(queue)
+            if current in parent:
+                continue
+            if via >= 0 and not self._visible_pair(via, current, points):
+                continue
+            parent[current] = via
+            if current == goal:
+                path = []
+                node = parent[goal]
+                while node > 0:
+                    path.append(points[node])
+                    node = parent[node]
+                return path[::-1]
+            here = points[current]
+            for other in range(1, len(points)):
+                if other not in parent:
+                    new_cost = cost + math.dist(here, points[other])
+                    heapq.heappush(queue, (new_cost + math.dist(points[other], b), new_cost, other, current))
+        raise ValueError(f"Kein Transferweg von ({a[0]:.2f}, {a[1]:.2f}) nach ({b[0]:.2f}, {b[1]:.2f}) "
+                         f"um die Hindernisse")
+
+    def _visible_pair(self, i: int, j: int, points: List[Point]) -> bool:
+        if i < 2 or j < 2:
+            # a/b wechseln pro Transfer, nicht zwischenspeichern
+            return self._clear(points[i], points[j])
+        key = (i, j) if i < j else (j, i)
+        visible = self._visible.get(key)
+        if visible is None:
+            visible = self._clear(points[i], points[j])
+            self._visible[key] = visible
+        return visible
@@ -0,0 +1,137 @@
+import sys
+import threading
+import time
+import types
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.config import PWMConfig, RampingConfig
+from motor_controller.control.control_scheduler import FixedRateScheduler
+from motor_controller.control.motor_control import MotorControl
+
+
+class FixedRateSchedulerTests(unittest.TestCase):
+    def run_scheduler(self, interval, callback, duration):
+        scheduler = FixedRateScheduler(interval, callback, name='test-control')
+        scheduler.start()
+        time.sleep(duration)
+        scheduler.stop()
+        return scheduler
+
+    def test_ticks_follow_absolute_deadlines(self):
+        elapsed = []
+        scheduler = self.run_scheduler(0.005, elapsed.append, 0.3)
+
+        # Keine Drift: Anzahl Takte entspricht der Laufzeit, nicht Laufzeit / (Periode + Ausführung)
+        self.assertGreaterEqual(scheduler.ticks, 45)
+        self.assertLessEqual(scheduler.ticks, 61)
+        self.assertEqual(len(elapsed), scheduler.ticks)
+        self.assertAlmostEqual(sum(elapsed) / len(elapsed), 0.005, delta=0.002)
+        self.assertFalse(scheduler.running)
+
+    def test_overrun_skips_missed_ticks(self):
+        calls = []
+
+        def slow_once(dt):
+            calls.append(dt)
+            if len(calls) == 3:
+                time.sleep(0.035)
+
+        scheduler = self.run_scheduler(0.01, slow_once, 0.15)
+
+        self.assertGreaterEqual(scheduler.overruns, 1)
+        self.assertGreaterEqual(scheduler.missed_ticks, 3)
+        self.assertGreaterEqual(scheduler.max_exec_time, 0.035)
+        # Verpasste Takte werden nicht nachgeholt: kein Schwall kurzer Takte nach dem Overrun
+        self.assertTrue(all(dt > 0.005 for dt in calls[4:]))
+
+        stats = scheduler.get_stats()
+        self.assertEqual(stats['interval_ms'], 10.0)
+        scheduler.reset_stats()
+        self.assertEqual((scheduler.overruns, scheduler.missed_ticks, scheduler.max_jitter), (0, 0, 0.0))
+
+    def test_callback_error_does_not_stop_the_loop(self):
+        calls = []
+
+        def failing(dt):
+            calls.append(dt)
+            raise RuntimeError("kaputt")
+
+        with self.assertLogs('motor_controller.control.control_scheduler', level='ERROR'):
+            scheduler = self.run_scheduler(0.005, failing, 0.05)
+
+        self.assertGreater(len(calls), 2)
+        self.assertEqual(scheduler.ticks, len(calls))
+
+    def test_stop_from_the_callback(self):
+        stopped = threading.Event()
+        holder = {}
+
+        def stop_self(dt):
+            holder['scheduler'].stop()
+            stopped.set()
+
+        holder['scheduler'] = FixedRateScheduler(0.005, stop_self)
+        holder['scheduler'].start()
+
+        self.assertTrue(stopped.wait(1.0))
+        time.sleep(0.02)
+        self.assertEqual(holder['scheduler'].ticks, 1)
+
+
+class FakePWM:
+    def __init__(self):
+        self.writes = []
+
+    def set_motor_pwm_both(self, left, right):
+        self.writes.append((left, right))
+        return True
+
+
+class RampingTests(unittest.TestCase):
+    def setUp(self):
+        self.pwm = FakePWM()
+        config = types.SimpleNamespace(
+            pwm=PWMConfig(enabled=True),
+            ramping=RampingConfig(acceleration_rate=25, deceleration_rate=800, brake_rate=1500)
+        )
+        self.control = MotorControl(self.pwm, config)
+        # Takte im Test von Hand
+        self.control.stop_ramping()
+        self.pwm.writes.clear()
+
+    def test_ramp_step_rates(self):
+        step = MotorControl._ramp_step
+        self.assertEqual(step(1500.0, 1600.0, 1500.0, 0.02, 25, 800, 1500), 1500.5)   # beschleunigen
+        self.assertEqual(step(1600.0, 1550.0, 1500.0, 0.02, 25, 800, 1500), 1584.0)   # verzögern
+        self.assertEqual(step(1600.0, 1500.0, 1500.0, 0.02, 25, 800, 1500), 1570.0)   # bremsen
+        self.assertEqual(step(1400.0, 1300.0, 1500.0, 0.02, 25, 800, 1500), 1399.5)   # rückwärts
+        self.assertEqual(step(1500.2, 1500.0, 1500.0, 0.02, 25, 800, 1500), 1500.0)   # Ziel erreicht
+
+    def test_slow_ramp_accumulates_below_one_microsecond(self):
+        self.control.set_motor_target(1600, 1600)
+
+        for _ in range(50):
+            self.control._ramping_tick(0.02)
+
+        # 25 μs/s · 1 s = 25 μs, obwohl jeder Takt nur 0,5 μs ändert
+        self.assertEqual(self.control.get_current_values(), {'left': 1525, 'right': 1525})
+        self.assertEqual(self.pwm.writes[0], (1500, 1500))
+        self.assertEqual(self.pwm.writes[-1], (1525, 1525))
+
+    def test_late_tick_is_clamped(self):
+        self.control.set_motor_target(1500, 1500)
+        self.control._current_left = 1800.0
+        self.control._current_right = 1200.0
+
+        self.control._ramping_tick(1.0)   # nach langer Pause
+
+        # Höchstens 5 Takte (0,1 s) auf einmal: Bremsen um 150 μs statt 1500 μs
+        self.assertEqual(self.control.get_current_values(), {'left': 1650, 'right': 1350})
+        self.assertEqual(self.pwm.writes, [(1650, 1350)])
+
+
+if __name__ == '__main__':
+    unittest.main()
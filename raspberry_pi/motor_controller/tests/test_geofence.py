@@ -0,0 +1,134 @@
+import math
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.navigation.geodesy import LocalFrame
+from motor_controller.navigation.geofence import ZONE_BOUNDARY, ZONE_NO_GO, Geofence
+from motor_controller.navigation.site import Site
+
+OUTER = [(0.0, 0.0), (10.0, 0.0), (10.0, 10.0), (0.0, 10.0)]
+HOLE = [(4.0, 4.0), (6.0, 4.0), (6.0, 6.0), (4.0, 6.0)]
+NO_GO = [(7.0, 1.0), (9.0, 1.0), (9.0, 3.0), (7.0, 3.0)]
+
+
+class GeofenceTests(unittest.TestCase):
+    def setUp(self):
+        self.fence = Geofence(boundary=[OUTER, HOLE], no_go=[NO_GO], cell_size=1.0)
+
+    def test_contains_respects_holes_and_no_go(self):
+        self.assertTrue(self.fence.contains(1.0, 1.0))
+        self.assertFalse(self.fence.contains(5.0, 5.0))    # Loch
+        self.assertFalse(self.fence.contains(8.0, 2.0))    # No-Go
+        self.assertFalse(self.fence.contains(-0.1, 5.0))
+        self.assertFalse(self.fence.contains(5.0, 10.1))
+
+    def test_empty_fence_contains_nothing(self):
+        fence = Geofence(no_go=[NO_GO])
+
+        self.assertFalse(fence.has_boundary)
+        self.assertFalse(fence.contains(8.0, 2.0))
+        self.assertFalse(fence.contains(1.0, 1.0))
+        self.assertIsNone(Geofence().nearest_edge(0.0, 0.0))
+
+    def test_segment_along_the_boundary_counts_as_inside(self):
+        self.assertTrue(self.fence.segment_inside(0.0, 0.0, 10.0, 0.0))
+        self.assertTrue(self.fence.segment_inside(10.0, 2.0, 10.0, 8.0))
+        self.assertTrue(self.fence.segment_inside(4.0, 4.0, 6.0, 4.0))  # Lochkante
+        self.assertTrue(self.fence.segment_inside(0.0, 2.0, 4.0, 2.0))  # endet auf der Grenze
+
+    def test_segment_crossing_a_hole_or_no_go_is_outside(self):
+        self.assertFalse(self.fence.segment_inside(1.0, 5.0, 9.0, 5.0))
+        self.assertFalse(self.fence.segment_inside(6.5, 2.0, 9.5, 2.0))
+        self.assertFalse(self.fence.segment_inside(-1.0, 5.0, 1.0, 5.0))
+        self.assertFalse(self.fence.segment_inside(4.5, 4.5, 5.5, 5.5))  # ganz im Loch
+
+    def test_segment_touching_a_corner_stays_inside(self):
+        self.assertTrue(self.fence.segment_inside(3.0, 3.0, 4.0, 4.0))
+
+    def test_nearest_edge_reports_zone_and_foot_point(self):
+        nearest = self.fence.nearest_edge(8.0, 0.5)
+        self.assertAlmostEqual(nearest.distance, 0.5)
+        self.assertIn(nearest.zone, (ZONE_BOUNDARY, ZONE_NO_GO))
+        self.assertAlmostEqual(nearest.x, 8.0)
+
+        nearest = self.fence.nearest_edge(8.0, 2.0)
+        self.assertEqual(nearest.zone, ZONE_NO_GO)
+        self.assertAlmostEqual(nearest.distance, 1.0)
+
+        self.assertIsNone(self.fence.nearest_edge(2.0, 2.0, max_distance=1.0))
+
+    def test_nearest_edge_outside_the_index(self):
+        nearest = self.fence.nearest_edge(-3.0, 5.0)
+
+        self.assertAlmostEqual(nearest.distance, 3.0)
+        self.assertEqual(nearest.zone, ZONE_BOUNDARY)
+        self.assertAlmostEqual(nearest.x, 0.0)
+        self.assertAlmostEqual(nearest.y, 5.0)
+
+    def test_nearest_edge_matches_brute_force(self):
+        edges = []
+        for ring in (OUTER, HOLE, NO_GO):
+            edges += list(zip(ring, ring[1:] + ring[:1]))
+
+        def brute(x, y):
+            best = math.inf
+            for (x0, y0), (x1, y1) in edges:
+                dx, dy = x1 - x0, y1 - y0
+                t = max(0.0, min(1.0, ((x - x0) * dx + (y - y0) * dy) / (dx * dx + dy * dy)))
+                best = min(best, math.hypot(x0 + t * dx - x, y0 + t * dy - y))
+            return best
+
+        for i in range(21):
+            for j in range(21):
+                x, y = i * 0.5, j * 0.5
+                self.assertAlmostEqual(self.fence.nearest_edge(x, y).distance, brute(x, y), places=9)
+
+    def test_check_combines_inside_and_distance(self):
+        status = self.fence.check(3.0, 5.0)
+
+        self.assertTrue(status.inside)
+        self.assertAlmostEqual(status.distance, 1.0)
+        self.assertEqual(status.zone, ZONE_BOUNDARY)
+        self.assertEqual(Geofence().check(0.0, 0.0).distance, math.inf)
+
+
+class SiteTests(unittest.TestCase):
+    def test_local_frame_round_trips(self):
+        frame = LocalFrame(48.1, 11.5, 520.0)
+
+        lat, lon, alt = frame.from_enu(12.0, -7.5, 0.0)
+        east, north = frame.to_local(lat, lon)
+
+        self.assertAlmostEqual(east, 12.0, places=4)
+        self.assertAlmostEqual(north, -7.5, places=4)
+        self.assertAlmostEqual(alt, 520.0, places=3)
+        self.assertEqual(frame.to_local(48.1, 11.5), (0.0, 0.0))
+
+    def test_site_checks_fixes_against_the_geofence(self):
+        frame = LocalFrame(48.1, 11.5)
+        ring = [frame.from_enu(x, y)[:2] for x, y in OUTER]
+        site = Site.from_dict({'origin': frame.to_dict(), 'boundary': [ring]})
+
+        inside = site.update(*frame.from_enu(2.0, 3.0)[:2], timestamp=1.0)
+        outside = site.update(*frame.from_enu(12.0, 3.0)[:2], timestamp=2.0)
+
+        self.assertTrue(inside.inside)
+        self.assertAlmostEqual(inside.boundary_distance, 2.0, places=3)
+        self.assertFalse(outside.inside)
+        self.assertIs(site.position, outside)
+        self.assertEqual(site.updates, 2)
+
+    def test_site_ignores_fixes_without_gps(self):
+        site = Site(LocalFrame(48.1, 11.5))
+
+        self.assertIsNone(site.update_from_sensor({'rtk_status': 'NO GPS', 'gps': {'lat': 48.1, 'lon': 11.5}}))
+        self.assertIsNone(site.update_from_sensor({'gps': {'lat': 0, 'lon': 0}}))
+        with self.assertRaises(ValueError):
+            Site.from_dict({})
+
+
+if __name__ == '__main__':
+    unittest.main()
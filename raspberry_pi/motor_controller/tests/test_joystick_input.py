@@ -0,0 +1,72 @@
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.control.joystick_input import (
+    JoystickMailbox,
+    decode_joystick_packet,
+    encode_joystick_packet,
+)
+
+MS = 1_000_000
+
+
+def sample(seq, client_ms, received_ms, x=0.0, y=0.5):
+    return decode_joystick_packet(encode_joystick_packet(seq, client_ms, x, y), received_ns=received_ms * MS)
+
+
+class JoystickMailboxTests(unittest.TestCase):
+    def test_packet_round_trips(self):
+        decoded = sample(7, 1234, 5000, x=-0.25, y=1.0)
+
+        self.assertEqual(decoded.seq, 7)
+        self.assertEqual(decoded.client_ms, 1234)
+        self.assertAlmostEqual(decoded.x, -0.25, places=4)
+        self.assertEqual(decoded.y, 1.0)
+        self.assertIsNone(decode_joystick_packet(b'\x02' + bytes(12)))
+
+    def test_reordered_and_wrapped_sequences(self):
+        mailbox = JoystickMailbox()
+
+        self.assertTrue(mailbox.offer(sample(0xFFFFFFFF, 0, 1000)))
+        self.assertTrue(mailbox.offer(sample(0, 20, 1020)))
+        self.assertFalse(mailbox.offer(sample(0xFFFFFFFF, 0, 1030)))
+        self.assertEqual(mailbox.dropped_stale, 1)
+        self.assertEqual(mailbox.take().seq, 0)
+        self.assertIsNone(mailbox.take())
+
+    def test_late_sample_is_dropped(self):
+        mailbox = JoystickMailbox(max_latency=0.1)
+
+        self.assertTrue(mailbox.offer(sample(1, 0, 1000)))
+        self.assertFalse(mailbox.offer(sample(2, 20, 1200)))
+        self.assertTrue(mailbox.offer(sample(3, 40, 1045)))
+        self.assertEqual(mailbox.dropped_late, 1)
+
+    def test_clock_step_rebaselines_after_bounded_drops(self):
+        mailbox = JoystickMailbox(max_latency=0.1, max_late_drops=5)
+
+        self.assertTrue(mailbox.offer(sample(1, 10000, 1000)))
+        # Client-Uhr springt 2 s zurück: jedes Sample wirkt 2 s verspätet
+        results = [mailbox.offer(sample(seq, 8000 + seq * 20, 1000 + seq * 20)) for seq in range(2, 10)]
+
+        self.assertEqual(results, [False] * 5 + [True] * 3)
+        self.assertEqual(mailbox.dropped_late, 5)
+        self.assertEqual(mailbox.rebaselined, 1)
+        self.assertEqual(mailbox.take().seq, 9)
+
+    def test_on_time_sample_resets_the_drop_count(self):
+        mailbox = JoystickMailbox(max_latency=0.1, max_late_drops=2)
+
+        self.assertTrue(mailbox.offer(sample(1, 0, 1000)))
+        self.assertFalse(mailbox.offer(sample(2, 20, 1300)))
+        self.assertTrue(mailbox.offer(sample(3, 40, 1050)))
+        self.assertFalse(mailbox.offer(sample(4, 60, 1400)))
+        self.assertFalse(mailbox.offer(sample(5, 80, 1400)))
+        self.assertEqual(mailbox.rebaselined, 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
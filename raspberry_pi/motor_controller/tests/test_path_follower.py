@@ -0,0 +1,141 @@
+import math
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.config import FollowerConfig
+from motor_controller.control.path_follower import PathFollower
+
+DT = 0.02
+
+
+class Vehicle:
+    """Ideale Skid-Steer-Kinematik, folgt speed/turn_rate des Followers"""
+
+    def __init__(self, x=0.0, y=0.0, heading=90.0):
+        self.x = x
+        self.y = y
+        self.yaw = math.radians(90.0 - heading)
+
+    def heading(self):
+        return 90.0 - math.degrees(self.yaw)
+
+    def advance(self, follower, dt):
+        self.x += follower.speed * math.cos(self.yaw) * dt
+        self.y += follower.speed * math.sin(self.yaw) * dt
+        self.yaw += follower.turn_rate * dt
+
+
+def run(follower, vehicle, max_steps=5000):
+    for _ in range(max_steps):
+        if not follower.step(DT):
+            break
+        vehicle.advance(follower, DT)
+        follower.update_pose(vehicle.x, vehicle.y, vehicle.heading())
+
+
+class PathFollowerTests(unittest.TestCase):
+    def make(self, **overrides):
+        config = FollowerConfig(max_waypoints=16, **overrides)
+        return PathFollower(config, forward_factor=500.0, turn_factor=300.0)
+
+    def test_start_needs_a_current_pose(self):
+        follower = self.make()
+
+        with self.assertLogs('motor_controller.control.path_follower', level='ERROR'):
+            self.assertFalse(follower.start([(1.0, 0.0, True)]))
+        follower.update_pose(0.0, 0.0, 90.0)
+        with self.assertLogs('motor_controller.control.path_follower', level='ERROR'):
+            self.assertFalse(follower.start([]))
+            self.assertFalse(follower.start([(float(i), 0.0, True) for i in range(17)]))
+        self.assertTrue(follower.start([(1.0, 0.0, True)]))
+        self.assertEqual(follower.state, 'tracking')
+
+    def test_straight_line_reaches_the_goal(self):
+        follower = self.make()
+        vehicle = Vehicle(heading=90.0)  # nach Osten
+        follower.update_pose(vehicle.x, vehicle.y, vehicle.heading())
+        self.assertTrue(follower.start([(5.0, 0.0, True)]))
+
+        run(follower, vehicle)
+
+        self.assertEqual(follower.state, 'finished')
+        self.assertFalse(follower.active)
+        self.assertEqual(follower.progress, 1.0)
+        self.assertAlmostEqual(vehicle.x, 5.0, delta=0.1)
+        self.assertLess(follower.max_cross_track, 0.01)
+        self.assertEqual((follower.cmd_x, follower.cmd_y), (0.0, 0.0))
+
+    def test_turn_at_a_corner_pivots_and_finishes(self):
+        follower = self.make()
+        vehicle = Vehicle(heading=90.0)
+        follower.update_pose(vehicle.x, vehicle.y, vehicle.heading())
+        # Streifen nach Osten, Wende nach Norden, Streifen zurück nach Westen
+        self.assertTrue(follower.start([(4.0, 0.0, True), (4.0, 1.0, True), (0.0, 1.0, True)]))
+
+        pivoted = False
+        for _ in range(5000):
+            if not follower.step(DT):
+                break
+            if follower.speed == 0.0 and follower.turn_rate != 0.0:
+                pivoted = True
+            vehicle.advance(follower, DT)
+            follower.update_pose(vehicle.x, vehicle.y, vehicle.heading())
+
+        self.assertTrue(pivoted)
+        self.assertEqual(follower.state, 'finished')
+        self.assertAlmostEqual(vehicle.x, 0.0, delta=0.15)
+        self.assertAlmostEqual(vehicle.y, 1.0, delta=0.15)
+        self.assertLess(follower.max_cross_track, 0.3)
+
+    def test_command_follows_joystick_convention(self):
+        follower = self.make()
+        follower.update_pose(0.0, 0.0, 90.0)
+        # Ziel links voraus: Drehung gegen den Uhrzeigersinn = Joystick x < 0
+        self.assertTrue(follower.start([(3.0, 0.5, False)]))
+
+        self.assertTrue(follower.step(DT))
+
+        self.assertGreater(follower.cmd_y, 0.0)
+        self.assertLess(follower.cmd_x, 0.0)
+        self.assertLessEqual(follower.cmd_y, follower.transit_speed / follower.max_speed + 1e-9)
+
+    def test_stale_pose_halts(self):
+        follower = self.make(pose_timeout=0.1)
+        follower.update_pose(0.0, 0.0, 90.0)
+        self.assertTrue(follower.start([(5.0, 0.0, True)]))
+        self.assertTrue(follower.step(DT))
+        self.assertGreater(follower.cmd_y, 0.0)
+
+        follower.update_pose(0.0, 0.0, 90.0, latency=0.2)
+        self.assertTrue(follower.step(DT))
+        self.assertTrue(follower.step(DT))
+
+        self.assertEqual(follower.state, 'pose_lost')
+        self.assertEqual(follower.pose_timeouts, 1)
+        self.assertEqual((follower.cmd_x, follower.cmd_y), (0.0, 0.0))
+        self.assertTrue(follower.active)
+
+        follower.update_pose(0.0, 0.0, 90.0)
+        follower.step(DT)
+        self.assertEqual(follower.state, 'tracking')
+
+    def test_stop_zeroes_the_command(self):
+        follower = self.make()
+        follower.update_pose(0.0, 0.0, 90.0)
+        follower.start([(5.0, 0.0, True)])
+        follower.step(DT)
+
+        follower.stop('cancelled')
+
+        self.assertFalse(follower.active)
+        self.assertEqual(follower.state, 'cancelled')
+        self.assertEqual((follower.cmd_x, follower.cmd_y), (0.0, 0.0))
+        self.assertFalse(follower.step(DT))
+        self.assertEqual(follower.get_status()['waypoints'], 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,247 @@
+import os
+import sys
+import threading
+import time
+import types
+import unittest
+from array import array
+from pathlib import Path
+from unittest import mock
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.config import MowerConfig, PWMConfig, SafetyConfig
+from motor_controller.hardware import safety_supervisor as sup
+from motor_controller.hardware.pwm_controller import PWMController
+from motor_controller.hardware.safety_monitor import SafetyMonitor
+
+NEUTRAL_DUTY = 1500 * 50
+
+
+class FakePi:
+    """Minimaler pigpio.pi: merkt sich hardware_PWM-Aufrufe, Scripts nicht verfügbar"""
+
+    connected = True
+
+    def __init__(self):
+        self.writes = []
+        self.level = 1
+        self.stopped = False
+
+    def hardware_PWM(self, pin, frequency, duty):
+        self.writes.append((pin, frequency, duty))
+        return 0
+
+    def read(self, pin):
+        return self.level
+
+    def callback(self, pin, edge, func):
+        return mock.Mock()
+
+    def get_current_tick(self):
+        return 0
+
+    def store_script(self, script):
+        return -1
+
+    def stop(self):
+        self.stopped = True
+
+
+class SupervisorLoopTests(unittest.TestCase):
+    """_supervise im Thread statt im eigenen Prozess, pigpio durch FakePi ersetzt"""
+
+    def setUp(self):
+        self.pi = FakePi()
+        fake_pigpio = types.ModuleType('pigpio')
+        fake_pigpio.pi = lambda: self.pi
+        fake_pigpio.FALLING_EDGE = 1
+        patcher = mock.patch.dict(sys.modules, {'pigpio': fake_pigpio})
+        patcher.start()
+        self.addCleanup(patcher.stop)
+
+        self.fields = array('q', [0] * sup.FIELD_COUNT)
+        now = time.monotonic_ns()
+        self.fields[sup.F_COMMAND_NS] = now
+        self.fields[sup.F_CAN_NS] = now
+        self.settings = {
+            'period': 0.001,
+            'priority': 0,
+            'command_timeout_ns': int(0.05 * 1e9),
+            'joystick_timeout_ns': int(0.05 * 1e9),
+            'can_timeout_ns': int(0.05 * 1e9),
+            'debounce_ns': 0,
+            'safety_pin': None,
+            'motor_pins': [19, 18],
+            'frequency': 50,
+            'neutral_duty': NEUTRAL_DUTY,
+        }
+
+    def start(self):
+        thread = threading.Thread(target=sup._supervise, args=(self.fields, self.settings, os.getppid()),
+                                  daemon=True)
+        thread.start()
+        self.addCleanup(self.shutdown, thread)
+        self.wait_for(lambda: self.fields[sup.F_STATE] == sup.STATE_RUNNING)
+        return thread
+
+    def shutdown(self, thread):
+        self.fields[sup.F_SHUTDOWN] = 1
+        thread.join(timeout=1.0)
+
+    def wait_for(self, predicate, timeout=1.0):
+        deadline = time.monotonic() + timeout
+        while not predicate():
+            if time.monotonic() > deadline:
+                self.fail("Bedingung nicht erreicht")
+            time.sleep(0.001)
+
+    def test_command_timeout_sets_both_motors_neutral(self):
+        self.start()
+        self.fields[sup.F_COMMAND_NS] = time.monotonic_ns() - int(1e9)
+        self.fields[sup.F_MOVING] = 1
+
+        self.wait_for(lambda: self.fields[sup.F_TRIPS] == 1)
+
+        self.assertEqual(self.pi.writes, [(19, 50, NEUTRAL_DUTY), (18, 50, NEUTRAL_DUTY)])
+        self.assertEqual(self.fields[sup.F_TRIP_REASON], sup.REASON_COMMAND_TIMEOUT)
+        self.assertGreater(self.fields[sup.F_LAST_REACTION_NS], 0)
+
+        # Dieselbe Heartbeat-Lücke löst nur einmal aus
+        time.sleep(0.02)
+        self.assertEqual(self.fields[sup.F_TRIPS], 1)
+
+    def test_stale_command_while_neutral_does_not_trip(self):
+        self.start()
+        self.fields[sup.F_COMMAND_NS] = time.monotonic_ns() - int(1e9)
+
+        time.sleep(0.02)
+
+        self.assertEqual(self.fields[sup.F_TRIPS], 0)
+        self.assertEqual(self.pi.writes, [])
+
+    def test_pressed_switch_holds_neutral_until_acknowledged(self):
+        self.settings['safety_pin'] = 17
+        self.pi.level = 0
+        self.start()
+        self.fields[sup.F_MOVING] = 1
+
+        self.wait_for(lambda: self.fields[sup.F_TRIPS] >= 1)
+        self.assertEqual(self.fields[sup.F_TRIP_REASON], sup.REASON_SAFETY_SWITCH)
+        time.sleep(0.01)
+        self.assertEqual(self.fields[sup.F_TRIPS], 1)  # ohne Quittung keine neue Auslösung
+
+        self.fields[sup.F_ACK] = 1
+        self.wait_for(lambda: self.fields[sup.F_TRIPS] == 2)
+
+    def test_shutdown_stops_the_loop(self):
+        thread = self.start()
+
+        self.shutdown(thread)
+
+        self.assertFalse(thread.is_alive())
+        self.assertEqual(self.fields[sup.F_STATE], sup.STATE_STOPPED)
+        self.assertTrue(self.pi.stopped)
+        self.assertGreater(self.fields[sup.F_CYCLES], 0)
+
+    def test_missing_pigpio_daemon_fails(self):
+        self.pi.connected = False
+
+        sup._supervise(self.fields, self.settings, os.getppid())
+
+        self.assertEqual(self.fields[sup.F_STATE], sup.STATE_FAILED)
+
+
+def make_supervisor():
+    """SafetySupervisor mit lokalem Feld-Array statt gestartetem Prozess"""
+    supervisor = sup.SafetySupervisor(SafetyConfig(), PWMConfig(enabled=True))
+    supervisor._fields = array('q', [0] * sup.FIELD_COUNT)
+    supervisor.running = True
+    supervisor.alive = lambda timeout=0.5: True
+    return supervisor
+
+
+class SupervisorSyncTests(unittest.TestCase):
+    def setUp(self):
+        self.supervisor = make_supervisor()
+        self.supervisor._fields[sup.F_TRIPS] = 1
+        self.supervisor._fields[sup.F_TRIP_REASON] = sup.REASON_COMMAND_TIMEOUT
+        self.monitor = SafetyMonitor(SafetyConfig(enabled=False, supervisor_enabled=False), None)
+        self.monitor.supervisor = self.supervisor
+
+    def test_trip_is_acknowledged_after_neutral_was_written(self):
+        calls = []
+        self.monitor.set_emergency_stop_callback(lambda: calls.append(1) or True)
+
+        with self.assertLogs('motor_controller.hardware.safety_monitor', level='WARNING'):
+            self.monitor._sync_supervisor()
+
+        self.assertEqual(calls, [1])
+        self.assertFalse(self.supervisor.tripped())
+
+    def test_failed_neutral_write_keeps_the_trip_pending(self):
+        self.monitor.set_emergency_stop_callback(lambda: False)
+
+        with self.assertLogs('motor_controller.hardware.safety_monitor', level='WARNING'):
+            self.monitor._sync_supervisor()
+        self.monitor._sync_supervisor()
+
+        self.assertTrue(self.supervisor.tripped())
+        self.assertEqual(self.supervisor.pending_trip()[:2], (1, 'command_timeout'))
+
+        self.monitor.set_emergency_stop_callback(lambda: True)
+        self.monitor._sync_supervisor()
+        self.assertFalse(self.supervisor.tripped())
+
+    def test_callback_exception_keeps_the_trip_pending(self):
+        def broken():
+            raise RuntimeError("pigpio weg")
+
+        self.monitor.set_emergency_stop_callback(broken)
+        with self.assertLogs('motor_controller.hardware.safety_monitor', level='ERROR'):
+            self.monitor._sync_supervisor()
+
+        self.assertTrue(self.supervisor.tripped())
+
+
+class PWMWhileTrippedTests(unittest.TestCase):
+    def setUp(self):
+        self.pi = FakePi()
+        gpio = mock.Mock()
+        gpio.get_pigpio.return_value = self.pi
+        with self.assertLogs('motor_controller.hardware.pwm_controller', level='WARNING'):
+            self.pwm = PWMController(PWMConfig(enabled=True), MowerConfig(enabled=False), gpio)
+        self.supervisor = make_supervisor()
+        self.pwm.set_supervisor(self.supervisor)
+        self.pi.writes.clear()
+
+    def test_only_neutral_passes_until_acknowledged(self):
+        self.assertTrue(self.pwm.set_motor_pwm_both(1800, 1700))
+        self.assertEqual(self.supervisor._fields[sup.F_MOVING], 1)
+
+        self.supervisor._fields[sup.F_TRIPS] = 1
+        self.pi.writes.clear()
+        self.assertTrue(self.pwm.set_motor_pwm_both(1800, 1700))
+
+        self.assertEqual(self.pi.writes, [(19, 50, NEUTRAL_DUTY), (18, 50, NEUTRAL_DUTY)])
+        self.assertEqual(self.pwm.get_motor_pwm_both(), {'left': 1500, 'right': 1500})
+        self.assertEqual(self.supervisor._fields[sup.F_MOVING], 0)
+
+        self.supervisor.acknowledge(1)
+        self.pi.writes.clear()
+        self.assertTrue(self.pwm.set_motor_pwm_both(1800, 1700))
+        self.assertEqual(self.pi.writes, [(19, 50, 1800 * 50), (18, 50, 1700 * 50)])
+
+    def test_neutral_is_rewritten_while_tripped(self):
+        self.supervisor._fields[sup.F_TRIPS] = 1
+
+        self.pwm.set_motor_pwm_both(1800, 1800)
+        self.pwm.set_motor_pwm_both(1800, 1800)
+
+        # Cache gilt nicht: der Supervisor hat die Kanäle selbst geschrieben
+        self.assertEqual(len(self.pi.writes), 4)
+        self.assertEqual(self.pwm.skipped_writes, 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
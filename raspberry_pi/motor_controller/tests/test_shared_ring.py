@@ -0,0 +1,152 @@
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.ipc import seqlock, shared_ring
+from motor_controller.ipc.seqlock import F_SEQ, SeqlockBlock
+from motor_controller.ipc.shared_ring import H_DROPPED, H_HEAD, SharedRing
+
+SLOT_SIZE = 64
+PAYLOAD = SLOT_SIZE - shared_ring._SLOT_HEADER.size
+
+
+class SharedRingTests(unittest.TestCase):
+    def setUp(self):
+        self.producer = SharedRing(capacity=4, slot_size=SLOT_SIZE)
+        self.consumer = SharedRing(name=self.producer.name)
+        self.addCleanup(self.producer.close)
+        self.addCleanup(self.consumer.close)
+
+    def test_messages_survive_many_wraparounds(self):
+        slots = 0
+        for number in range(50):
+            message = f"msg-{number:02d}".encode() * (number % 8 + 1)
+            slots += -(-len(message) // PAYLOAD)
+            self.assertTrue(self.producer.put(message))
+            self.assertEqual(self.consumer.get(), message)
+        self.assertIsNone(self.consumer.get())
+        self.assertEqual(self.consumer.get_stats()['written'], slots)
+        self.assertGreater(slots, 50)
+
+    def test_multi_fragment_message_across_the_wrap(self):
+        self.producer.put(b'a')
+        self.producer.put(b'b')
+        self.consumer.get()
+        self.consumer.get()
+
+        message = bytes(range(256))[:PAYLOAD * 3 - 5]
+        self.assertTrue(self.producer.put(message))   # Slots 2, 3, 0
+
+        self.assertEqual(self.consumer.get(), message)
+        self.assertEqual(self.consumer.pending(), 0)
+
+    def test_full_ring_drops_instead_of_blocking(self):
+        for number in range(4):
+            self.assertTrue(self.producer.put(bytes([number])))
+
+        self.assertFalse(self.producer.put(b'x'))
+        self.assertFalse(self.producer.put(b'y' * (PAYLOAD * 5)))
+        self.assertEqual(self.producer.get_stats()['dropped'], 2)
+        self.assertEqual(self.consumer.get(), b'\x00')
+        self.assertTrue(self.producer.put(b'x'))
+        self.assertEqual([self.consumer.get() for _ in range(4)], [b'\x01', b'\x02', b'\x03', b'x'])
+
+    def test_slot_from_the_previous_round_is_not_read(self):
+        for number in range(4):
+            self.producer.put(bytes([number]))
+            self.consumer.get()
+
+        # head sichtbar, bevor die Slots der neuen Runde geschrieben sind (fehlende Barriere):
+        # Slot 0 enthält noch die vollständige Nachricht der vorigen Runde mit gültigem CRC
+        self.producer._fields[H_HEAD] = 5
+        self.assertIsNone(self.consumer.get())
+
+        self.producer._fields[H_HEAD] = 4
+        self.assertTrue(self.producer.put(b'new'))
+        self.assertEqual(self.consumer.get(), b'new')
+
+    def test_slot_being_written_is_not_read(self):
+        self.producer.put(b'first')
+        offset = self.producer._slot_offset(0)
+        # Producer hat die Sequenz gelöscht und schreibt gerade die Daten
+        shared_ring._SLOT_SEQ.pack_into(self.producer._buf, offset, 0)
+
+        self.assertIsNone(self.consumer.get())
+        self.assertEqual(self.consumer.pending(), 1)
+
+        shared_ring._SLOT_SEQ.pack_into(self.producer._buf, offset, 1)
+        self.assertEqual(self.consumer.get(), b'first')
+
+    def test_corrupted_fragment_is_not_read(self):
+        self.producer.put(b'payload')
+        start = self.producer._slot_offset(0) + shared_ring._SLOT_HEADER.size
+        self.producer._buf[start] ^= 0xFF
+
+        self.assertIsNone(self.consumer.get())
+
+    def test_incomplete_multi_fragment_message_waits(self):
+        message = b'z' * (PAYLOAD * 2)
+        self.producer.put(message)
+        second = self.producer._slot_offset(1)
+        shared_ring._SLOT_SEQ.pack_into(self.producer._buf, second, 0)
+
+        self.assertIsNone(self.consumer.get())
+        self.assertEqual(self.consumer.pending(), 2)
+
+        shared_ring._SLOT_SEQ.pack_into(self.producer._buf, second, 2)
+        self.assertEqual(self.consumer.get(), message)
+
+    def test_empty_message(self):
+        self.assertTrue(self.producer.put(b''))
+        self.assertEqual(self.consumer.get(), b'')
+        self.assertEqual(self.producer._fields[H_DROPPED], 0)
+
+
+class SeqlockBlockTests(unittest.TestCase):
+    def setUp(self):
+        self.writer = SeqlockBlock(capacity=64)
+        self.reader = SeqlockBlock(name=self.writer.name)
+        self.addCleanup(self.writer.close)
+        self.addCleanup(self.reader.close)
+
+    def test_read_returns_latest_version(self):
+        self.assertIsNone(self.reader.read())
+
+        self.assertTrue(self.writer.write(b'one'))
+        first = self.reader.read()
+        self.assertTrue(self.writer.write(b'two'))
+        second = self.reader.read()
+
+        self.assertEqual(first[1], b'one')
+        self.assertEqual(second[1], b'two')
+        self.assertGreater(second[0], first[0])
+        self.assertEqual(second[0], self.reader.version())
+        self.assertEqual(second[0] % 2, 0)
+
+    def test_oversized_write_is_rejected(self):
+        self.writer.write(b'keep')
+
+        self.assertFalse(self.writer.write(b'x' * 65))
+        self.assertEqual(self.reader.read()[1], b'keep')
+
+    def test_write_in_progress_is_retried(self):
+        self.writer.write(b'stable')
+        self.writer._fields[F_SEQ] += 1   # Schreiber mitten im Schreiben
+
+        self.assertIsNone(self.reader.read(attempts=3))
+        self.assertEqual(self.reader.retries, 3)
+
+        self.writer._fields[F_SEQ] += 1
+        self.assertEqual(self.reader.read()[1], b'stable')
+
+    def test_torn_data_fails_the_crc(self):
+        self.writer.write(b'abcdef')
+        self.writer._buf[seqlock._HEADER_SIZE] ^= 0xFF
+
+        self.assertIsNone(self.reader.read(attempts=2))
+
+
+if __name__ == '__main__':
+    unittest.main()
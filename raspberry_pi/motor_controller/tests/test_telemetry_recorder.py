@@ -0,0 +1,133 @@
+import math
+import os
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.monitoring.telemetry_recorder import (
+    COLUMN_NAMES,
+    TelemetryRecorder,
+    iter_recording,
+)
+
+PWM = {'left': 1500, 'right': 1500}
+
+
+def row(timestamp, heading=0.0):
+    return (timestamp, 48.1, 11.5, heading, 0.0, 0.0, 0.0, 4, 1600, 1600, 1550, 1550)
+
+
+class TelemetryRecorderTests(unittest.TestCase):
+    def test_record_maps_json_and_binary_payloads(self):
+        recorder = TelemetryRecorder(capacity=8)
+
+        recorder.record({'gps': {'lat': 48.1, 'lon': 11.5}, 'imu': {'heading': 90.0, 'roll': 1.5},
+                         'rtk_status': 'RTK FIXED'}, {'left': 1600, 'right': 1400}, PWM, timestamp=1.0)
+        recorder.record({'lat': 48.2, 'lon': 11.6, 'heading': 45.0, 'rtk_status': 5}, PWM, PWM, timestamp=2.0)
+        recorder.record({}, PWM, PWM, timestamp=3.0)
+
+        result = recorder.query()
+        self.assertEqual(result['count'], 3)
+        self.assertEqual(result['lat'][:2], [48.1, 48.2])
+        self.assertEqual(result['heading'][:2], [90.0, 45.0])
+        self.assertEqual(result['rtk_status'], [4, 5, 0])
+        self.assertEqual(result['cmd_left'][0], 1600)
+        self.assertIsNone(result['lat'][2])   # NaN -> None (JSON)
+        self.assertIsNone(result['pitch'][0])
+
+    def test_ring_overwrites_the_oldest_rows(self):
+        recorder = TelemetryRecorder(capacity=4)
+        for index in range(10):
+            recorder.append_row(row(float(index)))
+
+        self.assertEqual(len(recorder), 4)
+        self.assertEqual(recorder.query()['timestamp'], [6.0, 7.0, 8.0, 9.0])
+        stats = recorder.get_stats()
+        self.assertEqual((stats['oldest'], stats['newest'], stats['total_rows']), (6.0, 9.0, 10))
+
+    def test_time_range_query_after_wraparound(self):
+        recorder = TelemetryRecorder(capacity=16)
+        for index in range(40):
+            recorder.append_row(row(index * 0.5))
+
+        result = recorder.query(start=15.0, end=17.0, columns=['heading'])
+
+        self.assertEqual(result['timestamp'], [15.0, 15.5, 16.0, 16.5, 17.0])
+        self.assertEqual(set(result), {'count', 'step', 'timestamp', 'heading'})
+        self.assertEqual(recorder.query(start=0.0, end=5.0)['count'], 0)   # bereits überschrieben
+
+    def test_query_thins_out_to_max_points(self):
+        recorder = TelemetryRecorder(capacity=100)
+        for index in range(100):
+            recorder.append_row(row(float(index)))
+
+        result = recorder.query(max_points=10)
+
+        self.assertEqual(result['count'], 100)
+        self.assertEqual(result['step'], 10)
+        self.assertEqual(result['timestamp'][:3], [0.0, 10.0, 20.0])
+
+    def test_timestamps_stay_monotonic_for_the_binary_search(self):
+        recorder = TelemetryRecorder(capacity=8)
+        recorder.append_row(row(10.0))
+        recorder.append_row(row(5.0))   # Uhr springt zurück
+        recorder.append_row(row(11.0))
+
+        self.assertEqual(recorder.query()['timestamp'], [10.0, 10.0, 11.0])
+        self.assertEqual(recorder.query(start=10.5)['count'], 1)
+
+
+class RecordingFileTests(unittest.TestCase):
+    def setUp(self):
+        directory = tempfile.TemporaryDirectory()
+        self.addCleanup(directory.cleanup)
+        self.path = os.path.join(directory.name, 'telemetry.trec')
+
+    def test_flush_writes_rows_readable_after_restart(self):
+        recorder = TelemetryRecorder(capacity=8, filepath=self.path, flush_interval=60.0)
+        with self.assertLogs('motor_controller.monitoring.telemetry_recorder', level='INFO'):
+            self.assertTrue(recorder.start())
+        for index in range(5):
+            recorder.append_row(row(float(index), heading=index * 10.0))
+        recorder.flush()
+        recorder.append_row(row(5.0))
+        recorder.stop()
+
+        rows = list(iter_recording(self.path))
+        self.assertEqual([r['timestamp'] for r in rows], [0.0, 1.0, 2.0, 3.0, 4.0, 5.0])
+        self.assertEqual(set(rows[0]), set(COLUMN_NAMES))
+        self.assertTrue(math.isclose(rows[3]['heading'], 30.0))
+        self.assertEqual(recorder.rows_flushed, 6)
+
+        # Neustart hängt an die vorhandene Datei an
+        recorder = TelemetryRecorder(capacity=8, filepath=self.path)
+        with self.assertLogs('motor_controller.monitoring.telemetry_recorder', level='INFO'):
+            recorder.start()
+        recorder.append_row(row(6.0))
+        recorder.stop()
+        self.assertEqual(len(list(iter_recording(self.path))), 7)
+
+    def test_rows_overwritten_before_the_flush_are_counted(self):
+        recorder = TelemetryRecorder(capacity=4, filepath=self.path, flush_interval=60.0)
+        with self.assertLogs('motor_controller.monitoring.telemetry_recorder', level='INFO'):
+            recorder.start()
+        for index in range(10):
+            recorder.append_row(row(float(index)))
+        recorder.stop()
+
+        self.assertEqual(recorder.rows_lost, 6)
+        self.assertEqual([r['timestamp'] for r in iter_recording(self.path)], [6.0, 7.0, 8.0, 9.0])
+
+    def test_foreign_file_is_rejected(self):
+        with open(self.path, 'wb') as f:
+            f.write(b'NOTATREC' + bytes(8))
+
+        with self.assertRaises(ValueError):
+            list(iter_recording(self.path))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,91 @@
+import math
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from motor_controller.navigation.geofence import Geofence
+from motor_controller.navigation.waypoint_planner import CoveragePlanner, _TransitRouter
+
+OUTER = [(0.0, 0.0), (20.0, 0.0), (20.0, 10.0), (0.0, 10.0)]
+HOLE = [(8.0, 3.0), (12.0, 3.0), (12.0, 7.0), (8.0, 7.0)]
+NO_GO = [(15.0, 1.0), (17.0, 1.0), (17.0, 4.0), (15.0, 4.0)]
+
+
+def legs(plan):
+    points = plan.waypoints
+    return [(a, b) for a, b in zip(points, points[1:])]
+
+
+class CoveragePlannerTests(unittest.TestCase):
+    def setUp(self):
+        self.planner = CoveragePlanner(cutting_width=1.0, overlap=0.1, time_budget=0.01)
+
+    def test_no_leg_crosses_a_hole_or_no_go_zone(self):
+        holes = [HOLE, NO_GO]
+        fence = Geofence(boundary=[OUTER], no_go=holes)
+
+        for angle in (0.0, 30.0, 90.0):
+            plan = self.planner.plan(OUTER, holes, angle=angle)
+            self.assertGreater(len(plan.waypoints), 2)
+            for a, b in legs(plan):
+                self.assertTrue(fence.segment_inside(a.x, a.y, b.x, b.y, eps=1e-6),
+                                f"Strecke {a} -> {b} bei {angle}° verlässt die Fläche")
+
+    def test_lengths_add_up(self):
+        plan = self.planner.plan(OUTER, [HOLE], angle=0.0)
+
+        mowing = sum(math.dist((a.x, a.y), (b.x, b.y)) for a, b in legs(plan) if b.mowing)
+        transit = sum(math.dist((a.x, a.y), (b.x, b.y)) for a, b in legs(plan) if not b.mowing)
+        self.assertAlmostEqual(plan.mow_length, mowing, places=6)
+        self.assertAlmostEqual(plan.transit_length, transit, places=6)
+        self.assertAlmostEqual(plan.area, 200.0 - 16.0)
+        self.assertGreater(plan.cells, 1)
+        self.assertGreater(plan.transit_length, 0.0)
+
+    def test_start_outside_the_area_is_approached_directly(self):
+        plan = self.planner.plan(OUTER, [HOLE], angle=0.0, start=(-5.0, -5.0))
+
+        first = plan.waypoints[0]
+        self.assertFalse(first.mowing)
+        self.assertTrue(Geofence(boundary=[OUTER, HOLE]).segment_inside(first.x, first.y,
+                                                                        plan.waypoints[1].x,
+                                                                        plan.waypoints[1].y, eps=1e-6))
+
+    def test_invalid_input_is_rejected(self):
+        with self.assertRaises(ValueError):
+            CoveragePlanner(cutting_width=0.5, overlap=0.5)
+        with self.assertRaises(ValueError):
+            self.planner.plan([(0.0, 0.0), (1.0, 0.0)])
+
+
+class TransitRouterTests(unittest.TestCase):
+    def test_route_goes_around_the_hole(self):
+        router = _TransitRouter([OUTER, HOLE], clearance=0.5)
+        fence = Geofence(boundary=[OUTER, HOLE])
+
+        route = router.route((2.0, 5.0), (18.0, 5.0))
+
+        self.assertTrue(route)
+        path = [(2.0, 5.0)] + route + [(18.0, 5.0)]
+        for a, b in zip(path, path[1:]):
+            self.assertTrue(fence.segment_inside(a[0], a[1], b[0], b[1]))
+
+    def test_direct_leg_has_no_intermediate_points(self):
+        router = _TransitRouter([OUTER, HOLE], clearance=0.5)
+
+        self.assertEqual(router.route((1.0, 1.0), (19.0, 1.0)), [])
+
+    def test_disconnected_target_raises(self):
+        # Ring um das Ziel trennt es vom Start
+        moat = [(14.0, 2.0), (19.0, 2.0), (19.0, 8.0), (14.0, 8.0)]
+        island = [(15.0, 3.0), (18.0, 3.0), (18.0, 7.0), (15.0, 7.0)]
+        router = _TransitRouter([OUTER, moat, island], clearance=0.2)
+
+        with self.assertRaises(ValueError):
+            router.route((2.0, 5.0), (16.5, 5.0))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -3,7 +3,8 @@
 Web-Module für Motor Controller
 """
 
+from .web_process import WebBridge
 from .web_server import WebServer
 
-__all__ = ['WebServer']
+__all__ = ['WebBridge', 'WebServer']
 
@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""
+Status Stream - Änderungsbasierte Status-Updates pro Socket.IO-Client
+Vollständiger Status nur beim Connect, danach kompakte Patches mit Ack-Flusskontrolle
+"""
+
+import logging
+import threading
+import time
+from typing import Any, Dict, List, Optional, Tuple
+
+try:
+    import msgpack
+    MSGPACK_AVAILABLE = True
+except ImportError:
+    msgpack = None
+    MSGPACK_AVAILABLE = False
+
+ENCODING_JSON = 'json'
+ENCODING_MSGPACK = 'msgpack'
+
+_SEPARATOR = '.'
+
+
+def flatten_status(status: Dict[str, Any], prefix: str = '', out: Optional[Dict[str, Any]] = None) -> Dict[str, Any]:
+    """
+    Wandelt verschachtelte Dictionaries in flache Pfade ('motor_status.current_values.left')
+
+    Listen und andere Werte werden als Blätter behandelt.
+    """
+    if out is None:
+        out = {}
+    for key, value in status.items():
+        path = f"{prefix}{key}"
+        if isinstance(value, dict) and value:
+            flatten_status(value, path + _SEPARATOR, out)
+        else:
+            out[path] = value
+    return out
+
+
+def diff_status(previous: Dict[str, Any], current: Dict[str, Any]) -> Tuple[Dict[str, Any], List[str]]:
+    """
+    Vergleicht zwei flache Status-Stände
+
+    Returns:
+        Tuple (geänderte/neue Pfade mit Wert, entfernte Pfade)
+    """
+    changed = {path: value for path, value in current.items()
+               if path not in previous or previous[path] != value}
+    removed = [path for path in previous if path not in current]
+    return changed, removed
+
+
+class _ClientState:
+    """Sendezustand eines Clients"""
+
+    __slots__ = ('sid', 'encoding', 'sent', 'in_flight', 'sent_at', 'interval', 'next_due',
+                 'patches_sent', 'acks', 'resyncs', 'last_rtt')
+
+    def __init__(self, sid: str, encoding: str, interval: float):
+        self.sid = sid
+        self.encoding = encoding
+        self.sent: Optional[Dict[str, Any]] = None  # Stand, den der Client kennt (None = Resync nötig)
+        self.in_flight = False
+        self.sent_at = 0.0
+        self.interval = interval
+        self.next_due = 0.0
+        self.patches_sent = 0
+        self.acks = 0
+        self.resyncs = 0
+        self.last_rtt = 0.0
+
+
+class StatusStream:
+    """
+    Verwaltet pro Client den zuletzt gesendeten Stand
+    - Patches enthalten nur geänderte Pfade seit dem letzten Stand des Clients
+      (verpasste Ticks werden dadurch automatisch zusammengefasst)
+    - Pro Client ist höchstens ein Patch unterwegs; der nächste folgt erst nach dem Ack
+    - Sendeintervall passt sich an die Ack-Laufzeit an (schwaches WLAN -> seltener)
+    """
+
+    def __init__(self, base_interval: float = 0.1, max_interval: float = 1.0, ack_timeout: float = 3.0):
+        """
+        Initialisiert den Status-Stream
+
+        Args:
+            base_interval: Minimales Sendeintervall pro Client (Sekunden)
+            max_interval: Maximales Sendeintervall bei langsamem Client
+            ack_timeout: Ohne Ack nach dieser Zeit wird ein Full-Resync gesendet
+        """
+        self.logger = logging.getLogger(__name__)
+        self.base_interval = base_interval
+        self.max_interval = max_interval
+        self.ack_timeout = ack_timeout
+        self.version = 0
+        self._clients: Dict[str, _ClientState] = {}
+        self._lock = threading.Lock()
+
+    def add_client(self, sid: str, encoding: str = ENCODING_JSON):
+        """Registriert einen neuen Client (erster Send ist immer ein Full-Status)"""
+        with self._lock:
+            self._clients[sid] = _ClientState(sid, self._supported_encoding(encoding), self.base_interval)
+
+    def remove_client(self, sid: str):
+        """Entfernt einen Client"""
+        with self._lock:
+            self._clients.pop(sid, None)
+
+    def set_encoding(self, sid: str, encodings: List[str]) -> str:
+        """
+        Wählt die kompakteste vom Client unterstützte Kodierung
+
+        Returns:
+            Gewählte Kodierung
+        """
+        encoding = ENCODING_MSGPACK if ENCODING_MSGPACK in encodings and MSGPACK_AVAILABLE else ENCODING_JSON
+        with self._lock:
+            client = self._clients.get(sid)
+            if client:
+                client.encoding = encoding
+        return encoding
+
+    def has_clients(self) -> bool:
+        """Prüft ob Clients verbunden sind"""
+        return bool(self._clients)
+
+    @staticmethod
+    def _supported_encoding(encoding: str) -> str:
+        if encoding == ENCODING_MSGPACK and MSGPACK_AVAILABLE:
+            return ENCODING_MSGPACK
+        return ENCODING_JSON
+
+    def _encode(self, payload: Dict[str, Any], encoding: str):
+        if encoding == ENCODING_MSGPACK:
+            return msgpack.packb(payload, use_bin_type=True)
+        return payload
+
+    def full_status(self, sid: str, status: Dict[str, Any], now: Optional[float] = None):
+        """
+        Baut den Full-Resync für einen Client
+
+        Returns:
+            Kodierte Nachricht für 'status_full' oder None wenn Client unbekannt
+        """
+        now = time.monotonic() if now is None else now
+        with self._lock:
+            client = self._clients.get(sid)
+            if client is None:
+                return None
+            client.sent = flatten_status(status)
+            client.in_flight = False
+            client.next_due = now + client.interval
+            client.resyncs += 1
+            return self._encode({'v': self.version, 'state': status}, client.encoding)
+
+    def collect_updates(self, status: Dict[str, Any], now: Optional[float] = None) -> List[Tuple[str, str, Any]]:
+        """
+        Berechnet die fälligen Nachrichten aller Clients aus einem neuen Status
+
+        Args:
+            status: Aktueller (verschachtelter) Status
+            now: Zeitstempel (monotonic)
+
+        Returns:
+            Liste (sid, event, payload) mit event 'status_patch' oder 'status_full'
+        """
+        now = time.monotonic() if now is None else now
+        flat = flatten_status(status)
+        self.version += 1
+        updates = []
+
+        with self._lock:
+            for client in self._clients.values():
+                if client.in_flight:
+                    if now - client.sent_at < self.ack_timeout:
+                        continue  # Patches zusammenfassen, bis der Client nachkommt
+                    # Ack verloren: Client-Stand unbekannt
+                    self.logger.debug(f"Status-Ack Timeout für {client.sid} - Resync")
+                    client.in_flight = False
+                    client.sent = None
+                    client.interval = self.max_interval
+
+                if now < client.next_due:
+                    continue
+
+                if client.sent is None:
+                    client.sent = flat
+                    client.resyncs += 1
+                    updates.append((client.sid, 'status_full',
+                                    self._encode({'v': self.version, 'state': status}, client.encoding)))
+                else:
+                    changed, removed = diff_status(client.sent, flat)
+                    if not changed and not removed:
+                        client.next_due = now + client.interval
+                        continue
+                    client.sent = flat
+                    patch = {'v': self.version, 'set': changed}
+                    if removed:
+                        patch['del'] = removed
+                    client.patches_sent += 1
+                    updates.append((client.sid, 'status_patch', self._encode(patch, client.encoding)))
+
+                client.in_flight = True
+                client.sent_at = now
+                client.next_due = now + client.interval
+
+        return updates
+
+    def on_ack(self, sid: str, now: Optional[float] = None):
+        """Client hat eine Nachricht bestätigt - Sendeintervall anpassen"""
+        now = time.monotonic() if now is None else now
+        with self._lock:
+            client = self._clients.get(sid)
+            if client is None or not client.in_flight:
+                return
+            client.in_flight = False
+            client.acks += 1
+            rtt = now - client.sent_at
+            client.last_rtt = rtt
+            if rtt < self.base_interval:
+                # Client kommt mit: schrittweise zurück zum Basisintervall
+                client.interval = max(self.base_interval, client.interval * 0.5)
+            else:
+                # Socket staut: nicht schneller senden als die Ack-Laufzeit erlaubt
+                client.interval = min(self.max_interval, max(client.interval, rtt * 2.0))
+            client.next_due = client.sent_at + client.interval
+
+    def get_stats(self) -> Dict[str, Any]:
+        """
+        Gibt Statistiken aller Clients zurück
+
+        Returns:
+            Dictionary mit Version und Client-Zuständen
+        """
+        with self._lock:
+            clients = {
+                client.sid: {
+                    'encoding': client.encoding,
+                    'interval_ms': round(client.interval * 1000.0, 1),
+                    'last_rtt_ms': round(client.last_rtt * 1000.0, 1),
+                    'patches_sent': client.patches_sent,
+                    'acks': client.acks,
+                    'resyncs': client.resyncs,
+                    'in_flight': client.in_flight,
+                }
+                for client in self._clients.values()
+            }
+        return {'version': self.version, 'msgpack_available': MSGPACK_AVAILABLE, 'clients': clients}
+
@@ -0,0 +1,785 @@
+#!/usr/bin/env python3
+"""
+Web Process - Web-Interface in einem eigenen Prozess
+Echtzeitteil (CAN, Ramping, Safety, Joystick-Takt) und Flask/Socket.IO tauschen
+Daten nur über Shared Memory aus: Befehlsring UI -> RT, eigener Ring für Stopp-Befehle
+UI -> RT, Antwortring RT -> UI, Seqlock-Zustandsblock RT -> UI
+"""
+
+import json
+import logging
+import multiprocessing
+import os
+import queue
+import struct
+import threading
+import time
+from dataclasses import asdict
+from typing import Any, Callable, Dict, Optional
+
+from ..control.joystick_input import JoystickSample
+from ..ipc.seqlock import SeqlockBlock
+from ..ipc.shared_ring import SharedRing
+from ..monitoring.latency_tracer import get_tracer
+
+# Nachrichtentypen im Befehlsring (erstes Byte)
+MSG_JOYSTICK = b'J'  # binäres Joystick-Sample + Quelle
+MSG_COMMAND = b'C'   # JSON {'cmd', 'args'}, ohne Antwort
+MSG_CALL = b'R'      # JSON {'id', 'method', 'args'}, Antwort im Antwortring
+
+# seq, client_ms, x, y, received_ns (fehlende Werte = NONE_VALUE)
+_JOYSTICK = struct.Struct('<qqddq')
+NONE_VALUE = -(1 << 63)
+
+COMMAND_RING = (256, 512)      # Slots, Slot-Größe
+STOP_RING = (16, 256)          # Not-Halt/Stopp, nie von Joystick-Samples verdrängt
+STOP_COMMANDS = frozenset(('emergency_stop', 'joystick_disable', 'stop_path_following'))
+STOP_SEND_TIMEOUT = 0.25       # s, danach gilt ein Stopp-Befehl als nicht zugestellt
+RESPONSE_RING = (1024, 4096)   # Antworten bis ~4 MB (Verlaufsabfragen)
+STATE_CAPACITY = 256 * 1024
+
+
+def encode_joystick(sample: JoystickSample, source: str) -> bytes:
+    """Joystick-Sample für den Befehlsring (32 Byte + Quelle)"""
+    return MSG_JOYSTICK + _JOYSTICK.pack(
+        NONE_VALUE if sample.seq is None else sample.seq,
+        NONE_VALUE if sample.client_ms is None else sample.client_ms,
+        sample.x,
+        sample.y,
+        sample.received_ns
+    ) + source.encode('utf-8')
+
+
+def decode_joystick(data: bytes):
+    """Gegenstück zu encode_joystick -> (JoystickSample, Quelle)"""
+    seq, client_ms, x, y, received_ns = _JOYSTICK.unpack_from(data, 1)
+    sample = JoystickSample(
+        seq=None if seq == NONE_VALUE else seq,
+        client_ms=None if client_ms == NONE_VALUE else client_ms,
+        x=x,
+        y=y,
+        received_ns=received_ns
+    )
+    return sample, data[1 + _JOYSTICK.size:].decode('utf-8', errors='replace')
+
+
+class WebBridge:
+    """
+    Echtzeit-Seite des Web-Prozesses (gleiche Schnittstelle wie WebServer für main.py)
+
+    - Bridge-Thread: leert zuerst den Stopp-Ring, dann den Befehlsring alle poll_interval
+      und veröffentlicht den Zustand im Seqlock-Block (10 Hz bzw. sofort nach
+      übernommenen Joystick-Samples)
+    - RPC-Thread: führt langsame Aufrufe (Verlauf, Bahnfolge-Start) aus und ist der
+      einzige Schreiber des Antwortrings; Joystick-Befehle warten nie auf ihn
+    - Das Mähabdeckungs-Raster blendet der UI-Prozess selbst nur lesend ein (Datei oder
+      Shared Memory), PNG-Kacheln werden dort kodiert
+    - Der UI-Prozess wird nach einem Absturz neu gestartet; Flask blockiert damit nie
+      den GIL des Echtzeitprozesses
+    """
+
+    def __init__(self, config, motor_control, joystick_handler, can_handler, gpio_controller):
+        """
+        Initialisiert die Web-Bridge
+
+        Args:
+            config: Config-Instanz (vollständig, der UI-Prozess baut daraus seine Konfiguration)
+            motor_control: MotorControl-Instanz
+            joystick_handler: JoystickHandler-Instanz
+            can_handler: CANHandler-Instanz
+            gpio_controller: GPIOController-Instanz
+        """
+        self.logger = logging.getLogger(__name__)
+        self.config = config
+        self.motor = motor_control
+        self.joystick = joystick_handler
+        self.can = can_handler
+        self.gpio = gpio_controller
+        self.pwm_controller = None
+        self.recorder = None
+        self.site = None
+        self.coverage = None
+
+        self.poll_interval = config.web.process_poll_interval
+        self.state_interval = 0.1
+        self._echo_interval = 1.0 / config.web.pwm_echo_rate if config.web.pwm_echo_rate > 0 else 0.0
+
+        self.commands: Optional[SharedRing] = None
+        self.stops: Optional[SharedRing] = None
+        self.responses: Optional[SharedRing] = None
+        self.state: Optional[SeqlockBlock] = None
+        self.process: Optional[multiprocessing.Process] = None
+        self.running = False
+        self._thread: Optional[threading.Thread] = None
+        self._rpc_thread: Optional[threading.Thread] = None
+        self._rpc_queue: 'queue.Queue' = queue.Queue()
+
+        # Vom Joystick-Takt gesetzt, vom Bridge-Thread gelesen
+        self._applied = 0
+        self._published_applied = 0
+        self._last_publish = 0.0
+
+        self.restarts = 0
+        self.commands_handled = 0
+        self.calls_handled = 0
+        self.errors = 0
+        self.publish_max_us = 0.0
+
+        self.joystick.on_applied = self._on_applied
+
+    def set_hardware_refs(self, light_config, mower_config, pwm_controller):
+        """
+        Setzt Hardware-Referenzen (Licht/Mäher-Konfiguration kommt im UI-Prozess aus der Config)
+
+        Args:
+            light_config: LightConfig-Instanz
+            mower_config: MowerConfig-Instanz
+            pwm_controller: PWMController-Instanz
+        """
+        self.pwm_controller = pwm_controller
+
+    def set_recorder(self, recorder):
+        """
+        Setzt den Telemetrie-Recorder für /api/history (Abfrage per RPC)
+
+        Args:
+            recorder: TelemetryRecorder-Instanz oder None
+        """
+        self.recorder = recorder
+
+    def set_site(self, site):
+        """
+        Setzt den Standort; der UI-Prozess lädt Grenzen selbst, Positionen kommen über den Zustand
+
+        Args:
+            site: Site-Instanz oder None
+        """
+        self.site = site
+
+    def set_coverage(self, coverage):
+        """
+        Setzt das Mähabdeckungs-Raster (der UI-Prozess liest es direkt, Reset per RPC)
+
+        Args:
+            coverage: CoverageRaster-Instanz oder None
+        """
+        self.coverage = coverage
+
+    def _on_applied(self):
+        """Joystick-Takt: nur Zähler erhöhen, veröffentlicht wird im Bridge-Thread"""
+        self._applied += 1
+
+    def start(self):
+        """Legt die Shared-Memory-Kanäle an und startet UI-Prozess und Bridge-Threads"""
+        if self.running:
+            self.logger.warning("Web-Bridge läuft bereits")
+            return
+
+        try:
+            self.commands = SharedRing(capacity=COMMAND_RING[0], slot_size=COMMAND_RING[1])
+            self.stops = SharedRing(capacity=STOP_RING[0], slot_size=STOP_RING[1])
+            self.responses = SharedRing(capacity=RESPONSE_RING[0], slot_size=RESPONSE_RING[1])
+            self.state = SeqlockBlock(capacity=STATE_CAPACITY)
+        except Exception as e:
+            self.logger.error(f"❌ Shared Memory für Web-Prozess nicht verfügbar: {e}")
+            self._release()
+            return
+
+        self._publish_state()
+        self.running = True
+        if not self._spawn():
+            self.running = False
+            self._release()
+            return
+
+        self._rpc_thread = threading.Thread(target=self._rpc_loop, name='web-rpc', daemon=True)
+        self._rpc_thread.start()
+        self._thread = threading.Thread(target=self._bridge_loop, name='web-bridge', daemon=True)
+        self._thread.start()
+        self.logger.info(f"✅ Web-Prozess gestartet (PID {self.process.pid}) auf "
+                         f"{self.config.web.host}:{self.config.web.port}")
+
+    def _spawn(self) -> bool:
+        """Startet den UI-Prozess (spawn, nicht fork: der Hauptprozess hat bereits Threads)"""
+        try:
+            context = multiprocessing.get_context('spawn')
+            coverage_source = None
+            if self.coverage:
+                coverage_source = {'file': self.coverage.filepath, 'shm': self.coverage.shm_name}
+            self.process = context.Process(
+                target=run_web_process,
+                args=(_config_dict(self.config), self.commands.name, self.responses.name,
+                      self.state.name, self.stops.name, os.getpid(), coverage_source),
+                name='web-ui',
+                daemon=True
+            )
+            self.process.start()
+            return True
+        except Exception as e:
+            self.logger.error(f"❌ Web-Prozess konnte nicht gestartet werden: {e}")
+            self.process = None
+            return False
+
+    def _bridge_loop(self):
+        """Befehle abarbeiten, Zustand veröffentlichen, UI-Prozess überwachen"""
+        last_check = time.monotonic()
+        restart_at = 0.0
+        while self.running:
+            try:
+                handled = self._drain_commands()
+
+                now = time.monotonic()
+                echo_due = (self._applied != self._published_applied
+                            and now - self._last_publish >= self._echo_interval)
+                if echo_due or now - self._last_publish >= self.state_interval:
+                    self._publish_state()
+
+                if now - last_check >= 1.0:
+                    last_check = now
+                    if self.process is not None and not self.process.is_alive():
+                        self.logger.error(f"❌ Web-Prozess beendet (Exit {self.process.exitcode}) "
+                                          f"- Neustart in 5 s")
+                        self.joystick.disable()
+                        self.process = None
+                        restart_at = now + 5.0
+                    elif self.process is None and restart_at and now >= restart_at:
+                        restart_at = 0.0
+                        if self._spawn():
+                            self.restarts += 1
+                            self.logger.info(f"✅ Web-Prozess neu gestartet (PID {self.process.pid})")
+                        else:
+                            restart_at = now + 5.0
+
+                if not handled:
+                    time.sleep(self.poll_interval)
+            except Exception as e:
+                self.errors += 1
+                self.logger.error(f"❌ Web-Bridge Fehler: {e}")
+                time.sleep(0.1)
+
+    def _drain_commands(self) -> int:
+        """Leert Stopp- und Befehlsring; Aufrufe gehen an den RPC-Thread"""
+        handled = self._drain(self.stops)
+        return handled + self._drain(self.commands)
+
+    def _drain(self, ring: SharedRing) -> int:
+        handled = 0
+        while True:
+            message = ring.get()
+            if message is None:
+                return handled
+            handled += 1
+            kind = message[:1]
+            try:
+                if kind == MSG_JOYSTICK:
+                    sample, source = decode_joystick(message)
+                    self.joystick.submit(sample, source)
+                elif kind == MSG_COMMAND:
+                    request = json.loads(message[1:])
+                    self._execute(request['cmd'], request.get('args', {}))
+                elif kind == MSG_CALL:
+                    self._rpc_queue.put(json.loads(message[1:]))
+                self.commands_handled += 1
+            except (KeyError, TypeError, ValueError, struct.error) as e:
+                self.errors += 1
+                self.logger.error(f"❌ Ungültige Nachricht vom Web-Prozess: {e}")
+
+    def _execute(self, cmd: str, args: Dict[str, Any]):
+        """Befehle ohne Antwort (kurz, direkt im Bridge-Thread)"""
+        if cmd == 'emergency_stop':
+            self.motor.emergency_stop()
+        elif cmd == 'joystick_disable':
+            self.joystick.disable()
+        elif cmd == 'joystick_forget':
+            self.joystick.forget_client(args['source'])
+        elif cmd == 'set_max_speed':
+            self.joystick.set_max_speed(args['max_speed'])
+        elif cmd == 'stop_path_following':
+            self.motor.stop_path_following(args.get('reason', 'stopped'))
+        elif cmd == 'gpio_output':
+            self.gpio.output(int(args['pin']), args['state'])
+        elif cmd == 'set_mower_speed' and self.pwm_controller:
+            self.pwm_controller.set_mower_speed(args['speed'])
+        elif cmd == 'stop_mower' and self.pwm_controller:
+            self.pwm_controller.stop_mower()
+        else:
+            raise ValueError(f"Unbekannter Befehl: {cmd}")
+
+    def _call(self, method: str, args: Dict[str, Any]) -> Any:
+        """Aufrufe mit Antwort (im RPC-Thread)"""
+        if method == 'start_path_following':
+            waypoints = [(float(w[0]), float(w[1]), bool(w[2])) for w in args['waypoints']]
+            return self.motor.start_path_following(waypoints)
+        if method == 'request_sensor_status':
+            return self.can.request_sensor_status()
+        if method == 'restart_sensor_hub':
+            return self.can.restart_sensor_hub()
+        if method == 'recorder_query':
+            if not self.recorder:
+                raise ValueError("Recorder deaktiviert")
+            return self.recorder.query(**args)
+        if method == 'coverage_reset':
+            if not self.coverage:
+                raise ValueError("Mähabdeckung nicht verfügbar")
+            self.coverage.reset()
+            return True
+        if method == 'render_tracer':
+            return get_tracer().render_prometheus()
+        raise ValueError(f"Unbekannter Aufruf: {method}")
+
+    def _rpc_loop(self):
+        """Führt Aufrufe nacheinander aus und schreibt die Antworten (einziger Producer)"""
+        while True:
+            request = self._rpc_queue.get()
+            if request is None:
+                self._respond({'shutdown': True})
+                return
+            try:
+                response = {'id': request['id'], 'result': self._call(request['method'], request.get('args', {}))}
+            except Exception as e:
+                self.errors += 1
+                self.logger.error(f"❌ Web-Aufruf {request.get('method')} fehlgeschlagen: {e}")
+                response = {'id': request.get('id'), 'error': str(e)}
+            self.calls_handled += 1
+            if not self._respond(response):
+                self._respond({'id': request.get('id'), 'error': 'Antwort zu groß'})
+
+    def _respond(self, response: dict, timeout: float = 1.0) -> bool:
+        data = json.dumps(response, default=str).encode('utf-8')
+        if len(data) > self.responses.max_message:
+            return False
+        deadline = time.monotonic() + timeout
+        while not self.responses.put(data):
+            if time.monotonic() > deadline or not self.running:
+                return False
+            time.sleep(0.005)
+        return True
+
+    def _build_state(self) -> dict:
+        """Alle Werte, die das Web-Interface liest, als ein Schnappschuss"""
+        follower = self.motor.follower
+        position = self.site.position if self.site else None
+        return {
+            'motor_status': self.motor.get_status(),
+            'current_values': self.motor.get_current_values(),
+            'joystick_status': self.joystick.get_status(),
+            'safety_status': self.joystick.safety.get_status(),
+            'can_status': self.can.get_status(),
+            'sensor_data': self.can.get_sensor_data(),
+            'mower_speed': self.pwm_controller.get_mower_speed() if self.pwm_controller else 0,
+            'follower': follower.get_status() if follower else None,
+            'site': self.site.get_status() if self.site else None,
+            'site_position': list(position) if position else None,
+            'applied': self._applied,
+        }
+
+    def _publish_state(self):
+        started = time.perf_counter()
+        applied = self._applied
+        data = json.dumps(self._build_state(), default=str).encode('utf-8')
+        if not self.state.write(data):
+            self.errors += 1
+            self.logger.error(f"❌ Zustand zu groß für Shared Memory ({len(data)} Bytes)")
+        self._published_applied = applied
+        self._last_publish = time.monotonic()
+        elapsed = (time.perf_counter() - started) * 1e6
+        if elapsed > self.publish_max_us:
+            self.publish_max_us = elapsed
+
+    def stop(self):
+        """Beendet UI-Prozess und Bridge-Threads"""
+        if not self.running:
+            return
+
+        self.running = False
+        self._rpc_queue.put(None)
+        if self._rpc_thread is not None:
+            self._rpc_thread.join(timeout=1.0)
+        if self._thread is not None:
+            self._thread.join(timeout=1.0)
+        if self.process is not None:
+            self.process.join(timeout=3.0)
+            if self.process.is_alive():
+                self.process.terminate()
+                self.process.join(timeout=1.0)
+            self.process = None
+        self._release()
+        self.logger.info("Web-Prozess gestoppt")
+
+    def _release(self):
+        for channel in (self.commands, self.stops, self.responses, self.state):
+            if channel is not None:
+                channel.close()
+        self.commands = self.stops = self.responses = self.state = None
+
+    def get_status(self) -> dict:
+        """
+        Gibt Web-Bridge-Status zurück
+
+        Returns:
+            Dictionary mit Status-Informationen
+        """
+        return {
+            'separate_process': True,
+            'running': self.running,
+            'pid': self.process.pid if self.process else None,
+            'restarts': self.restarts,
+            'commands': self.commands_handled,
+            'calls': self.calls_handled,
+            'errors': self.errors,
+            'publish_max_us': round(self.publish_max_us, 1),
+            'command_ring': self.commands.get_stats() if self.commands else None,
+            'stop_ring': self.stops.get_stats() if self.stops else None,
+            'response_ring': self.responses.get_stats() if self.responses else None,
+        }
+
+    def cleanup(self):
+        """Cleanup Web-Bridge"""
+        self.stop()
+        self.logger.info("Web-Bridge cleanup durchgeführt")
+
+
+def _config_dict(config) -> Dict[str, Any]:
+    """Config als Dictionary für Config.from_dict im UI-Prozess"""
+    return asdict(config)
+
+
+# ---------------------------------------------------------------------------
+# UI-Prozess
+# ---------------------------------------------------------------------------
+
+class BridgeClient:
+    """
+    UI-Seite der Kanäle
+
+    Flask-Threads schreiben in den Befehlsring (ein Lock nur zwischen UI-Threads, der
+    Echtzeitprozess wartet nie darauf); ein Watcher-Thread ist der einzige Leser des
+    Antwortrings und meldet neue übernommene Joystick-Samples über on_applied.
+
+    Stopp-Befehle (STOP_COMMANDS) gehen über einen eigenen kleinen Ring, den
+    Joystick-Samples nicht füllen können; ist auch er voll, wird bis STOP_SEND_TIMEOUT
+    wiederholt und sonst False gemeldet (der Aufrufer meldet den Fehler weiter).
+    """
+
+    def __init__(self, command_name: str, response_name: str, state_name: str, stop_name: str,
+                 poll_interval: float = 0.002):
+        self.logger = logging.getLogger(__name__)
+        self.commands = SharedRing(command_name)
+        self.stops = SharedRing(stop_name)
+        self.responses = SharedRing(response_name)
+        self.state_block = SeqlockBlock(state_name)
+        self.poll_interval = poll_interval
+
+        self._send_lock = threading.Lock()
+        self._stop_lock = threading.Lock()
+        self._pending: Dict[int, list] = {}
+        self._next_id = 1
+        self._state_version = -1
+        self._state: Dict[str, Any] = {}
+        self._applied = None
+        self.on_applied: Optional[Callable[[], None]] = None
+        self.shutdown = False
+        self.dropped = 0
+        self.stops_failed = 0
+
+    def send(self, data: bytes) -> bool:
+        with self._send_lock:
+            if self.commands.put(data):
+                return True
+        self.dropped += 1
+        self.logger.warning("⚠️ Befehlsring voll - Nachricht verworfen")
+        return False
+
+    def send_stop(self, data: bytes, timeout: float = STOP_SEND_TIMEOUT) -> bool:
+        """Stopp-Befehl über den eigenen Ring, bei vollem Ring begrenzt wiederholen"""
+        deadline = time.monotonic() + timeout
+        with self._stop_lock:
+            while not self.stops.put(data):
+                if time.monotonic() > deadline:
+                    self.stops_failed += 1
+                    self.logger.error("❌ Stopp-Befehl nicht zugestellt - Echtzeitprozess liest nicht")
+                    return False
+                time.sleep(0.001)
+        return True
+
+    def command(self, cmd: str, **args) -> bool:
+        """Befehl ohne Antwort; False wenn er nicht zugestellt werden konnte"""
+        message = MSG_COMMAND + json.dumps({'cmd': cmd, 'args': args}).encode('utf-8')
+        if cmd in STOP_COMMANDS:
+            return self.send_stop(message)
+        return self.send(message)
+
+    def call(self, method: str, timeout: float = 5.0, **args) -> Any:
+        """Aufruf mit Antwort (blockiert nur den aufrufenden Flask-Thread)"""
+        event = threading.Event()
+        with self._send_lock:
+            call_id = self._next_id
+            self._next_id += 1
+            self._pending[call_id] = [event, None]
+        message = MSG_CALL + json.dumps({'id': call_id, 'method': method, 'args': args}).encode('utf-8')
+        if not self.send(message) or not event.wait(timeout):
+            self._pending.pop(call_id, None)
+            raise TimeoutError(f"Keine Antwort vom Echtzeitprozess ({method})")
+        response = self._pending.pop(call_id)[1]
+        if 'error' in response:
+            raise RuntimeError(response['error'])
+        return response.get('result')
+
+    def state(self) -> Dict[str, Any]:
+        """Letzter konsistenter Zustand (nur bei neuer Version neu dekodiert)"""
+        version = self.state_block.version()
+        if version != self._state_version:
+            result = self.state_block.read()
+            if result is not None:
+                self._state_version, data = result
+                self._state = json.loads(data)
+        return self._state
+
+    def poll(self) -> bool:
+        """Antworten zuordnen und übernommene Joystick-Samples melden (Watcher-Thread)"""
+        busy = False
+        while True:
+            message = self.responses.get()
+            if message is None:
+                break
+            busy = True
+            response = json.loads(message)
+            if response.get('shutdown'):
+                self.shutdown = True
+                continue
+            pending = self._pending.get(response.get('id'))
+            if pending is not None:
+                pending[1] = response
+                pending[0].set()
+
+        applied = self.state().get('applied')
+        if applied != self._applied:
+            if self._applied is not None and self.on_applied:
+                self.on_applied()
+            self._applied = applied
+        return busy
+
+    def close(self):
+        for channel in (self.commands, self.stops, self.responses, self.state_block):
+            channel.close()
+
+
+class _MotorProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+        self._follower = _FollowerProxy(client)
+
+    @property
+    def follower(self):
+        return self._follower if self._client.state().get('follower') is not None else None
+
+    def get_status(self) -> dict:
+        return self._client.state().get('motor_status', {})
+
+    def get_current_values(self) -> dict:
+        return self._client.state().get('current_values', {'left': 1500, 'right': 1500})
+
+    def emergency_stop(self) -> bool:
+        return self._client.command('emergency_stop')
+
+    def start_path_following(self, waypoints) -> bool:
+        return bool(self._client.call('start_path_following', waypoints=[list(w) for w in waypoints]))
+
+    def stop_path_following(self, reason: str = 'stopped') -> bool:
+        return self._client.command('stop_path_following', reason=reason)
+
+
+class _FollowerProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def get_status(self) -> dict:
+        return self._client.state().get('follower') or {}
+
+    @property
+    def max_step_us(self) -> float:
+        return self.get_status().get('step_max_us', 0.0)
+
+
+class _SafetyProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def get_status(self) -> dict:
+        return self._client.state().get('safety_status', {})
+
+
+class _JoystickProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+        self.safety = _SafetyProxy(client)
+
+    @property
+    def on_applied(self):
+        return self._client.on_applied
+
+    @on_applied.setter
+    def on_applied(self, callback):
+        self._client.on_applied = callback
+
+    def submit(self, sample: JoystickSample, source: str = '') -> bool:
+        return self._client.send(encode_joystick(sample, source))
+
+    def forget_client(self, source: str):
+        self._client.command('joystick_forget', source=source)
+
+    def disable(self) -> bool:
+        return self._client.command('joystick_disable')
+
+    def set_max_speed(self, max_speed: float):
+        self._client.command('set_max_speed', max_speed=max_speed)
+
+    def get_status(self) -> dict:
+        return self._client.state().get('joystick_status', {})
+
+
+class _CANProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def get_status(self) -> dict:
+        return self._client.state().get('can_status', {})
+
+    def get_sensor_data(self) -> dict:
+        return self._client.state().get('sensor_data', {})
+
+    def request_sensor_status(self) -> bool:
+        return bool(self._client.call('request_sensor_status'))
+
+    def restart_sensor_hub(self) -> bool:
+        return bool(self._client.call('restart_sensor_hub'))
+
+
+class _GPIOProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def output(self, pin: int, state):
+        self._client.command('gpio_output', pin=pin, state=int(bool(state)))
+
+
+class _PWMProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def get_mower_speed(self) -> int:
+        return self._client.state().get('mower_speed', 0)
+
+    def set_mower_speed(self, speed: int):
+        self._client.command('set_mower_speed', speed=speed)
+
+    def stop_mower(self):
+        self._client.command('stop_mower')
+
+
+class _RecorderProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def query(self, start=None, end=None, columns=None, max_points: int = 2000) -> dict:
+        return self._client.call('recorder_query', start=start, end=end, columns=columns, max_points=max_points)
+
+
+class _TracerProxy:
+    def __init__(self, client: BridgeClient):
+        self._client = client
+
+    def render_prometheus(self) -> str:
+        return self._client.call('render_tracer')
+
+
+class _SiteProxy:
+    """Grenzen aus der lokal geladenen Standort-Datei, Position aus dem Zustand"""
+
+    def __init__(self, site, client: BridgeClient):
+        from ..navigation.site import SitePosition
+        self._position_type = SitePosition
+        self._client = client
+        self.boundary = site.boundary
+        self.no_go = site.no_go
+
+    @property
+    def position(self):
+        position = self._client.state().get('site_position')
+        return self._position_type(*position) if position else None
+
+    def get_status(self) -> dict:
+        return self._client.state().get('site') or {}
+
+
+class _CoverageProxy:
+    """Raster nur lesend eingeblendet (Kacheln werden hier kodiert), Reset im Echtzeitprozess"""
+
+    def __init__(self, raster, client: BridgeClient):
+        self._raster = raster
+        self._client = client
+
+    def get_status(self) -> dict:
+        return self._raster.get_status()
+
+    def tile_versions(self):
+        return self._raster.tile_versions()
+
+    def tile_png(self, tx: int, ty: int):
+        return self._raster.tile_png(tx, ty)
+
+    def reset(self):
+        self._client.call('coverage_reset')
+
+
+def run_web_process(config_dict: Dict[str, Any], command_name: str, response_name: str,
+                    state_name: str, stop_name: str, parent_pid: int,
+                    coverage_source: Optional[Dict[str, str]] = None):
+    """Einstiegspunkt des UI-Prozesses"""
+    from ..config import Config
+    from ..navigation.coverage_raster import CoverageRaster
+    from ..navigation.site import Site
+    from ..navigation.waypoint_planner import CoveragePlanner
+    from .web_server import WebServer
+
+    config = Config.from_dict(config_dict)
+    logging.basicConfig(
+        level=getattr(logging, config.logging.level.upper(), logging.INFO),
+        format=config.logging.format
+    )
+    logger = logging.getLogger(__name__)
+
+    client = BridgeClient(command_name, response_name, state_name, stop_name, config.web.process_poll_interval)
+    try:
+        web = WebServer(config.web, _MotorProxy(client), _JoystickProxy(client), _CANProxy(client), _GPIOProxy(client))
+        web.tracer = _TracerProxy(client)
+        web.set_hardware_refs(config.light, config.mower, _PWMProxy(client))
+        web.set_recorder(_RecorderProxy(client) if config.recorder.enabled else None)
+        web.set_planner(CoveragePlanner(
+            cutting_width=config.navigation.cutting_width,
+            overlap=config.navigation.overlap,
+            edge_margin=config.navigation.edge_margin,
+            min_stripe_length=config.navigation.min_stripe_length,
+            time_budget=config.navigation.time_budget
+        ))
+        if config.navigation.site_file:
+            try:
+                site = Site.from_file(config.navigation.site_file, cell_size=config.navigation.geofence_cell_size)
+                web.set_site(_SiteProxy(site, client))
+            except (OSError, ValueError, KeyError) as e:
+                logger.error(f"❌ Standort konnte im Web-Prozess nicht geladen werden: {e}")
+        if coverage_source:
+            try:
+                coverage = CoverageRaster.attach(filepath=coverage_source['file'], shm_name=coverage_source['shm'])
+                web.set_coverage(_CoverageProxy(coverage, client))
+            except (OSError, ValueError) as e:
+                logger.error(f"❌ Mähabdeckung im Web-Prozess nicht lesbar: {e}")
+        web.start()
+
+        while not client.shutdown and os.getppid() == parent_pid:
+            if not client.poll():
+                time.sleep(client.poll_interval)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        client.close()
@@ -6,10 +6,16 @@ REST API + WebSocket für UGV-Steuerung
 
 import logging
 import threading
+import time
 from typing import Optional
 
+from ..control.joystick_input import JoystickSample, decode_joystick_packet
+from ..monitoring.latency_tracer import get_tracer
+from ..navigation.area_calculator import area_with_holes
+from .status_stream import StatusStream
+
 try:
-    from flask import Flask, render_template, jsonify, request
+    from flask import Flask, Response, render_template, jsonify, request
     from flask_socketio import SocketIO, emit
     FLASK_AVAILABLE = True
     SOCKETIO_AVAILABLE = True
@@ -44,6 +50,10 @@ class WebServer:
         self.joystick = joystick_handler
         self.can = can_handler
         self.gpio = gpio_controller
+        self.tracer = get_tracer()
+        
+        # Änderungsbasierte Status-Updates pro Client
+        self.status_stream = StatusStream(base_interval=0.1, max_interval=1.0)
         
         # Flask-App
         self.flask_available = FLASK_AVAILABLE
@@ -57,6 +67,16 @@ class WebServer:
         self.light_config = None
         self.mower_config = None
         self.pwm_controller = None
+        self.recorder = None
+        self.planner = None
+        self.site = None
+        self.coverage = None
+        self._site_area = None
+        
+        # PWM-Echo an Clients mit begrenzter Rate
+        self._pwm_echo_interval = 1.0 / config.pwm_echo_rate if config.pwm_echo_rate > 0 else 0.0
+        self._last_pwm_echo = 0.0
+        self.joystick.on_applied = self._emit_pwm_update_limited
         
         # Status
         self.can_enabled = True
@@ -79,6 +99,44 @@ class WebServer:
         self.mower_config = mower_config
         self.pwm_controller = pwm_controller
     
+    def set_recorder(self, recorder):
+        """
+        Setzt den Telemetrie-Recorder für /api/history
+        
+        Args:
+            recorder: TelemetryRecorder-Instanz oder None
+        """
+        self.recorder = recorder
+    
+    def set_planner(self, planner):
+        """
+        Setzt den Bahnplaner für /api/navigation/plan
+        
+        Args:
+            planner: CoveragePlanner-Instanz oder None
+        """
+        self.planner = planner
+    
+    def set_site(self, site):
+        """
+        Setzt den Standort (ENU-Ursprung + Geofence) für /api/navigation/*
+        
+        Args:
+            site: Site-Instanz oder None
+        """
+        self.site = site
+        if site and site.boundary:
+            self._site_area = area_with_holes(site.boundary[0], site.boundary[1:] + site.no_go)
+    
+    def set_coverage(self, coverage):
+        """
+        Setzt das Mähabdeckungs-Raster für /api/coverage
+        
+        Args:
+            coverage: CoverageRaster-Instanz (oder Proxy im Web-Prozess) oder None
+        """
+        self.coverage = coverage
+    
     def _init_flask(self):
         """Initialisiert Flask-App mit Socket.IO"""
         try:
@@ -128,6 +186,7 @@ class WebServer:
                 'can_status': self.can.get_status(),
                 'motor_status': self.motor.get_status(),
                 'joystick_status': self.joystick.get_status(),
+                'safety_status': self.joystick.safety.get_status(),
                 'sensor_data': self.can.get_sensor_data(),
                 'light_state': self.light_state,
                 'mower_state': self.mower_state,
@@ -139,11 +198,16 @@ class WebServer:
             """Schaltet CAN Ein/Aus"""
             self.can_enabled = not self.can_enabled
             
+            # Im Web-Prozess melden die Proxys False, wenn der Stopp nicht zugestellt wurde
+            stopped = True
             if not self.can_enabled:
-                self.motor.emergency_stop()
-                self.joystick.disable()
+                stopped = self.motor.emergency_stop() is not False
+                stopped = self.joystick.disable() is not False and stopped
             
             self.logger.info(f"CAN {'aktiviert' if self.can_enabled else 'deaktiviert'}")
+            if not stopped:
+                return jsonify({'can_enabled': self.can_enabled, 'success': False,
+                                'error': 'Not-Halt nicht zugestellt'}), 503
             return jsonify({'can_enabled': self.can_enabled})
         
         @self.app.route('/api/light/toggle', methods=['POST'])
@@ -193,13 +257,162 @@ class WebServer:
             """Verarbeitet Joystick-Input"""
             if not self.can_enabled:
                 data = request.get_json()
-                x = data.get('x', 0.0)
-                y = data.get('y', 0.0)
-                
-                self.joystick.update(x, y)
+                self.joystick.submit(self._sample_from_json(data), 'rest')
             
             return jsonify({'success': True})
         
+        @self.app.route('/api/metrics')
+        def api_metrics():
+            """Latenz- und Timing-Metriken im Prometheus-Textformat"""
+            return Response(self._render_metrics(), mimetype='text/plain; version=0.0.4')
+        
+        @self.app.route('/api/history')
+        def api_history():
+            """Zeitreihen aus dem Telemetrie-Recorder (?start=&end=&columns=a,b&max_points=)"""
+            if not self.recorder:
+                return jsonify({'success': False, 'error': 'Recorder deaktiviert'}), 404
+            
+            try:
+                start = request.args.get('start', type=float)
+                end = request.args.get('end', type=float)
+                max_points = request.args.get('max_points', default=2000, type=int)
+                columns = request.args.get('columns')
+                result = self.recorder.query(
+                    start=start,
+                    end=end,
+                    columns=columns.split(',') if columns else None,
+                    max_points=max(1, min(max_points, 20000))
+                )
+                return jsonify({'success': True, **result})
+            except Exception as e:
+                self.logger.error(f"❌ History-Abfrage Fehler: {e}")
+                return jsonify({'success': False, 'error': str(e)}), 400
+        
+        @self.app.route('/api/navigation/plan', methods=['POST'])
+        def api_navigation_plan():
+            """Plant Mähbahnen für {outer: [[x, y], ...], holes: [...], angle?, start?} (Meter, lokal)
+            
+            Ohne outer wird die Fläche des Standorts verwendet (Löcher + No-Go-Zonen, Start = aktuelle Position).
+            """
+            if not self.planner:
+                return jsonify({'success': False, 'error': 'Bahnplanung nicht verfügbar'}), 404
+            
+            try:
+                plan = self._plan_from_request(request.get_json(silent=True) or {})
+                return jsonify({
+                    'success': True,
+                    'waypoints': [[round(w.x, 3), round(w.y, 3), w.mowing] for w in plan.waypoints],
+                    'cells': plan.cells,
+                    'stripes': plan.stripes,
+                    'area': round(plan.area, 2),
+                    'covered_area': round(plan.covered_area, 2),
+                    'mow_length': round(plan.mow_length, 2),
+                    'transit_length': round(plan.transit_length, 2),
+                    'stripe_angle': round(plan.stripe_angle, 2),
+                    'planning_ms': round(plan.planning_ms, 2)
+                })
+            except (KeyError, TypeError, ValueError) as e:
+                self.logger.error(f"❌ Bahnplanung Fehler: {e}")
+                return jsonify({'success': False, 'error': str(e)}), 400
+        
+        @self.app.route('/api/navigation/follow', methods=['POST'])
+        def api_navigation_follow():
+            """Startet die Bahnfolge auf {waypoints: [[x, y, mowing], ...]} oder auf einem neuen Plan
+            
+            Ohne waypoints wird wie bei /api/navigation/plan geplant. Nur im autonomen Modus (CAN aktiv).
+            """
+            if not self.motor.follower:
+                return jsonify({'success': False, 'error': 'Bahnfolge nicht verfügbar'}), 404
+            if not self.can_enabled:
+                return jsonify({'success': False, 'error': 'Autonomer Modus (CAN) nicht aktiv'}), 409
+            
+            try:
+                data = request.get_json(silent=True) or {}
+                if 'waypoints' in data:
+                    waypoints = [(float(w[0]), float(w[1]), bool(w[2]) if len(w) > 2 else True)
+                                 for w in data['waypoints']]
+                elif self.planner:
+                    waypoints = [(w.x, w.y, w.mowing) for w in self._plan_from_request(data).waypoints]
+                else:
+                    raise ValueError("Keine Wegpunkte angegeben und keine Bahnplanung verfügbar")
+            except (KeyError, TypeError, ValueError, IndexError) as e:
+                self.logger.error(f"❌ Bahnfolge Fehler: {e}")
+                return jsonify({'success': False, 'error': str(e)}), 400
+            
+            if not self.motor.start_path_following(waypoints):
+                return jsonify({'success': False, 'error': 'Bahnfolge konnte nicht starten',
+                                'follower': self.motor.follower.get_status()}), 409
+            return jsonify({'success': True, 'waypoints': len(waypoints)})
+        
+        @self.app.route('/api/navigation/stop', methods=['POST'])
+        def api_navigation_stop():
+            """Beendet die Bahnfolge (Bremsen mit Ramping)"""
+            if self.motor.stop_path_following('stopped') is False:
+                return jsonify({'success': False, 'error': 'Stopp-Befehl nicht zugestellt'}), 503
+            return jsonify({'success': True})
+        
+        @self.app.route('/api/navigation/follower')
+        def api_navigation_follower():
+            """Bahnfolge-Status mit Querabweichung, Kursfehler und Taktzeiten"""
+            if not self.motor.follower:
+                return jsonify({'success': False, 'error': 'Bahnfolge nicht verfügbar'}), 404
+            
+            return jsonify({'success': True, **self.motor.follower.get_status()})
+        
+        @self.app.route('/api/navigation/position')
+        def api_navigation_position():
+            """Letzte Position im lokalen ENU-Rahmen inkl. Geofence-Prüfung"""
+            if not self.site:
+                return jsonify({'success': False, 'error': 'Kein Standort geladen'}), 404
+            
+            return jsonify({'success': True, **self.site.get_status()})
+        
+        @self.app.route('/api/coverage')
+        def api_coverage():
+            """Mähabdeckung: Fläche, Anteil an der Standortfläche, Versionen der Kacheln mit Abdeckung"""
+            if not self.coverage:
+                return jsonify({'success': False, 'error': 'Mähabdeckung nicht verfügbar'}), 404
+            
+            status = self.coverage.get_status()
+            return jsonify({
+                'success': True,
+                **status,
+                'site_area': round(self._site_area, 2) if self._site_area else None,
+                'coverage_percent': round(100.0 * status['mowed_area'] / self._site_area, 1)
+                if self._site_area else None,
+                'tile_versions': self.coverage.tile_versions()
+            })
+        
+        @self.app.route('/api/coverage/tile/<int:tx>/<int:ty>.png')
+        def api_coverage_tile(tx, ty):
+            """Kachel als PNG (ETag = Epoche-Version, 304 wenn unverändert)"""
+            tile = self.coverage.tile_png(tx, ty) if self.coverage else None
+            if tile is None:
+                return jsonify({'success': False, 'error': 'Kachel nicht vorhanden'}), 404
+            
+            etag, png = tile
+            if request.if_none_match.contains(etag):
+                response = Response(status=304)
+            else:
+                response = Response(png, mimetype='image/png')
+            response.set_etag(etag)
+            response.headers['Cache-Control'] = 'no-cache'
+            return response
+        
+        @self.app.route('/api/coverage/reset', methods=['POST'])
+        def api_coverage_reset():
+            """Löscht die Mähabdeckung (neuer Mähdurchgang)"""
+            if not self.coverage:
+                return jsonify({'success': False, 'error': 'Mähabdeckung nicht verfügbar'}), 404
+            
+            try:
+                self.coverage.reset()
+            except (RuntimeError, TimeoutError) as e:
+                self.logger.error(f"❌ Mähabdeckung zurücksetzen fehlgeschlagen: {e}")
+                return jsonify({'success': False, 'error': str(e)}), 503
+            self.logger.info("Mähabdeckung zurückgesetzt")
+            return jsonify({'success': True})
+        
         @self.app.route('/api/sensor/status', methods=['GET'])
         def api_sensor_status():
             """Fordert Sensor-Status an"""
@@ -224,31 +437,46 @@ class WebServer:
         def handle_connect():
             """Client verbunden"""
             self.logger.info("🔌 WebSocket Client verbunden")
-            # Initial Status senden
-            self._emit_status_update()
+            # Initial Status senden (Full-Resync, danach nur Patches)
+            self.status_stream.add_client(request.sid)
+            self._emit_status_full(request.sid)
 
         @self.socketio.on('disconnect')
         def handle_disconnect():
             """Client getrennt"""
             self.logger.info("🔌 WebSocket Client getrennt")
+            self.status_stream.remove_client(request.sid)
+            self.joystick.forget_client(request.sid)
             # Joystick deaktivieren bei Disconnect
             self.joystick.disable()
 
+        @self.socketio.on('status_hello')
+        def handle_status_hello(data):
+            """Client meldet unterstützte Kodierungen - Full-Resync in gewählter Kodierung"""
+            encoding = self.status_stream.set_encoding(request.sid, (data or {}).get('encodings', []))
+            self.logger.debug(f"Status-Kodierung für {request.sid}: {encoding}")
+            self._emit_status_full(request.sid)
+
         @self.socketio.on('joystick_update')
         def handle_joystick_update(data):
-            """Joystick-Position Update"""
+            """Joystick-Position Update (JSON, optional mit 'seq' und 't')"""
             if not self.can_enabled:
-                x = data.get('x', 0.0)
-                y = data.get('y', 0.0)
-                self.joystick.update(x, y)
-                # PWM-Werte zurücksenden
-                self._emit_pwm_update()
+                self.joystick.submit(self._sample_from_json(data), request.sid)
+
+        @self.socketio.on('joystick_bin')
+        def handle_joystick_bin(data):
+            """Joystick-Position Update (binär, 13 Bytes mit Sequenznummer)"""
+            if not self.can_enabled and isinstance(data, (bytes, bytearray)):
+                sample = decode_joystick_packet(bytes(data))
+                if sample is not None:
+                    self.joystick.submit(sample, request.sid)
 
         @self.socketio.on('joystick_release')
         def handle_joystick_release():
             """Joystick losgelassen"""
             if not self.can_enabled:
-                self.joystick.disable()
+                if self.joystick.disable() is False:
+                    self.socketio.emit('stop_failed', {'error': 'Joystick-Stopp nicht zugestellt'}, to=request.sid)
                 self._emit_pwm_update()
 
         @self.socketio.on('max_speed_update')
@@ -258,38 +486,143 @@ class WebServer:
             self.joystick.set_max_speed(max_speed)
             self.logger.info(f"Max Speed: {max_speed}%")
 
-    def _emit_status_update(self):
-        """Sendet Status-Update an alle Clients"""
-        if not self.socketio:
-            return
+    def _plan_from_request(self, data: dict):
+        """Plant über die übergebene Fläche oder die des Standorts (siehe /api/navigation/plan)"""
+        start = data.get('start')
+        if 'outer' in data:
+            outer = [tuple(p) for p in data['outer']]
+            holes = [[tuple(p) for p in hole] for hole in data.get('holes', [])]
+        elif self.site and self.site.boundary:
+            outer = self.site.boundary[0]
+            holes = self.site.boundary[1:] + self.site.no_go
+            if start is None and self.site.position:
+                start = (self.site.position.x, self.site.position.y)
+        else:
+            raise ValueError("Keine Fläche angegeben und kein Standort geladen")
+        return self.planner.plan(
+            outer,
+            holes,
+            angle=data.get('angle'),
+            start=tuple(start) if start else None
+        )
 
-        status = {
+    def _render_metrics(self) -> str:
+        """Baut den Prometheus-Export (Latenz-Histogramme + Ramping-Scheduler)"""
+        lines = [self.tracer.render_prometheus()]
+        
+        scheduler = self.motor.get_status().get('scheduler')
+        if scheduler:
+            lines.append(
+                "# HELP ugv_ramping_jitter_max_seconds Maximaler Jitter des Ramping-Takts\n"
+                "# TYPE ugv_ramping_jitter_max_seconds gauge\n"
+                f"ugv_ramping_jitter_max_seconds {scheduler['jitter_max_ms'] / 1000.0:.6f}\n"
+                "# HELP ugv_ramping_overruns_total Ramping-Takte mit Deadline-Überschreitung\n"
+                "# TYPE ugv_ramping_overruns_total counter\n"
+                f"ugv_ramping_overruns_total {scheduler['overruns']}\n"
+            )
+        
+        supervisor = self.joystick.safety.get_status().get('supervisor')
+        if supervisor and supervisor.get('running'):
+            lines.append(
+                "# HELP ugv_safety_reaction_worst_seconds Längste beobachtete Not-Halt-Reaktionszeit des Supervisors\n"
+                "# TYPE ugv_safety_reaction_worst_seconds gauge\n"
+                f"ugv_safety_reaction_worst_seconds {supervisor['reaction_worst_ms'] / 1000.0:.6f}\n"
+                "# HELP ugv_safety_trips_total Auslösungen des Safety Supervisors\n"
+                "# TYPE ugv_safety_trips_total counter\n"
+                f"ugv_safety_trips_total {supervisor['trips']}\n"
+                "# HELP ugv_safety_cycle_max_seconds Längster Prüftakt des Supervisors\n"
+                "# TYPE ugv_safety_cycle_max_seconds gauge\n"
+                f"ugv_safety_cycle_max_seconds {supervisor['cycle_max_ms'] / 1000.0:.6f}\n"
+            )
+        
+        follower = self.motor.follower
+        if follower:
+            tracking = follower.get_status()['tracking']
+            lines.append(
+                "# HELP ugv_path_cross_track_error_meters Aktuelle Querabweichung zur Bahn (links positiv)\n"
+                "# TYPE ugv_path_cross_track_error_meters gauge\n"
+                f"ugv_path_cross_track_error_meters {tracking['cross_track_error']:.4f}\n"
+                "# HELP ugv_path_cross_track_rms_meters RMS der Querabweichung auf Mähstreifen (aktueller Pfad)\n"
+                "# TYPE ugv_path_cross_track_rms_meters gauge\n"
+                f"ugv_path_cross_track_rms_meters {tracking['cross_track_rms']:.4f}\n"
+                "# HELP ugv_path_step_max_seconds Maximale Rechenzeit eines Bahnfolge-Takts\n"
+                "# TYPE ugv_path_step_max_seconds gauge\n"
+                f"ugv_path_step_max_seconds {follower.max_step_us / 1e6:.6f}\n"
+            )
+        return ''.join(lines)
+    
+    def _build_status(self) -> dict:
+        """Baut den vollständigen Status (einmal pro Tick für alle Clients)"""
+        motor_status = self.motor.get_status()
+        joystick_status = self.joystick.get_status()
+
+        return {
             'can_enabled': self.can_enabled,
             'pwm_enabled': True,
             'monitor_enabled': True,
             'can_status': self.can.get_status(),
-            'motor_status': self.motor.get_status(),
-            'joystick_status': self.joystick.get_status(),
-            'joystick_enabled': self.joystick.get_status().get('enabled', False),
+            'motor_status': motor_status,
+            'joystick_status': joystick_status,
+            'joystick_enabled': joystick_status.get('enabled', False),
             'sensor_data': self.can.get_sensor_data(),
             'light_state': self.light_state,
             'light_enabled': self.light_config.enabled if self.light_config else False,
             'mower_state': self.mower_state,
             'mower_enabled': self.mower_config.enabled if self.mower_config else False,
             'mower_speed': self.pwm_controller.get_mower_speed() if self.pwm_controller else 0,
-            'current_pwm': self.motor.get_status().get('current_pwm', {'left': 1500, 'right': 1500}),
-            'max_speed_percent': self.joystick.get_status().get('max_speed', 100)
+            'current_pwm': motor_status.get('current_values', {'left': 1500, 'right': 1500}),
+            'max_speed_percent': joystick_status.get('max_speed', 100)
         }
 
-        self.socketio.emit('status_update', status)
+    def _emit_status_full(self, sid: str):
+        """Sendet den vollständigen Status an einen Client"""
+        if not self.socketio:
+            return
+
+        payload = self.status_stream.full_status(sid, self._build_status())
+        if payload is not None:
+            self.socketio.emit('status_full', payload, to=sid)
+
+    def _emit_status_updates(self):
+        """Sendet fällige Status-Patches an alle Clients (nur Änderungen)"""
+        if not self.socketio or not self.status_stream.has_clients():
+            return
+
+        for sid, event, payload in self.status_stream.collect_updates(self._build_status()):
+            self.socketio.emit(
+                event,
+                payload,
+                to=sid,
+                callback=lambda *args, sid=sid: self.status_stream.on_ack(sid)
+            )
+
+    @staticmethod
+    def _sample_from_json(data: dict) -> JoystickSample:
+        """JSON-Joystick-Input in ein Sample wandeln (seq/t optional)"""
+        seq = data.get('seq')
+        client_ms = data.get('t')
+        return JoystickSample(
+            seq=int(seq) if seq is not None else None,
+            client_ms=int(client_ms) if client_ms is not None else None,
+            x=float(data.get('x', 0.0)),
+            y=float(data.get('y', 0.0)),
+            received_ns=time.perf_counter_ns()
+        )
+
+    def _emit_pwm_update_limited(self):
+        """PWM-Echo nach übernommenen Joystick-Samples, höchstens mit pwm_echo_rate"""
+        now = time.monotonic()
+        if now - self._last_pwm_echo < self._pwm_echo_interval:
+            return
+        self._last_pwm_echo = now
+        self._emit_pwm_update()
 
     def _emit_pwm_update(self):
         """Sendet PWM-Update an alle Clients"""
         if not self.socketio:
             return
 
-        motor_status = self.motor.get_status()
-        current_pwm = motor_status.get('current_pwm', {'left': 1500, 'right': 1500})
+        current_pwm = self.motor.get_current_values()
 
         self.socketio.emit('pwm_update', {
             'left': int(current_pwm['left']),
@@ -318,12 +651,11 @@ class WebServer:
         self.logger.info(f"✅ Web-Server gestartet auf {self.config.host}:{self.config.port}")
     
     def _status_update_loop(self):
-        """Sendet regelmäßig Status-Updates (100ms)"""
-        import time
+        """Prüft alle 100ms auf fällige Status-Patches (Rate pro Client adaptiv)"""
         while self.running:
             try:
-                self._emit_status_update()
-                time.sleep(0.1)  # 100ms = 10 Hz
+                self._emit_status_updates()
+                time.sleep(self.status_stream.base_interval)  # 100ms = 10 Hz
             except Exception as e:
                 self.logger.error(f"❌ Status-Update Fehler: {e}")
                 time.sleep(1.0)
@@ -374,7 +706,8 @@ class WebServer:
             'flask_available': self.flask_available,
             'running': self.running,
             'host': self.config.host,
-            'port': self.config.port
+            'port': self.config.port,
+            'status_stream': self.status_stream.get_stats()
         }
     
     def cleanup(self):
@@ -1,66 +1,178 @@
 """
-CAN Protocol - Multi-Frame JSON-Kommunikation für den Sensor Hub.
+CAN Protocol - Multi-Frame JSON-/Binär-Kommunikation für den Sensor Hub.
+
+Klassisch: 8-Byte-Frames (2 Bytes Header + 6 Bytes Nutzdaten). CAN-FD: Frames bis
+64 Bytes (62 Bytes Nutzdaten), der letzte Frame wird nur bis zur nächsten gültigen
+FD-Länge aufgefüllt.
 """
 
+import bisect
 import logging
-import threading
 import time
-from typing import Any, Dict, Optional
+from collections import deque
+from typing import Deque, Dict, List, Optional, Tuple
+
+MAX_FRAMES_PER_MESSAGE = 255
+HEADER_SIZE = 2
+CLASSIC_FRAME_SIZE = 8
+# Gültige CAN-FD-Datenlängen (DLC 0-15)
+FD_FRAME_LENGTHS = (0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64)
+FD_MAX_PAYLOAD = FD_FRAME_LENGTHS[-1] - HEADER_SIZE
+
+
+def fd_frame_length(length: int) -> int:
+    """Kleinste gültige CAN-FD-Datenlänge >= length."""
+    return FD_FRAME_LENGTHS[bisect.bisect_left(FD_FRAME_LENGTHS, min(length, FD_FRAME_LENGTHS[-1]))]
+
+
+def fd_capable(interface: str) -> Optional[bool]:
+    """Prüft über die MTU (72 = CAN-FD, 16 = klassisch), ob das SocketCAN-Interface FD kann.
+
+    None, wenn die MTU nicht lesbar ist (kein SocketCAN, Tests).
+    """
+    try:
+        with open(f"/sys/class/net/{interface}/mtu") as f:
+            return int(f.read().strip()) >= 72
+    except (OSError, ValueError):
+        return None
+
+
+class _ReassemblySlot:
+    """Vorallokierter Reassembly-Kontext für genau eine Arbitration-ID."""
+
+    __slots__ = ('buffers', 'active', 'total', 'stride', 'mask', 'complete_mask', 'generation')
+
+    def __init__(self, capacity: int):
+        # Zwei Puffer: einer wird befüllt, der andere hält die zuletzt übergebene Nachricht
+        self.buffers = [bytearray(capacity), bytearray(capacity)]
+        self.active = False
+        self.total = 0
+        self.stride = 0
+        self.mask = 0
+        self.complete_mask = 0
+        self.generation = 0
 
 
 class CANProtocol:
-    """Thread-sichere Buffer-Verwaltung für Multi-Frame JSON-Nachrichten."""
+    """Reassembly von Multi-Frame-Nachrichten mit festen Slots und Completion-Bitmaske.
+
+    decode_frame()/decode_message() sind für genau einen Reader-Thread ausgelegt
+    und arbeiten ohne Lock und ohne Allokation pro Frame. Die Nutzdaten pro Frame
+    einer Nachricht ergeben sich aus der Länge ihres ersten Frames, ein FD-Empfänger
+    nimmt daher auch klassische Nachrichten an.
+    """
 
-    def __init__(self, max_frame_size: int = 6, frame_timeout: float = 1.0):
+    def __init__(self, max_frame_size: int = 6, frame_timeout: float = 1.0, fd: bool = False):
+        """
+        Args:
+            max_frame_size: Nutzdaten pro Frame beim Senden (klassisch max. 6, FD max. 62)
+            frame_timeout: Timeout für unvollständige Nachrichten (Sekunden)
+            fd: CAN-FD-Frames senden und empfangen
+        """
         self.logger = logging.getLogger(__name__)
-        self.max_frame_size = max_frame_size
+        self.fd = fd
+        if fd:
+            # Auf eine gültige FD-Länge runden, damit alle vollen Frames gleich lang sind
+            self.max_frame_size = fd_frame_length(HEADER_SIZE + max(1, max_frame_size)) - HEADER_SIZE
+        else:
+            self.max_frame_size = min(max_frame_size, CLASSIC_FRAME_SIZE - HEADER_SIZE)
+        self._slot_stride = FD_MAX_PAYLOAD if fd else CLASSIC_FRAME_SIZE - HEADER_SIZE
         self.frame_timeout = frame_timeout
-        self._frame_buffer: Dict[int, Dict[str, Any]] = {}
-        self._buffer_lock = threading.Lock()
+        self._slots: Dict[int, _ReassemblySlot] = {}
+        # Alle Nachrichten haben denselben Timeout, daher sind die Deadlines
+        # monoton - eine FIFO reicht als Timer-Queue (O(1) pro Prüfung).
+        self._deadlines: Deque[Tuple[float, int, int]] = deque()
+
+    def encode_frames(self, data: bytes) -> List[bytes]:
+        """Teilt Nutzdaten in Frames [frame_idx, total_frames, ...chunk] auf.
+
+        Klassisch immer 8 Bytes, FD volle Frames mit 2 + max_frame_size Bytes und der
+        letzte Frame auf die nächste gültige FD-Länge aufgefüllt.
+        """
+        size = self.max_frame_size
+        total_frames = (len(data) + size - 1) // size
+        if total_frames > MAX_FRAMES_PER_MESSAGE:
+            self.logger.error(f"❌ Nachricht zu groß für {MAX_FRAMES_PER_MESSAGE} Frames ({len(data)} Bytes)")
+            return []
+        frames = []
+        for frame_idx in range(total_frames):
+            chunk = data[frame_idx * size:(frame_idx + 1) * size]
+            frame = bytes([frame_idx, total_frames]) + chunk
+            length = fd_frame_length(len(frame)) if self.fd else HEADER_SIZE + size
+            frames.append(frame + b'\x00' * (length - len(frame)))
+        return frames
 
     def decode_frame(self, arbitration_id: int, frame_data: bytes) -> Optional[str]:
         """Dekodiert einen Frame und liefert vollständiges JSON zurück, sobald komplett."""
+        full_data = self.decode_message(arbitration_id, frame_data)
+        if full_data is None:
+            return None
+
+        try:
+            return bytes(full_data).rstrip(b'\x00').decode('utf-8')
+        except UnicodeDecodeError as exc:
+            self.logger.error(f"❌ UTF-8 Decode Fehler: {exc}")
+            return None
+
+    def decode_message(self, arbitration_id: int, frame_data: bytes) -> Optional[memoryview]:
+        """Dekodiert einen Frame und liefert die rohen Nutzdaten (inkl. Padding), sobald komplett.
+
+        Das Ergebnis ist eine memoryview auf den Slot-Puffer und bleibt gültig,
+        bis für dieselbe Arbitration-ID die nächste Nachricht komplett ist.
+        """
         if len(frame_data) < 2:
             return None
 
         frame_idx = frame_data[0]
-        total_frames = frame_data[1]
-        chunk = frame_data[2:2 + self.max_frame_size]
-
-        with self._buffer_lock:
-            if frame_idx == 0:
-                self._frame_buffer[arbitration_id] = {
-                    'total': total_frames,
-                    'frames': [None] * total_frames,
-                    'timestamp': time.time()
-                }
-
-            if arbitration_id not in self._frame_buffer:
+        slot = self._slots.get(arbitration_id)
+
+        if frame_idx == 0:
+            total_frames = frame_data[1]
+            if total_frames == 0:
+                return None
+            # Volle Frames: Nutzdaten pro Frame = Länge des ersten Frames - Header
+            stride = len(frame_data) - HEADER_SIZE
+            if stride > self._slot_stride:
                 return None
+            if slot is None:
+                slot = _ReassemblySlot(MAX_FRAMES_PER_MESSAGE * self._slot_stride)
+                self._slots[arbitration_id] = slot
+            slot.active = True
+            slot.total = total_frames
+            slot.stride = stride
+            slot.mask = 0
+            slot.complete_mask = (1 << total_frames) - 1
+            slot.generation += 1
+            self._deadlines.append((time.monotonic() + self.frame_timeout, arbitration_id, slot.generation))
+        elif slot is None or not slot.active or frame_idx >= slot.total:
+            return None
 
-            buffer = self._frame_buffer[arbitration_id]
-            if frame_idx < len(buffer['frames']):
-                buffer['frames'][frame_idx] = chunk
+        stride = slot.stride
+        chunk = frame_data[HEADER_SIZE:HEADER_SIZE + stride]
+        offset = frame_idx * stride
+        buffer = slot.buffers[0]
+        buffer[offset:offset + len(chunk)] = chunk
+        if len(chunk) < stride:
+            buffer[offset + len(chunk):offset + stride] = bytes(stride - len(chunk))
+        slot.mask |= 1 << frame_idx
 
-            if all(frame is not None for frame in buffer['frames']):
-                full_data = b''.join(buffer['frames']).rstrip(b'\x00')
-                del self._frame_buffer[arbitration_id]
-                try:
-                    return full_data.decode('utf-8')
-                except UnicodeDecodeError as exc:
-                    self.logger.error(f"❌ UTF-8 Decode Fehler: {exc}")
-                    return None
+        if slot.mask != slot.complete_mask:
+            return None
 
-        return None
+        slot.active = False
+        slot.buffers.reverse()
+        return memoryview(slot.buffers[1])[:slot.total * stride]
 
     def cleanup_old_buffers(self):
-        """Entfernt alte unvollständige Buffer."""
-        current_time = time.time()
-        with self._buffer_lock:
-            expired_ids = [
-                arb_id for arb_id, buffer in self._frame_buffer.items()
-                if current_time - buffer['timestamp'] > self.frame_timeout
-            ]
-            for arb_id in expired_ids:
-                del self._frame_buffer[arb_id]
-                self.logger.warning(f"⚠️ Frame-Buffer Timeout für ID 0x{arb_id:X}")
\ No newline at end of file
+        """Entfernt alte unvollständige Buffer (O(1), solange nichts abgelaufen ist)."""
+        deadlines = self._deadlines
+        if not deadlines:
+            return
+
+        current_time = time.monotonic()
+        while deadlines and deadlines[0][0] <= current_time:
+            _, arb_id, generation = deadlines.popleft()
+            slot = self._slots.get(arb_id)
+            if slot is not None and slot.active and slot.generation == generation:
+                slot.active = False
+                self.logger.warning(f"⚠️ Frame-Buffer Timeout für ID 0x{arb_id:X}")
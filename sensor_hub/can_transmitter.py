@@ -0,0 +1,193 @@
+"""
+CAN Transmitter - Sende-Queue für Multi-Frame-Nachrichten des Sensor Hubs.
+
+Ein eigener Thread übergibt jede Nachricht am Stück an SocketCAN. Statt fester
+Pausen zwischen den Frames wird die TX-Queue des Kernels als Backpressure genutzt:
+Ist sie voll (ENOBUFS), wartet der Thread kurz und sendet denselben Frame erneut.
+On-Demand-Antworten haben Vorrang vor periodischer Telemetrie, diese vor der
+Diagnose; von Telemetrie und Diagnose wird jeweils nur der neueste Stand gehalten.
+"""
+
+import errno
+import logging
+import threading
+import time
+from collections import deque
+from typing import Callable, Deque, List, Optional, Tuple
+
+try:
+    import can
+except ImportError:  # pragma: no cover - optional in tests
+    can = None
+
+logger = logging.getLogger(__name__)
+
+PRIORITY_COMMAND = 0
+PRIORITY_TELEMETRY = 1
+PRIORITY_DIAGNOSTICS = 2
+
+# Nachricht: (arbitration_id, frames, Einreihzeitpunkt)
+_Message = Tuple[int, List[bytes], float]
+
+
+def _default_message_factory(arbitration_id: int, data: bytes):
+    return can.Message(arbitration_id=arbitration_id, data=data, is_extended_id=False)
+
+
+def fd_message_factory(bitrate_switch: bool = True) -> Callable:
+    """Nachrichtenfabrik für CAN-FD-Frames (optional mit Bitrate Switch)."""
+    def factory(arbitration_id: int, data: bytes):
+        return can.Message(arbitration_id=arbitration_id, data=data, is_extended_id=False,
+                           is_fd=True, bitrate_switch=bitrate_switch)
+    return factory
+
+
+def _is_tx_queue_full(exc: Exception) -> bool:
+    """Erkennt ENOBUFS (Kernel-TX-Queue voll) in python-can- und OS-Exceptions."""
+    for attr in ('errno', 'error_code'):
+        if getattr(exc, attr, None) == errno.ENOBUFS:
+            return True
+    cause = exc.__cause__ or exc.__context__
+    return isinstance(cause, OSError) and cause.errno == errno.ENOBUFS
+
+
+class CANTransmitter:
+    """Priorisierte Sende-Queue mit einem dedizierten TX-Thread."""
+
+    def __init__(self, bus, message_factory: Optional[Callable] = None,
+                 send_timeout: float = 0.05, max_backoff: float = 0.005,
+                 max_pending_commands: int = 16):
+        """
+        Args:
+            bus: python-can Bus (oder kompatibles Objekt mit send())
+            message_factory: Erzeugt Nachrichtenobjekte aus (arbitration_id, data)
+            send_timeout: Maximale Wartezeit pro Frame bei voller TX-Queue
+            max_backoff: Obergrenze für das Warten zwischen Sendeversuchen
+            max_pending_commands: Maximale Anzahl wartender Antworten
+        """
+        self.bus = bus
+        self.message_factory = message_factory or _default_message_factory
+        self.send_timeout = send_timeout
+        self.max_backoff = max_backoff
+
+        self._commands: Deque[_Message] = deque(maxlen=max_pending_commands)
+        self._telemetry: Optional[_Message] = None
+        self._diagnostics: Optional[_Message] = None
+        self._condition = threading.Condition()
+        self._running = False
+        self._thread: Optional[threading.Thread] = None
+
+        self.messages_sent = 0
+        self.frames_sent = 0
+        self.send_errors = 0
+        self.telemetry_replaced = 0
+        self.diagnostics_replaced = 0
+        self.backpressure_waits = 0
+        self.last_queue_delay = 0.0
+
+    def start(self):
+        """Startet den TX-Thread."""
+        if self._running:
+            return
+        self._running = True
+        self._thread = threading.Thread(target=self._tx_loop, daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """Stoppt den TX-Thread; wartende Nachrichten werden verworfen."""
+        with self._condition:
+            self._running = False
+            self._condition.notify()
+        if self._thread:
+            self._thread.join(timeout=1.0)
+
+    def submit(self, arbitration_id: int, frames: List[bytes], priority: int = PRIORITY_COMMAND) -> bool:
+        """Reiht eine Nachricht ein. Telemetrie/Diagnose ersetzt noch nicht gesendete derselben Klasse."""
+        if not frames:
+            return False
+
+        message = (arbitration_id, frames, time.monotonic())
+        with self._condition:
+            if priority == PRIORITY_TELEMETRY:
+                if self._telemetry is not None:
+                    self.telemetry_replaced += 1
+                self._telemetry = message
+            elif priority == PRIORITY_DIAGNOSTICS:
+                if self._diagnostics is not None:
+                    self.diagnostics_replaced += 1
+                self._diagnostics = message
+            else:
+                self._commands.append(message)
+            self._condition.notify()
+        return True
+
+    def _next_message(self) -> Optional[_Message]:
+        with self._condition:
+            while (self._running and not self._commands and self._telemetry is None
+                   and self._diagnostics is None):
+                self._condition.wait()
+            if not self._running:
+                return None
+            if self._commands:
+                return self._commands.popleft()
+            if self._telemetry is not None:
+                message, self._telemetry = self._telemetry, None
+                return message
+            message, self._diagnostics = self._diagnostics, None
+            return message
+
+    def _tx_loop(self):
+        while True:
+            message = self._next_message()
+            if message is None:
+                return
+            self.send_now(*message)
+
+    def send_now(self, arbitration_id: int, frames: List[bytes], queued_at: Optional[float] = None) -> bool:
+        """Sendet alle Frames einer Nachricht direkt hintereinander (nur aus dem TX-Thread)."""
+        if queued_at is not None:
+            self.last_queue_delay = time.monotonic() - queued_at
+
+        for frame_idx, frame_data in enumerate(frames):
+            if not self._send_frame(self.message_factory(arbitration_id, frame_data)):
+                self.send_errors += 1
+                logger.error("❌ CAN-Send Fehler (Frame %d/%d, ID 0x%X)", frame_idx, len(frames), arbitration_id)
+                return False
+            self.frames_sent += 1
+
+        self.messages_sent += 1
+        return True
+
+    def _send_frame(self, msg) -> bool:
+        deadline = time.monotonic() + self.send_timeout
+        backoff = 0.0002
+        while True:
+            try:
+                self.bus.send(msg, timeout=self.send_timeout)
+                return True
+            except Exception as e:
+                if not _is_tx_queue_full(e) or time.monotonic() + backoff > deadline:
+                    logger.debug("CAN-Send abgebrochen: %s", e)
+                    return False
+                # TX-Queue voll: Kernel arbeitet die Queue ab, kurz warten und erneut versuchen
+                self.backpressure_waits += 1
+                time.sleep(backoff)
+                backoff = min(backoff * 2, self.max_backoff)
+
+    def get_status(self) -> dict:
+        """Gibt Sende-Statistiken zurück."""
+        with self._condition:
+            pending_commands = len(self._commands)
+            telemetry_pending = self._telemetry is not None
+        return {
+            'running': self._running,
+            'messages_sent': self.messages_sent,
+            'frames_sent': self.frames_sent,
+            'send_errors': self.send_errors,
+            'pending_commands': pending_commands,
+            'telemetry_pending': telemetry_pending,
+            'telemetry_replaced': self.telemetry_replaced,
+            'diagnostics_replaced': self.diagnostics_replaced,
+            'backpressure_waits': self.backpressure_waits,
+            'last_queue_delay_ms': round(self.last_queue_delay * 1000.0, 3),
+        }
@@ -32,6 +32,8 @@ NTRIP_USERNAME = os.getenv('NTRIP_USERNAME', '')  # Aus .env laden!
 NTRIP_PASSWORD = os.getenv('NTRIP_PASSWORD', '')  # Aus .env laden!
 NTRIP_TIMEOUT = float(os.getenv('NTRIP_TIMEOUT', '10.0'))
 NTRIP_RECONNECT_INTERVAL = float(os.getenv('NTRIP_RECONNECT_INTERVAL', '30.0'))
+# RTCM3-Frames per CRC-24Q validieren und direkt auf den GPS-Port schreiben (false = Rohdaten durchreichen)
+NTRIP_RTCM_FRAMING = _env_flag('NTRIP_RTCM_FRAMING', True)
 
 # ============================================================================
 # IMU KONFIGURATION
@@ -42,6 +44,20 @@ IMU_PORT = os.getenv('IMU_PORT', '/dev/serial/by-id/usb-1a86_USB_Serial-if00-por
 IMU_BAUDRATE = int(os.getenv('IMU_BAUDRATE', '9600'))
 IMU_TIMEOUT = float(os.getenv('IMU_TIMEOUT', '1.0'))
 IMU_SAMPLE_RATE = int(os.getenv('IMU_SAMPLE_RATE', '200'))
+# Fenster (Samples) für Stillstandserkennung, Gyro-Bias und Vibrations-RMS
+IMU_STATS_WINDOW = int(os.getenv('IMU_STATS_WINDOW', '100'))
+
+# EKF-Pose aus IMU (Prädiktion) + RTK-Position/Dual-Antenna-Heading (Korrektur)
+POSE_ESTIMATOR_ENABLED = _env_flag('POSE_ESTIMATOR_ENABLED', True)
+POSE_OUTPUT_RATE = float(os.getenv('POSE_OUTPUT_RATE', '100'))
+
+# Gemeinsamer epoll-Reactor für GPS, IMU und NTRIP (0 = ein Reader-Thread pro Gerät)
+IO_REACTOR_ENABLED = _env_flag('IO_REACTOR_ENABLED', True)
+
+# Geräte beim Start parallel öffnen, NTRIP verbindet im Hintergrund (0 = alles nacheinander)
+STARTUP_PARALLEL = _env_flag('STARTUP_PARALLEL', True)
+# Maximale Wartezeit auf GPS/IMU/CAN beim Start (s), danach läuft der Hub mit dem an, was bereit ist
+STARTUP_TIMEOUT = float(os.getenv('STARTUP_TIMEOUT', '5.0'))
 
 # ============================================================================
 # WEB-INTERFACE KONFIGURATION
@@ -50,11 +66,47 @@ WEB_HOST = os.getenv('WEB_HOST', '0.0.0.0')
 WEB_PORT = int(os.getenv('WEB_PORT', '8080'))
 WEB_DEBUG = _env_flag('WEB_DEBUG', False)
 WEB_UPDATE_RATE = int(os.getenv('WEB_UPDATE_RATE', '2'))
+# Vorberechnete API-Antworten: max. Rebuild-Rate (Hz) und spätester Rebuild ohne Sensor-Update (s)
+WEB_STATUS_RATE = float(os.getenv('WEB_STATUS_RATE', '10'))
+WEB_STATUS_REFRESH = float(os.getenv('WEB_STATUS_REFRESH', '1.0'))
+
+# ============================================================================
+# ABDECKUNGSRASTER (gefahrene Spur als PNG-Kacheln unter /api/coverage)
+# ============================================================================
+COVERAGE_ENABLED = _env_flag('COVERAGE_ENABLED', False)
+# Rasterdatei (mmap, übersteht Neustarts), leer = nur im Speicher
+COVERAGE_FILE = os.getenv('COVERAGE_FILE', '')
+# Quadrat mit dieser Kantenlänge (m) um den ersten Fix bzw. den Ursprung der Datei
+COVERAGE_SIZE = float(os.getenv('COVERAGE_SIZE', '100'))
+COVERAGE_RESOLUTION = float(os.getenv('COVERAGE_RESOLUTION', '0.05'))  # m pro Zelle
+COVERAGE_TILE_SIZE = int(os.getenv('COVERAGE_TILE_SIZE', '256'))  # Zellen pro Kachelkante
+COVERAGE_WIDTH = float(os.getenv('COVERAGE_WIDTH', '0.5'))  # gestempelte Breite (m)
+# Größere Sprünge zwischen zwei Fixes werden nicht verbunden (m)
+COVERAGE_MAX_GAP = float(os.getenv('COVERAGE_MAX_GAP', '1.0'))
+# Nur RTK-Fixed-Positionen stempeln (0 = jeder Fix)
+COVERAGE_RTK_ONLY = _env_flag('COVERAGE_RTK_ONLY', True)
+# Messermitte relativ zur Position (GPS-Antenne bzw. Pose), in m vorwärts/links im Fahrzeugrahmen
+COVERAGE_BLADE_OFFSET_FORWARD = float(os.getenv('COVERAGE_BLADE_OFFSET_FORWARD', '0.0'))
+COVERAGE_BLADE_OFFSET_LEFT = float(os.getenv('COVERAGE_BLADE_OFFSET_LEFT', '0.0'))
 
 # ============================================================================
 # TELEMETRIE KONFIGURATION
 # ============================================================================
-CAN_SEND_RATE = int(os.getenv('CAN_SEND_RATE', '10'))
+# Maximale Pose-Rate (Hz); gesendet wird nur bei Bewegung oder Änderung über dem Totband
+CAN_SEND_RATE = float(os.getenv('CAN_SEND_RATE', '50'))
+# Lebenszeichen ohne Änderung (s) - muss unter safety.can_timeout und follower.pose_timeout
+# des Motor Controllers bleiben (je 0.5 s)
+TELEMETRY_HEARTBEAT = float(os.getenv('TELEMETRY_HEARTBEAT', '0.25'))
+TELEMETRY_POSITION_DEADBAND = float(os.getenv('TELEMETRY_POSITION_DEADBAND', '0.01'))  # m
+TELEMETRY_ANGLE_DEADBAND = float(os.getenv('TELEMETRY_ANGLE_DEADBAND', '0.2'))  # Grad
+# Ab dieser EKF-Geschwindigkeit (m/s) gilt das Fahrzeug als fahrend -> volle Pose-Rate
+TELEMETRY_MOVING_SPEED = float(os.getenv('TELEMETRY_MOVING_SPEED', '0.05'))
+# Diagnose-JSON auf CAN_SENSOR_HUB_ID: höchstens TELEMETRY_DIAG_RATE Hz bei Änderung,
+# sonst alle TELEMETRY_DIAG_HEARTBEAT s (Rate 0 = aus)
+TELEMETRY_DIAG_RATE = float(os.getenv('TELEMETRY_DIAG_RATE', '1.0'))
+TELEMETRY_DIAG_HEARTBEAT = float(os.getenv('TELEMETRY_DIAG_HEARTBEAT', '10.0'))
+# 'binary' = gepacktes 24-Byte-Frame (4 CAN-Frames, 1 FD-Frame), 'json' = Legacy JSON-Transport
+CAN_TELEMETRY_FORMAT = os.getenv('CAN_TELEMETRY_FORMAT', 'binary').strip().lower()
 
 # ============================================================================
 # CAN-BUS KONFIGURATION
@@ -64,8 +116,18 @@ CAN_INTERFACE = os.getenv('CAN_INTERFACE', 'can0')
 CAN_BITRATE = int(os.getenv('CAN_BITRATE', '1000000'))
 CAN_SENSOR_HUB_ID = int(os.getenv('CAN_SENSOR_HUB_ID', '0x100'), 0)
 CAN_CONTROLLER_ID = int(os.getenv('CAN_CONTROLLER_ID', '0x200'), 0)
+CAN_TELEMETRY_ID = int(os.getenv('CAN_TELEMETRY_ID', '0x101'), 0)
 CAN_MAX_FRAME_SIZE = int(os.getenv('CAN_MAX_FRAME_SIZE', '6'))
+# CAN-FD: 64-Byte-Frames, Interface per 'ip link set can0 type can bitrate 1000000 dbitrate 5000000 fd on'
+CAN_FD = _env_flag('CAN_FD', False)
+CAN_DATA_BITRATE = int(os.getenv('CAN_DATA_BITRATE', '5000000'))
+CAN_FD_BRS = _env_flag('CAN_FD_BRS', True)
+CAN_FD_FRAME_SIZE = int(os.getenv('CAN_FD_FRAME_SIZE', '62'))
 CAN_FRAME_TIMEOUT = float(os.getenv('CAN_FRAME_TIMEOUT', '1.0'))
+# SocketCAN-Filter im Kernel (nur registrierte IDs werden empfangen)
+CAN_KERNEL_FILTERS = _env_flag('CAN_KERNEL_FILTERS', True)
+# Zusätzliche Filter 'id[:mask],...', z.B. '0x180:0x7F0' für einen ID-Bereich
+CAN_EXTRA_FILTERS = os.getenv('CAN_EXTRA_FILTERS', '')
 
 # ============================================================================
 # LOGGING KONFIGURATION
@@ -73,4 +135,12 @@ CAN_FRAME_TIMEOUT = float(os.getenv('CAN_FRAME_TIMEOUT', '1.0'))
 LOG_LEVEL = os.getenv('LOG_LEVEL', 'INFO')
 LOG_FILE = os.getenv('LOG_FILE', '/var/log/sensor_hub.log')
 LOG_FORMAT = os.getenv('LOG_FORMAT', '[%(asctime)s] %(levelname)s - %(message)s')
+# Asynchroner Ring-Logger: emit() ohne Formatierung/I/O, gebündeltes Schreiben im Hintergrund
+LOG_ASYNC = _env_flag('LOG_ASYNC', True)
+LOG_RING_SIZE = int(os.getenv('LOG_RING_SIZE', '4096'))
+LOG_FLUSH_INTERVAL = float(os.getenv('LOG_FLUSH_INTERVAL', '2.0'))
+# Meldungen pro Aufrufstelle und Sekunde (0 = unbegrenzt), Rest wird zusammengefasst
+LOG_RATE_LIMIT = int(os.getenv('LOG_RATE_LIMIT', '20'))
+# Zusätzlich in LOG_FILE schreiben (Journal reicht meist, spart SD-Karten-Schreibzugriffe)
+LOG_FILE_ENABLED = _env_flag('LOG_FILE_ENABLED', False)
 
@@ -0,0 +1,274 @@
+"""
+Streaming-Parser für NMEA- und Unicore-Binärnachrichten des UM982.
+
+Der Parser arbeitet direkt auf dem Byte-Stream der seriellen Schnittstelle:
+Satz-IDs werden per bytearray.startswith im Puffer verglichen (ohne Slices),
+Checksummen werden nur für Nachrichten geprüft, die tatsächlich ausgewertet
+werden, und es werden nur die benötigten Felder dekodiert. Unterstützt:
+
+- NMEA GGA (Position, Höhe, Fix-Qualität, Satelliten) und HDT (Heading)
+- Unicore Binär BESTNAV (ID 2118) und HEADING (ID 972) mit CRC-32
+"""
+
+import struct
+import time
+import zlib
+from datetime import datetime, timezone
+from typing import Callable, NamedTuple, Optional
+
+NMEA_START = 0x24  # '$'
+UNICORE_SYNC = b'\xaa\x44\xb5'
+UNICORE_HEADER_SIZE = 24
+UNICORE_MSG_BESTNAV = 2118
+UNICORE_MSG_HEADING = 972
+MAX_SENTENCE_LENGTH = 128
+MAX_BINARY_LENGTH = 1024
+
+_UNICORE_HEADER = struct.Struct('<3sBHHBBHIIBBH')
+_BESTNAV_POSITION = struct.Struct('<IIddd')
+_BESTNAV_SATS_OFFSET = 64
+_HEADING = struct.Struct('<IIff')
+
+# GPS-Epoche für die Umrechnung Woche/Millisekunden -> UTC
+_GPS_EPOCH = 315964800.0
+
+# Unicore/NovAtel Positionstyp -> NMEA Fix-Qualität
+POS_TYPE_FIX_QUALITY = {
+    0: 0,    # NONE
+    16: 1,   # SINGLE
+    17: 2,   # PSRDIFF
+    18: 2,   # SBAS
+    32: 5,   # L1_FLOAT
+    33: 5,   # IONOFREE_FLOAT
+    34: 5,   # NARROW_FLOAT
+    48: 4,   # L1_INT
+    49: 4,   # WIDE_INT
+    50: 4,   # NARROW_INT
+}
+
+
+class PositionFix(NamedTuple):
+    """Dekodierte Position (aus GGA oder BESTNAV)."""
+
+    fix_quality: int
+    latitude: Optional[float]
+    longitude: Optional[float]
+    altitude: Optional[float]
+    satellites: Optional[int]
+    raw_gga: Optional[str]
+
+
+def nmea_checksum(body: bytes) -> int:
+    """XOR über alle Bytes zwischen '$' und '*'."""
+    checksum = 0
+    for byte in body:
+        checksum ^= byte
+    return checksum
+
+
+def unicore_crc32(data: bytes) -> int:
+    """CRC-32 der Unicore/NovAtel-Binärnachrichten (Init 0, ohne Final-XOR)."""
+    return zlib.crc32(data, 0xFFFFFFFF) ^ 0xFFFFFFFF
+
+
+def _nmea_coordinate(value: bytes, hemisphere: bytes, degree_digits: int) -> Optional[float]:
+    """Wandelt (d)ddmm.mmmm + Hemisphäre in Dezimalgrad."""
+    if len(value) <= degree_digits:
+        return None
+    try:
+        degrees = int(value[:degree_digits]) + float(value[degree_digits:]) / 60.0
+    except ValueError:
+        return None
+    return -degrees if hemisphere in (b'S', b'W') else degrees
+
+
+def build_gga_sentence(fix: PositionFix, utc_time: Optional[float] = None) -> str:
+    """Erzeugt einen GGA-Satz (z.B. für NTRIP-VRS, wenn der Empfänger nur Binärdaten liefert)."""
+    stamp = datetime.fromtimestamp(time.time() if utc_time is None else utc_time, tz=timezone.utc)
+    lat = abs(fix.latitude or 0.0)
+    lon = abs(fix.longitude or 0.0)
+    lat_deg = int(lat)
+    lon_deg = int(lon)
+    body = (
+        f"GPGGA,{stamp:%H%M%S}.{stamp.microsecond // 10000:02d},"
+        f"{lat_deg:02d}{(lat - lat_deg) * 60.0:010.7f},{'S' if (fix.latitude or 0.0) < 0 else 'N'},"
+        f"{lon_deg:03d}{(lon - lon_deg) * 60.0:010.7f},{'W' if (fix.longitude or 0.0) < 0 else 'E'},"
+        f"{fix.fix_quality},{fix.satellites or 0:02d},1.0,{fix.altitude or 0.0:.3f},M,0.000,M,,"
+    )
+    return f"${body}*{nmea_checksum(body.encode('ascii')):02X}"
+
+
+class GNSSStreamParser:
+    """Inkrementeller Parser; Ergebnisse werden über Callbacks gemeldet."""
+
+    def __init__(self,
+                 on_position: Optional[Callable[[PositionFix], None]] = None,
+                 on_heading: Optional[Callable[[float], None]] = None):
+        self.on_position = on_position
+        self.on_heading = on_heading
+        self._buffer = bytearray()
+
+        self.sentences_parsed = 0
+        self.sentences_ignored = 0
+        self.checksum_errors = 0
+        self.binary_messages = 0
+
+    def feed(self, data: bytes):
+        """Verarbeitet neue Bytes vom Empfänger."""
+        buf = self._buffer
+        buf += data
+        pos = 0
+        size = len(buf)
+        # Letzte Fundstellen merken und erst neu suchen, wenn pos sie überholt hat
+        # (-1 = bis Pufferende nicht vorhanden, -2 = noch nicht gesucht); sonst würde
+        # z.B. ein reiner NMEA-Stream für jeden Satz bis zum Pufferende nach Sync suchen
+        start = sync = -2
+
+        while pos < size:
+            if start != -1 and start < pos:
+                start = buf.find(NMEA_START, pos)
+            if sync != -1 and sync < pos:
+                sync = buf.find(UNICORE_SYNC, pos)
+            if start < 0 and sync < 0:
+                # Ein angefangener Sync-Header darf am Pufferende stehen bleiben
+                pos = max(pos, size - (len(UNICORE_SYNC) - 1))
+                break
+
+            if sync >= 0 and (start < 0 or sync < start):
+                consumed = self._parse_binary(buf, sync, size)
+            else:
+                consumed = self._parse_nmea(buf, start, size)
+
+            if consumed == 0:
+                # Nachricht noch unvollständig
+                pos = sync if sync >= 0 and (start < 0 or sync < start) else start
+                break
+            pos = consumed
+
+        if pos:
+            del buf[:pos]
+
+    def _parse_nmea(self, buf: bytearray, start: int, size: int) -> int:
+        end = buf.find(b'\n', start)
+        if end < 0:
+            if size - start > MAX_SENTENCE_LENGTH:
+                return start + 1
+            return 0
+
+        # Dispatch auf Satz-ID direkt im Puffer ($ + 2 Zeichen Talker + ID)
+        if buf.startswith(b'GGA', start + 3):
+            handler = self._handle_gga
+        elif buf.startswith(b'HDT', start + 3):
+            handler = self._handle_hdt
+        else:
+            self.sentences_ignored += 1
+            return end + 1
+
+        star = buf.rfind(b'*', start, end)
+        if star < 0 or end - star < 3:
+            self.checksum_errors += 1
+            return end + 1
+
+        try:
+            expected = int(buf[star + 1:star + 3], 16)
+        except ValueError:
+            expected = -1
+        if nmea_checksum(buf[start + 1:star]) != expected:
+            self.checksum_errors += 1
+            return end + 1
+
+        self.sentences_parsed += 1
+        handler(buf, start, star, end)
+        return end + 1
+
+    def _handle_gga(self, buf: bytearray, start: int, star: int, end: int):
+        fields = buf[start:star].split(b',')
+        if len(fields) < 10:
+            return
+
+        try:
+            fix_quality = int(fields[6]) if fields[6] else 0
+        except ValueError:
+            fix_quality = 0
+        try:
+            satellites = int(fields[7]) if fields[7] else None
+        except ValueError:
+            satellites = None
+        try:
+            altitude = float(fields[9]) if fields[9] else None
+        except ValueError:
+            altitude = None
+
+        if self.on_position:
+            self.on_position(PositionFix(
+                fix_quality=fix_quality,
+                latitude=_nmea_coordinate(fields[2], fields[3], 2),
+                longitude=_nmea_coordinate(fields[4], fields[5], 3),
+                altitude=altitude,
+                satellites=satellites,
+                raw_gga=buf[start:end].rstrip(b'\r').decode('ascii', errors='ignore'),
+            ))
+
+    def _handle_hdt(self, buf: bytearray, start: int, star: int, end: int):
+        comma = buf.find(b',', start)
+        if comma < 0 or comma >= star:
+            return
+        field_end = buf.find(b',', comma + 1, star)
+        try:
+            heading = float(buf[comma + 1:field_end if field_end > 0 else star])
+        except ValueError:
+            return
+        if self.on_heading:
+            self.on_heading(heading)
+
+    def _parse_binary(self, buf: bytearray, sync: int, size: int) -> int:
+        if size - sync < UNICORE_HEADER_SIZE:
+            return 0
+
+        (_, _, msg_id, msg_length, _, _, week, tow_ms, _, _, leap_seconds, _) = \
+            _UNICORE_HEADER.unpack_from(buf, sync)
+        if msg_length > MAX_BINARY_LENGTH:
+            return sync + 1
+
+        total = UNICORE_HEADER_SIZE + msg_length + 4
+        if size - sync < total:
+            return 0
+
+        crc_offset = sync + UNICORE_HEADER_SIZE + msg_length
+        (crc,) = struct.unpack_from('<I', buf, crc_offset)
+        if unicore_crc32(memoryview(buf)[sync:crc_offset]) != crc:
+            self.checksum_errors += 1
+            return sync + 1
+
+        self.binary_messages += 1
+        payload = sync + UNICORE_HEADER_SIZE
+        if msg_id == UNICORE_MSG_BESTNAV and msg_length >= _BESTNAV_SATS_OFFSET + 2:
+            sol_stat, pos_type, lat, lon, hgt = _BESTNAV_POSITION.unpack_from(buf, payload)
+            # Nur SOL_COMPUTED zählt; unbekannte Typen (z.B. PROPAGATED) gelten als kein Fix
+            fix = PositionFix(
+                fix_quality=POS_TYPE_FIX_QUALITY.get(pos_type, 0) if sol_stat == 0 else 0,
+                latitude=lat,
+                longitude=lon,
+                altitude=hgt,
+                satellites=buf[payload + _BESTNAV_SATS_OFFSET + 1],
+                raw_gga=None,
+            )
+            utc = _GPS_EPOCH + week * 604800 + tow_ms / 1000.0 - leap_seconds
+            if self.on_position:
+                self.on_position(fix._replace(raw_gga=build_gga_sentence(fix, utc)))
+        elif msg_id == UNICORE_MSG_HEADING and msg_length >= _HEADING.size:
+            sol_stat, _, _, heading = _HEADING.unpack_from(buf, payload)
+            if sol_stat == 0 and self.on_heading:
+                self.on_heading(float(heading))
+        else:
+            self.sentences_ignored += 1
+
+        return sync + total
+
+    def get_stats(self) -> dict:
+        return {
+            'sentences_parsed': self.sentences_parsed,
+            'sentences_ignored': self.sentences_ignored,
+            'checksum_errors': self.checksum_errors,
+            'binary_messages': self.binary_messages,
+        }
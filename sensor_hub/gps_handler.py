@@ -1,24 +1,55 @@
 """
 GPS Handler für Holybro UM982 RTK-GPS
-Liest NMEA-Daten und extrahiert Position, Heading und RTK-Status
-Verwendet pynmea2 für robustes NMEA-Parsing mit Checksummen-Validierung
+Liest NMEA- oder Unicore-Binärdaten und extrahiert Position, Heading und RTK-Status
+Verwendet den Streaming-Parser aus gnss_parser (Checksummen-Validierung, nur GGA/HDT/BESTNAV/HEADING)
 """
 
-import serial
 import threading
 import time
 import logging
 from datetime import datetime
-from typing import Dict, Optional
-import pynmea2
+from typing import Callable, Dict, List, NamedTuple, Optional
+
+from gnss_parser import GNSSStreamParser, PositionFix
+from io_reactor import configure_low_latency
+from sensor_snapshot import Snapshot, SnapshotCell
+
+try:
+    import serial
+except ImportError:  # pragma: no cover - optional in tests
+    serial = None
 
 logger = logging.getLogger(__name__)
 
+# Fix Quality: 0=invalid, 1=GPS, 2=DGPS, 4=RTK Fixed, 5=RTK Float
+FIX_QUALITY_STATUS = {
+    0: "NO GPS",
+    1: "GPS FIX",
+    2: "DGPS",
+    4: "RTK FIXED",
+    5: "RTK FLOAT",
+}
+
+# Änderungs-Events (werden nach Freigabe des Parser-Locks zugestellt)
+EVENT_FIX_CHANGED = 'fix_changed'  # value = neuer RTK-Status, previous = alter Status
+EVENT_GGA = 'gga'                  # value = roher/synthetisierter GGA-Satz
+EVENT_POSITION = 'position'        # value = PositionFix (jede dekodierte Position)
+EVENT_HEADING = 'heading'          # value = Dual-Antenna-Heading in Grad
+
+
+class GPSEvent(NamedTuple):
+    """Typisiertes Änderungs-Event des GPSHandlers"""
+
+    kind: str
+    value: object
+    previous: object
+    timestamp: float
+
 
 class GPSHandler:
-    """Verwaltet GPS-Kommunikation und Datenverarbeitung mit pynmea2"""
+    """Verwaltet GPS-Kommunikation und Datenverarbeitung"""
     
-    def __init__(self, port: str, baudrate: int, timeout: float = 5.0):
+    def __init__(self, port: str, baudrate: int, timeout: float = 5.0, reactor=None):
         """
         Initialisiert GPS Handler
         
@@ -26,10 +57,12 @@ class GPSHandler:
             port: UART Port (z.B. '/dev/serial0')
             baudrate: Baud Rate (230400 für UM982)
             timeout: Timeout für GPS-Daten
+            reactor: Optionaler IOReactor; ohne Reactor liest ein eigener Thread
         """
         self.port = port
         self.baudrate = baudrate
         self.timeout = timeout
+        self.reactor = reactor
         self.serial_port = None
         self.running = False
         self.reader_thread = None
@@ -45,20 +78,34 @@ class GPSHandler:
         self.last_update_time = None
         self.last_raw_gga = None  # Letzter roher GGA-Satz für NTRIP
         
-        # Thread-Sicherheit
+        # Thread-Sicherheit: Lock nur für den Writer, Leser nutzen den Snapshot
         self.lock = threading.Lock()
+        self._snapshot = SnapshotCell(self._build_snapshot_data())
+        
+        # Event-Abonnenten und unter dem Lock gesammelte, noch nicht zugestellte Events
+        self._subscribers: Dict[str, List[Callable[[GPSEvent], None]]] = {}
+        self._pending_events: List[GPSEvent] = []
+        self.parser = GNSSStreamParser(on_position=self._on_position, on_heading=self._on_heading)
     
     def connect(self) -> bool:
         """Verbindet mit GPS-Gerät"""
         try:
+            if serial is None:
+                raise ImportError("pyserial nicht installiert")
             self.serial_port = serial.Serial(
                 port=self.port,
                 baudrate=self.baudrate,
                 timeout=self.timeout
             )
             self.running = True
-            self.reader_thread = threading.Thread(target=self._reader_loop, daemon=True)
-            self.reader_thread.start()
+            if self.reactor:
+                configure_low_latency(self.serial_port, self.port)
+                if not self.reactor.register(self.serial_port, self.feed,
+                                             on_close=self._on_port_closed, name='gps'):
+                    raise IOError("GPS-Port konnte nicht im I/O Reactor registriert werden")
+            else:
+                self.reader_thread = threading.Thread(target=self._reader_loop, daemon=True)
+                self.reader_thread.start()
             logger.info(f"✅ GPS verbunden: {self.port} @ {self.baudrate} baud")
             return True
         except Exception as e:
@@ -68,6 +115,8 @@ class GPSHandler:
     def disconnect(self):
         """Trennt GPS-Verbindung"""
         self.running = False
+        if self.reactor and self.serial_port:
+            self.reactor.unregister(self.serial_port)
         if self.reader_thread:
             self.reader_thread.join(timeout=2.0)
         if self.serial_port and self.serial_port.is_open:
@@ -75,72 +124,96 @@ class GPSHandler:
         logger.info("GPS getrennt")
     
     def _reader_loop(self):
-        """Liest NMEA-Sätze in Schleife"""
+        """Liest den Byte-Stream blockweise und übergibt ihn dem Streaming-Parser"""
         while self.running:
             try:
-                if self.serial_port and self.serial_port.in_waiting:
-                    line = self.serial_port.readline().decode('utf-8', errors='ignore').strip()
-                    if line:
-                        self._parse_nmea(line)
+                if self.serial_port:
+                    # Blockiert bis mindestens ein Byte da ist, liest dann alles Verfügbare
+                    chunk = self.serial_port.read(self.serial_port.in_waiting or 1)
+                    if chunk:
+                        self.feed(chunk)
             except Exception as e:
-                logger.debug(f"GPS Read-Fehler: {e}")
+                logger.debug("GPS Read-Fehler: %s", e)
                 time.sleep(0.1)
     
+    def _on_port_closed(self):
+        """Reactor meldet EOF/Lesefehler (z.B. USB-Adapter abgezogen)"""
+        logger.error("❌ GPS-Port geschlossen oder Lesefehler")
+    
+    def subscribe(self, kind: str, callback: Callable[[GPSEvent], None]):
+        """
+        Registriert einen Callback für Änderungs-Events
+        
+        Args:
+            kind: EVENT_FIX_CHANGED, EVENT_GGA, EVENT_POSITION oder EVENT_HEADING
+            callback: Wird im Reader-Kontext (Thread/Reactor) ohne GPS-Lock aufgerufen
+        """
+        self._subscribers.setdefault(kind, []).append(callback)
+    
+    def _emit(self, kind: str, value, previous=None):
+        """Merkt ein Event vor (Aufruf unter self.lock)"""
+        if kind in self._subscribers:
+            self._pending_events.append(GPSEvent(kind, value, previous, time.time()))
+    
+    def feed(self, data: bytes):
+        """Verarbeitet rohe Bytes vom Empfänger (NMEA und/oder Unicore-Binär)"""
+        with self.lock:
+            self.parser.feed(data)
+            if not self._pending_events:
+                return
+            events, self._pending_events = self._pending_events, []
+        
+        # Zustellung außerhalb des Locks, damit Abonnenten den Parser nicht blockieren
+        for event in events:
+            for callback in self._subscribers.get(event.kind, ()):
+                try:
+                    callback(event)
+                except Exception as e:
+                    logger.warning("⚠️  GPS-Event-Callback Fehler (%s): %s", event.kind, e)
+    
     def _parse_nmea(self, sentence: str):
-        """Parst NMEA-Sätze mit pynmea2 (robust mit Checksummen-Validierung)"""
+        """Parst einen einzelnen NMEA-Satz (Kompatibilität, z.B. für Tests)"""
         if not sentence.startswith('$'):
             return
+        self.feed(sentence.encode('ascii', errors='ignore') + b'\r\n')
+    
+    def _on_position(self, fix: PositionFix):
+        """Callback des Parsers für GGA/BESTNAV (läuft unter self.lock)"""
+        if fix.fix_quality in FIX_QUALITY_STATUS:
+            status = FIX_QUALITY_STATUS[fix.fix_quality]
+            if status != self.rtk_status:
+                self._emit(EVENT_FIX_CHANGED, status, self.rtk_status)
+                self.rtk_status = status
         
-        try:
-            msg = pynmea2.parse(sentence)
-            
-            # GGA: Position, Höhe, Fix-Qualität
-            if isinstance(msg, pynmea2.GGA):
-                with self.lock:
-                    # Fix Quality: 0=invalid, 1=GPS, 2=DGPS, 4=RTK Fixed, 5=RTK Float
-                    fix_quality = msg.gps_qual if msg.gps_qual else 0
-                    
-                    if fix_quality == 0:
-                        self.rtk_status = "NO GPS"
-                    elif fix_quality == 1:
-                        self.rtk_status = "GPS FIX"
-                    elif fix_quality == 2:
-                        self.rtk_status = "DGPS"
-                    elif fix_quality == 4:
-                        self.rtk_status = "RTK FIXED"
-                    elif fix_quality == 5:
-                        self.rtk_status = "RTK FLOAT"
-                    
-                    # Position
-                    if msg.latitude:
-                        self.latitude = msg.latitude
-                    if msg.longitude:
-                        self.longitude = msg.longitude
-                    
-                    # Altitude
-                    if msg.altitude:
-                        self.altitude = msg.altitude
-                    
-                    # Satelliten
-                    if msg.num_sats:
-                        self.satellites = msg.num_sats
-                    
-                    self.last_update = time.time()
-                    self.last_update_time = datetime.now()
-                    # Speichere rohen GGA-Satz für NTRIP
-                    self.last_raw_gga = sentence
-            
-            # HDT: Heading True (von Dual-Antenna, genauer als RMC)
-            elif isinstance(msg, pynmea2.HDT):
-                with self.lock:
-                    if msg.heading:
-                        self.heading = msg.heading
+        # Position
+        if fix.latitude:
+            self.latitude = fix.latitude
+        if fix.longitude:
+            self.longitude = fix.longitude
         
-        except pynmea2.ParseError:
-            # Ignoriere Parse-Fehler (z.B. korrupte Sätze)
-            logger.debug(f"NMEA Parse-Fehler (ignoriert): {sentence[:50]}")
-        except Exception as e:
-            logger.debug(f"NMEA Verarbeitungsfehler: {e}")
+        # Altitude
+        if fix.altitude:
+            self.altitude = fix.altitude
+        
+        # Satelliten
+        if fix.satellites:
+            self.satellites = fix.satellites
+        
+        self.last_update = time.time()
+        self.last_update_time = datetime.now()
+        # Speichere rohen (bzw. bei Binärbetrieb synthetisierten) GGA-Satz für NTRIP
+        self.last_raw_gga = fix.raw_gga
+        self._snapshot.publish(self._build_snapshot_data())
+        self._emit(EVENT_POSITION, fix)
+        if fix.raw_gga:
+            self._emit(EVENT_GGA, fix.raw_gga)
+    
+    def _on_heading(self, heading: float):
+        """Callback des Parsers für HDT/HEADING (Dual-Antenna, läuft unter self.lock)"""
+        if heading:
+            self.heading = heading
+            self._snapshot.publish(self._build_snapshot_data())
+            self._emit(EVENT_HEADING, heading)
     
     def write_data(self, data: bytes):
         """
@@ -150,36 +223,57 @@ class GPSHandler:
         if self.serial_port and self.serial_port.is_open:
             try:
                 self.serial_port.write(data)
-                logger.debug(f"📤 {len(data)} Bytes an GPS gesendet")
+                logger.debug("📤 %d Bytes an GPS gesendet", len(data))
             except Exception as e:
-                logger.warning(f"⚠️ Fehler beim Schreiben auf GPS-Port: {e}")
+                logger.warning("⚠️ Fehler beim Schreiben auf GPS-Port: %s", e)
+    
+    def get_write_fd(self) -> Optional[int]:
+        """File-Descriptor des GPS-Ports für direkte Schreibzugriffe (RTCM-Relay), sonst None"""
+        port = self.serial_port
+        if port is None or not port.is_open:
+            return None
+        try:
+            return port.fileno()
+        except Exception:
+            return None
+    
+    def _build_snapshot_data(self) -> Dict:
+        """Baut den konsistenten Stand für Leser (Aufruf nur durch den Writer)"""
+        return {
+            'latitude': self.latitude,
+            'longitude': self.longitude,
+            'altitude': self.altitude,
+            'heading': self.heading,
+            'rtk_status': self.rtk_status,
+            'satellites': self.satellites,
+            'last_update': self.last_update,
+            'last_update_time': self.last_update_time.isoformat() if self.last_update_time else None,
+            'last_raw_gga': self.last_raw_gga
+        }
+    
+    def get_snapshot(self) -> Snapshot:
+        """Gibt den neuesten Snapshot (Sequenznummer + Daten) ohne Lock zurück"""
+        return self._snapshot.read()
     
     def get_last_raw_gga(self) -> Optional[str]:
         """Gibt den letzten rohen GGA-Satz zurück (für NTRIP)"""
-        with self.lock:
-            return self.last_raw_gga
+        return self._snapshot.read().data['last_raw_gga']
     
     def get_status(self) -> Dict:
-        """Gibt aktuellen GPS-Status zurück"""
-        with self.lock:
-            return {
-                'latitude': self.latitude,
-                'longitude': self.longitude,
-                'altitude': self.altitude,
-                'heading': self.heading,
-                'rtk_status': self.rtk_status,
-                'satellites': self.satellites,
-                'is_connected': self.serial_port is not None and self.serial_port.is_open,
-                'last_update': self.last_update,
-                'last_update_time': self.last_update_time.isoformat() if self.last_update_time else None
-            }
+        """Gibt aktuellen GPS-Status zurück (lock-frei)"""
+        snapshot = self._snapshot.read()
+        status = {key: value for key, value in snapshot.data.items() if key != 'last_raw_gga'}
+        status['is_connected'] = self.serial_port is not None and self.serial_port.is_open
+        status['seq'] = snapshot.seq
+        status['parser'] = self.parser.get_stats()
+        return status
     
     def get_bing_maps_url(self) -> str:
         """Generiert Bing Maps URL für aktuelle Position"""
-        with self.lock:
-            # Prüfe auf einen validen Status, nicht nur auf Koordinaten != 0
-            # (0.0, 0.0) wäre Äquator vor Afrikas Küste - nicht sinnvoll)
-            if self.rtk_status not in ["NO GPS", ""]:
-                return f"https://www.bing.com/maps?cp={self.latitude}~{self.longitude}&lvl=18"
+        data = self._snapshot.read().data
+        # Prüfe auf einen validen Status, nicht nur auf Koordinaten != 0
+        # (0.0, 0.0) wäre Äquator vor Afrikas Küste - nicht sinnvoll)
+        if data['rtk_status'] not in ["NO GPS", ""]:
+            return f"https://www.bing.com/maps?cp={data['latitude']}~{data['longitude']}&lvl=18"
         return "https://www.bing.com/maps"
 
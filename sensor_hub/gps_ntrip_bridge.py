@@ -7,8 +7,9 @@ import threading
 import time
 import logging
 from typing import Optional
-from gps_handler import GPSHandler
+from gps_handler import EVENT_FIX_CHANGED, EVENT_GGA, GPSEvent, GPSHandler
 from ntrip_client import NTRIPClient
+from rtcm_relay import RTCMRelay
 
 logger = logging.getLogger(__name__)
 
@@ -16,18 +17,22 @@ logger = logging.getLogger(__name__)
 class GPSNTRIPBridge:
     """Verbindet GPS mit NTRIP für RTK-Korrekturdaten"""
     
-    def __init__(self, gps: GPSHandler, ntrip: NTRIPClient):
+    def __init__(self, gps: GPSHandler, ntrip: NTRIPClient, rtcm_framing: bool = True):
         """
         Initialisiert GPS-NTRIP Bridge
 
         Args:
             gps: GPSHandler Instanz
             ntrip: NTRIPClient Instanz
+            rtcm_framing: RTCM3-Frames validieren und direkt auf den GPS-Port schreiben
+                          (False = Rohdaten über GPSHandler.write_data weiterreichen)
         """
         self.gps = gps
         self.ntrip = ntrip
+        self.relay = RTCMRelay(gps.get_write_fd) if rtcm_framing else None
         self.running = False
         self.monitor_thread = None
+        self._stop_event = threading.Event()
 
         # Statistiken
         self.rtk_fix_count = 0
@@ -35,11 +40,16 @@ class GPSNTRIPBridge:
         self.gps_fix_count = 0
         self.last_rtk_status = "NO GPS"
         self.rtk_fix_time = None
-        self.rtk_uptime = 0
 
-        # GPGGA Versand (für NTRIP VRS)
+        # GPGGA Versand (für NTRIP VRS): erster Satz sofort, danach höchstens alle 10 s
         self.last_gga_send_time = 0
-        self.gga_send_interval = 10.0  # Alle 10 Sekunden
+        self.last_gga_time = 0
+        self.gga_send_interval = 10.0
+        self._ntrip_was_connected = False
+
+        # Ereignisgesteuert statt Polling: GPSHandler meldet Fix-Wechsel und neue GGA-Sätze
+        self.gps.subscribe(EVENT_FIX_CHANGED, self._on_fix_changed)
+        self.gps.subscribe(EVENT_GGA, self._on_gga)
     
     def start(self) -> bool:
         """Startet die Bridge"""
@@ -49,8 +59,8 @@ class GPSNTRIPBridge:
             # NTRIP Client aktivieren (für Reconnect-Versuche)
             self.ntrip.enable()
 
-            # NTRIP Callback registrieren
-            self.ntrip.on_data_received = self._on_ntrip_data
+            # NTRIP Callback registrieren (RTCM-Relay schreibt ohne GPS-Lock direkt auf den Port)
+            self.ntrip.on_data_received = self.relay.feed if self.relay else self._on_ntrip_data
 
             # NTRIP verbinden (erster Versuch)
             initial_connected = self.ntrip.connect()
@@ -59,6 +69,7 @@ class GPSNTRIPBridge:
             # damit connect()/reconnect_if_needed() nicht parallel auf denselben
             # Socket loslaufen.
             self.running = True
+            self._stop_event.clear()
             self.monitor_thread = threading.Thread(target=self._monitor_loop, daemon=True)
             self.monitor_thread.start()
 
@@ -76,6 +87,7 @@ class GPSNTRIPBridge:
     def stop(self):
         """Stoppt die Bridge"""
         self.running = False
+        self._stop_event.set()
         if self.monitor_thread:
             self.monitor_thread.join(timeout=2.0)
         if self.ntrip:
@@ -87,52 +99,52 @@ class GPSNTRIPBridge:
         try:
             # NTRIP-Daten an GPS-Gerät senden (über öffentliche Methode für Kapselung)
             self.gps.write_data(data)
-            logger.debug(f"📤 {len(data)} Bytes NTRIP-Daten an GPS gesendet")
+            logger.debug("📤 %d Bytes NTRIP-Daten an GPS gesendet", len(data))
         except Exception as e:
-            logger.warning(f"⚠️  Fehler beim Senden von NTRIP-Daten: {e}")
+            logger.warning("⚠️  Fehler beim Senden von NTRIP-Daten: %s", e)
     
+    def _on_fix_changed(self, event: GPSEvent):
+        """GPS-Event: RTK-Status hat gewechselt (innerhalb derselben GNSS-Epoche)"""
+        if event.value == "RTK FIXED":
+            self.rtk_fix_time = event.timestamp
+        else:
+            self.rtk_fix_time = None
+        self._on_rtk_status_changed(event.previous, event.value)
+        self.last_rtk_status = event.value
+
+    def _on_gga(self, event: GPSEvent):
+        """GPS-Event: neuer GGA-Satz - an NTRIP senden, sobald das Intervall abgelaufen ist"""
+        self.last_gga_time = event.timestamp
+        if not self.ntrip.is_connected():
+            return
+        # GPGGA an NTRIP senden (für VRS - Virtuelle Referenzstation)
+        if event.timestamp - self.last_gga_send_time >= self.gga_send_interval:
+            self.last_gga_send_time = event.timestamp
+            self.ntrip.send_gga_data(event.value)
+
     def _monitor_loop(self):
-        """Überwacht RTK-Status und Verbindungen"""
+        """Überwacht die NTRIP-Verbindung (Reconnect); RTK-Status und GGA kommen als Events"""
         while self.running:
             try:
                 # NTRIP Reconnect wenn nötig
                 self.ntrip.reconnect_if_needed()
 
-                # RTK-Status überwachen
-                gps_status = self.gps.get_status()
-                current_rtk_status = gps_status['rtk_status']
-
-                # Status-Änderungen tracken
-                if current_rtk_status != self.last_rtk_status:
-                    self._on_rtk_status_changed(self.last_rtk_status, current_rtk_status)
-                    self.last_rtk_status = current_rtk_status
-
-                # RTK-Uptime berechnen
-                if current_rtk_status == "RTK FIXED":
-                    if self.rtk_fix_time is None:
-                        self.rtk_fix_time = time.time()
-                    self.rtk_uptime = time.time() - self.rtk_fix_time
-                else:
-                    self.rtk_fix_time = None
-                    self.rtk_uptime = 0
-
-                # GPGGA periodisch an NTRIP senden (für VRS - Virtuelle Referenzstation)
-                now = time.time()
-                if self.ntrip.is_connected() and now - self.last_gga_send_time > self.gga_send_interval:
-                    raw_gga = self.gps.get_last_raw_gga()
-                    if raw_gga:
-                        self.ntrip.send_gga_data(raw_gga)
-                        self.last_gga_send_time = now
-                    else:
-                        # Warnung: Kein gültiger GGA-Satz verfügbar
-                        # Dies deutet auf schlechten GPS-Empfang hin
-                        logger.warning("⚠️  Wollte GPGGA an NTRIP senden, aber kein gültiger Satz vom GPS verfügbar. Prüfe GPS-Antenne und Himmelssicht!")
-
-                time.sleep(1.0)
+                connected = self.ntrip.is_connected()
+                if connected and not self._ntrip_was_connected:
+                    # Neue Verbindung: nächsten GGA-Satz sofort senden (VRS ohne 10-s-Verzögerung)
+                    self.last_gga_send_time = 0
+                self._ntrip_was_connected = connected
+
+                if connected and time.time() - self.last_gga_time > self.gga_send_interval:
+                    # Warnung: Kein gültiger GGA-Satz verfügbar
+                    # Dies deutet auf schlechten GPS-Empfang hin
+                    logger.warning("⚠️  Wollte GPGGA an NTRIP senden, aber kein gültiger Satz vom GPS verfügbar. Prüfe GPS-Antenne und Himmelssicht!")
+
+                self._stop_event.wait(1.0)
 
             except Exception as e:
-                logger.warning(f"⚠️  Monitor-Fehler: {e}")
-                time.sleep(1.0)
+                logger.warning("⚠️  Monitor-Fehler: %s", e)
+                self._stop_event.wait(1.0)
     
     def _on_rtk_status_changed(self, old_status: str, new_status: str):
         """Wird aufgerufen wenn sich RTK-Status ändert"""
@@ -159,7 +171,8 @@ class GPSNTRIPBridge:
             'rtk_fix_count': self.rtk_fix_count,
             'rtk_float_count': self.rtk_float_count,
             'gps_fix_count': self.gps_fix_count,
-            'rtk_uptime': self.rtk_uptime,
-            'current_rtk_status': self.last_rtk_status
+            'rtk_uptime': time.time() - self.rtk_fix_time if self.rtk_fix_time else 0,
+            'current_rtk_status': self.last_rtk_status,
+            'rtcm': self.relay.get_stats() if self.relay else None
         }
 
@@ -5,7 +5,12 @@ import logging
 import struct
 import threading
 import time
-from typing import Dict, Set
+from array import array
+from typing import Callable, Dict, List, Optional, Tuple
+
+from imu_statistics import MotionStatistics
+from io_reactor import configure_low_latency
+from sensor_snapshot import Snapshot, SnapshotCell
 
 try:
     import serial
@@ -23,6 +28,125 @@ def _normalize_heading(angle: float) -> float:
     return normalized
 
 
+class WitMotionFrameParser:
+    """Stream-Parser für 11-Byte WitMotion Frames ohne Kopie pro Frame.
+
+    Der Empfangspuffer wird über einen Leseindex abgearbeitet und nur einmal pro
+    feed() kompaktiert. Der Header wird mit bytearray.find (memchr) gesucht,
+    Checksummen und Werte werden direkt im Puffer geprüft bzw. entpackt. Die
+    dekodierten Werte landen in festen Arrays (Struct-of-Arrays).
+
+    Ein Sample ist mit dem Winkel-Frame abgeschlossen (Ausgabereihenfolge 0x51,
+    0x52, 0x53[, 0x54]); on_sample() wird dann noch innerhalb von feed() aufgerufen,
+    solange die Arrays genau dieses Sample enthalten.
+    """
+
+    FRAME_HEADER = 0x55
+    FRAME_SIZE = 11
+    FRAME_ACCEL = 0x51
+    FRAME_GYRO = 0x52
+    FRAME_ANGLE = 0x53
+    FRAME_MAG = 0x54
+
+    ACCEL_SCALE = 16.0 * 9.81 / 32768.0
+    GYRO_SCALE = 2000.0 / 32768.0
+    ANGLE_SCALE = 180.0 / 32768.0
+
+    _VALUES = struct.Struct('<hhhh')
+
+    def __init__(self):
+        self._buffer = bytearray()
+
+        self.accel = array('d', [0.0, 0.0, 0.0])
+        self.gyro = array('d', [0.0, 0.0, 0.0])
+        self.angles = array('d', [0.0, 0.0, 0.0])  # roll, pitch, yaw
+        self.mag = array('d', [0.0, 0.0, 0.0])
+        self.temperature = 0.0
+
+        self.frames_seen_mask = 0  # Bit (frame_type - 0x50) je gesehenem Frame-Typ
+        self.frame_count = 0
+        self.checksum_errors = 0
+        self.bytes_discarded = 0
+
+        # Optionaler Hook pro abgeschlossenem Sample (ohne Argumente, Werte in den Arrays)
+        self.on_sample: Optional[Callable[[], None]] = None
+
+    def reset(self):
+        """Verwirft gepufferte Bytes und vergisst gesehene Frame-Typen."""
+        self._buffer.clear()
+        self.frames_seen_mask = 0
+
+    def has_seen(self, frame_type: int) -> bool:
+        return bool(self.frames_seen_mask & (1 << (frame_type - 0x50)))
+
+    def feed(self, data: bytes) -> int:
+        """Verarbeitet neue Bytes und gibt die Anzahl valider Frames zurück."""
+        buf = self._buffer
+        buf += data
+        size = len(buf)
+        pos = 0
+        frames = 0
+        unpack_values = self._VALUES.unpack_from
+        on_sample = self.on_sample
+
+        while size - pos >= self.FRAME_SIZE:
+            if buf[pos] != self.FRAME_HEADER:
+                header = buf.find(self.FRAME_HEADER, pos)
+                if header < 0:
+                    self.bytes_discarded += size - pos
+                    pos = size
+                    break
+                self.bytes_discarded += header - pos
+                pos = header
+                continue
+
+            end = pos + self.FRAME_SIZE - 1
+            if sum(buf[pos:end]) & 0xFF != buf[end]:
+                # Kein valider Frame: ab dem nächsten Byte neu synchronisieren
+                self.checksum_errors += 1
+                self.bytes_discarded += 1
+                pos += 1
+                continue
+
+            frame_type = buf[pos + 1]
+            d1, d2, d3, d4 = unpack_values(buf, pos + 2)
+            pos += self.FRAME_SIZE
+            if 0x50 <= frame_type < 0x60:
+                self.frames_seen_mask |= 1 << (frame_type - 0x50)
+
+            if frame_type == self.FRAME_ACCEL:
+                scale = self.ACCEL_SCALE
+                self.accel[0] = d1 * scale
+                self.accel[1] = d2 * scale
+                self.accel[2] = d3 * scale
+                self.temperature = d4 / 100.0
+            elif frame_type == self.FRAME_GYRO:
+                scale = self.GYRO_SCALE
+                self.gyro[0] = d1 * scale
+                self.gyro[1] = d2 * scale
+                self.gyro[2] = d3 * scale
+                self.temperature = d4 / 100.0
+            elif frame_type == self.FRAME_ANGLE:
+                scale = self.ANGLE_SCALE
+                self.angles[0] = d1 * scale
+                self.angles[1] = d2 * scale
+                self.angles[2] = d3 * scale
+                if on_sample:
+                    on_sample()
+            elif frame_type == self.FRAME_MAG:
+                self.mag[0] = float(d1)
+                self.mag[1] = float(d2)
+                self.mag[2] = float(d3)
+            frames += 1
+
+        # Nach der Schleife bleibt höchstens ein angefangener Frame übrig
+        if pos:
+            del buf[:pos]
+
+        self.frame_count += frames
+        return frames
+
+
 class WitMotionUSBIMU:
     """WitMotion USB-IMU mit klassischem 0x55/0x51..0x54 Binärprotokoll."""
 
@@ -34,31 +158,35 @@ class WitMotionUSBIMU:
     FRAME_MAG = 0x54
 
     REQUIRED_FRAMES = {FRAME_ACCEL, FRAME_GYRO, FRAME_ANGLE}
-    ACCEL_RANGE_G = 16.0
-    GYRO_RANGE_DPS = 2000.0
-    ANGLE_RANGE_DEG = 180.0
+    REQUIRED_FRAMES_MASK = sum(1 << (frame_type - 0x50) for frame_type in REQUIRED_FRAMES)
 
-    def __init__(self, port: str, baudrate: int = 9600, timeout: float = 1.0, sample_rate: int = 100):
+    def __init__(self, port: str, baudrate: int = 9600, timeout: float = 1.0, sample_rate: int = 100,
+                 reactor=None, stats_window: int = 100):
         self.port = port
         self.baudrate = baudrate
         self.timeout = timeout
         self.sample_rate = sample_rate
+        self.reactor = reactor
         self.serial_port = None
         self.running = False
         self.connected = False
         self.read_thread = None
-        self.lock = threading.Lock()
-        self._rx_buffer = bytearray()
-        self._frames_seen: Set[int] = set()
+        self.lock = threading.Lock()  # nur Writer-Seite (Parser); Leser nutzen den Snapshot
+        self._parser = WitMotionFrameParser()
+        self._parser.on_sample = self._on_parser_sample
         self.last_packet_time = None
+        # Samples des laufenden feed()-Aufrufs (accel, gyro, angles) und Zeit des letzten Samples
+        self._batch: List[Tuple[List[float], List[float], List[float]]] = []
+        self._last_sample_time = 0.0
 
-        self.raw_accel = {'x': 0.0, 'y': 0.0, 'z': 0.0}
-        self.raw_gyro = {'x': 0.0, 'y': 0.0, 'z': 0.0}
-        self.raw_angles = {'roll': 0.0, 'pitch': 0.0, 'yaw': 0.0}
-        self.raw_mag = {'x': 0.0, 'y': 0.0, 'z': 0.0}
-        self.temperature = 0.0
         self.is_calibrated = False
         self.is_stationary = False
+        # Fensterstatistik: Stillstand, Gyro-Bias und Vibrations-RMS
+        self.motion_stats = MotionStatistics(window=stats_window)
+        self._snapshot = SnapshotCell(self._build_snapshot_data())
+        # Optionaler Konsument pro dekodiertem Sample (z.B. PoseEstimator):
+        # callback(accel, gyro, angles, timestamp)
+        self.sample_callback: Optional[Callable] = None
 
     def connect(self) -> bool:
         """Öffnet die serielle Verbindung und wartet auf valide WitMotion Frames."""
@@ -69,18 +197,27 @@ class WitMotionUSBIMU:
             self.serial_port = serial.Serial(self.port, self.baudrate, timeout=self.timeout)
             self.running = True
             self.connected = True
-            self._rx_buffer.clear()
-            self._frames_seen.clear()
-
-            self.read_thread = threading.Thread(target=self._read_loop, daemon=True)
-            self.read_thread.start()
+            with self.lock:
+                self._parser.reset()
+                self.motion_stats.reset()
+                self._last_sample_time = 0.0
+                self.is_calibrated = False
+                self._snapshot.publish(self._build_snapshot_data())
+
+            if self.reactor:
+                configure_low_latency(self.serial_port, self.port)
+                if not self.reactor.register(self.serial_port, self._process_bytes,
+                                             on_close=self._on_port_closed, name='imu'):
+                    raise IOError("IMU-Port konnte nicht im I/O Reactor registriert werden")
+            else:
+                self.read_thread = threading.Thread(target=self._read_loop, daemon=True)
+                self.read_thread.start()
 
             deadline = time.time() + max(2.0, self.timeout * 5.0)
             while time.time() < deadline:
-                with self.lock:
-                    if self.REQUIRED_FRAMES.issubset(self._frames_seen):
-                        logger.info(f"✅ WitMotion liefert Frames auf {self.port} @ {self.baudrate} Baud")
-                        return True
+                if self._snapshot.read().data['data']['is_calibrated']:
+                    logger.info(f"✅ WitMotion liefert Frames auf {self.port} @ {self.baudrate} Baud")
+                    return True
                 time.sleep(0.05)
 
             logger.warning("⚠️  WitMotion-Port geöffnet, aber keine vollständige Frame-Folge empfangen")
@@ -102,129 +239,145 @@ class WitMotionUSBIMU:
                 self._process_bytes(chunk)
             except Exception as e:
                 if self.running:
-                    logger.debug(f"⚠️  WitMotion Read Fehler: {e}")
+                    logger.debug("⚠️  WitMotion Read Fehler: %s", e)
                 time.sleep(0.1)
 
+    def _on_port_closed(self):
+        """Reactor meldet EOF/Lesefehler am seriellen Port."""
+        logger.error("❌ WitMotion-Port geschlossen oder Lesefehler")
+        self.connected = False
+
+    def _required_frames_seen(self) -> bool:
+        return self._parser.frames_seen_mask & self.REQUIRED_FRAMES_MASK == self.REQUIRED_FRAMES_MASK
+
+    def _on_parser_sample(self):
+        """Parser-Hook: abgeschlossenes Sample für die Auswertung nach feed() merken."""
+        if self._required_frames_seen():
+            parser = self._parser
+            self._batch.append((parser.accel.tolist(), parser.gyro.tolist(), parser.angles.tolist()))
+
+    def _sample_times(self, count: int, now: float) -> List[float]:
+        """Zeitstempel für die Samples eines Lesevorgangs.
+
+        Das letzte Sample bekommt den Lesezeitpunkt, die früheren liegen im Abstand
+        1/sample_rate davor - gestaucht, falls sie sonst vor das letzte Sample des
+        vorigen Lesevorgangs fielen (Zeitstempel bleiben streng monoton).
+        """
+        period = 1.0 / self.sample_rate if self.sample_rate > 0 else 0.0
+        last = self._last_sample_time
+        if last:
+            period = max(0.0, min(period, (now - last) / count))
+        self._last_sample_time = now
+        return [now - (count - 1 - index) * period for index in range(count)]
+
     def _process_bytes(self, data: bytes):
         """Verarbeitet einen Byte-Stream und extrahiert vollständige 11-Byte Frames."""
         if not data:
             return
 
         with self.lock:
-            self._rx_buffer.extend(data)
-
-            while len(self._rx_buffer) >= self.FRAME_SIZE:
-                if self._rx_buffer[0] != self.FRAME_HEADER:
-                    del self._rx_buffer[0]
-                    continue
-
-                frame = bytes(self._rx_buffer[:self.FRAME_SIZE])
-                del self._rx_buffer[:self.FRAME_SIZE]
-
-                checksum = sum(frame[:10]) & 0xFF
-                if checksum != frame[10]:
+            errors_before = self._parser.checksum_errors
+            self._batch = []
+            if not self._parser.feed(data):
+                if self._parser.checksum_errors != errors_before:
                     logger.debug("⚠️  WitMotion Checksum-Fehler verworfen")
-                    continue
-
-                self._process_frame_locked(frame)
-
-    def _process_frame_locked(self, frame: bytes):
-        """Aktualisiert die zuletzt empfangenen Sensorwerte."""
-        frame_type = frame[1]
-        d1, d2, d3, d4 = struct.unpack('<hhhh', frame[2:10])
-
-        self.last_packet_time = time.time()
-        self._frames_seen.add(frame_type)
-
-        if frame_type == self.FRAME_ACCEL:
-            scale = self.ACCEL_RANGE_G * 9.81 / 32768.0
-            self.raw_accel['x'] = d1 * scale
-            self.raw_accel['y'] = d2 * scale
-            self.raw_accel['z'] = d3 * scale
-            self.temperature = d4 / 100.0
-
-        elif frame_type == self.FRAME_GYRO:
-            scale = self.GYRO_RANGE_DPS / 32768.0
-            self.raw_gyro['x'] = d1 * scale
-            self.raw_gyro['y'] = d2 * scale
-            self.raw_gyro['z'] = d3 * scale
-            self.temperature = d4 / 100.0
-
-        elif frame_type == self.FRAME_ANGLE:
-            scale = self.ANGLE_RANGE_DEG / 32768.0
-            self.raw_angles['roll'] = d1 * scale
-            self.raw_angles['pitch'] = d2 * scale
-            self.raw_angles['yaw'] = d3 * scale
-
-        elif frame_type == self.FRAME_MAG:
-            self.raw_mag['x'] = float(d1)
-            self.raw_mag['y'] = float(d2)
-            self.raw_mag['z'] = float(d3)
-
-        self.is_calibrated = self.REQUIRED_FRAMES.issubset(self._frames_seen)
-        self.is_stationary = (
-            abs(self.raw_gyro['x']) < 1.0 and
-            abs(self.raw_gyro['y']) < 1.0 and
-            abs(self.raw_gyro['z']) < 1.0 and
-            abs(self.raw_accel['x']) < 0.5 and
-            abs(self.raw_accel['y']) < 0.5
-        )
-
-    def get_data(self) -> Dict:
-        """Gibt die zuletzt empfangenen Rohdaten zurück."""
-        with self.lock:
-            return {
-                'accel': self.raw_accel.copy(),
-                'gyro': self.raw_gyro.copy(),
-                'mag': self.raw_mag.copy(),
-                'temperature': self.temperature,
+                return
+
+            # Fensterstatistik pro Sample (ein Read enthält oft mehrere 200-Hz-Samples),
+            # Snapshot nur einmal pro Batch
+            self.last_packet_time = time.time()
+            self.is_calibrated = self._required_frames_seen()
+            batch = self._batch
+            timestamps = self._sample_times(len(batch), self.last_packet_time) if batch else []
+            update_stats = self.motion_stats.update
+            for (accel, gyro, _), timestamp in zip(batch, timestamps):
+                self.is_stationary = update_stats(gyro, accel, timestamp)
+            self._snapshot.publish(self._build_snapshot_data())
+
+        # Außerhalb des Locks, jedes Sample mit eigenem Zeitstempel (EKF-Prädiktion)
+        callback = self.sample_callback
+        if callback:
+            try:
+                for (accel, gyro, angles), timestamp in zip(batch, timestamps):
+                    callback(accel, gyro, angles, timestamp)
+            except Exception as e:
+                logger.warning("⚠️  IMU-Sample-Callback Fehler: %s", e)
+
+    def _build_snapshot_data(self) -> Dict:
+        """Baut den konsistenten Stand für Leser (einmal pro verarbeitetem Batch)."""
+        parser = self._parser
+        accel, gyro, mag, angles = parser.accel, parser.gyro, parser.mag, parser.angles
+        yaw = _normalize_heading(angles[2])
+        stats = self.motion_stats
+        motion = stats.to_dict()
+        gyro_bias = motion['gyro_bias']
+        return {
+            'data': {
+                'accel': {'x': accel[0], 'y': accel[1], 'z': accel[2]},
+                'gyro': {'x': gyro[0], 'y': gyro[1], 'z': gyro[2]},
+                'mag': {'x': mag[0], 'y': mag[1], 'z': mag[2]},
+                'temperature': parser.temperature,
                 'is_calibrated': self.is_calibrated,
-                'timestamp': self.last_packet_time or time.time(),
+                'timestamp': self.last_packet_time,
                 'orientation_source': 'witmotion_native'
-            }
-
-    def get_orientation(self) -> Dict:
-        """Gibt die native WitMotion-Orientierung zurück."""
-        with self.lock:
-            yaw = _normalize_heading(self.raw_angles['yaw'])
-            return {
-                'roll': self.raw_angles['roll'],
-                'pitch': self.raw_angles['pitch'],
+            },
+            'orientation': {
+                'roll': angles[0],
+                'pitch': angles[1],
                 'yaw': yaw,
                 'heading': yaw,
                 'is_stationary': self.is_stationary,
-                'gyro_bias': {'x': 0.0, 'y': 0.0, 'z': 0.0},
+                'gyro_bias': gyro_bias,
                 'gps_weight': 0.0,
                 'source': 'witmotion_native'
-            }
+            },
+            'motion': dict(
+                motion,
+                gps_weight=0.0,
+                zupt_enabled=False,
+                motion_threshold_gyro=stats.gyro_std_threshold,
+                motion_threshold_accel=stats.accel_std_threshold,
+                source='window_statistics'
+            ),
+        }
+
+    def get_snapshot(self) -> Snapshot:
+        """Gibt den neuesten Snapshot (Sequenznummer + Daten) ohne Lock zurück."""
+        return self._snapshot.read()
+
+    def get_data(self) -> Dict:
+        """Gibt die zuletzt empfangenen Rohdaten zurück (lock-frei, nur lesen)."""
+        data = self._snapshot.read().data['data']
+        if data['timestamp'] is None:
+            return dict(data, timestamp=time.time())
+        return data
+
+    def get_orientation(self) -> Dict:
+        """Gibt die native WitMotion-Orientierung zurück (lock-frei, nur lesen)."""
+        return self._snapshot.read().data['orientation']
 
     def get_motion_status(self) -> Dict:
-        """Gibt einfachen Bewegungsstatus für UI/API zurück."""
-        with self.lock:
-            return {
-                'is_stationary': self.is_stationary,
-                'gyro_bias': {'x': 0.0, 'y': 0.0, 'z': 0.0},
-                'gps_weight': 0.0,
-                'zupt_enabled': False,
-                'motion_threshold_gyro': 1.0,
-                'motion_threshold_accel': 0.5,
-                'source': 'witmotion_native'
-            }
+        """Gibt Bewegungsstatus (Stillstand, Gyro-Bias, Vibrations-RMS) zurück (lock-frei, nur lesen)."""
+        return self._snapshot.read().data['motion']
 
     def get_status(self) -> Dict:
         """Gibt generische Statusinformationen für API/UI zurück."""
-        with self.lock:
-            return {
-                'connected': self.connected,
-                'running': self.running,
-                'imu_type': 'witmotion_usb',
-                'port': self.port,
-                'baudrate': self.baudrate,
-                'sample_rate': self.sample_rate,
-                'receiving_data': bool(self.last_packet_time and (time.time() - self.last_packet_time) < 2.0),
-                'last_packet_time': self.last_packet_time,
-                'orientation_source': 'witmotion_native'
-            }
+        last_packet_time = self.last_packet_time
+        return {
+            'connected': self.connected,
+            'running': self.running,
+            'imu_type': 'witmotion_usb',
+            'port': self.port,
+            'baudrate': self.baudrate,
+            'sample_rate': self.sample_rate,
+            'receiving_data': bool(last_packet_time and (time.time() - last_packet_time) < 2.0),
+            'last_packet_time': last_packet_time,
+            'snapshot_seq': self._snapshot.seq,
+            'frame_count': self._parser.frame_count,
+            'checksum_errors': self._parser.checksum_errors,
+            'bytes_discarded': self._parser.bytes_discarded,
+            'orientation_source': 'witmotion_native'
+        }
 
     def calibrate(self, samples: int = 0) -> bool:
         """Für WitMotion nicht erforderlich; erfolgreiche Frame-Erkennung reicht."""
@@ -234,6 +387,8 @@ class WitMotionUSBIMU:
     def disconnect(self):
         """Schließt die serielle Verbindung sicher."""
         self.running = False
+        if self.reactor and self.serial_port:
+            self.reactor.unregister(self.serial_port)
         if self.read_thread and self.read_thread.is_alive():
             self.read_thread.join(timeout=1.0)
         if self.serial_port:
@@ -255,7 +410,9 @@ def create_imu_handler(imu_type: str, **kwargs):
             port=kwargs.get('port', '/dev/ttyUSB0'),
             baudrate=kwargs.get('baudrate', 9600),
             timeout=kwargs.get('timeout', 1.0),
-            sample_rate=kwargs.get('sample_rate', 100)
+            sample_rate=kwargs.get('sample_rate', 100),
+            reactor=kwargs.get('reactor'),
+            stats_window=kwargs.get('stats_window', 100)
         )
 
     raise ValueError(f"Nicht unterstützter IMU-Typ für diesen Stand: {imu_type}")
@@ -0,0 +1,170 @@
+"""Gleitende IMU-Statistik für Stillstandserkennung, Gyro-Bias und Vibration.
+
+Ein Ring über die letzten `window` Samples (Gyro x/y/z, Beschleunigung x/y/z)
+liegt als flaches array('d') vor. Mittelwert und Varianz werden pro Kanal mit
+Welford inklusive Entfernen des ältesten Samples nachgeführt, also O(1) pro
+Sample ohne Neuberechnung über das Fenster. Nur der Reader-Thread des IMU
+schreibt; Leser bekommen die Ergebnisse über den Snapshot des Handlers.
+"""
+
+import math
+from array import array
+from typing import Dict, Optional
+
+CHANNELS = 6  # gx, gy, gz (°/s), ax, ay, az (m/s²)
+
+
+class MotionStatistics:
+    """Fensterstatistik über den IMU-Strom (Single Writer)."""
+
+    def __init__(self, window: int = 100, gyro_std_threshold: float = 0.6, accel_std_threshold: float = 0.3,
+                 gyro_rate_threshold: float = 3.0, min_stationary_time: float = 0.5,
+                 bias_time_constant: float = 5.0, vibration_time_constant: float = 10.0):
+        """
+        Args:
+            window: Fensterlänge in Samples (100 = 0,5 s bei 200 Hz)
+            gyro_std_threshold: Max. Standardabweichung je Gyro-Achse im Stillstand (°/s)
+            accel_std_threshold: Max. Standardabweichung der Beschleunigung (Betrag über 3 Achsen, m/s²)
+            gyro_rate_threshold: Max. Abweichung der mittleren Drehrate vom Bias (°/s)
+            min_stationary_time: So lange müssen die Kriterien erfüllt sein (s)
+            bias_time_constant: Zeitkonstante der Bias-Nachführung im Stillstand (s)
+            vibration_time_constant: Zeitkonstante des gemittelten Vibrations-RMS (s)
+        """
+        self.window = max(2, int(window))
+        self.gyro_std_threshold = gyro_std_threshold
+        self.accel_std_threshold = accel_std_threshold
+        self.gyro_rate_threshold = gyro_rate_threshold
+        self.min_stationary_time = min_stationary_time
+        self.bias_time_constant = bias_time_constant
+        self.vibration_time_constant = vibration_time_constant
+
+        self._ring = array('d', bytes(8 * CHANNELS * self.window))
+        self._mean = array('d', bytes(8 * CHANNELS))
+        self._m2 = array('d', bytes(8 * CHANNELS))
+        self.gyro_bias = array('d', [0.0, 0.0, 0.0])
+        self.reset()
+
+    def reset(self):
+        """Verwirft Fensterinhalt und Stillstandszustand (Bias bleibt erhalten)."""
+        for i in range(len(self._ring)):
+            self._ring[i] = 0.0
+        for i in range(CHANNELS):
+            self._mean[i] = 0.0
+            self._m2[i] = 0.0
+        self._count = 0
+        self._index = 0
+        self._last_time: Optional[float] = None
+        self._candidate_since: Optional[float] = None
+
+        self.is_stationary = False
+        self.bias_valid = getattr(self, 'bias_valid', False)
+        self.gyro_std = 0.0
+        self.accel_std = 0.0
+        self.vibration_rms = 0.0
+        self.vibration_rms_avg = 0.0
+        self.stationary_time = 0.0
+
+    def update(self, gyro, accel, timestamp: float) -> bool:
+        """Nimmt ein Sample auf und aktualisiert alle Kenngrößen; liefert is_stationary."""
+        ring = self._ring
+        mean = self._mean
+        m2 = self._m2
+        base = self._index * CHANNELS
+
+        if self._count < self.window:
+            # Fenster füllt sich noch: klassischer Welford-Schritt
+            self._count += 1
+            n = self._count
+            for channel in range(CHANNELS):
+                value = gyro[channel] if channel < 3 else accel[channel - 3]
+                delta = value - mean[channel]
+                mean[channel] += delta / n
+                m2[channel] += delta * (value - mean[channel])
+                ring[base + channel] = value
+        else:
+            # Volles Fenster: ältestes Sample ersetzen (Welford mit Entfernen)
+            n = self._count
+            for channel in range(CHANNELS):
+                value = gyro[channel] if channel < 3 else accel[channel - 3]
+                old = ring[base + channel]
+                old_mean = mean[channel]
+                new_mean = old_mean + (value - old) / n
+                m2[channel] += (value - old) * (value - new_mean + old - old_mean)
+                mean[channel] = new_mean
+                ring[base + channel] = value
+
+        self._index = (self._index + 1) % self.window
+
+        dt = timestamp - self._last_time if self._last_time is not None else 0.0
+        self._last_time = timestamp
+        dt = min(max(dt, 0.0), 1.0)
+        self._evaluate(timestamp, dt)
+        return self.is_stationary
+
+    def _variance(self, channel: int) -> float:
+        return max(self._m2[channel], 0.0) / self._count if self._count else 0.0
+
+    def _evaluate(self, timestamp: float, dt: float):
+        mean = self._mean
+        gyro_std = math.sqrt(max(self._variance(0), self._variance(1), self._variance(2)))
+        accel_var = self._variance(3) + self._variance(4) + self._variance(5)
+        accel_std = math.sqrt(accel_var)
+        self.gyro_std = gyro_std
+        self.accel_std = accel_std
+
+        # Vibration: RMS der Beschleunigung um den Fenstermittelwert (Schwerkraft fällt heraus)
+        self.vibration_rms = accel_std
+        if dt and self.vibration_time_constant > 0:
+            alpha = min(dt / self.vibration_time_constant, 1.0)
+            self.vibration_rms_avg += (accel_std - self.vibration_rms_avg) * alpha
+        else:
+            self.vibration_rms_avg = accel_std
+
+        bias = self.gyro_bias
+        candidate = (
+            self._count >= self.window and
+            gyro_std < self.gyro_std_threshold and
+            accel_std < self.accel_std_threshold and
+            abs(mean[0] - bias[0]) < self.gyro_rate_threshold and
+            abs(mean[1] - bias[1]) < self.gyro_rate_threshold and
+            abs(mean[2] - bias[2]) < self.gyro_rate_threshold
+        )
+        if not candidate:
+            # Bewegung beendet den Stillstand sofort
+            self._candidate_since = None
+            self.is_stationary = False
+            self.stationary_time = 0.0
+            return
+
+        if self._candidate_since is None:
+            self._candidate_since = timestamp
+        self.stationary_time = timestamp - self._candidate_since
+        self.is_stationary = self.stationary_time >= self.min_stationary_time
+        if not self.is_stationary:
+            return
+
+        if not self.bias_valid:
+            bias[0], bias[1], bias[2] = mean[0], mean[1], mean[2]
+            self.bias_valid = True
+        elif dt:
+            alpha = min(dt / self.bias_time_constant, 1.0)
+            for axis in range(3):
+                bias[axis] += (mean[axis] - bias[axis]) * alpha
+
+    def get_bias(self) -> Dict[str, float]:
+        return {'x': self.gyro_bias[0], 'y': self.gyro_bias[1], 'z': self.gyro_bias[2]}
+
+    def to_dict(self) -> Dict:
+        """Kenngrößen für get_motion_status (neues Dict pro Aufruf)."""
+        return {
+            'is_stationary': self.is_stationary,
+            'stationary_time': round(self.stationary_time, 3),
+            'gyro_bias': self.get_bias(),
+            'bias_valid': self.bias_valid,
+            'gyro_std': self.gyro_std,
+            'accel_std': self.accel_std,
+            'vibration_rms': self.vibration_rms,
+            'vibration_rms_avg': self.vibration_rms_avg,
+            'window': self.window,
+            'window_fill': self._count,
+        }
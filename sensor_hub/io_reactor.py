@@ -0,0 +1,216 @@
+"""
+I/O Reactor - ereignisgesteuertes Lesen für GPS, IMU und NTRIP.
+
+Ein einzelner Thread wartet per selectors (epoll unter Linux) auf alle
+registrierten File-Deskriptoren und ruft die Parser-Callbacks nur dann auf,
+wenn tatsächlich Bytes angekommen sind. Ohne Daten schläft der Thread im
+Kernel - keine Polling-Schleifen, keine Wakeups im Leerlauf.
+"""
+
+import logging
+import os
+import selectors
+import threading
+import time
+from typing import Callable, Dict, Optional
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_READ_SIZE = 4096
+FTDI_LATENCY_TIMER_MS = 1
+
+
+class _Registration:
+    """Callback-Daten pro File-Deskriptor."""
+
+    __slots__ = ('name', 'fileobj', 'on_data', 'on_close', 'bytes_read', 'dispatches')
+
+    def __init__(self, name: str, fileobj, on_data: Callable[[bytes], None],
+                 on_close: Optional[Callable[[], None]]):
+        self.name = name
+        self.fileobj = fileobj
+        self.on_data = on_data
+        self.on_close = on_close
+        self.bytes_read = 0
+        self.dispatches = 0
+
+
+def configure_low_latency(serial_port, device_path: Optional[str] = None) -> bool:
+    """
+    Setzt eine serielle Schnittstelle auf minimale Latenz (best effort).
+
+    - ASYNC_LOW_LATENCY über TIOCSSERIAL (pyserial set_low_latency_mode)
+    - FTDI Latency-Timer über sysfs von 16 ms auf 1 ms
+    """
+    changed = False
+    if hasattr(serial_port, 'set_low_latency_mode'):
+        try:
+            serial_port.set_low_latency_mode(True)
+            changed = True
+        except Exception as e:
+            logger.debug(f"Low-Latency-Modus nicht verfügbar: {e}")
+
+    path = device_path or getattr(serial_port, 'port', None)
+    if path:
+        tty_name = os.path.basename(os.path.realpath(path))
+        latency_file = f"/sys/bus/usb-serial/devices/{tty_name}/latency_timer"
+        if os.path.exists(latency_file):
+            try:
+                with open(latency_file, 'w') as f:
+                    f.write(str(FTDI_LATENCY_TIMER_MS))
+                changed = True
+            except OSError as e:
+                logger.debug(f"FTDI Latency-Timer nicht setzbar: {e}")
+    return changed
+
+
+class IOReactor:
+    """Single-Thread-Reactor über selectors.DefaultSelector."""
+
+    def __init__(self, read_size: int = DEFAULT_READ_SIZE):
+        self.read_size = read_size
+        self._selector = selectors.DefaultSelector()
+        self._registrations: Dict[int, _Registration] = {}
+        self._lock = threading.Lock()
+        self._wakeup_r, self._wakeup_w = os.pipe()
+        os.set_blocking(self._wakeup_r, False)
+        os.set_blocking(self._wakeup_w, False)
+        self._selector.register(self._wakeup_r, selectors.EVENT_READ, None)
+        self._running = False
+        self._thread: Optional[threading.Thread] = None
+
+        self.wakeups = 0
+        self.callback_errors = 0
+
+    def start(self):
+        """Startet den Reactor-Thread."""
+        if self._running:
+            return
+        self._running = True
+        self._thread = threading.Thread(target=self._loop, name='io-reactor', daemon=True)
+        self._thread.start()
+        logger.info(f"✅ I/O Reactor gestartet ({type(self._selector).__name__})")
+
+    def stop(self):
+        """Stoppt den Reactor-Thread; Registrierungen bleiben unberührt."""
+        self._running = False
+        self._wakeup()
+        if self._thread:
+            self._thread.join(timeout=1.0)
+            self._thread = None
+
+    def register(self, fileobj, on_data: Callable[[bytes], None],
+                 on_close: Optional[Callable[[], None]] = None, name: str = '') -> bool:
+        """
+        Registriert einen lesbaren File-Deskriptor.
+
+        Args:
+            fileobj: Objekt mit fileno() (serial.Serial, socket) oder int
+            on_data: Wird im Reactor-Thread mit den gelesenen Bytes aufgerufen
+            on_close: Wird bei EOF/Lesefehler aufgerufen (nach dem Deregistrieren)
+            name: Name für Logging und Statistik
+        """
+        try:
+            fd = fileobj if isinstance(fileobj, int) else fileobj.fileno()
+            os.set_blocking(fd, False)
+            with self._lock:
+                self._selector.register(fd, selectors.EVENT_READ, None)
+                self._registrations[fd] = _Registration(name or f"fd{fd}", fileobj, on_data, on_close)
+            self._wakeup()
+            logger.debug(f"I/O Reactor: {name or fd} registriert (fd {fd})")
+            return True
+        except (OSError, ValueError, KeyError) as e:
+            logger.error(f"❌ I/O Reactor Registrierung fehlgeschlagen ({name}): {e}")
+            return False
+
+    def unregister(self, fileobj) -> bool:
+        """Entfernt einen File-Deskriptor (vor dem Schließen aufrufen)."""
+        with self._lock:
+            for fd, registration in self._registrations.items():
+                if registration.fileobj is fileobj or fd == fileobj:
+                    break
+            else:
+                return False
+            del self._registrations[fd]
+            try:
+                self._selector.unregister(fd)
+            except (KeyError, ValueError, OSError):
+                pass
+        self._wakeup()
+        return True
+
+    def _wakeup(self):
+        try:
+            os.write(self._wakeup_w, b'\x00')
+        except (BlockingIOError, OSError):
+            pass
+
+    def _loop(self):
+        while self._running:
+            try:
+                events = self._selector.select()
+            except OSError as e:
+                logger.warning("⚠️  I/O Reactor select Fehler: %s", e)
+                time.sleep(0.1)
+                continue
+
+            self.wakeups += 1
+            for key, _ in events:
+                fd = key.fd
+                if fd == self._wakeup_r:
+                    try:
+                        while os.read(self._wakeup_r, 64):
+                            pass
+                    except BlockingIOError:
+                        pass
+                    continue
+                self._dispatch(fd)
+
+    def _dispatch(self, fd: int):
+        registration = self._registrations.get(fd)
+        if registration is None:
+            return
+
+        try:
+            data = os.read(fd, self.read_size)
+        except BlockingIOError:
+            return
+        except OSError as e:
+            logger.warning("⚠️  I/O Reactor Lesefehler (%s): %s", registration.name, e)
+            data = b''
+
+        if not data:
+            self.unregister(registration.fileobj)
+            if registration.on_close:
+                try:
+                    registration.on_close()
+                except Exception as e:
+                    logger.debug("I/O Reactor on_close Fehler (%s): %s", registration.name, e)
+            return
+
+        registration.bytes_read += len(data)
+        registration.dispatches += 1
+        try:
+            registration.on_data(data)
+        except Exception as e:
+            self.callback_errors += 1
+            logger.debug("I/O Reactor Callback-Fehler (%s): %s", registration.name, e)
+
+    def get_status(self) -> dict:
+        """Gibt Reactor-Statistiken zurück."""
+        with self._lock:
+            sources = {
+                registration.name: {
+                    'fd': fd,
+                    'bytes_read': registration.bytes_read,
+                    'dispatches': registration.dispatches,
+                }
+                for fd, registration in self._registrations.items()
+            }
+        return {
+            'running': self._running,
+            'selector': type(self._selector).__name__,
+            'wakeups': self.wakeups,
+            'callback_errors': self.callback_errors,
+            'sources': sources,
+        }
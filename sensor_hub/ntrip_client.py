@@ -3,6 +3,7 @@ NTRIP Client für RTK-Korrekturdaten
 Verbindet mit NTRIP-Server und sendet Korrekturdaten an GPS-Gerät
 """
 
+import os
 import socket
 import threading
 import time
@@ -18,7 +19,7 @@ class NTRIPClient:
     
     def __init__(self, host: str, port: int, mountpoint: str, 
                  username: str, password: str, timeout: float = 10.0,
-                 reconnect_interval: float = 30.0):
+                 reconnect_interval: float = 30.0, reactor=None):
         """
         Initialisiert NTRIP Client
         
@@ -30,6 +31,7 @@ class NTRIPClient:
             password: Passwort
             timeout: Verbindungs-Timeout
             reconnect_interval: Reconnect-Versuch nach X Sekunden
+            reactor: Optionaler IOReactor; ohne Reactor liest ein eigener Thread
         """
         self.host = host
         self.port = port
@@ -38,6 +40,7 @@ class NTRIPClient:
         self.password = password
         self.timeout = timeout
         self.reconnect_interval = reconnect_interval
+        self.reactor = reactor
         
         self.socket = None
         self.running = False
@@ -48,6 +51,16 @@ class NTRIPClient:
         self.bytes_received = 0
         self.last_data_time = 0
         
+        # Vorallokierter Empfangspuffer für den Reader-Thread (recv_into statt neuer bytes)
+        self._recv_buffer = bytearray(4096)
+        self._recv_view = memoryview(self._recv_buffer)
+        
+        # GGA-Versand läuft im Reactor-/GPS-Thread: nie blockieren, bei vollem
+        # Sendepuffer verwerfen (nächster Satz folgt), angefangene Zeile nachreichen
+        self._gga_pending = b''
+        self.gga_sent = 0
+        self.gga_dropped = 0
+        
         # Callback für empfangene Daten
         self.on_data_received = None
 
@@ -79,7 +92,7 @@ class NTRIPClient:
             )
             
             self.socket.sendall(request.encode())
-            logger.debug(f"📤 NTRIP Request gesendet")
+            logger.debug("📤 NTRIP Request gesendet")
             
             # Response lesen (HTTP Header)
             response = b""
@@ -93,15 +106,30 @@ class NTRIPClient:
             
             # HTTP Status überprüfen
             if "200" in response_str:
-                logger.info("✅ NTRIP verbunden - RTK-Daten werden empfangen")
+                self._gga_pending = b''
                 self.connected = True
-                self.connection_attempts = 0
                 self.running = True
                 
-                # Reader-Thread starten
-                self.reader_thread = threading.Thread(target=self._read_loop, daemon=True)
-                self.reader_thread.start()
+                # Nach dem Header: Daten übernimmt der Reactor bzw. der Reader-Thread.
+                # Bereits mitgelesene RTCM-Bytes hinter dem Header nicht verlieren.
+                initial_data = response[response.index(b"\r\n\r\n") + 4:]
+                if initial_data:
+                    self._on_socket_data(initial_data)
+                if self.reactor:
+                    if not self.reactor.register(self.socket, self._on_socket_data,
+                                                 on_close=self._on_socket_closed, name='ntrip'):
+                        # Ohne Registrierung liest niemand den Socket -> als getrennt
+                        # behandeln, damit reconnect_if_needed() es erneut versucht
+                        logger.error("❌ NTRIP-Socket konnte nicht im I/O Reactor registriert werden")
+                        self.connected = False
+                        self.socket.close()
+                        return False
+                else:
+                    self.reader_thread = threading.Thread(target=self._read_loop, daemon=True)
+                    self.reader_thread.start()
                 
+                logger.info("✅ NTRIP verbunden - RTK-Daten werden empfangen")
+                self.connection_attempts = 0
                 return True
             else:
                 # Fehler extrahieren
@@ -129,6 +157,8 @@ class NTRIPClient:
     def disconnect(self):
         """Trennt NTRIP-Verbindung"""
         self.running = False
+        if self.reactor and self.socket:
+            self.reactor.unregister(self.socket)
         if self.reader_thread:
             self.reader_thread.join(timeout=2.0)
         if self.socket:
@@ -143,28 +173,41 @@ class NTRIPClient:
         """Liest kontinuierlich NTRIP-Daten"""
         while self.running and self.connected:
             try:
-                data = self.socket.recv(4096)
+                received = self.socket.recv_into(self._recv_buffer)
                 
-                if not data:
-                    logger.warning("⚠️  NTRIP Server hat Verbindung geschlossen")
-                    self.connected = False
+                if not received:
+                    self._on_socket_closed()
                     break
                 
-                self.bytes_received += len(data)
-                self.last_data_time = time.time()
-                
-                # Callback aufrufen wenn registriert
-                if self.on_data_received:
-                    self.on_data_received(data)
+                # memoryview ist nur während des Callbacks gültig
+                self._on_socket_data(self._recv_view[:received])
             
             except socket.timeout:
                 # Timeout ist ok, einfach weitermachen
                 pass
             except Exception as e:
-                logger.warning(f"⚠️  NTRIP Read-Fehler: {e}")
+                logger.warning("⚠️  NTRIP Read-Fehler: %s", e)
                 self.connected = False
                 break
     
+    def _on_socket_data(self, data):
+        """Verarbeitet empfangene Korrekturdaten (Reader-Thread oder Reactor, bytes oder memoryview)"""
+        self.bytes_received += len(data)
+        self.last_data_time = time.time()
+        
+        # Callback aufrufen wenn registriert
+        if self.on_data_received:
+            self.on_data_received(data)
+    
+    def _on_socket_closed(self):
+        """Server hat die Verbindung geschlossen"""
+        logger.warning("⚠️  NTRIP Server hat Verbindung geschlossen")
+        self.connected = False
+        try:
+            self.socket.close()
+        except Exception:
+            pass
+    
     def is_connected(self) -> bool:
         """Gibt Verbindungsstatus zurück"""
         return self.connected and self.running
@@ -178,7 +221,9 @@ class NTRIPClient:
             'mountpoint': self.mountpoint,
             'bytes_received': self.bytes_received,
             'last_data_time': self.last_data_time,
-            'connection_attempts': self.connection_attempts
+            'connection_attempts': self.connection_attempts,
+            'gga_sent': self.gga_sent,
+            'gga_dropped': self.gga_dropped
         }
     
     def send_gga_data(self, gga_sentence: str):
@@ -186,16 +231,35 @@ class NTRIPClient:
         Sendet einen GPGGA-Satz an den NTRIP-Server
         Wichtig: Der Server braucht die Position für VRS (Virtuelle Referenzstation)
 
+        Wird aus dem Reactor-Thread aufgerufen und blockiert nicht: socket.send()
+        würde bei gesetztem Timeout erst auf Schreibbarkeit warten, daher os.write()
+        direkt auf den (nicht blockierenden) Deskriptor. Ist der Sendepuffer voll,
+        wird der Satz verworfen.
+
         Args:
             gga_sentence: Roher GGA-Satz (z.B. "$GNGGA,...")
         """
-        if self.is_connected():
-            try:
-                # GGA-Satz mit CRLF senden
-                self.socket.sendall(gga_sentence.encode('ascii') + b'\r\n')
-                logger.debug(f"📤 GPGGA an NTRIP gesendet: {gga_sentence[:50]}...")
-            except Exception as e:
-                logger.warning(f"⚠️ Fehler beim Senden von GPGGA: {e}")
+        if not self.is_connected():
+            return
+        pending = self._gga_pending
+        data = pending + gga_sentence.encode('ascii') + b'\r\n'
+        try:
+            written = os.write(self.socket.fileno(), data)
+        except BlockingIOError:
+            self.gga_dropped += 1
+            logger.debug("⚠️ NTRIP-Sendepuffer voll - GPGGA verworfen")
+            return
+        except Exception as e:
+            logger.warning("⚠️ Fehler beim Senden von GPGGA: %s", e)
+            return
+        if written < len(pending):
+            # Nicht einmal der Rest der vorigen Zeile passte -> neuer Satz verworfen
+            self._gga_pending = pending[written:]
+            self.gga_dropped += 1
+            return
+        self._gga_pending = data[written:]
+        self.gga_sent += 1
+        logger.debug("📤 GPGGA an NTRIP gesendet: %.50s...", gga_sentence)
 
     def reconnect_if_needed(self):
         """Versucht zu reconnecten wenn nötig"""
@@ -0,0 +1,484 @@
+"""
+Pose Estimator - EKF für Position, Geschwindigkeit und Heading in der Ebene.
+
+- Prädiktion mit jedem IMU-Sample (Beschleunigung + Drehrate, bis 200 Hz)
+- Korrektur mit RTK-Position (Gewichtung nach Fix-Qualität) und Dual-Antenna-Heading
+- Nebenbedingung "kein Seitwärtsfahren" als Pseudo-Messung (Differentialantrieb)
+- Ausgabe als lock-freier Snapshot mit Kovarianz, höchstens mit output_rate
+
+Zustand x = [E, N, vE, vN, psi, bg] im lokalen ENU-Rahmen um den ersten Fix;
+psi = Heading im Uhrzeigersinn ab Nord (rad), bg = Drehraten-Bias der z-Achse (rad/s).
+Alle Matrizen liegen als flache, vorallokierte array('d') vor; pro Sample entstehen
+keine neuen Listen oder Matrizen.
+"""
+
+import logging
+import math
+import threading
+import time
+from array import array
+from typing import Dict, Optional
+
+from sensor_snapshot import Snapshot, SnapshotCell
+
+logger = logging.getLogger(__name__)
+
+STATE_SIZE = 6
+IX, IY, IVE, IVN, IPSI, IBG = range(STATE_SIZE)
+
+GRAVITY = 9.81
+_WGS84_A = 6378137.0
+_WGS84_E2 = 6.69437999014e-3
+
+# WitMotion: z-Achse nach oben, positive Drehrate = gegen den Uhrzeigersinn = Heading nimmt ab
+GYRO_Z_SIGN = -1.0
+
+# Positions-Standardabweichung (m) pro NMEA Fix-Qualität; fehlende Qualität = keine Korrektur
+POSITION_SIGMA = {
+    1: 2.5,    # GPS FIX
+    2: 0.8,    # DGPS
+    4: 0.02,   # RTK FIXED
+    5: 0.25,   # RTK FLOAT
+}
+
+# Chi²-Schwellen (99.9 %) für das Innovations-Gating
+_GATE_1DOF = 10.83
+_GATE_2DOF = 13.82
+
+
+def _wrap_pi(angle: float) -> float:
+    return (angle + math.pi) % (2.0 * math.pi) - math.pi
+
+
+class PoseEstimator:
+    """Erweiterter Kalman-Filter für die Fahrzeug-Pose (thread-safe, ein Lock pro Schritt)."""
+
+    def __init__(self, output_rate: float = 100.0, accel_sigma: float = 0.8, gyro_sigma: float = 0.02,
+                 bias_sigma: float = 2e-4, heading_sigma: float = 0.5, lateral_sigma: float = 0.1,
+                 max_rejects: int = 5):
+        """
+        Args:
+            output_rate: Maximale Rate der veröffentlichten Pose (Hz)
+            accel_sigma: Prozessrauschen Beschleunigung (m/s²)
+            gyro_sigma: Prozessrauschen Drehrate (rad/s)
+            bias_sigma: Random Walk des Drehraten-Bias (rad/s/√s)
+            heading_sigma: Messrauschen Dual-Antenna-Heading bei RTK FIXED (Grad)
+            lateral_sigma: Messrauschen der Nebenbedingung v_quer = 0 (m/s)
+            max_rejects: Nach so vielen verworfenen Positionen in Folge wird neu initialisiert
+        """
+        self.output_interval = 1.0 / output_rate if output_rate > 0 else 0.0
+        self.accel_var = accel_sigma ** 2
+        self.gyro_var = gyro_sigma ** 2
+        self.bias_var = bias_sigma ** 2
+        self.heading_sigma = math.radians(heading_sigma)
+        self.lateral_var = lateral_sigma ** 2
+        self.max_rejects = max_rejects
+
+        self.lock = threading.Lock()
+
+        self._x = array('d', bytes(8 * STATE_SIZE))
+        self._P = array('d', bytes(8 * STATE_SIZE * STATE_SIZE))
+        # Puffer für Messupdates mit bis zu 2 Zeilen
+        self._H = array('d', bytes(8 * 2 * STATE_SIZE))
+        self._PHt = array('d', bytes(8 * STATE_SIZE * 2))
+        self._K = array('d', bytes(8 * STATE_SIZE * 2))
+        self._r = array('d', [0.0, 0.0])
+        self._R = array('d', [0.0, 0.0])
+
+        self._origin: Optional[tuple] = None  # (lat, lon, m/rad Nord, m/rad Ost)
+        self.reset()
+        self._snapshot = SnapshotCell(self._build_snapshot_data(time.time()))
+
+    def reset(self):
+        """Verwirft Zustand und Ursprung (nächster Fix initialisiert neu)."""
+        with self.lock:
+            for i in range(STATE_SIZE):
+                self._x[i] = 0.0
+            for i in range(STATE_SIZE * STATE_SIZE):
+                self._P[i] = 0.0
+            P = self._P
+            P[IX * 7] = P[IY * 7] = 1e4
+            P[IVE * 7] = P[IVN * 7] = 1.0
+            P[IPSI * 7] = math.pi ** 2
+            P[IBG * 7] = math.radians(1.0) ** 2
+
+            self._origin = None
+            self.position_initialized = False
+            self.heading_initialized = False
+            self._last_imu_time: Optional[float] = None
+            self._last_publish = 0.0
+            self._consecutive_rejects = 0
+            self.fix_quality = 0
+
+            self.predictions = 0
+            self.position_updates = 0
+            self.heading_updates = 0
+            self.rejected_updates = 0
+            self.last_position_time = 0.0
+            self.last_heading_time = 0.0
+
+    # ------------------------------------------------------------------
+    # Eingänge
+    # ------------------------------------------------------------------
+
+    def on_imu_sample(self, accel, gyro, angles, timestamp: float):
+        """
+        Prädiktion mit einem IMU-Sample (Callback des IMU-Handlers)
+
+        Args:
+            accel: Beschleunigung x/y/z in m/s² (inkl. Erdbeschleunigung, x vorne, y links)
+            gyro: Drehrate x/y/z in °/s
+            angles: Roll/Pitch/Yaw in Grad (für die Schwerkraft-Kompensation)
+            timestamp: Zeitpunkt des Samples (time.time())
+        """
+        roll = math.radians(angles[0])
+        pitch = math.radians(angles[1])
+        cos_pitch = math.cos(pitch)
+        # Schwerkraftanteil in der Fahrzeugebene abziehen (Pitch positiv = Nase hoch)
+        accel_forward = accel[0] - GRAVITY * math.sin(pitch)
+        accel_right = -(accel[1] - GRAVITY * math.sin(roll) * cos_pitch)
+        omega = math.radians(gyro[2])
+
+        with self.lock:
+            last = self._last_imu_time
+            self._last_imu_time = timestamp
+            if last is None:
+                return
+            dt = timestamp - last
+            if dt <= 0.0:
+                return
+            dt = min(dt, 0.1)
+
+            if not self.heading_initialized:
+                # Ohne Heading ist die Richtung der Beschleunigung unbekannt
+                accel_forward = accel_right = 0.0
+            self._predict(dt, omega, accel_forward, accel_right)
+            self._update_lateral()
+            self.predictions += 1
+            self._publish_limited(timestamp)
+
+    def on_position(self, latitude: float, longitude: float, fix_quality: int, timestamp: Optional[float] = None):
+        """Korrektur mit einer GNSS-Position; fix_quality als NMEA-Qualität (4 = RTK FIXED)."""
+        sigma = POSITION_SIGMA.get(fix_quality)
+        if sigma is None or not latitude or not longitude:
+            return
+        timestamp = time.time() if timestamp is None else timestamp
+
+        with self.lock:
+            self.fix_quality = fix_quality
+            if self._origin is None:
+                self._set_origin(latitude, longitude)
+            east, north = self._to_local(latitude, longitude)
+
+            if not self.position_initialized or self._consecutive_rejects >= self.max_rejects:
+                if self.position_initialized:
+                    logger.warning("⚠️  Pose: Position nach wiederholten Ausreißern neu initialisiert")
+                self._reset_position(east, north, sigma)
+            else:
+                H = self._H
+                for i in range(2 * STATE_SIZE):
+                    H[i] = 0.0
+                H[IX] = 1.0
+                H[STATE_SIZE + IY] = 1.0
+                self._r[0] = east - self._x[IX]
+                self._r[1] = north - self._x[IY]
+                self._R[0] = self._R[1] = sigma * sigma
+                if self._update(2, _GATE_2DOF):
+                    self._consecutive_rejects = 0
+                else:
+                    self._consecutive_rejects += 1
+                    self.rejected_updates += 1
+                    return
+
+            self.position_updates += 1
+            self.last_position_time = timestamp
+            self._publish(timestamp)
+
+    def on_heading(self, heading_deg: float, fix_quality: Optional[int] = None, timestamp: Optional[float] = None):
+        """Korrektur mit dem Dual-Antenna-Heading (Grad ab Nord, im Uhrzeigersinn)."""
+        timestamp = time.time() if timestamp is None else timestamp
+        heading = _wrap_pi(math.radians(heading_deg))
+
+        with self.lock:
+            quality = self.fix_quality if fix_quality is None else fix_quality
+            # Außerhalb von RTK FIXED ist die Basislinie ungenauer
+            sigma = self.heading_sigma if quality == 4 else self.heading_sigma * 4.0
+
+            if not self.heading_initialized:
+                self._x[IPSI] = heading
+                self._reset_covariance(IPSI, sigma * sigma)
+                self.heading_initialized = True
+            else:
+                H = self._H
+                for i in range(STATE_SIZE):
+                    H[i] = 0.0
+                H[IPSI] = 1.0
+                self._r[0] = _wrap_pi(heading - self._x[IPSI])
+                self._R[0] = sigma * sigma
+                if not self._update(1, _GATE_1DOF):
+                    self.rejected_updates += 1
+                    return
+
+            self.heading_updates += 1
+            self.last_heading_time = timestamp
+            self._publish(timestamp)
+
+    def on_gps_position(self, event):
+        """Adapter für GPSHandler EVENT_POSITION (value = PositionFix)."""
+        fix = event.value
+        self.on_position(fix.latitude, fix.longitude, fix.fix_quality, event.timestamp)
+
+    def on_gps_heading(self, event):
+        """Adapter für GPSHandler EVENT_HEADING (value = Heading in Grad)."""
+        self.on_heading(event.value, timestamp=event.timestamp)
+
+    # ------------------------------------------------------------------
+    # Filter (Aufruf unter self.lock)
+    # ------------------------------------------------------------------
+
+    def _predict(self, dt: float, omega: float, accel_forward: float, accel_right: float):
+        x = self._x
+        P = self._P
+        n = STATE_SIZE
+
+        psi = x[IPSI]
+        sin_psi = math.sin(psi)
+        cos_psi = math.cos(psi)
+        accel_e = accel_forward * sin_psi + accel_right * cos_psi
+        accel_n = accel_forward * cos_psi - accel_right * sin_psi
+        half_dt2 = 0.5 * dt * dt
+
+        x[IX] += x[IVE] * dt + accel_e * half_dt2
+        x[IY] += x[IVN] * dt + accel_n * half_dt2
+        x[IVE] += accel_e * dt
+        x[IVN] += accel_n * dt
+        x[IPSI] = _wrap_pi(psi + GYRO_Z_SIGN * (omega - x[IBG]) * dt)
+
+        # Jacobi-Matrix F = I + Nebendiagonale (i, j, Wert); F ist obere Dreiecksmatrix mit
+        # Einheitsdiagonale und alle j > i, daher lässt sich F·P·Fᵀ ohne Zwischenpuffer
+        # zeilen- und dann spaltenweise in aufsteigender Reihenfolge berechnen.
+        f_x_ve = dt
+        f_x_psi = accel_n * half_dt2
+        f_y_vn = dt
+        f_y_psi = -accel_e * half_dt2
+        f_ve_psi = accel_n * dt
+        f_vn_psi = -accel_e * dt
+        f_psi_bg = -GYRO_Z_SIGN * dt
+
+        # P ← F·P (Zeilen)
+        for k in range(n):
+            p_ve = P[IVE * n + k]
+            p_vn = P[IVN * n + k]
+            p_psi = P[IPSI * n + k]
+            P[IX * n + k] += f_x_ve * p_ve + f_x_psi * p_psi
+            P[IY * n + k] += f_y_vn * p_vn + f_y_psi * p_psi
+            P[IVE * n + k] += f_ve_psi * p_psi
+            P[IVN * n + k] += f_vn_psi * p_psi
+            P[IPSI * n + k] += f_psi_bg * P[IBG * n + k]
+
+        # P ← P·Fᵀ (Spalten)
+        for k in range(n):
+            row = k * n
+            p_ve = P[row + IVE]
+            p_vn = P[row + IVN]
+            p_psi = P[row + IPSI]
+            P[row + IX] += f_x_ve * p_ve + f_x_psi * p_psi
+            P[row + IY] += f_y_vn * p_vn + f_y_psi * p_psi
+            P[row + IVE] += f_ve_psi * p_psi
+            P[row + IVN] += f_vn_psi * p_psi
+            P[row + IPSI] += f_psi_bg * P[row + IBG]
+
+        # Prozessrauschen (diskretisiert, diagonal)
+        accel_var = self.accel_var
+        P[IX * 7] += accel_var * half_dt2 * half_dt2
+        P[IY * 7] += accel_var * half_dt2 * half_dt2
+        P[IVE * 7] += accel_var * dt * dt
+        P[IVN * 7] += accel_var * dt * dt
+        P[IPSI * 7] += self.gyro_var * dt * dt
+        P[IBG * 7] += self.bias_var * dt
+
+    def _update_lateral(self):
+        """Pseudo-Messung: Geschwindigkeit quer zur Fahrtrichtung ist null."""
+        if not self.heading_initialized:
+            return
+        x = self._x
+        H = self._H
+        sin_psi = math.sin(x[IPSI])
+        cos_psi = math.cos(x[IPSI])
+        for i in range(STATE_SIZE):
+            H[i] = 0.0
+        # v_quer = vE·cos(psi) - vN·sin(psi)
+        H[IVE] = cos_psi
+        H[IVN] = -sin_psi
+        H[IPSI] = -x[IVE] * sin_psi - x[IVN] * cos_psi
+        self._r[0] = -(x[IVE] * cos_psi - x[IVN] * sin_psi)
+        self._R[0] = self.lateral_var
+        self._update(1, 0.0)
+
+    def _update(self, rows: int, gate: float) -> bool:
+        """Kalman-Update mit self._H/_r/_R (rows ≤ 2); False wenn durch das Gating verworfen."""
+        n = STATE_SIZE
+        P, H, PHt, K, r, R = self._P, self._H, self._PHt, self._K, self._r, self._R
+
+        # PHt = P·Hᵀ (n × rows)
+        for i in range(n):
+            row = i * n
+            for a in range(rows):
+                h = a * n
+                total = 0.0
+                for j in range(n):
+                    total += P[row + j] * H[h + j]
+                PHt[i * 2 + a] = total
+
+        # S = H·P·Hᵀ + R und dessen Inverse (1×1 oder 2×2)
+        if rows == 1:
+            s00 = R[0]
+            for j in range(n):
+                s00 += H[j] * PHt[j * 2]
+            if s00 <= 0.0:
+                return False
+            i00 = 1.0 / s00
+            i01 = i11 = 0.0
+            distance = r[0] * r[0] * i00
+        else:
+            s00, s01, s11 = R[0], 0.0, R[1]
+            for j in range(n):
+                s00 += H[j] * PHt[j * 2]
+                s01 += H[j] * PHt[j * 2 + 1]
+                s11 += H[n + j] * PHt[j * 2 + 1]
+            det = s00 * s11 - s01 * s01
+            if det <= 0.0:
+                return False
+            i00, i01, i11 = s11 / det, -s01 / det, s00 / det
+            distance = r[0] * (i00 * r[0] + i01 * r[1]) + r[1] * (i01 * r[0] + i11 * r[1])
+
+        if gate and distance > gate:
+            return False
+
+        # K = PHt·S⁻¹, x += K·r
+        x = self._x
+        for i in range(n):
+            a0 = PHt[i * 2]
+            if rows == 1:
+                k0 = a0 * i00
+                K[i * 2] = k0
+                x[i] += k0 * r[0]
+            else:
+                a1 = PHt[i * 2 + 1]
+                k0 = a0 * i00 + a1 * i01
+                k1 = a0 * i01 + a1 * i11
+                K[i * 2] = k0
+                K[i * 2 + 1] = k1
+                x[i] += k0 * r[0] + k1 * r[1]
+        x[IPSI] = _wrap_pi(x[IPSI])
+
+        # P ← P - K·(H·P) mit H·P = PHtᵀ, danach symmetrisieren
+        for i in range(n):
+            row = i * n
+            k0 = K[i * 2]
+            k1 = K[i * 2 + 1] if rows == 2 else 0.0
+            for j in range(n):
+                P[row + j] -= k0 * PHt[j * 2] + k1 * PHt[j * 2 + 1]
+        for i in range(n):
+            for j in range(i + 1, n):
+                mean = 0.5 * (P[i * n + j] + P[j * n + i])
+                P[i * n + j] = P[j * n + i] = mean
+        return True
+
+    def _reset_covariance(self, index: int, variance: float):
+        """Setzt Zeile/Spalte eines Zustands zurück (neue, unkorrelierte Initialisierung)."""
+        n = STATE_SIZE
+        for k in range(n):
+            self._P[index * n + k] = 0.0
+            self._P[k * n + index] = 0.0
+        self._P[index * n + index] = variance
+
+    def _reset_position(self, east: float, north: float, sigma: float):
+        self._x[IX] = east
+        self._x[IY] = north
+        self._reset_covariance(IX, sigma * sigma)
+        self._reset_covariance(IY, sigma * sigma)
+        self.position_initialized = True
+        self._consecutive_rejects = 0
+
+    def _set_origin(self, latitude: float, longitude: float):
+        phi = math.radians(latitude)
+        factor = 1.0 - _WGS84_E2 * math.sin(phi) ** 2
+        meridian = _WGS84_A * (1.0 - _WGS84_E2) / factor ** 1.5
+        prime_vertical = _WGS84_A / math.sqrt(factor)
+        self._origin = (latitude, longitude, meridian, prime_vertical * math.cos(phi))
+
+    def _to_local(self, latitude: float, longitude: float):
+        lat0, lon0, north_scale, east_scale = self._origin
+        return (math.radians(longitude - lon0) * east_scale, math.radians(latitude - lat0) * north_scale)
+
+    def _to_geodetic(self, east: float, north: float):
+        lat0, lon0, north_scale, east_scale = self._origin
+        return (lat0 + math.degrees(north / north_scale), lon0 + math.degrees(east / east_scale))
+
+    # ------------------------------------------------------------------
+    # Ausgabe
+    # ------------------------------------------------------------------
+
+    def _publish_limited(self, timestamp: float):
+        if timestamp - self._last_publish >= self.output_interval:
+            self._publish(timestamp)
+
+    def _publish(self, timestamp: float):
+        self._last_publish = timestamp
+        self._snapshot.publish(self._build_snapshot_data(timestamp))
+
+    def _build_snapshot_data(self, timestamp: float) -> Dict:
+        """Baut den konsistenten Stand für Leser (Aufruf unter self.lock)."""
+        x = self._x
+        P = self._P
+        latitude = longitude = None
+        if self._origin is not None and self.position_initialized:
+            latitude, longitude = self._to_geodetic(x[IX], x[IY])
+        return {
+            'initialized': self.position_initialized and self.heading_initialized,
+            'timestamp': timestamp,
+            'east': x[IX],
+            'north': x[IY],
+            'latitude': latitude,
+            'longitude': longitude,
+            'vel_east': x[IVE],
+            'vel_north': x[IVN],
+            'speed': math.hypot(x[IVE], x[IVN]),
+            'heading': math.degrees(x[IPSI]) % 360.0,
+            'gyro_bias': math.degrees(x[IBG]),
+            'std_position': math.sqrt(max(P[IX * 7], 0.0) + max(P[IY * 7], 0.0)),
+            'std_velocity': math.sqrt(max(P[IVE * 7], 0.0) + max(P[IVN * 7], 0.0)),
+            'std_heading': math.degrees(math.sqrt(max(P[IPSI * 7], 0.0))),
+            'covariance': [P[i * 7] for i in range(STATE_SIZE)],
+            'fix_quality': self.fix_quality,
+        }
+
+    def get_snapshot(self) -> Snapshot:
+        """Gibt die neueste Pose (Sequenznummer + Daten) ohne Lock zurück."""
+        return self._snapshot.read()
+
+    def get_pose(self) -> Dict:
+        """Gibt die zuletzt veröffentlichte Pose zurück (lock-frei, nur lesen)."""
+        return self._snapshot.read().data
+
+    def get_origin(self) -> Optional[Dict]:
+        """Ursprung des lokalen ENU-Rahmens (erster verwendeter Fix)."""
+        origin = self._origin
+        if origin is None:
+            return None
+        return {'latitude': origin[0], 'longitude': origin[1]}
+
+    def get_status(self) -> Dict:
+        """Zähler und Initialisierungsstatus."""
+        return {
+            'position_initialized': self.position_initialized,
+            'heading_initialized': self.heading_initialized,
+            'origin': self.get_origin(),
+            'predictions': self.predictions,
+            'position_updates': self.position_updates,
+            'heading_updates': self.heading_updates,
+            'rejected_updates': self.rejected_updates,
+            'last_position_age': round(time.time() - self.last_position_time, 2) if self.last_position_time else None,
+            'last_heading_age': round(time.time() - self.last_heading_time, 2) if self.last_heading_time else None,
+        }
@@ -0,0 +1,229 @@
+"""
+Ring Logger - Asynchrones Logging mit festem Speicher für die Hot Paths des Sensor Hubs.
+
+emit() legt nur den LogRecord in einen Ringpuffer fester Größe; formatiert und
+geschrieben wird gebündelt im Flusher-Thread (Konsole/Journal und optional Datei).
+Anders als logging.handlers.QueueHandler formatiert der Handler die Meldung nicht
+schon beim Einreihen. Pro Aufrufstelle (Datei:Zeile) gilt ein Ratenlimit, damit
+Fehlerstürme weder den Puffer noch die SD-Karte fluten; unterdrückte Meldungen
+werden als Zusammenfassung ausgegeben.
+"""
+
+import logging
+import sys
+import threading
+import time
+from collections import deque
+from typing import Deque, Dict, List, Optional, TextIO
+
+# Argumenttypen, die bis zum Flush unverändert bleiben (alles andere wird sofort formatiert)
+_IMMUTABLE_ARGS = (str, int, float, bool, bytes, type(None))
+
+
+class _SiteBudget:
+    """Ratenlimit einer Aufrufstelle (Fenster von einer Sekunde)."""
+
+    __slots__ = ('window_start', 'count', 'suppressed', 'name', 'levelno', 'msg')
+
+    def __init__(self, window_start: float):
+        self.window_start = window_start
+        self.count = 0
+        self.suppressed = 0
+        self.name = ''
+        self.levelno = logging.INFO
+        self.msg = ''
+
+
+class RingLogHandler(logging.Handler):
+    """Logging-Handler mit Ringpuffer, verzögerter Formatierung und Hintergrund-Flusher.
+
+    - emit(): O(1), keine String-Formatierung, kein I/O; ist der Ring voll, wird der
+      älteste Eintrag verworfen (Zähler dropped)
+    - Flusher: alle flush_interval Sekunden bzw. sofort nach ERROR/CRITICAL, ein
+      write() und ein flush() pro Ausgabe und Durchlauf
+    - Ratenlimit: höchstens rate_limit Meldungen pro Aufrufstelle und Sekunde
+      (0 = unbegrenzt)
+    """
+
+    def __init__(self, capacity: int = 4096, flush_interval: float = 2.0, rate_limit: int = 20,
+                 streams: Optional[List[TextIO]] = None, filepath: Optional[str] = None):
+        """
+        Args:
+            capacity: Maximale Anzahl gepufferter Meldungen
+            flush_interval: Spätestes Schreiben gepufferter Meldungen (Sekunden)
+            rate_limit: Meldungen pro Aufrufstelle und Sekunde (0 = unbegrenzt)
+            streams: Ausgabeströme (Default: stderr)
+            filepath: Optionale Logdatei (gepuffert, Anhängen)
+        """
+        super().__init__()
+        self.capacity = capacity
+        self.flush_interval = flush_interval
+        self.rate_limit = rate_limit
+        self.streams: List[TextIO] = list(streams) if streams is not None else [sys.stderr]
+        self.filepath = filepath
+        self._file: Optional[TextIO] = None
+        if filepath:
+            try:
+                self._file = open(filepath, 'a', buffering=64 * 1024, encoding='utf-8')
+            except OSError as e:
+                sys.stderr.write(f"⚠️  Logdatei {filepath} nicht beschreibbar: {e}\n")
+
+        self._ring: Deque[logging.LogRecord] = deque(maxlen=capacity)
+        self._sites: Dict[tuple, _SiteBudget] = {}
+        self._wakeup = threading.Event()
+        # Eigenes Lock für den Ring: logging.shutdown() hält das Handler-Lock während close()
+        self._ring_lock = threading.Lock()
+        self._io_lock = threading.Lock()
+        self._running = True
+
+        self.records = 0
+        self.dropped = 0
+        self.suppressed = 0
+        self.written = 0
+        self.flushes = 0
+        self.write_errors = 0
+        self.max_flush_ms = 0.0
+
+        self._thread = threading.Thread(target=self._flush_loop, name='ring-logger', daemon=True)
+        self._thread.start()
+
+    def emit(self, record: logging.LogRecord):
+        """Reiht einen Record ein (läuft unter dem Handler-Lock)."""
+        with self._ring_lock:
+            self._enqueue(record)
+        if record.levelno >= logging.ERROR:
+            self._wakeup.set()
+
+    def _enqueue(self, record: logging.LogRecord):
+        if self.rate_limit:
+            key = (record.pathname, record.lineno)
+            site = self._sites.get(key)
+            if site is None or record.created - site.window_start >= 1.0:
+                if site is not None and site.suppressed:
+                    self._append(self._summary(site))
+                site = _SiteBudget(record.created)
+                self._sites[key] = site
+            if site.count >= self.rate_limit:
+                site.suppressed += 1
+                self.suppressed += 1
+                site.name, site.levelno, site.msg = record.name, record.levelno, record.msg
+                return
+            site.count += 1
+
+        # Veränderliche Argumente (dicts, Listen, Objekte) jetzt festhalten
+        if record.args and not all(isinstance(arg, _IMMUTABLE_ARGS) for arg in
+                                   (record.args if isinstance(record.args, tuple) else (record.args,))):
+            record.msg = record.getMessage()
+            record.args = None
+        # Traceback-Text jetzt erzeugen, die Frames gehören danach niemandem mehr
+        if record.exc_info and not record.exc_text:
+            record.exc_text = logging.Formatter().formatException(record.exc_info)
+            record.exc_info = None
+
+        self._append(record)
+
+    def _append(self, record: logging.LogRecord):
+        if len(self._ring) == self.capacity:
+            self.dropped += 1
+        self._ring.append(record)
+        self.records += 1
+
+    @staticmethod
+    def _summary(site: _SiteBudget) -> logging.LogRecord:
+        record = logging.LogRecord(site.name, site.levelno, '', 0,
+                                   '%d× unterdrückt (Ratenlimit): %s', (site.suppressed, str(site.msg)), None)
+        record.created = site.window_start + 1.0
+        return record
+
+    def _take(self) -> List[logging.LogRecord]:
+        with self._ring_lock:
+            records = list(self._ring)
+            self._ring.clear()
+            # Abgelaufene Fenster mit unterdrückten Meldungen zusammenfassen und aufräumen
+            now = time.time()
+            for key, site in list(self._sites.items()):
+                if now - site.window_start >= 1.0:
+                    if site.suppressed:
+                        records.append(self._summary(site))
+                    del self._sites[key]
+        return records
+
+    def _flush_loop(self):
+        while self._running:
+            self._wakeup.wait(self.flush_interval)
+            self._wakeup.clear()
+            self.flush()
+
+    def flush(self):
+        """Formatiert und schreibt alle gepufferten Meldungen (ein write pro Ausgabe)."""
+        with self._io_lock:
+            records = self._take()
+            if not records:
+                return
+
+            started = time.perf_counter()
+            lines = []
+            for record in records:
+                try:
+                    lines.append(self.format(record))
+                except Exception:
+                    lines.append(f"<Log-Formatierungsfehler: {record.msg!r}>")
+            text = '\n'.join(lines) + '\n'
+
+            outputs = self.streams + ([self._file] if self._file else [])
+            for output in outputs:
+                try:
+                    output.write(text)
+                    output.flush()
+                except (OSError, ValueError):
+                    self.write_errors += 1
+
+            self.written += len(records)
+            self.flushes += 1
+            elapsed = (time.perf_counter() - started) * 1000.0
+            if elapsed > self.max_flush_ms:
+                self.max_flush_ms = elapsed
+
+    def close(self):
+        """Stoppt den Flusher und schreibt den Rest (auch über logging.shutdown beim Beenden)."""
+        if self._running:
+            self._running = False
+            self._wakeup.set()
+            self._thread.join(timeout=2.0)
+            self.flush()
+            if self._file:
+                try:
+                    self._file.close()
+                except OSError:
+                    pass
+                self._file = None
+        super().close()
+
+    def get_stats(self) -> dict:
+        """Gibt Puffer- und Schreibstatistiken zurück."""
+        return {
+            'capacity': self.capacity,
+            'pending': len(self._ring),
+            'records': self.records,
+            'written': self.written,
+            'dropped': self.dropped,
+            'suppressed': self.suppressed,
+            'flushes': self.flushes,
+            'write_errors': self.write_errors,
+            'max_flush_ms': round(self.max_flush_ms, 3),
+            'file': self.filepath if self._file else None,
+        }
+
+
+def install_ring_logger(level: int, fmt: str, capacity: int = 4096, flush_interval: float = 2.0,
+                        rate_limit: int = 20, filepath: Optional[str] = None) -> RingLogHandler:
+    """Ersetzt die Handler des Root-Loggers durch einen RingLogHandler."""
+    handler = RingLogHandler(capacity=capacity, flush_interval=flush_interval,
+                             rate_limit=rate_limit, filepath=filepath)
+    handler.setFormatter(logging.Formatter(fmt))
+    root = logging.getLogger()
+    for existing in list(root.handlers):
+        root.removeHandler(existing)
+    root.addHandler(handler)
+    root.setLevel(level)
+    return handler
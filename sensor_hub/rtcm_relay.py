@@ -0,0 +1,299 @@
+"""
+RTCM Relay - NTRIP-Korrekturdaten als validierte RTCM3-Nachrichten an das GPS.
+
+- Framing mit CRC-24Q in einem vorallokierten Puffer (keine bytes-Kopie pro Chunk)
+- Schreibt direkt auf den seriellen File-Descriptor, ohne den GPS-Parser-Lock
+- Statistik pro Nachrichtentyp inkl. Alter der Korrekturen (MSM-Epochenzeit)
+"""
+
+import errno
+import logging
+import os
+import select
+import threading
+import time
+from typing import Callable, Dict, Optional
+
+logger = logging.getLogger(__name__)
+
+RTCM3_PREAMBLE = 0xD3
+RTCM3_HEADER_SIZE = 3
+RTCM3_CRC_SIZE = 3
+RTCM3_MAX_PAYLOAD = 1023
+RTCM3_MAX_FRAME = RTCM3_HEADER_SIZE + RTCM3_MAX_PAYLOAD + RTCM3_CRC_SIZE
+
+# GPS-Zeit = UTC + Schaltsekunden (seit 2017: 18 s)
+GPS_EPOCH_UNIX = 315964800
+GPS_LEAP_SECONDS = 18
+BDS_GPS_OFFSET_S = 14
+_WEEK_MS = 7 * 86400 * 1000
+_DAY_MS = 86400 * 1000
+
+
+def _crc24q_table():
+    table = []
+    for byte in range(256):
+        crc = byte << 16
+        for _ in range(8):
+            crc <<= 1
+            if crc & 0x1000000:
+                crc ^= 0x1864CFB
+        table.append(crc & 0xFFFFFF)
+    return table
+
+
+_CRC24Q_TABLE = _crc24q_table()
+
+
+def crc24q(data) -> int:
+    """CRC-24Q (Qualcomm) über die Bytes von data."""
+    crc = 0
+    table = _CRC24Q_TABLE
+    for byte in data:
+        crc = ((crc << 8) & 0xFFFFFF) ^ table[(crc >> 16) ^ byte]
+    return crc
+
+
+def build_rtcm3_frame(payload: bytes) -> bytes:
+    """Baut ein RTCM3-Frame (Preamble, Länge, Payload, CRC) - z.B. für Tests."""
+    if len(payload) > RTCM3_MAX_PAYLOAD:
+        raise ValueError("RTCM3-Payload zu lang")
+    header = bytes([RTCM3_PREAMBLE, (len(payload) >> 8) & 0x03, len(payload) & 0xFF])
+    frame = header + payload
+    crc = crc24q(frame)
+    return frame + bytes([(crc >> 16) & 0xFF, (crc >> 8) & 0xFF, crc & 0xFF])
+
+
+def _bits(data, start: int, length: int) -> int:
+    value = 0
+    for position in range(start, start + length):
+        value = (value << 1) | ((data[position >> 3] >> (7 - (position & 7))) & 1)
+    return value
+
+
+def msm_epoch_age_ms(message_type: int, payload, now: Optional[float] = None) -> Optional[float]:
+    """Alter einer MSM-Nachricht (1071-1127) in ms anhand der Epochenzeit, sonst None."""
+    if not 1071 <= message_type <= 1127 or message_type % 10 == 0 or message_type % 10 > 7:
+        return None
+    if len(payload) < 8:
+        return None
+
+    now = time.time() if now is None else now
+    epoch = _bits(payload, 24, 30)
+    system = message_type // 10
+
+    if system == 108:
+        # GLONASS: 3 Bit Wochentag + 27 Bit ms des Tages (Moskauer Zeit, UTC+3)
+        reference_ms = int((now + 3 * 3600) * 1000) % _DAY_MS
+        age = (reference_ms - (epoch & 0x7FFFFFF)) % _DAY_MS
+        return float(age if age < _DAY_MS // 2 else age - _DAY_MS)
+
+    gps_seconds = now - GPS_EPOCH_UNIX + GPS_LEAP_SECONDS
+    if system == 112:
+        gps_seconds -= BDS_GPS_OFFSET_S
+    reference_ms = int(gps_seconds * 1000) % _WEEK_MS
+    age = (reference_ms - epoch) % _WEEK_MS
+    return float(age if age < _WEEK_MS // 2 else age - _WEEK_MS)
+
+
+class RTCM3Framer:
+    """Streaming-Framer: sammelt Bytes und liefert CRC-validierte RTCM3-Frames.
+
+    on_frame(frame, message_type) bekommt eine memoryview auf den internen
+    Puffer; sie ist nur während des Callbacks gültig.
+    """
+
+    def __init__(self, on_frame: Callable[[memoryview, int], None], capacity: int = 4 * RTCM3_MAX_FRAME):
+        self.on_frame = on_frame
+        self._buffer = bytearray(capacity)
+        self._view = memoryview(self._buffer)
+        self._length = 0
+
+        self.frames = 0
+        self.crc_errors = 0
+        self.discarded_bytes = 0
+
+    def reset(self):
+        self._length = 0
+
+    def feed(self, data) -> int:
+        """Verarbeitet einen Chunk; gibt die Anzahl gültiger Frames zurück."""
+        frames = 0
+        data = memoryview(data)
+        while data:
+            space = len(self._buffer) - self._length
+            take = min(space, len(data))
+            self._view[self._length:self._length + take] = data[:take]
+            self._length += take
+            data = data[take:]
+            frames += self._drain()
+        return frames
+
+    def _drain(self) -> int:
+        buffer = self._buffer
+        view = self._view
+        length = self._length
+        position = 0
+        frames = 0
+
+        while True:
+            preamble = buffer.find(RTCM3_PREAMBLE, position, length)
+            if preamble < 0:
+                self.discarded_bytes += length - position
+                position = length
+                break
+            self.discarded_bytes += preamble - position
+            position = preamble
+
+            if length - position < RTCM3_HEADER_SIZE:
+                break
+            # 6 reservierte Bits müssen 0 sein
+            if buffer[position + 1] & 0xFC:
+                position += 1
+                self.discarded_bytes += 1
+                continue
+
+            payload_length = ((buffer[position + 1] & 0x03) << 8) | buffer[position + 2]
+            frame_length = RTCM3_HEADER_SIZE + payload_length + RTCM3_CRC_SIZE
+            if length - position < frame_length:
+                break
+
+            end = position + frame_length
+            crc = (buffer[end - 3] << 16) | (buffer[end - 2] << 8) | buffer[end - 1]
+            if crc24q(view[position:end - RTCM3_CRC_SIZE]) != crc:
+                self.crc_errors += 1
+                self.discarded_bytes += 1
+                position += 1
+                continue
+
+            message_type = ((buffer[position + 3] << 4) | (buffer[position + 4] >> 4)) if payload_length >= 2 else 0
+            self.frames += 1
+            frames += 1
+            self.on_frame(view[position:end], message_type)
+            position = end
+
+        # Rest an den Pufferanfang verschieben (max. ein unvollständiges Frame)
+        if position:
+            remaining = length - position
+            if remaining:
+                view[:remaining] = view[position:length]
+            self._length = remaining
+        return frames
+
+
+class _TypeStats:
+    __slots__ = ('count', 'bytes', 'first_seen', 'last_seen', 'interval', 'age_ms', 'age_mean_ms')
+
+    def __init__(self, now: float):
+        self.count = 0
+        self.bytes = 0
+        self.first_seen = now
+        self.last_seen = now
+        self.interval = 0.0
+        self.age_ms: Optional[float] = None
+        self.age_mean_ms: Optional[float] = None
+
+
+class RTCMRelay:
+    """Leitet validierte RTCM3-Frames vom NTRIP-Client direkt an den GPS-Port weiter."""
+
+    def __init__(self, fd_provider: Callable[[], Optional[int]], write_timeout: float = 0.2):
+        """
+        Args:
+            fd_provider: Liefert den aktuellen File-Descriptor des GPS-Ports (oder None)
+            write_timeout: Maximale Wartezeit, wenn der Port-Puffer voll ist
+        """
+        self.fd_provider = fd_provider
+        self.write_timeout = write_timeout
+        self.framer = RTCM3Framer(self._on_frame)
+        self._stats: Dict[int, _TypeStats] = {}
+        self._stats_lock = threading.Lock()  # nur für get_stats(), nicht im GPS-Pfad
+
+        self.bytes_written = 0
+        self.frames_dropped = 0
+        self.write_errors = 0
+        self.last_write_us = 0.0
+
+    def feed(self, data):
+        """NTRIP-Callback: Chunk framen und gültige Nachrichten weiterleiten."""
+        self.framer.feed(data)
+
+    def _on_frame(self, frame: memoryview, message_type: int):
+        now = time.time()
+        self._record(message_type, frame, now)
+
+        fd = self.fd_provider()
+        if fd is None:
+            self.frames_dropped += 1
+            return
+
+        started = time.perf_counter()
+        if self._write_all(fd, frame):
+            self.bytes_written += len(frame)
+        else:
+            self.frames_dropped += 1
+        self.last_write_us = (time.perf_counter() - started) * 1e6
+
+    def _write_all(self, fd: int, data: memoryview) -> bool:
+        deadline = None
+        while data:
+            try:
+                written = os.write(fd, data)
+                data = data[written:]
+            except BlockingIOError:
+                # pyserial öffnet den Port non-blocking: auf Platz im TX-Puffer warten
+                now = time.monotonic()
+                deadline = deadline or now + self.write_timeout
+                if now >= deadline:
+                    return False
+                select.select([], [fd], [], deadline - now)
+            except OSError as e:
+                if e.errno == errno.EINTR:
+                    continue
+                self.write_errors += 1
+                logger.warning("⚠️  RTCM-Schreibfehler auf GPS-Port: %s", e)
+                return False
+        return True
+
+    def _record(self, message_type: int, frame: memoryview, now: float):
+        with self._stats_lock:
+            stats = self._stats.get(message_type)
+            if stats is None:
+                stats = self._stats[message_type] = _TypeStats(now)
+            elif stats.count:
+                interval = now - stats.last_seen
+                stats.interval = interval if not stats.interval else stats.interval + (interval - stats.interval) * 0.1
+            stats.count += 1
+            stats.bytes += len(frame)
+            stats.last_seen = now
+
+            age = msm_epoch_age_ms(message_type, frame[RTCM3_HEADER_SIZE:-RTCM3_CRC_SIZE], now)
+            if age is not None:
+                stats.age_ms = age
+                stats.age_mean_ms = age if stats.age_mean_ms is None else stats.age_mean_ms + (age - stats.age_mean_ms) * 0.1
+
+    def get_stats(self) -> Dict:
+        """Statistik pro Nachrichtentyp (Rate, Bytes, Korrektur-Alter)."""
+        now = time.time()
+        with self._stats_lock:
+            types = {
+                str(message_type): {
+                    'count': stats.count,
+                    'bytes': stats.bytes,
+                    'rate_hz': round(1.0 / stats.interval, 2) if stats.interval else 0.0,
+                    'last_seen_s': round(now - stats.last_seen, 2),
+                    'age_ms': round(stats.age_ms, 1) if stats.age_ms is not None else None,
+                    'age_mean_ms': round(stats.age_mean_ms, 1) if stats.age_mean_ms is not None else None,
+                }
+                for message_type, stats in sorted(self._stats.items())
+            }
+        return {
+            'frames': self.framer.frames,
+            'crc_errors': self.framer.crc_errors,
+            'discarded_bytes': self.framer.discarded_bytes,
+            'bytes_written': self.bytes_written,
+            'frames_dropped': self.frames_dropped,
+            'write_errors': self.write_errors,
+            'last_write_us': round(self.last_write_us, 1),
+            'types': types,
+        }
@@ -11,27 +11,61 @@ import signal
 import time
 import json
 import glob
+import math
 import subprocess
 from pathlib import Path
 
 # Konfiguration laden
 sys.path.insert(0, str(Path(__file__).parent))
 import config
-from gps_handler import GPSHandler
+from gps_handler import EVENT_FIX_CHANGED, EVENT_HEADING, EVENT_POSITION, GPSHandler
 from ntrip_client import NTRIPClient
 from gps_ntrip_bridge import GPSNTRIPBridge
-from can_protocol import CANProtocol
-from telemetry_payload import build_status_payload, build_telemetry_payload, serialize_can_payload
-
-# Logging konfigurieren
-logging.basicConfig(
-    level=getattr(logging, config.LOG_LEVEL),
-    format=config.LOG_FORMAT
+from io_reactor import IOReactor
+from pose_estimator import PoseEstimator
+from status_cache import StatusCache
+from can_dispatcher import MODE_JSON, CANDispatcher, parse_filter_spec
+from can_protocol import CANProtocol, fd_capable
+from can_transmitter import (PRIORITY_COMMAND, PRIORITY_DIAGNOSTICS, PRIORITY_TELEMETRY, CANTransmitter,
+                             fd_message_factory)
+from coverage_raster import CoverageRaster, blade_position, local_offset
+from ring_logger import install_ring_logger
+from startup import StartupOrchestrator
+from telemetry_payload import (
+    build_diagnostics_payload,
+    build_status_payload,
+    build_telemetry_payload,
+    pack_fused_pose_frame,
+    pack_telemetry_frame,
+    serialize_can_payload,
+    telemetry_exceeds_deadband,
 )
+from telemetry_scheduler import TelemetryGroup, TelemetryScheduler
+
+# Logging konfigurieren (Ring-Logger: Hot Paths zahlen weder Formatierung noch I/O)
+if config.LOG_ASYNC:
+    log_handler = install_ring_logger(
+        level=getattr(logging, config.LOG_LEVEL),
+        fmt=config.LOG_FORMAT,
+        capacity=config.LOG_RING_SIZE,
+        flush_interval=config.LOG_FLUSH_INTERVAL,
+        rate_limit=config.LOG_RATE_LIMIT,
+        filepath=config.LOG_FILE if config.LOG_FILE_ENABLED else None
+    )
+else:
+    log_handler = None
+    handlers = [logging.StreamHandler()]
+    if config.LOG_FILE_ENABLED:
+        handlers.append(logging.FileHandler(config.LOG_FILE))
+    logging.basicConfig(
+        level=getattr(logging, config.LOG_LEVEL),
+        format=config.LOG_FORMAT,
+        handlers=handlers
+    )
 logger = logging.getLogger(__name__)
 
 # Flask imports
-from flask import Flask, render_template, jsonify
+from flask import Flask, Response, render_template, jsonify, request
 import threading
 
 # CAN imports
@@ -53,102 +87,158 @@ class SensorHubApp:
         self.ntrip = None
         self.bridge = None
         self.imu = None
+        self.pose = PoseEstimator(output_rate=config.POSE_OUTPUT_RATE) if config.POSE_ESTIMATOR_ENABLED else None
+        self.io_reactor = IOReactor() if config.IO_REACTOR_ENABLED else None
         self.can_bus = None
-        self.can_send_lock = threading.Lock()
+        self.can_tx = None
+        self.coverage = None
+        self.coverage_error = None
         self.resolved_gps_port = config.GPS_PORT
         self.resolved_imu_port = None
-        self.can_messages_sent = 0
-        self.can_send_errors = 0
         self.last_command = None
         self.last_command_time = None
-        self.can_protocol = CANProtocol(
+        # Transport: CAN-FD (64-Byte-Frames) oder klassisch (8 Bytes)
+        self.can_fd = config.CAN_FD
+        self.can_protocol = self._create_can_protocol()
+        # Empfang: eigene Route (und eigener Reassembly-Kontext) pro Arbitration-ID;
+        # ein FD-Empfänger nimmt auch klassische Frames an
+        self.can_dispatcher = CANDispatcher(
             max_frame_size=config.CAN_MAX_FRAME_SIZE,
-            frame_timeout=config.CAN_FRAME_TIMEOUT
+            frame_timeout=config.CAN_FRAME_TIMEOUT,
+            fd=config.CAN_FD
         )
+        self.can_dispatcher.register(config.CAN_CONTROLLER_ID, self._on_can_command, mode=MODE_JSON,
+                                     name='controller')
         self.can_sender_thread = None
         self.can_receiver_thread = None
+        # Weckt den CAN-Sender sofort bei RTK-Statuswechsel (statt bis zum nächsten Takt zu warten)
+        self._can_wakeup = threading.Event()
+        self.telemetry = self._init_telemetry()
         self.app = Flask(__name__, template_folder='templates')
         self._setup_routes()
+        self.startup = StartupOrchestrator(parallel=config.STARTUP_PARALLEL)
         self._init_sensors()
-        self._init_can_bus()
+        self._init_status_cache()
     
     def _init_sensors(self):
-        """Initialisiert Sensoren"""
+        """Initialisiert Sensoren und CAN parallel (NTRIP-Verbindungsaufbau im Hintergrund)"""
         logger.info("🚀 Initialisiere Sensoren...")
-
+        self.startup.add('io_reactor', self._init_io_reactor)
+        # CAN zuerst: der Controller sieht den Sensor Hub, bevor GPS/IMU fertig sind
+        self.startup.add('can', self._init_can_bus)
+        self.startup.add('gps', self._init_gps, depends=('io_reactor',))
+        self.startup.add('imu', self._init_imu, depends=('io_reactor',))
+        # NTRIP blockiert bis zu NTRIP_TIMEOUT im ersten connect() - darauf wartet niemand
+        self.startup.add('ntrip', self._init_ntrip, depends=('gps',), background=True)
+        self.startup.run(timeout=config.STARTUP_TIMEOUT)
+
+    def _init_io_reactor(self):
+        if self.io_reactor:
+            self.io_reactor.start()
+
+    def _init_gps(self):
+        """Öffnet den GPS-Port (Wildcard-Pfad aufgelöst)"""
         gps_port = self._resolve_device_path(config.GPS_PORT)
         self.resolved_gps_port = gps_port
         logger.info(f"📡 Verwende GPS-Port: {gps_port}")
 
-        # GPS initialisieren
-        self.gps = GPSHandler(
+        gps = GPSHandler(
             port=gps_port,
             baudrate=config.GPS_BAUDRATE,
-            timeout=config.GPS_TIMEOUT
+            timeout=config.GPS_TIMEOUT,
+            reactor=self.io_reactor
         )
-
-        if self.gps.connect():
+        gps.subscribe(EVENT_FIX_CHANGED, self._on_gps_fix_changed)
+        if self.pose:
+            gps.subscribe(EVENT_POSITION, self.pose.on_gps_position)
+            gps.subscribe(EVENT_HEADING, self.pose.on_gps_heading)
+        if config.COVERAGE_ENABLED:
+            gps.subscribe(EVENT_POSITION, self._on_coverage_position)
+        self.gps = gps
+
+        if gps.connect():
             logger.info("✅ GPS initialisiert")
-        else:
-            logger.error("❌ GPS-Initialisierung fehlgeschlagen")
-            return
+            return True
+        logger.error("❌ GPS-Initialisierung fehlgeschlagen")
+        return False
 
-        # NTRIP initialisieren wenn aktiviert
-        if config.NTRIP_ENABLED:
-            self.ntrip = NTRIPClient(
-                host=config.NTRIP_HOST,
-                port=config.NTRIP_PORT,
-                mountpoint=config.NTRIP_MOUNTPOINT,
-                username=config.NTRIP_USERNAME,
-                password=config.NTRIP_PASSWORD,
-                timeout=config.NTRIP_TIMEOUT,
-                reconnect_interval=config.NTRIP_RECONNECT_INTERVAL
-            )
-
-            # GPS-NTRIP Bridge starten
-            self.bridge = GPSNTRIPBridge(self.gps, self.ntrip)
-            if self.bridge.start():
-                logger.info("✅ NTRIP/RTK aktiviert")
-            else:
-                logger.warning("⚠️  NTRIP konnte nicht verbunden werden")
-        else:
+    def _init_ntrip(self):
+        """Startet NTRIP-Client und GPS-NTRIP-Bridge (braucht ein verbundenes GPS)"""
+        if not config.NTRIP_ENABLED:
             logger.info("ℹ️  NTRIP deaktiviert")
+            return True
+
+        self.ntrip = NTRIPClient(
+            host=config.NTRIP_HOST,
+            port=config.NTRIP_PORT,
+            mountpoint=config.NTRIP_MOUNTPOINT,
+            username=config.NTRIP_USERNAME,
+            password=config.NTRIP_PASSWORD,
+            timeout=config.NTRIP_TIMEOUT,
+            reconnect_interval=config.NTRIP_RECONNECT_INTERVAL,
+            reactor=self.io_reactor
+        )
 
-        # IMU initialisieren wenn aktiviert
-        if config.IMU_ENABLED:
-            try:
-                from imu_handler import create_imu_handler
-            except ImportError as e:
-                logger.error(f"❌ IMU aktiviert, aber Abhängigkeit fehlt: {e}")
-                logger.info("ℹ️  Starte ohne IMU")
-                return
+        # GPS-NTRIP Bridge starten
+        self.bridge = GPSNTRIPBridge(self.gps, self.ntrip, rtcm_framing=config.NTRIP_RTCM_FRAMING)
+        if self.bridge.start():
+            logger.info("✅ NTRIP/RTK aktiviert")
+            return True
+        logger.warning("⚠️  NTRIP konnte nicht verbunden werden")
+        return False
+
+    def _init_imu(self):
+        """Öffnet die IMU (unabhängig vom GPS)"""
+        if not config.IMU_ENABLED:
+            logger.info("ℹ️  IMU deaktiviert")
+            return True
 
-            imu_port = self._resolve_device_path(config.IMU_PORT)
-            self.resolved_imu_port = imu_port
-            logger.info(f"🧭 Verwende IMU-Port: {imu_port}")
+        try:
+            from imu_handler import create_imu_handler
+        except ImportError as e:
+            logger.error(f"❌ IMU aktiviert, aber Abhängigkeit fehlt: {e}")
+            logger.info("ℹ️  Starte ohne IMU")
+            return False
 
-            try:
-                self.imu = create_imu_handler(
-                    config.IMU_TYPE,
-                    port=imu_port,
-                    baudrate=config.IMU_BAUDRATE,
-                    timeout=config.IMU_TIMEOUT,
-                    sample_rate=config.IMU_SAMPLE_RATE,
-                )
-            except ValueError as e:
-                logger.error(f"❌ Ungültige IMU-Konfiguration: {e}")
-                logger.info("ℹ️  Starte ohne IMU")
-                return
-
-            if self.imu.connect():
-                imu_status = self.imu.get_status() if hasattr(self.imu, 'get_status') else {}
-                logger.info(f"✅ IMU aktiviert ({imu_status.get('imu_type', config.IMU_TYPE)})")
-                logger.info("ℹ️  WitMotion liefert native Orientierung und Bewegungsdaten")
-            else:
-                logger.warning("⚠️  IMU konnte nicht verbunden werden")
-                self.imu = None
-        else:
-            logger.info("ℹ️  IMU deaktiviert")
+        imu_port = self._resolve_device_path(config.IMU_PORT)
+        self.resolved_imu_port = imu_port
+        logger.info(f"🧭 Verwende IMU-Port: {imu_port}")
+
+        try:
+            imu = create_imu_handler(
+                config.IMU_TYPE,
+                port=imu_port,
+                baudrate=config.IMU_BAUDRATE,
+                timeout=config.IMU_TIMEOUT,
+                sample_rate=config.IMU_SAMPLE_RATE,
+                reactor=self.io_reactor,
+                stats_window=config.IMU_STATS_WINDOW,
+            )
+        except ValueError as e:
+            logger.error(f"❌ Ungültige IMU-Konfiguration: {e}")
+            logger.info("ℹ️  Starte ohne IMU")
+            return False
+
+        if not imu.connect():
+            logger.warning("⚠️  IMU konnte nicht verbunden werden")
+            return False
+
+        imu_status = imu.get_status() if hasattr(imu, 'get_status') else {}
+        logger.info(f"✅ IMU aktiviert ({imu_status.get('imu_type', config.IMU_TYPE)})")
+        logger.info("ℹ️  WitMotion liefert native Orientierung und Bewegungsdaten")
+        if self.pose and hasattr(imu, 'sample_callback'):
+            imu.sample_callback = self.pose.on_imu_sample
+            logger.info(f"✅ Pose-Schätzung aktiv (EKF, max. {config.POSE_OUTPUT_RATE:g} Hz)")
+        self.imu = imu
+        return True
+
+    def _create_can_protocol(self):
+        """Sende-Protokoll für den aktiven Transport (FD: CAN_FD_FRAME_SIZE Bytes pro Frame)"""
+        return CANProtocol(
+            max_frame_size=config.CAN_FD_FRAME_SIZE if self.can_fd else config.CAN_MAX_FRAME_SIZE,
+            frame_timeout=config.CAN_FRAME_TIMEOUT,
+            fd=self.can_fd
+        )
 
     def _init_can_bus(self):
         """Initialisiert CAN-Bus für JSON-Kommunikation"""
@@ -158,14 +248,37 @@ class SensorHubApp:
 
         if not CAN_AVAILABLE:
             logger.error("❌ python-can nicht verfügbar, CAN deaktiviert")
-            return
+            return False
+
+        if self.can_fd and fd_capable(config.CAN_INTERFACE) is False:
+            logger.error(f"❌ {config.CAN_INTERFACE} ist nicht im FD-Modus (ip link ... fd on) "
+                         f"- sende klassische 8-Byte-Frames")
+            self.can_fd = False
+            self.can_protocol = self._create_can_protocol()
 
         try:
+            # Kernel-Filter (CAN_RAW_FILTER): nur Frames registrierter IDs erreichen den Receiver
+            can_filters = None
+            if config.CAN_KERNEL_FILTERS:
+                can_filters = self.can_dispatcher.filters(parse_filter_spec(config.CAN_EXTRA_FILTERS))
+
             self.can_bus = can.interface.Bus(
                 channel=config.CAN_INTERFACE,
-                interface='socketcan'
+                interface='socketcan',
+                can_filters=can_filters,
+                fd=self.can_fd
                 # bitrate nicht angeben, da CAN bereits via ip link konfiguriert ist
             )
+            if can_filters:
+                ids = ', '.join(f"0x{f['can_id']:X}/0x{f['can_mask']:X}" for f in can_filters)
+                logger.info(f"🔎 CAN-Kernel-Filter aktiv: {ids}")
+
+            # TX-Thread: sendet Nachrichten am Stück, Antworten vor Telemetrie
+            self.can_tx = CANTransmitter(
+                self.can_bus,
+                message_factory=fd_message_factory(config.CAN_FD_BRS) if self.can_fd else None
+            )
+            self.can_tx.start()
 
             # CAN Sender Thread starten (50Hz)
             self.can_sender_thread = threading.Thread(target=self._can_sender_loop, daemon=True)
@@ -175,38 +288,153 @@ class SensorHubApp:
             self.can_receiver_thread = threading.Thread(target=self._can_receiver_loop, daemon=True)
             self.can_receiver_thread.start()
 
-            logger.info(f"✅ CAN-Bus initialisiert ({config.CAN_INTERFACE}, {config.CAN_BITRATE} bps)")
+            if self.can_fd:
+                logger.info(f"✅ CAN-FD-Bus initialisiert ({config.CAN_INTERFACE}, {config.CAN_BITRATE} / "
+                            f"{config.CAN_DATA_BITRATE} bps, {self.can_protocol.max_frame_size} Bytes pro Frame"
+                            f"{', BRS' if config.CAN_FD_BRS else ''})")
+            else:
+                logger.info(f"✅ CAN-Bus initialisiert ({config.CAN_INTERFACE}, {config.CAN_BITRATE} bps)")
 
         except Exception as e:
             logger.error(f"❌ CAN-Bus Initialisierung fehlgeschlagen: {e}")
             self.can_bus = None
+            return False
 
-    def _can_sender_loop(self):
-        """Sendet Sensor-Daten über CAN mit konfigurierbarer Rate"""
-        interval = 1.0 / config.CAN_SEND_RATE
+    def _init_telemetry(self):
+        """Feldgruppen der CAN-Telemetrie: Pose (schnell, bei Änderung) und Diagnose (langsam)"""
+        scheduler = TelemetryScheduler()
+        scheduler.add(TelemetryGroup(
+            'pose',
+            build=self._get_sensor_data,
+            send=self._send_pose_telemetry,
+            min_interval=1.0 / config.CAN_SEND_RATE,
+            heartbeat=config.TELEMETRY_HEARTBEAT,
+            changed=self._pose_changed,
+            sequence=self._status_sequence
+        ))
+        if config.TELEMETRY_DIAG_RATE > 0:
+            scheduler.add(TelemetryGroup(
+                'diagnostics',
+                build=self._get_diagnostics,
+                send=lambda payload: self._send_can_json(serialize_can_payload(payload),
+                                                         priority=PRIORITY_DIAGNOSTICS),
+                min_interval=1.0 / config.TELEMETRY_DIAG_RATE,
+                heartbeat=config.TELEMETRY_DIAG_HEARTBEAT,
+                changed=lambda previous, current: previous['diag'] != current['diag']
+            ))
+        return scheduler
 
+    def _can_sender_loop(self):
+        """Sendet Telemetrie-Gruppen über CAN, sobald sie fällig sind"""
         while self.running:
             try:
                 if not self.can_bus:
                     time.sleep(0.1)
                     continue
 
-                # Sensor-Daten sammeln
-                sensor_data = self._get_sensor_data()
-
-                # JSON-String erstellen
-                json_str = serialize_can_payload(sensor_data)
-
-                # CAN-Nachricht senden (max 8 Bytes pro Frame)
-                # Bei längeren Nachrichten müssen wir fragmentieren
-                self._send_can_json(json_str)
-
-                time.sleep(interval)
+                self._wait_can_interval(self.telemetry.poll())
 
             except Exception as e:
-                logger.error(f"❌ CAN-Sender Fehler: {e}")
+                logger.error("❌ CAN-Sender Fehler: %s", e)
                 time.sleep(0.1)
 
+    def _send_pose_telemetry(self, sensor_data):
+        if config.CAN_TELEMETRY_FORMAT == 'binary':
+            # Gepacktes Binär-Frame (4 CAN-Frames) auf eigener Telemetrie-ID; die fusionierte
+            # Pose als eigener Nachrichtentyp davor, der Empfänger hängt sie an das Sensor-Frame.
+            # Beide in einer Einreihung: neuere Telemetrie ersetzt sonst das noch wartende Pose-Frame
+            if not self.can_bus or not self.can_tx:
+                return False
+            frames = self.can_protocol.encode_frames(pack_telemetry_frame(sensor_data))
+            pose_frame = pack_fused_pose_frame(sensor_data)
+            if pose_frame is not None:
+                frames = self.can_protocol.encode_frames(pose_frame) + frames
+            return self.can_tx.submit(config.CAN_TELEMETRY_ID, frames, PRIORITY_TELEMETRY)
+        # Legacy: JSON-String, fragmentiert in 6-Byte-Chunks
+        return self._send_can_json(serialize_can_payload(sensor_data), priority=PRIORITY_TELEMETRY)
+
+    def _pose_changed(self, previous, current):
+        """Fahrend immer senden, im Stillstand nur über dem Totband"""
+        pose = current.get('pose')
+        if pose:
+            if math.hypot(pose['vel_east'], pose['vel_north']) >= config.TELEMETRY_MOVING_SPEED:
+                return True
+        else:
+            orientation = self._get_orientation()
+            if orientation and not orientation.get('is_stationary', True):
+                return True
+        return telemetry_exceeds_deadband(previous, current, config.TELEMETRY_POSITION_DEADBAND,
+                                          config.TELEMETRY_ANGLE_DEADBAND)
+
+    def _get_diagnostics(self):
+        return build_diagnostics_payload(
+            gps_status=self.gps.get_status() if self.gps else None,
+            imu_connected=bool(self.imu and self.imu.connected),
+            ntrip_connected=self.ntrip.is_connected() if self.ntrip else None,
+            pose=self.pose.get_pose() if self.pose else None,
+            send_errors=self.can_tx.send_errors if self.can_tx else 0
+        )
+
+    def _wait_can_interval(self, interval):
+        """Wartet bis zum nächsten Sendetakt oder bis ein GPS-Event den Sender weckt"""
+        if self._can_wakeup.wait(interval):
+            self._can_wakeup.clear()
+
+    def _on_gps_fix_changed(self, event):
+        """GPS-Event: RTK-Statuswechsel sofort per CAN melden"""
+        logger.debug("🔄 GPS-Fix: %s → %s - CAN-Sender geweckt", event.previous, event.value)
+        self.telemetry.trigger('pose')
+        self._can_wakeup.set()
+
+    def _on_coverage_position(self, event):
+        """GPS-Event: Messerposition ins Abdeckungsraster stempeln (fusionierte Pose, sonst Antennenfix)"""
+        fix = event.value
+        if (not fix.latitude or not fix.longitude or fix.fix_quality == 0
+                or (config.COVERAGE_RTK_ONLY and fix.fix_quality != 4)):
+            if self.coverage:
+                self.coverage.update(0.0, 0.0, active=False)
+            return
+        if self.coverage is None and (self.coverage_error or not self._create_coverage(fix.latitude, fix.longitude)):
+            return
+        # Pose-Handler ist vor diesem Abonnenten registriert und hat den Fix schon verarbeitet
+        latitude, longitude = fix.latitude, fix.longitude
+        heading = (self.gps.heading or None) if self.gps else None
+        pose = self.pose.get_pose() if self.pose else None
+        if pose and pose.get('initialized') and pose.get('latitude') is not None:
+            latitude, longitude, heading = pose['latitude'], pose['longitude'], pose['heading']
+        east, north = local_offset(self.coverage.origin[0], self.coverage.origin[1], latitude, longitude)
+        if heading is not None:
+            east, north = blade_position(east, north, heading,
+                                         config.COVERAGE_BLADE_OFFSET_FORWARD, config.COVERAGE_BLADE_OFFSET_LEFT)
+        self.coverage.update(east, north)
+
+    def _create_coverage(self, latitude, longitude):
+        """Legt das Raster um den ersten Fix an (Ursprung einer vorhandenen Datei, wenn der Fix darin liegt)"""
+        half = config.COVERAGE_SIZE / 2.0
+        origin = (latitude, longitude)
+        existing = CoverageRaster.read_origin(config.COVERAGE_FILE) if config.COVERAGE_FILE else None
+        if existing:
+            east, north = local_offset(existing[0], existing[1], latitude, longitude)
+            if abs(east) < half and abs(north) < half:
+                origin = existing
+        try:
+            self.coverage = CoverageRaster(
+                -half, -half, half, half,
+                resolution=config.COVERAGE_RESOLUTION,
+                tile_size=config.COVERAGE_TILE_SIZE,
+                origin=origin,
+                filepath=config.COVERAGE_FILE,
+                stamp_width=config.COVERAGE_WIDTH,
+                max_gap=config.COVERAGE_MAX_GAP
+            )
+        except (OSError, ValueError) as e:
+            self.coverage_error = str(e)
+            logger.error(f"❌ Abdeckungsraster nicht verfügbar: {e}")
+            return False
+        logger.info(f"✅ Abdeckungsraster {self.coverage.width}x{self.coverage.height} Zellen "
+                    f"({self.coverage.size / (1 << 20):.1f} MB) um {origin[0]:.7f}, {origin[1]:.7f}")
+        return True
+
     def _can_receiver_loop(self):
         """Empfängt CAN-Befehle vom Controller"""
         while self.running:
@@ -216,30 +444,22 @@ class SensorHubApp:
                     continue
 
                 msg = self.can_bus.recv(timeout=1.0)
-                if msg is None:
-                    continue
-
-                if msg.arbitration_id != config.CAN_CONTROLLER_ID:
-                    self.can_protocol.cleanup_old_buffers()
-                    continue
+                if msg is not None:
+                    self.can_dispatcher.dispatch(msg.arbitration_id, bytes(msg.data))
 
-                try:
-                    json_str = self.can_protocol.decode_frame(msg.arbitration_id, bytes(msg.data))
-                    if not json_str:
-                        self.can_protocol.cleanup_old_buffers()
-                        continue
-
-                    data = json.loads(json_str)
-                    self._process_can_command(data)
-                except json.JSONDecodeError as e:
-                    logger.warning(f"⚠️  CAN JSON-Decode Fehler: {e}")
-
-                self.can_protocol.cleanup_old_buffers()
+                # Timeout-Prüfung zeitgesteuert statt pro Frame
+                self.can_dispatcher.cleanup()
 
             except Exception as e:
-                logger.error(f"❌ CAN-Receiver Fehler: {e}")
+                logger.error("❌ CAN-Receiver Fehler: %s", e)
                 time.sleep(0.1)
 
+    def _sensor_sequence(self):
+        """Kombinierte Snapshot-Sequenznummern von GPS und IMU."""
+        gps_seq = self.gps.get_snapshot().seq if self.gps else 0
+        imu_seq = self.imu.get_snapshot().seq if self.imu and hasattr(self.imu, 'get_snapshot') else 0
+        return gps_seq, imu_seq
+
     def _get_sensor_data(self):
         """Sammelt aktuelle Sensor-Daten"""
         gps_status = None
@@ -252,7 +472,8 @@ class SensorHubApp:
             imu_data = self.imu.get_data()
             orientation = self._get_orientation()
 
-        return build_telemetry_payload(gps_status=gps_status, orientation=orientation, imu_data=imu_data)
+        pose = self.pose.get_pose() if self.pose else None
+        return build_telemetry_payload(gps_status=gps_status, orientation=orientation, imu_data=imu_data, pose=pose)
 
     def _get_orientation(self):
         """Liefert Orientierung direkt vom WitMotion-Treiber."""
@@ -287,53 +508,34 @@ class SensorHubApp:
                 'ntrip_connected': bool(self.ntrip and self.ntrip.is_connected()),
                 'can_enabled': bool(self.can_bus),
                 'can_interface': config.CAN_INTERFACE,
-                'messages_sent': self.can_messages_sent,
-                'send_errors': self.can_send_errors,
+                'can_fd': self.can_fd,
+                'telemetry_format': config.CAN_TELEMETRY_FORMAT,
+                'messages_sent': self.can_tx.messages_sent if self.can_tx else 0,
+                'send_errors': self.can_tx.send_errors if self.can_tx else 0,
                 'last_command': self.last_command,
                 'last_command_time': self.last_command_time,
             }
         )
 
-    def _send_can_json(self, json_str):
+    def _send_can_json(self, json_str, priority=PRIORITY_COMMAND):
         """Sendet JSON-String über CAN (Multi-Frame für längere Nachrichten)"""
-        if not self.can_bus:
-            return False
-
-        with self.can_send_lock:
-            data_bytes = json_str.encode('utf-8')
+        return self._send_can_frames(config.CAN_SENSOR_HUB_ID, json_str.encode('utf-8'), priority=priority)
 
-            # Multi-Frame Übertragung (6 Bytes Nutzdaten pro Frame, 2 Bytes Header)
-            chunk_size = 6
-            total_frames = (len(data_bytes) + chunk_size - 1) // chunk_size
-
-            for frame_idx in range(total_frames):
-                start = frame_idx * chunk_size
-                end = min(start + chunk_size, len(data_bytes))
-                chunk = data_bytes[start:end]
-
-                # Frame-Header: [frame_idx, total_frames, ...data (max 6 bytes)]
-                frame_data = bytes([frame_idx, total_frames]) + chunk
-
-                # Auf 8 Bytes auffüllen
-                frame_data = frame_data + b'\x00' * (8 - len(frame_data))
-
-                msg = can.Message(
-                    arbitration_id=config.CAN_SENSOR_HUB_ID,
-                    data=frame_data,
-                    is_extended_id=False
-                )
+    def _send_can_frames(self, arbitration_id, data_bytes, priority=PRIORITY_COMMAND):
+        """Reiht Nutzdaten als Multi-Frame-Nachricht in die TX-Queue ein (2 Bytes Header pro Frame)"""
+        if not self.can_bus or not self.can_tx:
+            return False
 
-                try:
-                    self.can_bus.send(msg)
-                    # Kleine Pause zwischen Frames
-                    time.sleep(0.001)  # 1ms
-                except Exception as e:
-                    self.can_send_errors += 1
-                    logger.error(f"❌ CAN-Send Fehler (Frame {frame_idx}/{total_frames}): {e}")
-                    return False
+        return self.can_tx.submit(arbitration_id, self.can_protocol.encode_frames(data_bytes), priority)
 
-        self.can_messages_sent += 1
-        return True
+    def _on_can_command(self, arbitration_id, json_str):
+        """Route für JSON-Befehle vom Controller"""
+        try:
+            data = json.loads(json_str)
+        except json.JSONDecodeError as e:
+            logger.warning("⚠️  CAN JSON-Decode Fehler: %s", e)
+            return
+        self._process_can_command(data)
 
     def _process_can_command(self, data):
         """Verarbeitet CAN-Befehle vom Controller"""
@@ -345,14 +547,14 @@ class SensorHubApp:
             logger.info("📡 Status-Anfrage empfangen")
             status_response = self._get_status_response()
             if self._send_can_json(serialize_can_payload(status_response)):
-                logger.info("📤 Sensor-Status über CAN gesendet")
+                logger.info("📤 Sensor-Status zum Senden über CAN eingereiht")
 
         elif cmd == 'restart':
             logger.warning("🔄 Restart-Befehl empfangen")
             threading.Thread(target=self._restart_service_async, daemon=True).start()
 
         else:
-            logger.debug(f"📡 Unbekannter CAN-Befehl: {cmd}")
+            logger.debug("📡 Unbekannter CAN-Befehl: %s", cmd)
 
     def _restart_service_async(self):
         """Startet den Sensor-Hub-Dienst asynchron neu."""
@@ -367,6 +569,116 @@ class SensorHubApp:
         except Exception as e:
             logger.error(f"❌ Restart fehlgeschlagen: {e}")
 
+    def _init_status_cache(self):
+        """Registriert die vorberechneten API-Antworten und startet den Producer."""
+        self.status_cache = StatusCache(
+            sequence=self._status_sequence,
+            max_rate=config.WEB_STATUS_RATE,
+            refresh_interval=config.WEB_STATUS_REFRESH
+        )
+        self.status_cache.register('status', self._build_status_response)
+        self.status_cache.register('coordinates', self._build_coordinates_response)
+        self.status_cache.register('imu_data', self._build_imu_data_response)
+        self.status_cache.register('health', self._build_health_response)
+        self.status_cache.start()
+
+    def _status_sequence(self):
+        """Ändert sich bei jedem GPS-, IMU- oder Pose-Update."""
+        pose_seq = self.pose.get_snapshot().seq if self.pose else 0
+        return self._sensor_sequence() + (pose_seq,)
+
+    def _build_status_response(self):
+        if not self.gps:
+            return 500, {'error': 'GPS nicht initialisiert'}
+
+        return 200, {
+            'gps': self.gps.get_status(),
+            'timestamp': time.time()
+        }
+
+    def _build_coordinates_response(self):
+        if not self.gps:
+            return 500, {'error': 'GPS nicht initialisiert'}
+
+        status = self.gps.get_status()
+        return 200, {
+            'latitude': status['latitude'],
+            'longitude': status['longitude'],
+            'bing_maps_url': self.gps.get_bing_maps_url()
+        }
+
+    def _build_imu_data_response(self):
+        if not self.imu or not self.imu.connected:
+            return 503, {'error': 'IMU nicht verbunden'}
+
+        imu_data = self.imu.get_data()
+        orientation = {'roll': 0.0, 'pitch': 0.0, 'yaw': 0.0, 'heading': 0.0,
+                      'is_stationary': False, 'gyro_bias': {'x': 0.0, 'y': 0.0, 'z': 0.0},
+                      'gps_weight': 0.0}
+        imu_status = self.imu.get_status() if hasattr(self.imu, 'get_status') else {}
+        driver_orientation = self._get_orientation()
+        if driver_orientation:
+            orientation = driver_orientation
+
+        return 200, {
+            'accel': imu_data['accel'],
+            'gyro': imu_data['gyro'],
+            'mag': imu_data.get('mag'),
+            'temperature': imu_data['temperature'],
+            'roll': orientation['roll'],
+            'pitch': orientation['pitch'],
+            'yaw': orientation['yaw'],
+            'heading': orientation['heading'],
+            'is_calibrated': imu_data['is_calibrated'],
+            'is_stationary': orientation['is_stationary'],
+            'gyro_bias': orientation['gyro_bias'],
+            'gps_weight': orientation['gps_weight'],
+            'imu_type': imu_status.get('imu_type', config.IMU_TYPE),
+            'orientation_source': orientation.get('source', imu_status.get('orientation_source', 'unknown')),
+            'timestamp': imu_data['timestamp']
+        }
+
+    def _build_health_response(self):
+        return 200, {
+            'status': 'ok',
+            'gps_connected': self.gps.running if self.gps else False,
+            'ntrip_connected': self.ntrip.is_connected() if self.ntrip else False,
+            'can_enabled': bool(self.can_bus),
+            'can_tx': self.can_tx.get_status() if self.can_tx else None,
+            'can_rx': self.can_dispatcher.get_status(),
+            'telemetry': self.telemetry.get_status(),
+            'io_reactor': self.io_reactor.get_status() if self.io_reactor else None,
+            'pose': self.pose.get_status() if self.pose else None,
+            'status_cache': self.status_cache.get_status(),
+            'logging': log_handler.get_stats() if log_handler else None,
+            'startup': self.startup.get_report(),
+            'coverage': self.coverage.get_status() if self.coverage else None,
+            'gps_port': self.resolved_gps_port,
+            'imu_enabled': config.IMU_ENABLED,
+            'imu_type': config.IMU_TYPE,
+            'timestamp': time.time()
+        }
+
+    def _cached_response(self, key):
+        """Liefert die vorberechnete Antwort (ETag/304, Long-Poll über ?since=<version>&wait=<s>)."""
+        since = request.args.get('since', type=int)
+        if since is not None:
+            timeout = min(max(request.args.get('wait', 25.0, type=float), 0.0), 60.0)
+            entry = self.status_cache.wait(key, since, timeout)
+        else:
+            entry = self.status_cache.get(key)
+        if entry is None:
+            return jsonify({'error': 'Status noch nicht verfügbar'}), 503
+
+        if request.if_none_match.contains(entry.etag):
+            response = Response(status=304)
+        else:
+            response = Response(entry.body, status=entry.status, mimetype='application/json')
+        response.set_etag(entry.etag)
+        response.headers['Cache-Control'] = 'no-cache'
+        response.headers['X-Status-Version'] = str(entry.version)
+        return response
+
     def _setup_routes(self):
         """Konfiguriert Flask Routes"""
         
@@ -378,41 +690,27 @@ class SensorHubApp:
         @self.app.route('/api/status')
         def api_status():
             """API: Aktueller Status"""
-            if not self.gps:
-                return jsonify({'error': 'GPS nicht initialisiert'}), 500
-            
-            status = self.gps.get_status()
-            return jsonify({
-                'gps': status,
-                'timestamp': time.time()
-            })
+            return self._cached_response('status')
         
         @self.app.route('/api/coordinates')
         def api_coordinates():
             """API: Koordinaten"""
-            if not self.gps:
-                return jsonify({'error': 'GPS nicht initialisiert'}), 500
-
-            status = self.gps.get_status()
-            return jsonify({
-                'latitude': status['latitude'],
-                'longitude': status['longitude'],
-                'bing_maps_url': self.gps.get_bing_maps_url()
-            })
+            return self._cached_response('coordinates')
         
         @self.app.route('/api/health')
         def api_health():
             """API: Health Check"""
-            return jsonify({
-                'status': 'ok',
-                'gps_connected': self.gps.running if self.gps else False,
-                'ntrip_connected': self.ntrip.is_connected() if self.ntrip else False,
-                'can_enabled': bool(self.can_bus),
-                'gps_port': self.resolved_gps_port,
-                'imu_enabled': config.IMU_ENABLED,
-                'imu_type': config.IMU_TYPE,
-                'timestamp': time.time()
-            })
+            return self._cached_response('health')
+
+        @self.app.route('/api/stream')
+        def api_stream():
+            """API: Server-Sent Events bei geänderten Antworten (?keys=status,imu_data)"""
+            keys = [key for key in request.args.get('keys', 'status').split(',') if self.status_cache.get(key)]
+            if not keys:
+                return jsonify({'error': 'Keine gültigen Keys'}), 400
+
+            return Response(self.status_cache.stream(keys), mimetype='text/event-stream',
+                            headers={'Cache-Control': 'no-cache', 'X-Accel-Buffering': 'no'})
 
         @self.app.route('/api/ntrip/status')
         def api_ntrip_status():
@@ -430,38 +728,18 @@ class SensorHubApp:
 
             return jsonify(self.bridge.get_status())
 
+        @self.app.route('/api/pose')
+        def api_pose():
+            """API: Fusionierte Pose (EKF) mit Kovarianz"""
+            if not self.pose:
+                return jsonify({'error': 'Pose-Schätzung nicht aktiviert'}), 503
+
+            return jsonify({**self.pose.get_pose(), 'status': self.pose.get_status()})
+
         @self.app.route('/api/imu/data')
         def api_imu_data():
             """API: IMU Sensor-Daten (Rohdaten + Orientierung)"""
-            if not self.imu or not self.imu.connected:
-                return jsonify({'error': 'IMU nicht verbunden'}), 503
-
-            imu_data = self.imu.get_data()
-            orientation = {'roll': 0.0, 'pitch': 0.0, 'yaw': 0.0, 'heading': 0.0,
-                          'is_stationary': False, 'gyro_bias': {'x': 0.0, 'y': 0.0, 'z': 0.0},
-                          'gps_weight': 0.0}
-            imu_status = self.imu.get_status() if hasattr(self.imu, 'get_status') else {}
-            driver_orientation = self._get_orientation()
-            if driver_orientation:
-                orientation = driver_orientation
-
-            return jsonify({
-                'accel': imu_data['accel'],
-                'gyro': imu_data['gyro'],
-                'mag': imu_data.get('mag'),
-                'temperature': imu_data['temperature'],
-                'roll': orientation['roll'],
-                'pitch': orientation['pitch'],
-                'yaw': orientation['yaw'],
-                'heading': orientation['heading'],
-                'is_calibrated': imu_data['is_calibrated'],
-                'is_stationary': orientation['is_stationary'],
-                'gyro_bias': orientation['gyro_bias'],
-                'gps_weight': orientation['gps_weight'],
-                'imu_type': imu_status.get('imu_type', config.IMU_TYPE),
-                'orientation_source': orientation.get('source', imu_status.get('orientation_source', 'unknown')),
-                'timestamp': imu_data['timestamp']
-            })
+            return self._cached_response('imu_data')
 
         @self.app.route('/api/imu/status')
         def api_imu_status():
@@ -480,6 +758,32 @@ class SensorHubApp:
 
             return jsonify(motion_status)
 
+        @self.app.route('/api/coverage')
+        def api_coverage():
+            """API: Abdeckungsraster (Geometrie, Fläche, Versionen der Kacheln mit Abdeckung)"""
+            if not self.coverage:
+                error = self.coverage_error or ('Noch kein Fix' if config.COVERAGE_ENABLED else
+                                                'Abdeckungsraster nicht aktiviert')
+                return jsonify({'error': error}), 503
+
+            return jsonify({**self.coverage.get_status(), 'tile_versions': self.coverage.tile_versions()})
+
+        @self.app.route('/api/coverage/tile/<int:tx>/<int:ty>.png')
+        def api_coverage_tile(tx, ty):
+            """API: Kachel als PNG (ETag = Epoche-Version, 304 wenn unverändert)"""
+            tile = self.coverage.tile_png(tx, ty) if self.coverage else None
+            if tile is None:
+                return jsonify({'error': 'Kachel nicht vorhanden'}), 404
+
+            etag, png = tile
+            if request.if_none_match.contains(etag):
+                response = Response(status=304)
+            else:
+                response = Response(png, mimetype='image/png')
+            response.set_etag(etag)
+            response.headers['Cache-Control'] = 'no-cache'
+            return response
+
     @staticmethod
     def _resolve_device_path(path_pattern: str) -> str:
         """Löst Wildcards für stabile /dev/serial/by-id-Pfade auf."""
@@ -506,6 +810,7 @@ class SensorHubApp:
     def shutdown(self):
         """Beendet die Anwendung"""
         self.running = False
+        self.status_cache.stop()
         if self.bridge:
             self.bridge.stop()
         if self.ntrip:
@@ -514,8 +819,14 @@ class SensorHubApp:
             self.imu.disconnect()
         if self.gps:
             self.gps.disconnect()
+        if self.io_reactor:
+            self.io_reactor.stop()
+        if self.can_tx:
+            self.can_tx.stop()
         if self.can_bus:
             self.can_bus.shutdown()
+        if self.coverage:
+            self.coverage.close()
         logger.info("✅ Sensor Hub beendet")
 
 
@@ -0,0 +1,44 @@
+"""Lock-freie Snapshots für den zuletzt gelesenen Sensorzustand.
+
+Genau ein Writer (der Reader-Thread des Sensors) baut pro Update ein neues
+Dictionary und veröffentlicht es zusammen mit einer Sequenznummer über eine
+einzige Referenzzuweisung. Leser erhalten dadurch immer einen konsistenten
+Stand, ohne ein Lock zu nehmen, und können anhand der Sequenznummer
+unveränderte Daten überspringen. Veröffentlichte Dictionaries gelten als
+unveränderlich und dürfen von Lesern nicht modifiziert werden.
+"""
+
+import time
+from typing import Any, Dict, NamedTuple
+
+
+class Snapshot(NamedTuple):
+    """Unveränderlicher Sensorzustand mit monotoner Sequenznummer."""
+
+    seq: int
+    timestamp: float
+    data: Dict[str, Any]
+
+
+class SnapshotCell:
+    """Single-Writer/Multi-Reader Zelle für den jeweils neuesten Snapshot."""
+
+    __slots__ = ('_snapshot',)
+
+    def __init__(self, initial: Dict[str, Any]):
+        self._snapshot = Snapshot(0, time.monotonic(), initial)
+
+    def publish(self, data: Dict[str, Any]) -> int:
+        """Veröffentlicht einen neuen Stand (nur vom Writer-Thread aufrufen)."""
+        seq = self._snapshot.seq + 1
+        # Eine Referenzzuweisung ist atomar: Leser sehen entweder den alten oder den neuen Snapshot
+        self._snapshot = Snapshot(seq, time.monotonic(), data)
+        return seq
+
+    def read(self) -> Snapshot:
+        """Liefert den neuesten Snapshot ohne zu blockieren."""
+        return self._snapshot
+
+    @property
+    def seq(self) -> int:
+        return self._snapshot.seq
@@ -0,0 +1,207 @@
+"""Paralleles Hochfahren mit Abhängigkeiten und Zeitmessung pro Stufe.
+
+Jede Stufe (GPS, IMU, CAN, NTRIP, ...) läuft in einem eigenen Thread, sobald
+ihre Abhängigkeiten erfolgreich fertig sind; unabhängige Geräte werden also
+gleichzeitig geöffnet statt nacheinander. run() wartet nur auf die
+Vordergrund-Stufen - Hintergrund-Stufen wie der erste NTRIP-Verbindungsaufbau
+laufen weiter, während die Anwendung schon arbeitet. Schlägt eine Stufe fehl,
+werden die von ihr abhängigen Stufen übersprungen.
+
+Der Motor Controller nutzt denselben Code als raspberry_pi/motor_controller/startup.py
+(getrennt verteilt, daher kein gemeinsamer Import). Änderungen dort nachziehen;
+die Tests in sensor_hub/tests/test_startup.py decken beide ab.
+"""
+
+import logging
+import threading
+import time
+from typing import Callable, Dict, Iterable, List, Optional
+
+logger = logging.getLogger(__name__)
+
+STATE_PENDING = 'pending'
+STATE_RUNNING = 'running'
+STATE_OK = 'ok'
+STATE_FAILED = 'failed'
+STATE_SKIPPED = 'skipped'
+
+_STATE_ICONS = {STATE_OK: '✅', STATE_FAILED: '❌', STATE_SKIPPED: '⏭️', STATE_RUNNING: '⏳', STATE_PENDING: '⏳'}
+
+
+class StartupStage:
+    """Eine Init-Stufe mit Zustand und Zeitmessung."""
+
+    def __init__(self, name: str, func: Callable[[], Optional[bool]], depends: List['StartupStage'],
+                 critical: bool, background: bool):
+        self.name = name
+        self.func = func
+        self.depends = depends
+        self.critical = critical
+        self.background = background
+        self.state = STATE_PENDING
+        self.error: Optional[str] = None
+        self.started: Optional[float] = None
+        self.finished: Optional[float] = None
+        self.done = threading.Event()
+
+    @property
+    def elapsed_ms(self) -> Optional[float]:
+        if self.started is None:
+            return None
+        end = self.finished if self.finished is not None else time.perf_counter()
+        return (end - self.started) * 1000.0
+
+    def to_dict(self, origin: float) -> dict:
+        elapsed = self.elapsed_ms
+        return {
+            'name': self.name,
+            'state': self.state,
+            'critical': self.critical,
+            'background': self.background,
+            'depends': [dep.name for dep in self.depends],
+            'start_ms': round((self.started - origin) * 1000.0, 1) if self.started is not None else None,
+            'elapsed_ms': round(elapsed, 1) if elapsed is not None else None,
+            'error': self.error,
+        }
+
+
+class StartupOrchestrator:
+    """Startet Init-Stufen nach Abhängigkeiten parallel (oder seriell in Reihenfolge von add())."""
+
+    def __init__(self, parallel: bool = True):
+        """
+        Args:
+            parallel: False = Stufen nacheinander im aufrufenden Thread (bisheriges Verhalten)
+        """
+        self.parallel = parallel
+        self._stages: Dict[str, StartupStage] = {}
+        self._origin: Optional[float] = None
+        self._foreground_ms: Optional[float] = None
+
+    def add(self, name: str, func: Callable[[], Optional[bool]], depends: Iterable[str] = (),
+            critical: bool = False, background: bool = False):
+        """Registriert eine Stufe.
+
+        Args:
+            name: Eindeutiger Name (erscheint in Log und Report)
+            func: Init-Funktion; False oder eine Exception gilt als Fehlschlag
+            depends: Namen bereits registrierter Stufen, die vorher erfolgreich sein müssen
+            critical: Fehlschlag lässt run() False liefern
+            background: run() wartet nicht auf diese Stufe
+        """
+        if name in self._stages:
+            raise ValueError(f"Startup-Stufe doppelt registriert: {name}")
+        missing = [dep for dep in depends if dep not in self._stages]
+        if missing:
+            raise ValueError(f"Startup-Stufe {name}: unbekannte Abhängigkeit {', '.join(missing)}")
+        self._stages[name] = StartupStage(name, func, [self._stages[dep] for dep in depends],
+                                          critical, background)
+
+    def run(self, timeout: Optional[float] = None) -> bool:
+        """Führt alle Stufen aus und wartet auf die Vordergrund-Stufen.
+
+        Args:
+            timeout: Maximale Wartezeit auf die Vordergrund-Stufen (None = unbegrenzt)
+
+        Returns:
+            True wenn keine kritische Stufe fehlgeschlagen, übersprungen oder zu spät ist
+        """
+        self._origin = time.perf_counter()
+        stages = list(self._stages.values())
+
+        if self.parallel:
+            for stage in stages:
+                threading.Thread(target=self._run_stage, args=(stage,),
+                                 name=f"startup-{stage.name}", daemon=True).start()
+            deadline = None if timeout is None else self._origin + timeout
+            for stage in stages:
+                if stage.background:
+                    continue
+                remaining = None if deadline is None else max(0.0, deadline - time.perf_counter())
+                if not stage.done.wait(remaining):
+                    logger.warning("⚠️  Startup-Stufe %s nach %.1f s nicht fertig - läuft im Hintergrund weiter",
+                                   stage.name, timeout)
+        else:
+            for stage in stages:
+                self._run_stage(stage)
+
+        self._foreground_ms = (time.perf_counter() - self._origin) * 1000.0
+        self._log_summary()
+
+        ok = True
+        for stage in stages:
+            if not stage.critical:
+                continue
+            if not stage.done.is_set():
+                if stage.background:
+                    continue
+                reason = 'Zeitüberschreitung'
+            elif stage.state == STATE_OK:
+                continue
+            else:
+                reason = stage.error or stage.state
+            logger.error("❌ Kritische Startup-Stufe %s: %s", stage.name, reason)
+            ok = False
+        return ok
+
+    def wait(self, timeout: Optional[float] = None) -> bool:
+        """Wartet zusätzlich auf die Hintergrund-Stufen (True = alle fertig)."""
+        deadline = None if timeout is None else time.perf_counter() + timeout
+        for stage in self._stages.values():
+            remaining = None if deadline is None else max(0.0, deadline - time.perf_counter())
+            if not stage.done.wait(remaining):
+                return False
+        return True
+
+    def failed(self) -> List[str]:
+        """Namen der fehlgeschlagenen oder übersprungenen Stufen."""
+        return [stage.name for stage in self._stages.values()
+                if stage.state in (STATE_FAILED, STATE_SKIPPED)]
+
+    def _run_stage(self, stage: StartupStage):
+        for dep in stage.depends:
+            dep.done.wait()
+            if dep.state != STATE_OK:
+                stage.state = STATE_SKIPPED
+                stage.error = f"Abhängigkeit {dep.name} nicht verfügbar"
+                stage.done.set()
+                return
+
+        stage.state = STATE_RUNNING
+        stage.started = time.perf_counter()
+        try:
+            result = stage.func()
+            stage.state = STATE_FAILED if result is False else STATE_OK
+        except Exception as e:
+            stage.state = STATE_FAILED
+            stage.error = str(e)
+            logger.error("❌ Startup-Stufe %s fehlgeschlagen: %s", stage.name, e, exc_info=stage.critical)
+        finally:
+            stage.finished = time.perf_counter()
+            stage.done.set()
+
+        if stage.background:
+            logger.info("⏱️  Startup-Stufe %s (Hintergrund): %s nach %.0f ms",
+                        stage.name, stage.state, stage.elapsed_ms)
+
+    def _log_summary(self):
+        parts = []
+        for stage in self._stages.values():
+            if stage.background and not stage.done.is_set():
+                parts.append(f"{stage.name} ⏳ (Hintergrund)")
+            elif stage.elapsed_ms is None:
+                parts.append(f"{stage.name} {_STATE_ICONS[stage.state]}")
+            else:
+                parts.append(f"{stage.name} {stage.elapsed_ms:.0f} ms {_STATE_ICONS[stage.state]}")
+        logger.info("⏱️  Startup %s nach %.0f ms: %s", 'parallel' if self.parallel else 'seriell',
+                    self._foreground_ms, ', '.join(parts))
+
+    def get_report(self) -> dict:
+        """Zeitmessung und Zustand aller Stufen (für Health-Endpunkte)."""
+        origin = self._origin if self._origin is not None else time.perf_counter()
+        return {
+            'parallel': self.parallel,
+            'foreground_ms': round(self._foreground_ms, 1) if self._foreground_ms is not None else None,
+            'complete': all(stage.done.is_set() for stage in self._stages.values()),
+            'stages': [stage.to_dict(origin) for stage in self._stages.values()],
+        }
@@ -0,0 +1,175 @@
+"""Vorberechnete, serialisierte API-Antworten für das Web-Interface.
+
+Ein Producer-Thread baut die JSON-Antworten nur dann neu, wenn sich die
+Sensor-Sequenznummern geändert haben (höchstens mit max_rate, spätestens nach
+refresh_interval), und legt sie als fertige Bytes mit Version und ETag ab.
+Flask-Handler liefern diese Bytes ohne Neuberechnung aus; Long-Poll- und
+SSE-Clients warten auf einer Condition, bis sich die Version ändert.
+"""
+
+import json
+import logging
+import threading
+import time
+from typing import Callable, Dict, Hashable, Iterator, NamedTuple, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+# Builder liefert (HTTP-Status, Payload-Dict)
+Builder = Callable[[], Tuple[int, Dict]]
+
+
+class CachedResponse(NamedTuple):
+    """Unveränderliche, serialisierte Antwort eines Endpunkts."""
+
+    version: int
+    status: int
+    body: bytes
+    etag: str
+    timestamp: float
+
+
+class StatusCache:
+    """Single-Producer-Cache für JSON-Antworten mit Versionierung und Änderungsbenachrichtigung."""
+
+    def __init__(self, sequence: Callable[[], Hashable], max_rate: float = 10.0, refresh_interval: float = 1.0):
+        """
+        Args:
+            sequence: Liefert einen Wert, der sich bei jedem Sensor-Update ändert (z.B. Snapshot-Sequenzen)
+            max_rate: Maximale Rebuild-Rate (Hz), begrenzt die Last bei 200-Hz-IMU
+            refresh_interval: Spätester Rebuild auch ohne Sensor-Update (Zähler, Verbindungsstatus)
+        """
+        self.sequence = sequence
+        self.min_interval = 1.0 / max_rate if max_rate > 0 else 0.0
+        self.refresh_interval = refresh_interval
+
+        self._builders: Dict[str, Builder] = {}
+        self._entries: Dict[str, CachedResponse] = {}
+        self._changed = threading.Condition()
+        self._running = False
+        self._thread: Optional[threading.Thread] = None
+        self._last_sequence = None
+        self._last_build = 0.0
+
+        self.builds = 0
+        self.build_errors = 0
+        self.last_build_ms = 0.0
+
+    def register(self, key: str, builder: Builder):
+        """Registriert einen Endpunkt; der erste Stand wird sofort gebaut."""
+        self._builders[key] = builder
+        self._rebuild_entry(key, builder, time.time())
+
+    def start(self):
+        if self._running:
+            return
+        self._running = True
+        self._thread = threading.Thread(target=self._producer_loop, daemon=True, name='status-cache')
+        self._thread.start()
+
+    def stop(self):
+        self._running = False
+        with self._changed:
+            self._changed.notify_all()
+        if self._thread:
+            self._thread.join(timeout=2.0)
+
+    def _producer_loop(self):
+        while self._running:
+            try:
+                self.refresh()
+            except Exception as e:
+                logger.error(f"❌ Status-Cache Fehler: {e}")
+            time.sleep(self.min_interval or 0.05)
+
+    def refresh(self, force: bool = False) -> bool:
+        """Baut alle Antworten neu, falls sich die Sensoren geändert haben; True bei Rebuild."""
+        now = time.time()
+        sequence = self.sequence()
+        if not force and sequence == self._last_sequence and now - self._last_build < self.refresh_interval:
+            return False
+
+        started = time.perf_counter()
+        self._last_sequence = sequence
+        self._last_build = now
+        changed = False
+        for key, builder in list(self._builders.items()):
+            changed |= self._rebuild_entry(key, builder, now)
+        self.builds += 1
+        self.last_build_ms = (time.perf_counter() - started) * 1000.0
+
+        if changed:
+            with self._changed:
+                self._changed.notify_all()
+        return changed
+
+    def _rebuild_entry(self, key: str, builder: Builder, now: float) -> bool:
+        try:
+            status, payload = builder()
+            body = json.dumps(payload, separators=(',', ':'), default=str).encode('utf-8')
+        except Exception as e:
+            self.build_errors += 1
+            logger.debug(f"⚠️  Status-Cache: '{key}' konnte nicht gebaut werden: {e}")
+            return False
+
+        previous = self._entries.get(key)
+        if previous is not None and previous.status == status and previous.body == body:
+            return False
+
+        version = previous.version + 1 if previous else 1
+        # Eine Referenzzuweisung pro Eintrag: Leser sehen immer eine vollständige Antwort
+        self._entries[key] = CachedResponse(version, status, body, f'{key}-{version}', now)
+        return True
+
+    def get(self, key: str) -> Optional[CachedResponse]:
+        """Aktuelle Antwort ohne Lock und ohne Neuberechnung."""
+        return self._entries.get(key)
+
+    def wait(self, key: str, since: int, timeout: float) -> Optional[CachedResponse]:
+        """Long-Poll: wartet bis die Version von key größer als since ist (oder Timeout)."""
+        deadline = time.monotonic() + timeout
+        with self._changed:
+            while self._running:
+                entry = self._entries.get(key)
+                if entry is not None and entry.version > since:
+                    return entry
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    break
+                self._changed.wait(remaining)
+        return self._entries.get(key)
+
+    def stream(self, keys, keepalive: float = 15.0) -> Iterator[bytes]:
+        """Server-Sent Events: ein Event pro geänderter Antwort, Kommentar als Keepalive."""
+        versions = {key: 0 for key in keys}
+        while self._running:
+            # Prüfen und Warten unter der Condition, damit kein notify verloren geht
+            with self._changed:
+                pending = self._pending(versions)
+                if not pending:
+                    self._changed.wait(keepalive)
+                    pending = self._pending(versions)
+            if not pending:
+                yield b': keepalive\n\n'
+                continue
+
+            for key, entry in pending:
+                versions[key] = entry.version
+                yield b'event: ' + key.encode() + b'\nid: ' + str(entry.version).encode() + \
+                    b'\ndata: ' + entry.body + b'\n\n'
+
+    def _pending(self, versions: Dict[str, int]):
+        pending = []
+        for key, version in versions.items():
+            entry = self._entries.get(key)
+            if entry is not None and entry.version > version:
+                pending.append((key, entry))
+        return pending
+
+    def get_status(self) -> Dict:
+        return {
+            'endpoints': {key: entry.version for key, entry in self._entries.items()},
+            'builds': self.builds,
+            'build_errors': self.build_errors,
+            'last_build_ms': round(self.last_build_ms, 2),
+        }
@@ -1,9 +1,58 @@
 """Hilfsfunktionen für kompakte Sensor-Hub Telemetrie- und Status-Payloads."""
 
 import json
+import math
+import struct
 import time
 from typing import Any, Dict, Optional
 
+# Binäres Telemetrie-Frame (Little Endian, 24 Bytes = 4 klassische CAN-Frames):
+#   B  Header (Version << 4 | Nachrichtentyp)
+#   B  Flags (Bit 0-2 RTK/Fix-Qualität, Bit 3 GPS, Bit 4 IMU, Bit 5 IMU kalibriert)
+#   I  Zeitstempel in ms (modulo 2^32)
+#   i  Breitengrad in 1e-7°
+#   i  Längengrad in 1e-7°
+#   h  Höhe in 0.1 m
+#   H  Heading (Top-Level, IMU vor GPS) in 0.01° (0-360)
+#   h  Roll in 0.01°
+#   h  Pitch in 0.01°
+#   H  Yaw in 0.01° (0-360)
+TELEMETRY_FRAME_VERSION = 1
+TELEMETRY_MSG_POSE = 0x1
+TELEMETRY_FRAME_FORMAT = struct.Struct('<BBIiihHhhH')
+TELEMETRY_FRAME_SIZE = TELEMETRY_FRAME_FORMAT.size
+
+# Fusionierte EKF-Pose (gleiche ID, direkt vor dem Sensor-Frame gesendet, 24 Bytes):
+#   B  Header (Version << 4 | TELEMETRY_MSG_FUSED_POSE)
+#   B  Flags (reserviert)
+#   I  Zeitstempel der Pose in ms (modulo 2^32)
+#   i  Breitengrad in 1e-7°
+#   i  Längengrad in 1e-7°
+#   H  Heading in 0.01° (0-360)
+#   h  Geschwindigkeit Ost in mm/s
+#   h  Geschwindigkeit Nord in mm/s
+#   H  Positions-Standardabweichung in mm
+#   B  Heading-Standardabweichung in 0.1°
+#   B  Alter der Pose beim Senden in ms (max. 255)
+TELEMETRY_MSG_FUSED_POSE = 0x2
+FUSED_POSE_FRAME_FORMAT = struct.Struct('<BBIiiHhhHBB')
+FUSED_POSE_FRAME_SIZE = FUSED_POSE_FRAME_FORMAT.size
+
+FLAG_RTK_MASK = 0x07
+FLAG_HAS_GPS = 0x08
+FLAG_HAS_IMU = 0x10
+FLAG_IMU_CALIBRATED = 0x20
+
+# RTK-Status als NMEA Fix-Qualität (passt in 3 Bit)
+RTK_STATUS_CODES = {
+    'NO GPS': 0,
+    'GPS FIX': 1,
+    'DGPS': 2,
+    'RTK FIXED': 4,
+    'RTK FLOAT': 5,
+}
+RTK_STATUS_NAMES = {code: name for name, code in RTK_STATUS_CODES.items()}
+
 
 def round_if_number(value: Any, digits: int) -> Any:
     """Rundet numerische Werte, lässt andere Typen unverändert."""
@@ -18,6 +67,7 @@ def build_telemetry_payload(
     gps_status: Optional[Dict[str, Any]] = None,
     orientation: Optional[Dict[str, Any]] = None,
     imu_data: Optional[Dict[str, Any]] = None,
+    pose: Optional[Dict[str, Any]] = None,
     *,
     timestamp: Optional[float] = None,
 ) -> Dict[str, Any]:
@@ -45,9 +95,105 @@ def build_telemetry_payload(
         }
         payload['heading'] = round_if_number(orientation.get('heading', payload.get('heading', 0.0)), 2)
 
+    # Fusionierte Pose nur im JSON-Format; das binäre Frame bleibt unverändert
+    if pose and pose.get('initialized'):
+        payload['pose'] = {
+            'east': round_if_number(pose['east'], 3),
+            'north': round_if_number(pose['north'], 3),
+            'lat': round_if_number(pose.get('latitude'), 8),
+            'lon': round_if_number(pose.get('longitude'), 8),
+            'vel_east': round_if_number(pose['vel_east'], 3),
+            'vel_north': round_if_number(pose['vel_north'], 3),
+            'heading': round_if_number(pose['heading'], 2),
+            'std_position': round_if_number(pose['std_position'], 3),
+            'std_heading': round_if_number(pose['std_heading'], 2),
+            'age': round_if_number(max(0.0, payload['timestamp'] - pose.get('timestamp', payload['timestamp'])), 3),
+        }
+
     return payload
 
 
+def build_diagnostics_payload(
+    gps_status: Optional[Dict[str, Any]] = None,
+    imu_connected: bool = False,
+    ntrip_connected: Optional[bool] = None,
+    pose: Optional[Dict[str, Any]] = None,
+    send_errors: int = 0,
+    *,
+    timestamp: Optional[float] = None,
+) -> Dict[str, Any]:
+    """Erstellt die langsame Diagnose-Payload (nur Werte, die sich im Stillstand kaum ändern)."""
+    diag: Dict[str, Any] = {
+        'gps': bool(gps_status and gps_status.get('is_connected')),
+        'satellites': (gps_status or {}).get('satellites', 0),
+        'imu': imu_connected,
+        'ntrip': ntrip_connected,
+        'send_errors': send_errors,
+    }
+    if pose and pose.get('initialized'):
+        diag['std_position'] = round_if_number(pose['std_position'], 2)
+    return {
+        'timestamp': round_if_number(time.time() if timestamp is None else timestamp, 3),
+        'diag': diag,
+    }
+
+
+# Meter pro Grad Breite (WGS84-Mittelwert), genügt für Totband-Vergleiche
+_METERS_PER_DEGREE = 111320.0
+
+
+def _angle_delta(a: Any, b: Any) -> float:
+    """Betrag der Winkeldifferenz in Grad (mit Umlauf bei 360°)."""
+    try:
+        delta = abs(float(a) - float(b)) % 360.0
+    except (TypeError, ValueError):
+        return 0.0
+    return min(delta, 360.0 - delta)
+
+
+def telemetry_exceeds_deadband(previous: Dict[str, Any], current: Dict[str, Any],
+                               position_deadband: float, angle_deadband: float) -> bool:
+    """Vergleicht zwei Payloads aus build_telemetry_payload gegen Positions- und Winkel-Totband.
+
+    RTK-Status, Kalibrierung und das Auftauchen/Verschwinden von GPS, IMU oder Pose
+    zählen immer als Änderung.
+    """
+    if previous.get('rtk_status') != current.get('rtk_status'):
+        return True
+    for key in ('gps', 'imu', 'pose'):
+        if (key in previous) != (key in current):
+            return True
+
+    gps_prev, gps_cur = previous.get('gps'), current.get('gps')
+    if gps_prev and gps_cur:
+        d_north = (gps_cur['lat'] - gps_prev['lat']) * _METERS_PER_DEGREE
+        d_east = (gps_cur['lon'] - gps_prev['lon']) * _METERS_PER_DEGREE * math.cos(math.radians(gps_cur['lat']))
+        if math.hypot(d_north, d_east) > position_deadband:
+            return True
+        if abs(gps_cur['altitude'] - gps_prev['altitude']) > max(position_deadband, 0.1):
+            return True
+
+    if _angle_delta(previous.get('heading', 0.0), current.get('heading', 0.0)) > angle_deadband:
+        return True
+
+    imu_prev, imu_cur = previous.get('imu'), current.get('imu')
+    if imu_prev and imu_cur:
+        if imu_prev.get('is_calibrated') != imu_cur.get('is_calibrated'):
+            return True
+        for key in ('roll', 'pitch', 'yaw'):
+            if _angle_delta(imu_prev.get(key, 0.0), imu_cur.get(key, 0.0)) > angle_deadband:
+                return True
+
+    pose_prev, pose_cur = previous.get('pose'), current.get('pose')
+    if pose_prev and pose_cur:
+        if math.hypot(pose_cur['east'] - pose_prev['east'], pose_cur['north'] - pose_prev['north']) > position_deadband:
+            return True
+        if _angle_delta(pose_prev['heading'], pose_cur['heading']) > angle_deadband:
+            return True
+
+    return False
+
+
 def build_status_payload(telemetry: Dict[str, Any], meta: Dict[str, Any]) -> Dict[str, Any]:
     """Erweitert Telemetrie um Status-Metadaten für On-Demand-Abfragen."""
     payload = dict(telemetry)
@@ -57,4 +203,147 @@ def build_status_payload(telemetry: Dict[str, Any], meta: Dict[str, Any]) -> Dic
 
 def serialize_can_payload(payload: Dict[str, Any]) -> str:
     """Serialisiert eine Payload kompakt für den CAN-Transport."""
-    return json.dumps(payload, separators=(',', ':'))
\ No newline at end of file
+    return json.dumps(payload, separators=(',', ':'))
+
+
+def _scaled(value: Any, scale: float, low: int, high: int) -> int:
+    """Skaliert einen Messwert auf Ganzzahl und begrenzt ihn auf den Feldbereich."""
+    try:
+        scaled = int(round(float(value) * scale))
+    except (TypeError, ValueError):
+        return 0
+    return max(low, min(high, scaled))
+
+
+def _scaled_angle(value: Any) -> int:
+    """Skaliert einen Winkel 0-360° auf 0.01°-Schritte."""
+    try:
+        angle = float(value) % 360.0
+    except (TypeError, ValueError):
+        return 0
+    return int(round(angle * 100.0)) % 36000
+
+
+def pack_telemetry_frame(payload: Dict[str, Any]) -> bytes:
+    """Packt eine Telemetrie-Payload aus build_telemetry_payload in das binäre Frame-Format."""
+    gps = payload.get('gps')
+    imu = payload.get('imu')
+
+    flags = RTK_STATUS_CODES.get(payload.get('rtk_status', 'NO GPS'), 0) & FLAG_RTK_MASK
+    if gps:
+        flags |= FLAG_HAS_GPS
+    if imu:
+        flags |= FLAG_HAS_IMU
+        if imu.get('is_calibrated'):
+            flags |= FLAG_IMU_CALIBRATED
+
+    gps = gps or {}
+    imu = imu or {}
+
+    timestamp = payload.get('timestamp', time.time())
+    return TELEMETRY_FRAME_FORMAT.pack(
+        (TELEMETRY_FRAME_VERSION << 4) | TELEMETRY_MSG_POSE,
+        flags,
+        int(round(timestamp * 1000.0)) & 0xFFFFFFFF,
+        _scaled(gps.get('lat', 0.0), 1e7, -0x80000000, 0x7FFFFFFF),
+        _scaled(gps.get('lon', 0.0), 1e7, -0x80000000, 0x7FFFFFFF),
+        _scaled(gps.get('altitude', 0.0), 10.0, -0x8000, 0x7FFF),
+        _scaled_angle(payload.get('heading', 0.0)),
+        _scaled(imu.get('roll', 0.0), 100.0, -0x8000, 0x7FFF),
+        _scaled(imu.get('pitch', 0.0), 100.0, -0x8000, 0x7FFF),
+        _scaled_angle(imu.get('yaw', 0.0)),
+    )
+
+
+def pack_fused_pose_frame(payload: Dict[str, Any]) -> Optional[bytes]:
+    """Packt die fusionierte Pose einer Payload aus build_telemetry_payload (None ohne Pose mit lat/lon)."""
+    pose = payload.get('pose')
+    if not pose or pose.get('lat') is None or pose.get('lon') is None:
+        return None
+
+    timestamp = payload.get('timestamp', time.time())
+    age = pose.get('age') or 0.0
+    return FUSED_POSE_FRAME_FORMAT.pack(
+        (TELEMETRY_FRAME_VERSION << 4) | TELEMETRY_MSG_FUSED_POSE,
+        0,
+        int(round((timestamp - age) * 1000.0)) & 0xFFFFFFFF,
+        _scaled(pose['lat'], 1e7, -0x80000000, 0x7FFFFFFF),
+        _scaled(pose['lon'], 1e7, -0x80000000, 0x7FFFFFFF),
+        _scaled_angle(pose.get('heading', 0.0)),
+        _scaled(pose.get('vel_east', 0.0), 1000.0, -0x8000, 0x7FFF),
+        _scaled(pose.get('vel_north', 0.0), 1000.0, -0x8000, 0x7FFF),
+        _scaled(pose.get('std_position', 0.0), 1000.0, 0, 0xFFFF),
+        _scaled(pose.get('std_heading', 0.0), 10.0, 0, 0xFF),
+        _scaled(age, 1000.0, 0, 0xFF),
+    )
+
+
+def _unwrap_timestamp(timestamp_ms: int, now: Optional[float]) -> float:
+    """32-Bit-Millisekunden gegen die lokale Uhr rekonstruieren (laufen nach ~49 Tagen über)."""
+    now_ms = int((time.time() if now is None else now) * 1000.0)
+    delta = (timestamp_ms - now_ms) & 0xFFFFFFFF
+    if delta >= 0x80000000:
+        delta -= 0x100000000
+    return round((now_ms + delta) / 1000.0, 3)
+
+
+def telemetry_message_type(data: bytes) -> Optional[int]:
+    """Nachrichtentyp eines binären Telemetrie-Frames (None bei fremder Version)."""
+    if not data or data[0] >> 4 != TELEMETRY_FRAME_VERSION:
+        return None
+    return data[0] & 0x0F
+
+
+def unpack_fused_pose_frame(data: bytes, *, now: Optional[float] = None) -> Optional[Dict[str, Any]]:
+    """Entpackt ein Pose-Frame in die Dict-Form von payload['pose'] (lat/lon statt east/north)."""
+    if len(data) < FUSED_POSE_FRAME_SIZE or telemetry_message_type(data) != TELEMETRY_MSG_FUSED_POSE:
+        return None
+
+    (_, _, timestamp_ms, lat, lon, heading, vel_east, vel_north,
+     std_position, std_heading, age_ms) = FUSED_POSE_FRAME_FORMAT.unpack_from(data)
+    return {
+        'timestamp': _unwrap_timestamp(timestamp_ms, now),
+        'lat': lat / 1e7,
+        'lon': lon / 1e7,
+        'heading': heading / 100.0,
+        'vel_east': vel_east / 1000.0,
+        'vel_north': vel_north / 1000.0,
+        'std_position': std_position / 1000.0,
+        'std_heading': std_heading / 10.0,
+        'age': age_ms / 1000.0,
+    }
+
+
+def unpack_telemetry_frame(data: bytes, *, now: Optional[float] = None) -> Optional[Dict[str, Any]]:
+    """Entpackt ein binäres Telemetrie-Frame in die Dict-Form von build_telemetry_payload."""
+    if len(data) < TELEMETRY_FRAME_SIZE:
+        return None
+
+    (header, flags, timestamp_ms, lat, lon, altitude,
+     heading, roll, pitch, yaw) = TELEMETRY_FRAME_FORMAT.unpack_from(data)
+    if header >> 4 != TELEMETRY_FRAME_VERSION or header & 0x0F != TELEMETRY_MSG_POSE:
+        return None
+
+    payload: Dict[str, Any] = {'timestamp': _unwrap_timestamp(timestamp_ms, now)}
+
+    if flags & FLAG_HAS_GPS:
+        payload['gps'] = {
+            'lat': round(lat / 1e7, 7),
+            'lon': round(lon / 1e7, 7),
+            'altitude': round(altitude / 10.0, 2),
+        }
+        payload['rtk_status'] = RTK_STATUS_NAMES.get(flags & FLAG_RTK_MASK, 'NO GPS')
+
+    if flags & FLAG_HAS_IMU:
+        payload['imu'] = {
+            'roll': roll / 100.0,
+            'pitch': pitch / 100.0,
+            'yaw': yaw / 100.0,
+            'heading': yaw / 100.0,
+            'is_calibrated': bool(flags & FLAG_IMU_CALIBRATED),
+        }
+
+    if flags & (FLAG_HAS_GPS | FLAG_HAS_IMU):
+        payload['heading'] = heading / 100.0
+
+    return payload
\ No newline at end of file
@@ -0,0 +1,162 @@
+"""Ereignisgesteuerte CAN-Telemetrie mit eigener Rate und Totband pro Feldgruppe.
+
+Statt die komplette Payload mit fester Rate zu senden, entscheidet der Scheduler
+pro Gruppe (Pose, Diagnose, ...), ob sich das Senden lohnt:
+
+- geändert (über dem Totband) und min_interval abgelaufen -> senden
+- unverändert, aber heartbeat abgelaufen -> senden (Lebenszeichen)
+- trigger() (z.B. RTK-Statuswechsel) -> beim nächsten poll() senden
+
+Verglichen wird immer mit der zuletzt *gesendeten* Probe, langsames Driften
+unterhalb des Totbands summiert sich also auf und wird irgendwann gesendet.
+"""
+
+import logging
+import time
+from typing import Any, Callable, Dict, Hashable, List, Optional
+
+logger = logging.getLogger(__name__)
+
+REASON_CHANGE = 'change'
+REASON_HEARTBEAT = 'heartbeat'
+REASON_TRIGGER = 'trigger'
+
+
+class TelemetryGroup:
+    """Feldgruppe mit Builder, Sender und eigener Rate."""
+
+    def __init__(self, name: str, build: Callable[[], Any], send: Callable[[Any], bool],
+                 min_interval: float, heartbeat: float = 0.0,
+                 changed: Optional[Callable[[Any, Any], bool]] = None,
+                 sequence: Optional[Callable[[], Hashable]] = None):
+        """
+        Args:
+            name: Name für Status/Statistik
+            build: Erzeugt die aktuelle Probe (z.B. Payload-Dict)
+            send: Sendet eine Probe, True bei Erfolg
+            min_interval: Kleinster Abstand zweier Sendungen (1 / maximale Rate)
+            heartbeat: Spätestes Senden auch ohne Änderung (0 = nie)
+            changed: (zuletzt gesendet, aktuell) -> True wenn über dem Totband (Default: !=)
+            sequence: Ändert sich mit den Quelldaten; gleiche Sequenz spart build() und Vergleich
+        """
+        self.name = name
+        self.build = build
+        self.send = send
+        self.min_interval = min_interval
+        self.heartbeat = heartbeat
+        self.changed = changed or (lambda previous, current: previous != current)
+        self.sequence = sequence
+
+        self.triggered = False
+        self.last_sent = float('-inf')
+        self.last_checked = float('-inf')
+        self.last_sample: Any = None
+        self.last_sequence: Any = None
+
+        self.sent = {REASON_CHANGE: 0, REASON_HEARTBEAT: 0, REASON_TRIGGER: 0}
+        self.suppressed = 0
+        self.send_failures = 0
+
+    def poll(self, now: float) -> float:
+        """Sendet bei Bedarf; gibt die Zeit bis zur nächsten sinnvollen Prüfung zurück."""
+        elapsed = now - self.last_sent
+        if elapsed < self.min_interval:
+            return self.min_interval - elapsed
+
+        heartbeat_due = self.heartbeat > 0 and elapsed >= self.heartbeat and self.last_sample is not None
+        if self.triggered:
+            # Vor build() zurücksetzen, damit ein Trigger während des Sendens nicht verloren geht
+            self.triggered = False
+            reason = REASON_TRIGGER
+        elif heartbeat_due:
+            reason = REASON_HEARTBEAT
+        else:
+            reason = None
+            # Höchstens ein Vergleich pro min_interval (schneller kann ohnehin nicht gesendet werden)
+            since_check = now - self.last_checked
+            if since_check < self.min_interval:
+                return self.min_interval - since_check
+            if self.sequence is not None:
+                sequence = self.sequence()
+                if sequence == self.last_sequence:
+                    return self._idle_wait(elapsed)
+                self.last_sequence = sequence
+
+        sample = self.build()
+        self.last_checked = now
+        if reason is None:
+            if self.last_sample is not None and not self.changed(self.last_sample, sample):
+                self.suppressed += 1
+                return self._idle_wait(elapsed)
+            reason = REASON_CHANGE
+
+        if not self.send(sample):
+            self.send_failures += 1
+            self.last_sequence = None  # beim nächsten poll() erneut versuchen
+            return self.min_interval
+        self.last_sent = now
+        self.last_sample = sample
+        self.sent[reason] += 1
+        return self.min_interval
+
+    def _idle_wait(self, elapsed: float) -> float:
+        # Änderungen kommen ohne Benachrichtigung: im Takt der Maximalrate weiter prüfen
+        if self.heartbeat > 0:
+            return min(self.min_interval, self.heartbeat - elapsed)
+        return self.min_interval
+
+    def get_status(self) -> Dict[str, Any]:
+        return {
+            'rate_max': round(1.0 / self.min_interval, 2) if self.min_interval > 0 else None,
+            'heartbeat': self.heartbeat or None,
+            'sent': dict(self.sent),
+            'suppressed': self.suppressed,
+            'send_failures': self.send_failures,
+        }
+
+
+class TelemetryScheduler:
+    """Fragt alle Gruppen aus einem Sender-Thread ab (poll() liefert die Wartezeit)."""
+
+    def __init__(self, min_wait: float = 0.001):
+        """
+        Args:
+            min_wait: Untergrenze der zurückgegebenen Wartezeit (verhindert Busy-Loops)
+        """
+        self.min_wait = min_wait
+        self._groups: List[TelemetryGroup] = []
+        self._by_name: Dict[str, TelemetryGroup] = {}
+        self.polls = 0
+
+    def add(self, group: TelemetryGroup) -> TelemetryGroup:
+        """Registriert eine Gruppe (vor dem Start des Sender-Threads)."""
+        self._groups.append(group)
+        self._by_name[group.name] = group
+        return group
+
+    def trigger(self, name: str):
+        """Erzwingt das Senden einer Gruppe beim nächsten poll() (thread-sicher)."""
+        group = self._by_name.get(name)
+        if group is not None:
+            group.triggered = True
+
+    def poll(self, now: Optional[float] = None) -> float:
+        """Sendet fällige Gruppen und gibt die Wartezeit bis zum nächsten poll() zurück."""
+        now = time.monotonic() if now is None else now
+        self.polls += 1
+        wait = float('inf')
+        for group in self._groups:
+            try:
+                wait = min(wait, group.poll(now))
+            except Exception as e:
+                logger.error("❌ Telemetrie-Gruppe %s: %s", group.name, e)
+                wait = min(wait, group.min_interval)
+        if wait == float('inf'):
+            wait = 0.1
+        return max(self.min_wait, wait)
+
+    def get_status(self) -> Dict[str, Any]:
+        return {
+            'polls': self.polls,
+            'groups': {group.name: group.get_status() for group in self._groups},
+        }
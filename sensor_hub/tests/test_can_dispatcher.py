@@ -0,0 +1,57 @@
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from can_dispatcher import MODE_JSON, MODE_RAW, CANDispatcher, parse_filter_spec
+from can_protocol import CANProtocol
+
+
+class CANDispatcherTests(unittest.TestCase):
+    def test_interleaved_ids_reassemble_in_separate_contexts(self):
+        dispatcher = CANDispatcher()
+        received = []
+        dispatcher.register(0x200, lambda can_id, text: received.append((can_id, text)), mode=MODE_JSON)
+        dispatcher.register(0x201, lambda can_id, text: received.append((can_id, text)), mode=MODE_JSON)
+
+        encoder = CANProtocol()
+        frames_a = encoder.encode_frames(b'{"cmd":"status_request"}')
+        frames_b = encoder.encode_frames(b'{"cmd":"restart"}')
+        for frame_a, frame_b in zip(frames_a, frames_b):
+            dispatcher.dispatch(0x200, frame_a)
+            dispatcher.dispatch(0x201, frame_b)
+        for frame_a in frames_a[len(frames_b):]:
+            dispatcher.dispatch(0x200, frame_a)
+
+        self.assertEqual(sorted(received), [(0x200, '{"cmd":"status_request"}'), (0x201, '{"cmd":"restart"}')])
+
+    def test_masked_route_and_unrouted_frames(self):
+        dispatcher = CANDispatcher()
+        raw = []
+        dispatcher.register(0x180, lambda can_id, data: raw.append(can_id), mode=MODE_RAW, mask=0x7F0, name='esc')
+
+        dispatcher.dispatch(0x183, b'\x01\x02')
+        dispatcher.dispatch(0x18F, b'\x03')
+        dispatcher.dispatch(0x190, b'\x04')
+
+        self.assertEqual(raw, [0x183, 0x18F])
+        status = dispatcher.get_status()
+        self.assertEqual(status['routes']['esc']['frames'], 2)
+        self.assertEqual(status['unrouted_frames'], 1)
+
+    def test_filters_cover_routes_and_extra_spec(self):
+        dispatcher = CANDispatcher()
+        dispatcher.register(0x200, lambda *_: None, mode=MODE_JSON)
+
+        filters = dispatcher.filters(parse_filter_spec('0x180:0x7F0, 0x18FF50E5'))
+
+        self.assertEqual(filters, [
+            {'can_id': 0x200, 'can_mask': 0x7FF, 'extended': False},
+            {'can_id': 0x180, 'can_mask': 0x7F0, 'extended': False},
+            {'can_id': 0x18FF50E5, 'can_mask': 0x1FFFFFFF, 'extended': True},
+        ])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,10 +1,11 @@
 import sys
+import time
 import unittest
 from pathlib import Path
 
 sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
 
-from can_protocol import CANProtocol
+from can_protocol import FD_FRAME_LENGTHS, CANProtocol, fd_frame_length
 
 
 class CANProtocolTests(unittest.TestCase):
@@ -21,6 +22,88 @@ class CANProtocolTests(unittest.TestCase):
 
         self.assertEqual(result, '{"cmd":"restart"}')
 
+    def test_encode_frames_round_trips_binary_payload_with_trailing_zeros(self):
+        protocol = CANProtocol()
+        payload = bytes(range(1, 19)) + b'\x00' * 6
+
+        frames = protocol.encode_frames(payload)
+        result = None
+        for frame in frames:
+            self.assertEqual(len(frame), 8)
+            result = protocol.decode_message(0x101, frame)
+
+        self.assertEqual(len(frames), 4)
+        self.assertEqual(result, payload)
+
+    def test_incomplete_message_is_evicted_after_timeout(self):
+        protocol = CANProtocol(frame_timeout=0.01)
+        frames = protocol.encode_frames(b'{"cmd":"status_request"}')
+
+        self.assertIsNone(protocol.decode_frame(0x200, frames[0]))
+        time.sleep(0.02)
+        protocol.cleanup_old_buffers()
+
+        for frame in frames[1:]:
+            self.assertIsNone(protocol.decode_frame(0x200, frame))
+
+    def test_frames_without_start_frame_are_ignored(self):
+        protocol = CANProtocol()
+        frames = protocol.encode_frames(b'{"cmd":"restart"}')
+
+        self.assertIsNone(protocol.decode_frame(0x200, frames[-1]))
+        self.assertEqual(protocol.decode_frame(0x200, frames[0]), None)
+        for frame in frames[1:-1]:
+            protocol.decode_frame(0x200, frame)
+        self.assertEqual(protocol.decode_frame(0x200, frames[-1]), '{"cmd":"restart"}')
+
+    def test_fd_frames_carry_62_bytes_and_pad_last_frame_to_valid_length(self):
+        protocol = CANProtocol(max_frame_size=62, fd=True)
+        payload = bytes(range(200))
+
+        frames = protocol.encode_frames(payload)
+        self.assertEqual([len(frame) for frame in frames], [64, 64, 64, 16])
+        self.assertTrue(all(len(frame) in FD_FRAME_LENGTHS for frame in frames))
+
+        result = None
+        for frame in frames:
+            result = protocol.decode_message(0x101, frame)
+        self.assertEqual(bytes(result[:len(payload)]), payload)
+
+    def test_fd_telemetry_frame_fits_into_single_frame(self):
+        classic = CANProtocol()
+        fd = CANProtocol(max_frame_size=62, fd=True)
+        payload = bytes(range(1, 25))
+
+        self.assertEqual(len(classic.encode_frames(payload)), 4)
+        frames = fd.encode_frames(payload)
+        self.assertEqual(len(frames), 1)
+        self.assertEqual(len(frames[0]), 32)
+        self.assertEqual(bytes(fd.decode_message(0x101, frames[0])[:24]), payload)
+
+    def test_fd_receiver_accepts_classic_frames(self):
+        classic = CANProtocol()
+        receiver = CANProtocol(max_frame_size=62, fd=True)
+        payload = b'{"cmd":"status_request","id":42}'
+
+        result = None
+        for frame in classic.encode_frames(payload):
+            result = receiver.decode_frame(0x200, frame)
+        self.assertEqual(result, payload.decode())
+
+    def test_fd_frame_size_is_rounded_to_valid_length(self):
+        protocol = CANProtocol(max_frame_size=40, fd=True)
+
+        self.assertEqual(protocol.max_frame_size, 46)
+        self.assertEqual(fd_frame_length(9), 12)
+        self.assertEqual(fd_frame_length(64), 64)
+        self.assertEqual(fd_frame_length(100), 64)
+
+    def test_message_exceeding_frame_counter_is_rejected(self):
+        protocol = CANProtocol()
+
+        self.assertEqual(protocol.encode_frames(b'x' * (6 * 255 + 1)), [])
+        self.assertEqual(len(protocol.encode_frames(b'x' * (6 * 255))), 255)
+
 
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
@@ -0,0 +1,94 @@
+import errno
+import sys
+import threading
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from can_transmitter import PRIORITY_COMMAND, PRIORITY_DIAGNOSTICS, PRIORITY_TELEMETRY, CANTransmitter
+
+
+class FakeBus:
+    def __init__(self, full_for=0):
+        self.sent = []
+        self.full_for = full_for
+
+    def send(self, msg, timeout=None):
+        if self.full_for:
+            self.full_for -= 1
+            raise OSError(errno.ENOBUFS, 'No buffer space available')
+        self.sent.append(msg)
+
+
+class CountingBus(FakeBus):
+    def __init__(self, expected):
+        super().__init__()
+        self.expected = expected
+        self.done = threading.Event()
+
+    def send(self, msg, timeout=None):
+        super().send(msg, timeout)
+        if len(self.sent) >= self.expected:
+            self.done.set()
+
+
+def make_transmitter(bus, **kwargs):
+    return CANTransmitter(bus, message_factory=lambda arb_id, data: (arb_id, data), **kwargs)
+
+
+class CANTransmitterTests(unittest.TestCase):
+    def test_commands_are_sent_before_pending_telemetry(self):
+        bus = CountingBus(expected=3)
+        tx = make_transmitter(bus)
+
+        tx.submit(0x101, [b'tele-old'], PRIORITY_TELEMETRY)
+        tx.submit(0x101, [b'tele-new'], PRIORITY_TELEMETRY)
+        tx.submit(0x100, [b'reply-0', b'reply-1'], PRIORITY_COMMAND)
+        tx.start()
+        try:
+            self.assertTrue(bus.done.wait(1.0))
+        finally:
+            tx.stop()
+
+        self.assertEqual(bus.sent, [(0x100, b'reply-0'), (0x100, b'reply-1'), (0x101, b'tele-new')])
+        self.assertEqual(tx.telemetry_replaced, 1)
+        self.assertEqual(tx.messages_sent, 2)
+
+    def test_diagnostics_wait_behind_telemetry_and_do_not_replace_it(self):
+        bus = CountingBus(expected=3)
+        tx = make_transmitter(bus)
+
+        tx.submit(0x100, [b'diag-old'], PRIORITY_DIAGNOSTICS)
+        tx.submit(0x100, [b'diag-new'], PRIORITY_DIAGNOSTICS)
+        tx.submit(0x101, [b'tele'], PRIORITY_TELEMETRY)
+        tx.submit(0x100, [b'reply'], PRIORITY_COMMAND)
+        tx.start()
+        try:
+            self.assertTrue(bus.done.wait(1.0))
+        finally:
+            tx.stop()
+
+        self.assertEqual(bus.sent, [(0x100, b'reply'), (0x101, b'tele'), (0x100, b'diag-new')])
+        self.assertEqual(tx.diagnostics_replaced, 1)
+        self.assertEqual(tx.telemetry_replaced, 0)
+
+    def test_full_tx_queue_is_retried_instead_of_failing(self):
+        bus = FakeBus(full_for=3)
+        tx = make_transmitter(bus)
+
+        self.assertTrue(tx.send_now(0x101, [b'a', b'b']))
+        self.assertEqual(len(bus.sent), 2)
+        self.assertEqual(tx.backpressure_waits, 3)
+        self.assertEqual(tx.send_errors, 0)
+
+    def test_persistent_backpressure_fails_after_send_timeout(self):
+        bus = FakeBus(full_for=10_000)
+        tx = make_transmitter(bus, send_timeout=0.005)
+
+        self.assertFalse(tx.send_now(0x101, [b'a']))
+        self.assertEqual(tx.send_errors, 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
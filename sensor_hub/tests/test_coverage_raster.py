@@ -0,0 +1,162 @@
+import os
+import struct
+import sys
+import tempfile
+import unittest
+import zlib
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from coverage_raster import CoverageRaster, blade_position, local_offset
+
+
+def decode_png(data):
+    """Minimaler Decoder für die Paletten-PNGs des Rasters -> (Breite, Zeilen)"""
+    assert data[:8] == b'\x89PNG\r\n\x1a\n'
+    offset = 8
+    width = height = 0
+    idat = b''
+    while offset < len(data):
+        length, kind = struct.unpack('>I4s', data[offset:offset + 8])
+        chunk = data[offset + 8:offset + 8 + length]
+        if kind == b'IHDR':
+            width, height = struct.unpack('>II', chunk[:8])
+        elif kind == b'IDAT':
+            idat += chunk
+        offset += 12 + length
+    raw = zlib.decompress(idat)
+    stride = width + 1
+    rows = [raw[k * stride + 1:(k + 1) * stride] for k in range(height)]
+    assert all(raw[k * stride] == 0 for k in range(height))
+    return width, rows
+
+
+class CoverageRasterTests(unittest.TestCase):
+    def setUp(self):
+        self.rasters = []
+
+    def tearDown(self):
+        for raster in self.rasters:
+            raster.close()
+
+    def make(self, **kwargs):
+        options = dict(min_x=0.0, min_y=0.0, max_x=10.0, max_y=10.0, resolution=0.1, tile_size=32)
+        options.update(kwargs)
+        raster = CoverageRaster(**options)
+        self.rasters.append(raster)
+        return raster
+
+    def test_straight_stripe_covers_length_times_width(self):
+        raster = self.make(stamp_width=0.5, max_gap=5.0)
+        raster.update(1.02, 2.02)
+        raster.update(5.02, 2.02)
+
+        # 4 m x 0.5 m Rechteck + Kreis mit 0.25 m Radius an den Enden
+        expected = 4.0 * 0.5 + 3.14159 * 0.25 ** 2
+        self.assertAlmostEqual(raster.mowed_area, expected, delta=0.1)
+        self.assertEqual(raster.get_status()['stamps'], 2)
+
+    def test_inactive_and_gaps_break_the_track(self):
+        raster = self.make(stamp_width=0.2, max_gap=1.0)
+        raster.update(1.0, 1.0)
+        raster.update(1.0, 5.0, active=False)
+        raster.update(1.0, 5.0)
+        raster.update(8.0, 5.0)  # Sprung > max_gap: nur ein Punkt
+
+        self.assertLess(raster.mowed_area, 0.2)
+        self.assertEqual(raster.gaps, 1)
+
+    def test_restamping_does_not_bump_versions(self):
+        raster = self.make()
+        raster.update(2.0, 2.0)
+        versions = raster.tile_versions()
+        self.assertEqual(raster.update(2.0, 2.0), 0)
+        self.assertEqual(raster.tile_versions(), versions)
+
+    def test_tile_png_is_north_up_and_cached(self):
+        raster = self.make(stamp_width=0.1)
+        raster.update(0.05, 3.15)  # Zelle (0, 31): oberste Zeile der Kachel (0, 0)
+
+        etag, png = raster.tile_png(0, 0)
+        width, rows = decode_png(png)
+        self.assertEqual(width, 32)
+        self.assertEqual(rows[0][0], 1)
+        self.assertEqual(sum(sum(row) for row in rows), 1)
+
+        self.assertEqual(raster.tile_png(0, 0), (etag, png))
+        self.assertEqual(raster.tiles_rendered, 1)
+        self.assertIsNone(raster.tile_png(raster.tiles_x, 0))
+
+        raster.update(0.25, 0.05)
+        new_etag, _ = raster.tile_png(0, 0)
+        self.assertNotEqual(new_etag, etag)
+
+    def test_reset_clears_cells_and_starts_new_epoch(self):
+        raster = self.make()
+        raster.update(2.0, 2.0)
+        raster.update(4.0, 2.0)
+        raster.reset()
+
+        self.assertEqual(raster.mowed_cells, 0)
+        self.assertEqual(raster.tile_versions(), [])
+        self.assertEqual(raster.epoch, 1)
+        _, rows = decode_png(raster.tile_png(0, 0)[1])
+        self.assertFalse(any(any(row) for row in rows))
+
+    def test_file_survives_reopen_and_reader_sees_writer(self):
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, 'coverage.cov')
+            raster = CoverageRaster(0.0, 0.0, 10.0, 10.0, resolution=0.1, tile_size=32,
+                                    origin=(52.5, 13.4), filepath=path)
+            raster.update(1.0, 1.0)
+            raster.update(3.0, 1.0)
+            area = raster.mowed_area
+
+            reader = CoverageRaster.attach(filepath=path)
+            self.assertEqual(reader.mowed_area, area)
+            self.assertEqual(reader.tile_versions(), raster.tile_versions())
+            raster.update(3.0, 4.0)
+            self.assertGreater(reader.mowed_area, area)
+            reader.close()
+            raster.close()
+
+            self.assertEqual(CoverageRaster.read_origin(path), (52.5, 13.4))
+            reopened = CoverageRaster(0.0, 0.0, 10.0, 10.0, resolution=0.1, tile_size=32,
+                                      origin=(52.5, 13.4), filepath=path)
+            self.assertGreater(reopened.mowed_area, area)
+            reopened.close()
+
+            with self.assertLogs('coverage_raster', level='WARNING'):
+                moved = CoverageRaster(0.0, 0.0, 10.0, 10.0, resolution=0.1, tile_size=32,
+                                       origin=(52.6, 13.4), filepath=path)
+            self.assertEqual(moved.mowed_cells, 0)
+            moved.close()
+
+    def test_shared_memory_reader(self):
+        raster = self.make()
+        raster.update(5.0, 5.0)
+        reader = CoverageRaster.attach(shm_name=raster.shm_name)
+        try:
+            self.assertEqual(reader.mowed_cells, raster.mowed_cells)
+            self.assertEqual(reader.tile_png(1, 1)[0], raster.tile_png(1, 1)[0])
+        finally:
+            reader.close()
+
+    def test_local_offset(self):
+        east, north = local_offset(52.0, 13.0, 52.0 + 1e-5, 13.0)
+        self.assertAlmostEqual(east, 0.0, places=6)
+        self.assertAlmostEqual(north, 1.113, places=2)
+
+    def test_blade_position_rotates_offset_with_heading(self):
+        # Messer 0.3 m hinter und 0.1 m links der Antenne
+        east, north = blade_position(5.0, 5.0, 0.0, forward=-0.3, left=0.1)
+        self.assertAlmostEqual(east, 4.9)
+        self.assertAlmostEqual(north, 4.7)
+        east, north = blade_position(5.0, 5.0, 90.0, forward=-0.3, left=0.1)
+        self.assertAlmostEqual(east, 4.7)
+        self.assertAlmostEqual(north, 5.1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,147 @@
+import struct
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from gnss_parser import (
+    UNICORE_MSG_BESTNAV,
+    UNICORE_MSG_HEADING,
+    GNSSStreamParser,
+    nmea_checksum,
+    unicore_crc32,
+)
+from gps_handler import EVENT_FIX_CHANGED, EVENT_GGA, GPSHandler
+
+
+def nmea(body: str) -> bytes:
+    return f"${body}*{nmea_checksum(body.encode()):02X}\r\n".encode()
+
+
+def unicore(msg_id: int, payload: bytes, week: int = 2300, tow_ms: int = 43200000) -> bytes:
+    header = struct.pack('<3sBHHBBHIIBBH', b'\xaa\x44\xb5', 0, msg_id, len(payload),
+                         0, 0, week, tow_ms, 0, 0, 18, 0)
+    message = header + payload
+    return message + struct.pack('<I', unicore_crc32(message))
+
+
+def bestnav(pos_type: int, lat: float, lon: float, hgt: float, sats: int, sol_stat: int = 0) -> bytes:
+    payload = bytearray(struct.pack('<IIddd', sol_stat, pos_type, lat, lon, hgt))
+    payload.extend(bytes(64 - len(payload)))
+    payload.extend(bytes([sats + 2, sats]))
+    payload.extend(bytes(120 - len(payload)))
+    return bytes(payload)
+
+
+class GNSSStreamParserTests(unittest.TestCase):
+    def setUp(self):
+        self.positions = []
+        self.headings = []
+        self.parser = GNSSStreamParser(on_position=self.positions.append, on_heading=self.headings.append)
+
+    def test_gga_and_hdt_split_across_chunks(self):
+        stream = (
+            nmea('GNGSV,3,1,12,01,40,083,46')
+            + nmea('GNGGA,123519.00,4807.0380000,N,01131.0000000,W,4,12,0.9,545.4,M,46.9,M,,')
+            + nmea('GNHDT,274.07,T')
+        )
+        for i in range(0, len(stream), 7):
+            self.parser.feed(stream[i:i + 7])
+
+        self.assertEqual(len(self.positions), 1)
+        fix = self.positions[0]
+        self.assertEqual(fix.fix_quality, 4)
+        self.assertEqual(fix.satellites, 12)
+        self.assertAlmostEqual(fix.latitude, 48.1173, places=6)
+        self.assertAlmostEqual(fix.longitude, -11.5166667, places=6)
+        self.assertAlmostEqual(fix.altitude, 545.4)
+        self.assertTrue(fix.raw_gga.startswith('$GNGGA,123519.00'))
+        self.assertEqual(self.headings, [274.07])
+        self.assertEqual(self.parser.sentences_ignored, 1)
+
+    def test_bad_checksum_is_rejected(self):
+        sentence = bytearray(nmea('GPHDT,90.0,T'))
+        sentence[7] = ord('1')
+        self.parser.feed(bytes(sentence))
+
+        self.assertEqual(self.headings, [])
+        self.assertEqual(self.parser.checksum_errors, 1)
+
+    def test_unicore_bestnav_and_heading(self):
+        stream = (
+            b'\x00\xaa'
+            + unicore(UNICORE_MSG_BESTNAV, bestnav(50, 52.5, 13.25, 40.5, 21))
+            + nmea('GPHDT,10.0,T')
+            + unicore(UNICORE_MSG_HEADING, struct.pack('<IIff', 0, 50, 1.2, 181.5) + bytes(32))
+        )
+        self.parser.feed(stream[:30])
+        self.parser.feed(stream[30:])
+
+        self.assertEqual(self.parser.binary_messages, 2)
+        fix = self.positions[0]
+        self.assertEqual(fix.fix_quality, 4)
+        self.assertEqual(fix.satellites, 21)
+        self.assertAlmostEqual(fix.latitude, 52.5)
+        self.assertAlmostEqual(fix.longitude, 13.25)
+        # Synthetischer GGA-Satz für NTRIP muss selbst wieder gültig parsen
+        reparsed = []
+        GNSSStreamParser(on_position=reparsed.append).feed(fix.raw_gga.encode() + b'\r\n')
+        self.assertAlmostEqual(reparsed[0].latitude, 52.5, places=6)
+        self.assertEqual(reparsed[0].fix_quality, 4)
+        self.assertEqual(self.headings, [10.0, 181.5])
+
+    def test_bestnav_without_computed_solution_is_no_fix(self):
+        self.parser.feed(
+            unicore(UNICORE_MSG_BESTNAV, bestnav(50, 1.0, 2.0, 3.0, 8, sol_stat=1))
+            + unicore(UNICORE_MSG_BESTNAV, bestnav(19, 1.0, 2.0, 3.0, 8))  # PROPAGATED
+        )
+
+        self.assertEqual([fix.fix_quality for fix in self.positions], [0, 0])
+
+    def test_many_nmea_sentences_in_one_chunk(self):
+        stream = b''.join(nmea(f'GPHDT,{i}.0,T') for i in range(200)) + unicore(
+            UNICORE_MSG_BESTNAV, bestnav(16, 1.0, 2.0, 3.0, 8)) + nmea('GPHDT,7.5,T')
+        self.parser.feed(stream)
+
+        self.assertEqual(len(self.headings), 201)
+        self.assertEqual(self.headings[-1], 7.5)
+        self.assertEqual(self.positions[0].fix_quality, 1)
+
+    def test_corrupted_binary_message_is_skipped(self):
+        message = bytearray(unicore(UNICORE_MSG_BESTNAV, bestnav(16, 1.0, 2.0, 3.0, 8)))
+        message[40] ^= 0xFF
+        self.parser.feed(bytes(message) + nmea('GPHDT,45.0,T'))
+
+        self.assertEqual(self.positions, [])
+        self.assertEqual(self.parser.checksum_errors, 1)
+        self.assertEqual(self.headings, [45.0])
+
+
+class GPSHandlerParserTests(unittest.TestCase):
+    def test_handler_publishes_snapshot(self):
+        gps = GPSHandler('/dev/null', 230400)
+        gps.feed(nmea('GNGGA,123519.00,4807.0380000,N,01131.0000000,E,5,09,0.9,545.4,M,46.9,M,,'))
+
+        status = gps.get_status()
+        self.assertEqual(status['rtk_status'], 'RTK FLOAT')
+        self.assertEqual(status['satellites'], 9)
+        self.assertEqual(status['seq'], 1)
+        self.assertTrue(gps.get_last_raw_gga().startswith('$GNGGA'))
+
+    def test_handler_emits_fix_change_and_gga_events_outside_lock(self):
+        gps = GPSHandler('/dev/null', 230400)
+        fix_events = []
+        gga_events = []
+        gps.subscribe(EVENT_FIX_CHANGED, lambda event: fix_events.append((event.previous, event.value)))
+        gps.subscribe(EVENT_GGA, lambda event: gga_events.append(gps.lock.locked()))
+
+        for quality in (4, 4, 5):
+            gps.feed(nmea(f'GNGGA,123519.00,4807.0380000,N,01131.0000000,E,{quality},09,0.9,545.4,M,46.9,M,,'))
+
+        self.assertEqual(fix_events, [('NO GPS', 'RTK FIXED'), ('RTK FIXED', 'RTK FLOAT')])
+        self.assertEqual(gga_events, [False, False, False])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -49,6 +49,68 @@ class WitMotionHandlerTests(unittest.TestCase):
         self.assertFalse(imu.get_data()['is_calibrated'])
         self.assertEqual(imu.get_orientation()['yaw'], 0.0)
 
+    def test_parser_resyncs_after_garbage_and_split_frames(self):
+        imu = WitMotionUSBIMU(port='COM_TEST', baudrate=9600)
+        stream = (
+            b'\x00\xff\x55\x12' * 20 +
+            build_frame(0x51, [2048, 0, 0, 0]) +
+            build_frame(0x52, [0, 0, 0, 0]) +
+            build_frame(0x53, [8192, 0, 0, 0])
+        )
+
+        for idx in range(0, len(stream), 7):
+            imu._process_bytes(stream[idx:idx + 7])
+
+        status = imu.get_status()
+        self.assertTrue(imu.get_data()['is_calibrated'])
+        self.assertAlmostEqual(imu.get_orientation()['roll'], 45.0, places=2)
+        self.assertEqual(status['frame_count'], 3)
+        self.assertEqual(status['bytes_discarded'], 80)
+
+    def test_snapshot_sequence_advances_only_on_valid_frames(self):
+        imu = WitMotionUSBIMU(port='COM_TEST', baudrate=9600)
+        initial_seq = imu.get_snapshot().seq
+
+        imu._process_bytes(b'\x00' * 32)
+        self.assertEqual(imu.get_snapshot().seq, initial_seq)
+
+        imu._process_bytes(build_frame(0x53, [8192, 0, 0, 0]) + build_frame(0x53, [4096, 0, 0, 0]))
+        snapshot = imu.get_snapshot()
+
+        self.assertEqual(snapshot.seq, initial_seq + 1)
+        self.assertAlmostEqual(snapshot.data['orientation']['roll'], 22.5, places=2)
+        self.assertIs(imu.get_orientation(), snapshot.data['orientation'])
+
+    def test_statistics_use_every_sample_of_a_batch(self):
+        stream = b''.join(
+            build_frame(0x51, [0, 0, 2048, 0]) + build_frame(0x52, [value, 0, 0, 0]) + build_frame(0x53, [0, 0, 0, 0])
+            for value in (100, -100, 100, -100, 100)
+        )
+        batched = WitMotionUSBIMU(port='COM_TEST', baudrate=9600, sample_rate=200)
+        batched._process_bytes(stream)
+        single = WitMotionUSBIMU(port='COM_TEST', baudrate=9600, sample_rate=200)
+        for idx in range(0, len(stream), 33):
+            single._process_bytes(stream[idx:idx + 33])
+
+        motion = batched.get_motion_status()
+        self.assertEqual(motion['window_fill'], 5)
+        self.assertEqual(motion['gyro_std'], single.get_motion_status()['gyro_std'])
+
+    def test_sample_callback_fires_per_sample_with_own_timestamp(self):
+        imu = WitMotionUSBIMU(port='COM_TEST', baudrate=9600, sample_rate=200)
+        samples = []
+        imu.sample_callback = lambda accel, gyro, angles, timestamp: samples.append((gyro[0], timestamp))
+        imu._process_bytes(b''.join(
+            build_frame(0x51, [0, 0, 2048, 0]) + build_frame(0x52, [value, 0, 0, 0]) + build_frame(0x53, [0, 0, 0, 0])
+            for value in (1638, 3276, 4915)
+        ))
+
+        self.assertEqual(len(samples), 3)
+        self.assertAlmostEqual(samples[0][0], 99.98, places=1)
+        self.assertAlmostEqual(samples[2][0], 299.97, places=1)
+        self.assertAlmostEqual(samples[1][1] - samples[0][1], 0.005, places=6)
+        self.assertEqual(samples[2][1], imu.last_packet_time)
+
     def test_create_imu_handler_returns_witmotion_handler(self):
         imu = create_imu_handler('witmotion', port='COM_TEST', baudrate=9600)
         self.assertIsInstance(imu, WitMotionUSBIMU)
@@ -0,0 +1,52 @@
+import math
+import random
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from imu_statistics import MotionStatistics
+
+
+class MotionStatisticsTests(unittest.TestCase):
+    def _feed(self, stats, seconds, gyro_mean=(0.0, 0.0, 0.0), gyro_noise=0.1, accel_noise=0.05, start=0.0):
+        rng = random.Random(7)
+        steps = int(seconds * 200)
+        for step in range(steps):
+            gyro = [mean + rng.gauss(0.0, gyro_noise) for mean in gyro_mean]
+            accel = [rng.gauss(0.0, accel_noise), rng.gauss(0.0, accel_noise), 9.81 + rng.gauss(0.0, accel_noise)]
+            stats.update(gyro, accel, start + step / 200.0)
+        return start + steps / 200.0
+
+    def test_sliding_variance_matches_window(self):
+        stats = MotionStatistics(window=50)
+        values = [math.sin(i * 0.3) * 2.0 + i * 0.01 for i in range(200)]
+        for i, value in enumerate(values):
+            stats.update((value, 0.0, 0.0), (0.0, 0.0, 9.81), i * 0.005)
+
+        tail = values[-50:]
+        mean = sum(tail) / len(tail)
+        std = math.sqrt(sum((v - mean) ** 2 for v in tail) / len(tail))
+        self.assertAlmostEqual(stats.gyro_std, std, places=9)
+
+    def test_stationary_after_hold_time_and_bias_estimate(self):
+        stats = MotionStatistics(window=100, min_stationary_time=0.5)
+        end = self._feed(stats, 0.6, gyro_mean=(0.4, -0.2, 0.8))
+        self.assertFalse(stats.is_stationary)
+
+        self._feed(stats, 2.0, gyro_mean=(0.4, -0.2, 0.8), start=end)
+        self.assertTrue(stats.is_stationary)
+        self.assertTrue(stats.bias_valid)
+        self.assertAlmostEqual(stats.gyro_bias[2], 0.8, delta=0.05)
+
+    def test_vibration_prevents_stationary_and_is_reported(self):
+        stats = MotionStatistics(window=100)
+        self._feed(stats, 2.0, accel_noise=1.5)
+
+        self.assertFalse(stats.is_stationary)
+        self.assertAlmostEqual(stats.vibration_rms, 1.5 * math.sqrt(3.0), delta=0.5)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,80 @@
+import os
+import socket
+import sys
+import threading
+import time
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from io_reactor import IOReactor
+
+
+class IOReactorTests(unittest.TestCase):
+    def setUp(self):
+        self.reactor = IOReactor()
+        self.reactor.start()
+
+    def tearDown(self):
+        self.reactor.stop()
+
+    def test_dispatches_only_when_bytes_arrive(self):
+        read_fd, write_fd = os.pipe()
+        received = []
+        got_data = threading.Event()
+
+        def on_data(data):
+            received.append(data)
+            got_data.set()
+
+        self.assertTrue(self.reactor.register(read_fd, on_data, name='pipe'))
+        os.write(write_fd, b'$GNGGA')
+        self.assertTrue(got_data.wait(1.0))
+
+        self.assertEqual(received, [b'$GNGGA'])
+        status = self.reactor.get_status()
+        self.assertEqual(status['sources']['pipe']['bytes_read'], 6)
+        self.assertEqual(status['sources']['pipe']['dispatches'], 1)
+
+        self.reactor.unregister(read_fd)
+        os.close(read_fd)
+        os.close(write_fd)
+
+    def test_eof_unregisters_and_calls_on_close(self):
+        local, remote = socket.socketpair()
+        closed = threading.Event()
+
+        self.reactor.register(local, lambda data: None, on_close=closed.set, name='ntrip')
+        remote.close()
+
+        self.assertTrue(closed.wait(1.0))
+        self.assertNotIn('ntrip', self.reactor.get_status()['sources'])
+        local.close()
+
+    def test_callback_error_does_not_stop_reactor(self):
+        read_fd, write_fd = os.pipe()
+        received = threading.Event()
+        calls = []
+
+        def on_data(data):
+            calls.append(data)
+            if len(calls) == 1:
+                raise ValueError('Parser-Fehler')
+            received.set()
+
+        self.reactor.register(read_fd, on_data)
+        os.write(write_fd, b'a')
+        while not calls:
+            time.sleep(0.01)
+        os.write(write_fd, b'b')
+
+        self.assertTrue(received.wait(1.0))
+        self.assertEqual(self.reactor.callback_errors, 1)
+        self.reactor.unregister(read_fd)
+        os.close(read_fd)
+        os.close(write_fd)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,64 @@
+import math
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from pose_estimator import PoseEstimator
+
+LAT0 = 48.0
+LON0 = 11.0
+METERS_PER_DEG_LAT = 111200.0
+
+
+def _offset(east, north):
+    return (LAT0 + north / METERS_PER_DEG_LAT,
+            LON0 + east / (METERS_PER_DEG_LAT * math.cos(math.radians(LAT0))))
+
+
+class PoseEstimatorTests(unittest.TestCase):
+    def _drive_north(self, estimator, seconds, speed=1.0, gyro_z=0.0):
+        # 200 Hz IMU, 10 Hz RTK-Position und Heading, konstante Fahrt nach Norden
+        for step in range(int(seconds * 200)):
+            t = 1000.0 + step / 200.0
+            estimator.on_imu_sample((0.0, 0.0, 9.81), (0.0, 0.0, gyro_z), (0.0, 0.0, 0.0), t)
+            if step % 20 == 0:
+                latitude, longitude = _offset(0.0, speed * (t - 1000.0))
+                estimator.on_position(latitude, longitude, 4, t)
+                estimator.on_heading(0.0, timestamp=t)
+
+    def test_converges_to_velocity_and_position(self):
+        estimator = PoseEstimator()
+        self._drive_north(estimator, 10.0)
+
+        pose = estimator.get_pose()
+        self.assertTrue(pose['initialized'])
+        self.assertAlmostEqual(pose['vel_north'], 1.0, delta=0.05)
+        self.assertAlmostEqual(pose['vel_east'], 0.0, delta=0.05)
+        self.assertAlmostEqual(pose['north'], 10.0, delta=0.1)
+        self.assertLess(pose['std_position'], 0.05)
+        self.assertLess(min(pose['heading'], 360.0 - pose['heading']), 0.5)
+
+    def test_estimates_gyro_bias(self):
+        estimator = PoseEstimator()
+        self._drive_north(estimator, 30.0, gyro_z=0.5)
+
+        self.assertAlmostEqual(estimator.get_pose()['gyro_bias'], 0.5, delta=0.1)
+
+    def test_heading_wraps_and_outliers_are_rejected(self):
+        estimator = PoseEstimator()
+        estimator.on_position(LAT0, LON0, 4, 1.0)
+        estimator.on_heading(359.5, fix_quality=4, timestamp=1.0)
+        estimator.on_heading(0.5, fix_quality=4, timestamp=1.1)
+        heading = estimator.get_pose()['heading']
+        self.assertLess(min(heading, 360.0 - heading), 0.6)
+
+        latitude, longitude = _offset(50.0, 0.0)
+        estimator.on_position(latitude, longitude, 4, 1.2)
+        self.assertAlmostEqual(estimator.get_pose()['east'], 0.0, delta=0.01)
+        self.assertEqual(estimator.get_status()['rejected_updates'], 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
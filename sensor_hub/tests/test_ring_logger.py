@@ -0,0 +1,107 @@
+import io
+import logging
+import sys
+import time
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from ring_logger import RingLogHandler
+
+
+class CountingFormatter(logging.Formatter):
+    def __init__(self):
+        super().__init__('%(levelname)s %(message)s')
+        self.calls = 0
+
+    def format(self, record):
+        self.calls += 1
+        return super().format(record)
+
+
+class RingLoggerTests(unittest.TestCase):
+    def make_logger(self, **kwargs):
+        self.stream = io.StringIO()
+        kwargs.setdefault('flush_interval', 60.0)
+        self.handler = RingLogHandler(streams=[self.stream], **kwargs)
+        self.formatter = CountingFormatter()
+        self.handler.setFormatter(self.formatter)
+        logger = logging.getLogger(f"ring_test_{id(self)}")
+        logger.propagate = False
+        logger.setLevel(logging.DEBUG)
+        logger.addHandler(self.handler)
+        self.addCleanup(logger.removeHandler, self.handler)
+        self.addCleanup(self.handler.close)
+        return logger
+
+    def test_formatting_is_deferred_until_flush(self):
+        logger = self.make_logger()
+
+        for size in range(5):
+            logger.debug("📤 %d Bytes gesendet", size)
+        self.assertEqual(self.formatter.calls, 0)
+        self.assertEqual(self.stream.getvalue(), '')
+
+        self.handler.flush()
+        self.assertEqual(self.formatter.calls, 5)
+        self.assertIn('DEBUG 📤 4 Bytes gesendet', self.stream.getvalue())
+
+    def test_rate_limit_per_call_site_emits_summary(self):
+        logger = self.make_logger(rate_limit=3)
+
+        for _ in range(10):
+            logger.warning("⚠️  Read-Fehler: %s", "timeout")
+        logger.info("andere Stelle")
+        # Fenster der Aufrufstellen ablaufen lassen
+        for site in self.handler._sites.values():
+            site.window_start -= 1.0
+        self.handler.flush()
+
+        output = self.stream.getvalue()
+        self.assertEqual(output.count('Read-Fehler: timeout'), 3)
+        self.assertIn('7× unterdrückt (Ratenlimit): ⚠️  Read-Fehler: %s', output)
+        self.assertIn('andere Stelle', output)
+        self.assertEqual(self.handler.get_stats()['suppressed'], 7)
+
+    def test_full_ring_drops_oldest_records(self):
+        logger = self.make_logger(capacity=4, rate_limit=0)
+
+        for index in range(10):
+            logger.info("Meldung %d", index)
+        self.handler.flush()
+
+        lines = self.stream.getvalue().splitlines()
+        self.assertEqual(lines, [f'INFO Meldung {index}' for index in range(6, 10)])
+        self.assertEqual(self.handler.get_stats()['dropped'], 6)
+
+    def test_error_wakes_flusher(self):
+        logger = self.make_logger()
+
+        logger.error("❌ CAN-Send Fehler (ID 0x%X)", 0x101)
+        deadline = time.monotonic() + 1.0
+        while 'CAN-Send Fehler (ID 0x101)' not in self.stream.getvalue() and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.assertIn('CAN-Send Fehler (ID 0x101)', self.stream.getvalue())
+
+    def test_mutable_arguments_are_captured_at_log_time(self):
+        logger = self.make_logger()
+        state = {'fix': 'GPS FIX'}
+
+        logger.info("Status: %s", state)
+        state['fix'] = 'RTK FIXED'
+        self.handler.flush()
+
+        self.assertIn("Status: {'fix': 'GPS FIX'}", self.stream.getvalue())
+
+    def test_close_flushes_pending_records(self):
+        logger = self.make_logger()
+
+        logger.info("letzte Meldung")
+        self.handler.close()
+
+        self.assertIn('letzte Meldung', self.stream.getvalue())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,75 @@
+import os
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from rtcm_relay import (
+    GPS_EPOCH_UNIX,
+    GPS_LEAP_SECONDS,
+    RTCM3Framer,
+    RTCMRelay,
+    build_rtcm3_frame,
+    crc24q,
+    msm_epoch_age_ms,
+)
+
+
+def message_payload(message_type: int, body: bytes = b'') -> bytes:
+    return bytes([message_type >> 4, (message_type & 0x0F) << 4]) + body
+
+
+def msm_payload(message_type: int, epoch_ms: int) -> bytes:
+    # 12 Bit Typ, 12 Bit Station (0), 30 Bit Epochenzeit, Rest 0
+    value = (message_type << 52) | (epoch_ms << 10)
+    return value.to_bytes(8, 'big')
+
+
+class RTCMRelayTests(unittest.TestCase):
+    def test_crc24q_known_value(self):
+        self.assertEqual(crc24q(b'123456789'), 0xCDE703)
+
+    def test_framer_resyncs_over_garbage_and_split_chunks(self):
+        frames = []
+        framer = RTCM3Framer(lambda frame, message_type: frames.append((bytes(frame), message_type)))
+        first = build_rtcm3_frame(message_payload(1005, bytes(17)))
+        second = build_rtcm3_frame(message_payload(1230, b'\xAA\xBB'))
+        corrupted = bytearray(build_rtcm3_frame(message_payload(1074, bytes(10))))
+        corrupted[6] ^= 0xFF
+        stream = b'\x00\xD3\xFF' + first + bytes(corrupted) + second
+
+        for offset in range(0, len(stream), 5):
+            framer.feed(stream[offset:offset + 5])
+
+        self.assertEqual(frames, [(first, 1005), (second, 1230)])
+        self.assertEqual(framer.crc_errors, 1)
+
+    def test_msm_epoch_age(self):
+        now = 1700000000.25
+        gps_ms = int((now - GPS_EPOCH_UNIX + GPS_LEAP_SECONDS) * 1000) % (7 * 86400 * 1000)
+
+        age = msm_epoch_age_ms(1077, msm_payload(1077, gps_ms - 120), now)
+
+        self.assertAlmostEqual(age, 120.0, delta=1.0)
+        self.assertIsNone(msm_epoch_age_ms(1005, msm_payload(1005, 0), now))
+
+    def test_relay_writes_valid_frames_to_fd_and_counts_types(self):
+        read_fd, write_fd = os.pipe()
+        try:
+            relay = RTCMRelay(lambda: write_fd)
+            frame = build_rtcm3_frame(message_payload(1005, bytes(17)))
+
+            relay.feed(frame + frame)
+
+            self.assertEqual(os.read(read_fd, 4096), frame + frame)
+            stats = relay.get_stats()
+            self.assertEqual(stats['types']['1005']['count'], 2)
+            self.assertEqual(stats['bytes_written'], 2 * len(frame))
+        finally:
+            os.close(read_fd)
+            os.close(write_fd)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,100 @@
+import sys
+import threading
+import time
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from startup import STATE_FAILED, STATE_OK, STATE_SKIPPED, StartupOrchestrator
+
+
+class StartupOrchestratorTests(unittest.TestCase):
+    def test_independent_stages_run_concurrently(self):
+        startup = StartupOrchestrator()
+        startup.add('gps', lambda: time.sleep(0.2))
+        startup.add('imu', lambda: time.sleep(0.2))
+        startup.add('can', lambda: time.sleep(0.2))
+
+        started = time.perf_counter()
+        self.assertTrue(startup.run(timeout=2.0))
+        self.assertLess(time.perf_counter() - started, 0.45)
+
+        report = startup.get_report()
+        self.assertTrue(report['complete'])
+        self.assertEqual([stage['state'] for stage in report['stages']], [STATE_OK] * 3)
+        self.assertTrue(all(stage['elapsed_ms'] >= 190 for stage in report['stages']))
+
+    def test_dependency_runs_after_its_prerequisite(self):
+        order = []
+        startup = StartupOrchestrator()
+        startup.add('reactor', lambda: (time.sleep(0.05), order.append('reactor')))
+        startup.add('gps', lambda: order.append('gps'), depends=('reactor',))
+
+        self.assertTrue(startup.run(timeout=1.0))
+        self.assertEqual(order, ['reactor', 'gps'])
+
+    def test_failed_stage_skips_dependents_only(self):
+        startup = StartupOrchestrator()
+        startup.add('gps', lambda: False)
+        startup.add('ntrip', lambda: True, depends=('gps',))
+        startup.add('imu', lambda: True)
+
+        self.assertTrue(startup.run(timeout=1.0))
+        states = {stage['name']: stage['state'] for stage in startup.get_report()['stages']}
+        self.assertEqual(states, {'gps': STATE_FAILED, 'ntrip': STATE_SKIPPED, 'imu': STATE_OK})
+        self.assertEqual(startup.failed(), ['gps', 'ntrip'])
+
+    def test_critical_failure_and_exception_are_reported(self):
+        def broken():
+            raise RuntimeError('pigpio daemon nicht erreichbar')
+
+        startup = StartupOrchestrator()
+        startup.add('gpio', broken, critical=True)
+        with self.assertLogs('startup', level='ERROR'):
+            self.assertFalse(startup.run(timeout=1.0))
+        stage = startup.get_report()['stages'][0]
+        self.assertEqual(stage['state'], STATE_FAILED)
+        self.assertIn('pigpio', stage['error'])
+
+    def test_background_stage_does_not_delay_run(self):
+        release = threading.Event()
+        startup = StartupOrchestrator()
+        startup.add('gps', lambda: True)
+        startup.add('ntrip', lambda: release.wait(2.0), depends=('gps',), critical=True, background=True)
+
+        started = time.perf_counter()
+        self.assertTrue(startup.run(timeout=1.0))
+        self.assertLess(time.perf_counter() - started, 0.5)
+        self.assertFalse(startup.get_report()['complete'])
+
+        release.set()
+        self.assertTrue(startup.wait(1.0))
+        self.assertTrue(startup.get_report()['complete'])
+
+    def test_timeout_of_critical_foreground_stage_fails_run(self):
+        release = threading.Event()
+        startup = StartupOrchestrator()
+        startup.add('safety', lambda: release.wait(2.0), critical=True)
+
+        with self.assertLogs('startup', level='WARNING'):
+            self.assertFalse(startup.run(timeout=0.1))
+        release.set()
+
+    def test_serial_mode_keeps_registration_order_in_calling_thread(self):
+        threads = []
+        startup = StartupOrchestrator(parallel=False)
+        startup.add('a', lambda: threads.append(threading.current_thread()))
+        startup.add('b', lambda: threads.append(threading.current_thread()), background=True)
+
+        self.assertTrue(startup.run())
+        self.assertEqual(threads, [threading.current_thread()] * 2)
+
+    def test_unknown_dependency_is_rejected(self):
+        startup = StartupOrchestrator()
+        with self.assertRaises(ValueError):
+            startup.add('ntrip', lambda: True, depends=('gps',))
+
+
+if __name__ == '__main__':
+    unittest.main()
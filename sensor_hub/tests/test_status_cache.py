@@ -0,0 +1,53 @@
+import sys
+import threading
+import time
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from status_cache import StatusCache
+
+
+class StatusCacheTests(unittest.TestCase):
+    def test_rebuilds_only_on_sequence_change(self):
+        state = {'seq': 1, 'builds': 0}
+
+        def build():
+            state['builds'] += 1
+            return 200, {'seq': state['seq']}
+
+        cache = StatusCache(lambda: state['seq'], refresh_interval=60.0)
+        cache.register('status', build)
+        first = cache.get('status')
+        self.assertEqual(first.body, b'{"seq":1}')
+
+        cache.refresh()
+        self.assertFalse(cache.refresh())
+        builds = state['builds']
+        self.assertIs(cache.get('status'), first)
+
+        state['seq'] = 2
+        self.assertTrue(cache.refresh())
+        self.assertEqual(state['builds'], builds + 1)
+        self.assertEqual(cache.get('status').version, first.version + 1)
+        self.assertNotEqual(cache.get('status').etag, first.etag)
+
+    def test_long_poll_wakes_on_change(self):
+        state = {'seq': 1}
+        cache = StatusCache(lambda: state['seq'], max_rate=100.0, refresh_interval=60.0)
+        cache.register('status', lambda: (200, {'seq': state['seq']}))
+        cache.start()
+        try:
+            version = cache.get('status').version
+            threading.Timer(0.05, lambda: state.update(seq=2)).start()
+            started = time.monotonic()
+            entry = cache.wait('status', version, timeout=2.0)
+            self.assertLess(time.monotonic() - started, 1.0)
+            self.assertEqual(entry.body, b'{"seq":2}')
+        finally:
+            cache.stop()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -4,7 +4,22 @@ from pathlib import Path
 
 sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
 
-from telemetry_payload import build_status_payload, build_telemetry_payload, serialize_can_payload
+from telemetry_payload import (
+    FUSED_POSE_FRAME_SIZE,
+    TELEMETRY_FRAME_SIZE,
+    TELEMETRY_MSG_FUSED_POSE,
+    TELEMETRY_MSG_POSE,
+    build_diagnostics_payload,
+    build_status_payload,
+    build_telemetry_payload,
+    pack_fused_pose_frame,
+    pack_telemetry_frame,
+    serialize_can_payload,
+    telemetry_exceeds_deadband,
+    telemetry_message_type,
+    unpack_fused_pose_frame,
+    unpack_telemetry_frame,
+)
 
 
 class TelemetryPayloadTests(unittest.TestCase):
@@ -34,6 +49,116 @@ class TelemetryPayloadTests(unittest.TestCase):
         self.assertEqual(payload['meta']['messages_sent'], 7)
         self.assertIn('"meta":', serialize_can_payload(payload))
 
+    def test_deadband_ignores_jitter_but_not_motion_or_rtk_change(self):
+        base = {
+            'gps': {'lat': 53.3322738, 'lon': 11.0790067, 'altitude': 19.33},
+            'rtk_status': 'RTK FIXED',
+            'heading': 359.9,
+            'imu': {'roll': 0.5, 'pitch': -0.2, 'yaw': 359.9, 'heading': 359.9, 'is_calibrated': True},
+        }
+        jitter = {**base, 'gps': {**base['gps'], 'lat': 53.3322739}, 'heading': 0.05,
+                  'imu': {**base['imu'], 'yaw': 0.05}}
+        self.assertFalse(telemetry_exceeds_deadband(base, jitter, 0.02, 0.2))
+
+        moved = {**base, 'gps': {**base['gps'], 'lon': 11.0790071}}
+        self.assertTrue(telemetry_exceeds_deadband(base, moved, 0.02, 0.2))
+
+        turned = {**base, 'imu': {**base['imu'], 'roll': 0.8}}
+        self.assertTrue(telemetry_exceeds_deadband(base, turned, 0.02, 0.2))
+
+        self.assertTrue(telemetry_exceeds_deadband(base, {**base, 'rtk_status': 'RTK FLOAT'}, 0.02, 0.2))
+        self.assertTrue(telemetry_exceeds_deadband(base, {k: v for k, v in base.items() if k != 'imu'}, 0.02, 0.2))
+
+    def test_diagnostics_payload_is_compact(self):
+        payload = build_diagnostics_payload(
+            gps_status={'is_connected': True, 'satellites': 21},
+            imu_connected=True,
+            ntrip_connected=False,
+            pose={'initialized': True, 'std_position': 0.01234},
+            timestamp=1.0,
+        )
+
+        self.assertEqual(payload, {
+            'timestamp': 1.0,
+            'diag': {'gps': True, 'satellites': 21, 'imu': True, 'ntrip': False,
+                     'send_errors': 0, 'std_position': 0.01},
+        })
+        self.assertLess(len(serialize_can_payload(payload)), 120)
+
+    def test_binary_frame_round_trips_gps_and_imu(self):
+        payload = build_telemetry_payload(
+            gps_status={
+                'latitude': 53.33227380466667,
+                'longitude': 11.079006669333333,
+                'altitude': 19.3277,
+                'heading': 12.3456,
+                'rtk_status': 'RTK FIXED'
+            },
+            orientation={'roll': -2.5, 'pitch': 1.25, 'yaw': 348.75, 'heading': 348.75},
+            imu_data={'is_calibrated': True},
+            timestamp=1776599841.86649,
+        )
+
+        frame = pack_telemetry_frame(payload)
+        decoded = unpack_telemetry_frame(frame, now=1776599842.0)
+
+        self.assertEqual(len(frame), TELEMETRY_FRAME_SIZE)
+        self.assertLessEqual(len(frame), 4 * 6)
+        self.assertEqual(decoded['timestamp'], 1776599841.866)
+        self.assertEqual(decoded['gps']['lat'], 53.3322738)
+        self.assertEqual(decoded['gps']['lon'], 11.0790067)
+        self.assertAlmostEqual(decoded['gps']['altitude'], 19.3, places=2)
+        self.assertEqual(decoded['rtk_status'], 'RTK FIXED')
+        self.assertEqual(decoded['imu']['roll'], -2.5)
+        self.assertEqual(decoded['imu']['yaw'], 348.75)
+        self.assertTrue(decoded['imu']['is_calibrated'])
+        self.assertEqual(decoded['heading'], 348.75)
+
+    def test_binary_frame_without_sensors_has_only_timestamp(self):
+        frame = pack_telemetry_frame(build_telemetry_payload(timestamp=100.0))
+        decoded = unpack_telemetry_frame(frame, now=100.5)
+
+        self.assertEqual(decoded, {'timestamp': 100.0})
+
+    def test_unpack_rejects_unknown_version(self):
+        frame = bytearray(pack_telemetry_frame(build_telemetry_payload(timestamp=1.0)))
+        frame[0] = 0x21
+
+        self.assertIsNone(unpack_telemetry_frame(bytes(frame)))
+
+    def test_fused_pose_frame_round_trips(self):
+        payload = build_telemetry_payload(
+            pose={'initialized': True, 'timestamp': 99.96, 'east': 1.0, 'north': 2.0,
+                  'latitude': 53.332273812, 'longitude': 11.079006634, 'vel_east': 0.4123,
+                  'vel_north': -0.25, 'heading': 123.456, 'std_position': 0.0123, 'std_heading': 0.87},
+            timestamp=100.0,
+        )
+        frame = pack_fused_pose_frame(payload)
+        decoded = unpack_fused_pose_frame(frame, now=100.2)
+
+        self.assertEqual(len(frame), FUSED_POSE_FRAME_SIZE)
+        self.assertLessEqual(len(frame), 4 * 6)
+        self.assertEqual(telemetry_message_type(frame), TELEMETRY_MSG_FUSED_POSE)
+        self.assertAlmostEqual(decoded['lat'], 53.3322738, places=7)
+        self.assertAlmostEqual(decoded['lon'], 11.0790066, places=7)
+        self.assertAlmostEqual(decoded['heading'], 123.46)
+        self.assertAlmostEqual(decoded['vel_east'], 0.412)
+        self.assertAlmostEqual(decoded['vel_north'], -0.25)
+        self.assertAlmostEqual(decoded['std_position'], 0.012)
+        self.assertAlmostEqual(decoded['std_heading'], 0.9)
+        self.assertAlmostEqual(decoded['age'], 0.04)
+        self.assertAlmostEqual(decoded['timestamp'], 99.96)
+
+    def test_fused_pose_frame_needs_initialized_pose(self):
+        self.assertIsNone(pack_fused_pose_frame(build_telemetry_payload(timestamp=1.0)))
+        self.assertIsNone(pack_fused_pose_frame(build_telemetry_payload(pose={'initialized': False}, timestamp=1.0)))
+
+    def test_frame_types_are_told_apart(self):
+        frame = pack_telemetry_frame(build_telemetry_payload(timestamp=1.0))
+
+        self.assertEqual(telemetry_message_type(frame), TELEMETRY_MSG_POSE)
+        self.assertIsNone(unpack_fused_pose_frame(frame))
+
 
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
@@ -0,0 +1,119 @@
+import sys
+import unittest
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1]))
+
+from telemetry_scheduler import REASON_CHANGE, REASON_HEARTBEAT, REASON_TRIGGER, TelemetryGroup, TelemetryScheduler
+
+
+class FakeSource:
+    def __init__(self):
+        self.value = 0.0
+        self.seq = 0
+        self.builds = 0
+        self.sent = []
+
+    def build(self):
+        self.builds += 1
+        return self.value
+
+    def send(self, sample):
+        self.sent.append(sample)
+        return True
+
+    def set(self, value):
+        self.value = value
+        self.seq += 1
+
+
+class TelemetrySchedulerTests(unittest.TestCase):
+    def make_group(self, source, **kwargs):
+        kwargs.setdefault('min_interval', 0.02)
+        kwargs.setdefault('heartbeat', 0.25)
+        kwargs.setdefault('changed', lambda previous, current: abs(current - previous) > 0.5)
+        group = TelemetryGroup('pose', build=source.build, send=source.send,
+                               sequence=lambda: source.seq, **kwargs)
+        scheduler = TelemetryScheduler()
+        scheduler.add(group)
+        return scheduler, group
+
+    def run_for(self, scheduler, source, seconds, step=0.01, start=0.0, update=None):
+        now = start
+        while now < start + seconds:
+            if update:
+                update(now)
+            scheduler.poll(now)
+            now += step
+        return now
+
+    def test_idle_sends_only_heartbeats(self):
+        source = FakeSource()
+        scheduler, group = self.make_group(source)
+
+        self.run_for(scheduler, source, 1.0)
+
+        # Erste Probe + Lebenszeichen alle 0.25 s
+        self.assertEqual(len(source.sent), 4)
+        self.assertEqual(group.sent[REASON_HEARTBEAT], 3)
+        # Unveränderte Sequenz: kein build() zwischen den Lebenszeichen
+        self.assertEqual(source.builds, 4)
+
+    def test_changes_are_sent_at_most_at_max_rate(self):
+        source = FakeSource()
+        scheduler, group = self.make_group(source)
+
+        self.run_for(scheduler, source, 1.0, step=0.005, update=lambda now: source.set(now * 100.0))
+
+        self.assertGreaterEqual(group.sent[REASON_CHANGE], 45)
+        self.assertLessEqual(len(source.sent), 51)
+
+    def test_changes_within_deadband_are_suppressed_until_they_accumulate(self):
+        source = FakeSource()
+        scheduler, group = self.make_group(source, heartbeat=0.0)
+        scheduler.poll(0.0)
+
+        source.set(0.3)
+        scheduler.poll(0.1)
+        self.assertEqual(source.sent, [0.0])
+        self.assertEqual(group.suppressed, 1)
+
+        source.set(0.6)
+        scheduler.poll(0.2)
+        self.assertEqual(source.sent, [0.0, 0.6])
+
+    def test_trigger_bypasses_deadband(self):
+        source = FakeSource()
+        scheduler, group = self.make_group(source)
+        scheduler.poll(0.0)
+
+        scheduler.trigger('pose')
+        scheduler.poll(0.05)
+
+        self.assertEqual(len(source.sent), 2)
+        self.assertEqual(group.sent[REASON_TRIGGER], 1)
+
+    def test_poll_returns_wait_until_next_useful_check(self):
+        source = FakeSource()
+        scheduler, _ = self.make_group(source, min_interval=0.1, heartbeat=0.0)
+
+        self.assertAlmostEqual(scheduler.poll(0.0), 0.1)
+        self.assertAlmostEqual(scheduler.poll(0.04), 0.06)
+
+    def test_failed_send_is_retried(self):
+        source = FakeSource()
+        results = [False, True]
+        group = TelemetryGroup('diag', build=source.build, send=lambda sample: results.pop(0),
+                               min_interval=0.1, heartbeat=1.0)
+        scheduler = TelemetryScheduler()
+        scheduler.add(group)
+
+        scheduler.poll(0.0)
+        scheduler.poll(0.1)
+
+        self.assertEqual(group.send_failures, 1)
+        self.assertEqual(group.sent[REASON_CHANGE], 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,345 @@
+#!/usr/bin/env python3
+"""
+Replay-Benchmark für die Sensor-Hub-Pipelines
+Spielt candump-Logs, WitMotion-Rohdaten und NMEA-Mitschnitte beschleunigt
+(ohne Original-Timing) durch CAN-Reassembly, IMU-Parser, GPS-Parser und
+Telemetrie-Aufbau und schreibt Durchsatz, Latenz und Allokationen als JSON.
+
+Ohne Mitschnitte werden synthetische Daten erzeugt.
+
+Beispiele:
+    python3 tools/replay_benchmark.py --output bench.json
+    python3 tools/replay_benchmark.py --candump can.log --imu imu.bin --nmea gps.nmea \\
+        --baseline bench_old.json --tolerance 0.15
+"""
+
+import argparse
+import gc
+import json
+import platform
+import re
+import subprocess
+import sys
+import time
+import tracemalloc
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple
+
+SENSOR_HUB_DIR = Path(__file__).resolve().parents[1] / 'sensor_hub'
+sys.path.insert(0, str(SENSOR_HUB_DIR))
+
+from can_protocol import CANProtocol
+from gnss_parser import PositionFix, build_gga_sentence, nmea_checksum
+from gps_handler import GPSHandler
+from imu_handler import WitMotionUSBIMU
+from telemetry_payload import build_telemetry_payload, pack_telemetry_frame, serialize_can_payload
+
+RESULT_VERSION = 1
+
+# candump -l:  (1700000000.123456) can0 100#0102030405060708
+_CANDUMP_LOG = re.compile(r'^\(\s*[\d.]+\)\s+\S+\s+([0-9A-Fa-f]+)#([0-9A-Fa-f]*)')
+# candump (Standard): can0  100   [8]  01 02 03 04 05 06 07 08
+_CANDUMP_TEXT = re.compile(r'^\s*\S+\s+([0-9A-Fa-f]+)\s+\[\d+\]\s+((?:[0-9A-Fa-f]{2}\s*)*)$')
+
+IMU_READ_SIZE = 64  # wie WitMotionUSBIMU._read_loop
+
+
+# ---------------------------------------------------------------------------
+# Eingabedaten
+# ---------------------------------------------------------------------------
+
+def load_candump(path: Path) -> List[Tuple[int, bytes]]:
+    """Liest ein candump-Log (Format -l oder Standardausgabe)"""
+    frames = []
+    with open(path, 'r', errors='ignore') as f:
+        for line in f:
+            match = _CANDUMP_LOG.match(line)
+            if match:
+                frames.append((int(match.group(1), 16), bytes.fromhex(match.group(2))))
+                continue
+            match = _CANDUMP_TEXT.match(line)
+            if match:
+                frames.append((int(match.group(1), 16), bytes.fromhex(match.group(2).replace(' ', ''))))
+    return frames
+
+
+def load_nmea(path: Path) -> List[str]:
+    """Liest NMEA-Sätze aus einem Mitschnitt (Binärdaten dazwischen werden übersprungen)"""
+    sentences = []
+    with open(path, 'rb') as f:
+        for line in f.read().split(b'\n'):
+            start = line.find(b'$')
+            if start >= 0:
+                sentences.append(line[start:].rstrip(b'\r').decode('ascii', errors='ignore'))
+    return sentences
+
+
+def _synthetic_payload(index: int) -> Dict[str, Any]:
+    gps_status = {
+        'latitude': 53.8234 + index * 1e-7,
+        'longitude': 10.4567 + index * 1e-7,
+        'altitude': 45.2,
+        'rtk_status': 'RTK FIXED',
+        'heading': (index * 0.1) % 360.0,
+    }
+    orientation = {'roll': 2.3, 'pitch': -1.8, 'yaw': (index * 0.1) % 360.0, 'heading': (index * 0.1) % 360.0}
+    return {'gps_status': gps_status, 'orientation': orientation, 'imu_data': {'is_calibrated': True}}
+
+
+def synthetic_can_frames(messages: int, arbitration_id: int = 0x200) -> List[Tuple[int, bytes]]:
+    """Multi-Frame-JSON-Nachrichten im Format des Motor-Controllers"""
+    protocol = CANProtocol()
+    frames = []
+    for index in range(messages):
+        kwargs = _synthetic_payload(index)
+        payload = serialize_can_payload(build_telemetry_payload(timestamp=1700000000.0 + index * 0.02, **kwargs))
+        frames.extend((arbitration_id, frame) for frame in protocol.encode_frames(payload.encode('utf-8')))
+    return frames
+
+
+def _witmotion_frame(frame_type: int, values: Sequence[int]) -> bytes:
+    frame = bytearray([0x55, frame_type])
+    for value in values:
+        frame.extend(int(value).to_bytes(2, byteorder='little', signed=True))
+    frame.append(sum(frame) & 0xFF)
+    return bytes(frame)
+
+
+def synthetic_imu_stream(samples: int) -> bytes:
+    """WitMotion-Rohstrom (Accel/Gyro/Angle/Mag pro Sample)"""
+    stream = bytearray()
+    for index in range(samples):
+        yaw = (index * 37) % 32768
+        stream += _witmotion_frame(0x51, [20, -10, 2048, 2500])
+        stream += _witmotion_frame(0x52, [5, -3, 1, 2500])
+        stream += _witmotion_frame(0x53, [400, -300, yaw, 0])
+        stream += _witmotion_frame(0x54, [120, -240, 360, 0])
+    return bytes(stream)
+
+
+def synthetic_nmea(samples: int) -> List[str]:
+    """GGA + HDT pro Sample"""
+    sentences = []
+    for index in range(samples):
+        fix = PositionFix(4, 53.8234 + index * 1e-7, 10.4567, 45.2, 24, None)
+        sentences.append(build_gga_sentence(fix, utc_time=1700000000.0 + index * 0.1))
+        body = f"GNHDT,{(index * 0.1) % 360.0:.4f},T".encode('ascii')
+        sentences.append(f"${body.decode('ascii')}*{nmea_checksum(body):02X}")
+    return sentences
+
+
+def chunk_stream(stream: bytes, size: int) -> List[bytes]:
+    return [stream[offset:offset + size] for offset in range(0, len(stream), size)]
+
+
+# ---------------------------------------------------------------------------
+# Messung
+# ---------------------------------------------------------------------------
+
+def _percentile(sorted_values: List[int], quantile: float) -> int:
+    if not sorted_values:
+        return 0
+    index = min(len(sorted_values) - 1, int(quantile * len(sorted_values)))
+    return sorted_values[index]
+
+
+def run_benchmark(name: str, setup: Callable[[], Callable[[Any], Any]], items: Sequence[Any],
+                  repeat: int, alloc_repeat: int = 1) -> Dict[str, Any]:
+    """
+    Misst eine Pipeline-Stufe
+
+    Args:
+        name: Benchmark-Name
+        setup: Erzeugt frischen Zustand und liefert die Funktion pro Nachricht
+        items: Eingaben (eine pro Aufruf)
+        repeat: Anzahl Durchläufe für Durchsatz/Latenz
+        alloc_repeat: Durchläufe unter tracemalloc (getrennt, da tracemalloc bremst)
+
+    Returns:
+        Ergebnis-Dictionary
+    """
+    perf_counter_ns = time.perf_counter_ns
+    latencies: List[int] = []
+    append = latencies.append
+    process = setup()
+
+    # Aufwärmen (Slots/Caches anlegen)
+    for item in items[:min(len(items), 100)]:
+        process(item)
+
+    gc_before = sum(stat['collections'] for stat in gc.get_stats())
+    started = perf_counter_ns()
+    for _ in range(repeat):
+        for item in items:
+            t0 = perf_counter_ns()
+            process(item)
+            append(perf_counter_ns() - t0)
+    elapsed_ns = perf_counter_ns() - started
+    gc_collections = sum(stat['collections'] for stat in gc.get_stats()) - gc_before
+
+    # Allokationen: Netto-Zuwachs und Spitze pro Nachricht mit frischem Zustand
+    process = setup()
+    for item in items[:min(len(items), 100)]:
+        process(item)
+    gc.collect()
+    tracemalloc.start()
+    baseline_current, _ = tracemalloc.get_traced_memory()
+    tracemalloc.reset_peak()
+    for _ in range(alloc_repeat):
+        for item in items:
+            process(item)
+    current, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+
+    count = len(latencies)
+    alloc_count = max(1, len(items) * alloc_repeat)
+    latencies.sort()
+    return {
+        'name': name,
+        'messages': count,
+        'elapsed_s': round(elapsed_ns / 1e9, 6),
+        'messages_per_s': round(count / (elapsed_ns / 1e9), 1) if elapsed_ns else 0.0,
+        'latency_us': {
+            'mean': round(sum(latencies) / count / 1000.0, 3) if count else 0.0,
+            'p50': round(_percentile(latencies, 0.50) / 1000.0, 3),
+            'p99': round(_percentile(latencies, 0.99) / 1000.0, 3),
+            'max': round(latencies[-1] / 1000.0, 3) if count else 0.0,
+        },
+        'alloc': {
+            'net_bytes_per_message': round((current - baseline_current) / alloc_count, 2),
+            'peak_kb': round((peak - baseline_current) / 1024.0, 2),
+        },
+        'gc_collections': gc_collections,
+    }
+
+
+def _can_setup():
+    protocol = CANProtocol()
+
+    def process(frame):
+        return protocol.decode_frame(frame[0], frame[1])
+    return process
+
+
+def _imu_setup():
+    imu = WitMotionUSBIMU(port='REPLAY', baudrate=9600)
+    return imu._process_bytes
+
+
+def _gps_setup():
+    gps = GPSHandler(port='REPLAY', baudrate=230400)
+    return gps._parse_nmea
+
+
+def _telemetry_setup():
+    def process(kwargs):
+        return build_telemetry_payload(timestamp=1700000000.0, **kwargs)
+    return process
+
+
+def _telemetry_pack_setup():
+    def process(kwargs):
+        return pack_telemetry_frame(build_telemetry_payload(timestamp=1700000000.0, **kwargs))
+    return process
+
+
+# ---------------------------------------------------------------------------
+# Ergebnisse
+# ---------------------------------------------------------------------------
+
+def _git_revision() -> Optional[str]:
+    try:
+        return subprocess.check_output(
+            ['git', 'rev-parse', '--short', 'HEAD'], cwd=SENSOR_HUB_DIR, stderr=subprocess.DEVNULL
+        ).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def compare_with_baseline(results: Dict[str, Any], baseline: Dict[str, Any], tolerance: float) -> List[str]:
+    """
+    Vergleicht Durchsatz und p99-Latenz mit einem früheren Lauf
+
+    Returns:
+        Liste der Regressionen (leer = ok)
+    """
+    previous = {bench['name']: bench for bench in baseline.get('benchmarks', [])}
+    regressions = []
+    for bench in results['benchmarks']:
+        old = previous.get(bench['name'])
+        if not old:
+            continue
+        if bench['messages_per_s'] < old['messages_per_s'] * (1.0 - tolerance):
+            regressions.append(
+                f"{bench['name']}: Durchsatz {bench['messages_per_s']:.0f}/s < {old['messages_per_s']:.0f}/s"
+            )
+        if bench['latency_us']['p99'] > old['latency_us']['p99'] * (1.0 + tolerance):
+            regressions.append(
+                f"{bench['name']}: p99 {bench['latency_us']['p99']:.1f} μs > {old['latency_us']['p99']:.1f} μs"
+            )
+    return regressions
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Replay-Benchmark für die Sensor-Hub-Pipelines')
+    parser.add_argument('--candump', type=Path, help='candump-Log (candump -l oder Standardausgabe)')
+    parser.add_argument('--imu', type=Path, help='WitMotion-Rohdaten (Binärdatei)')
+    parser.add_argument('--nmea', type=Path, help='NMEA-Mitschnitt')
+    parser.add_argument('--samples', type=int, default=5000, help='Synthetische Samples ohne Mitschnitt')
+    parser.add_argument('--repeat', type=int, default=5, help='Durchläufe pro Benchmark')
+    parser.add_argument('--output', type=Path, help='Ergebnis als JSON schreiben')
+    parser.add_argument('--baseline', type=Path, help='Früheres Ergebnis zum Vergleich')
+    parser.add_argument('--tolerance', type=float, default=0.15, help='Erlaubte Verschlechterung (0.15 = 15%%)')
+    args = parser.parse_args()
+
+    can_frames = load_candump(args.candump) if args.candump else synthetic_can_frames(args.samples)
+    imu_stream = args.imu.read_bytes() if args.imu else synthetic_imu_stream(args.samples)
+    nmea = load_nmea(args.nmea) if args.nmea else synthetic_nmea(args.samples)
+    telemetry_inputs = [_synthetic_payload(index) for index in range(args.samples)]
+
+    benchmarks = [
+        run_benchmark('can_decode_frame', _can_setup, can_frames, args.repeat),
+        run_benchmark('imu_process_bytes', _imu_setup, chunk_stream(imu_stream, IMU_READ_SIZE), args.repeat),
+        run_benchmark('gps_parse_nmea', _gps_setup, nmea, args.repeat),
+        run_benchmark('telemetry_build', _telemetry_setup, telemetry_inputs, args.repeat),
+        run_benchmark('telemetry_build_pack', _telemetry_pack_setup, telemetry_inputs, args.repeat),
+    ]
+
+    results = {
+        'version': RESULT_VERSION,
+        'created': time.strftime('%Y-%m-%dT%H:%M:%S%z'),
+        'git_revision': _git_revision(),
+        'python': platform.python_version(),
+        'machine': platform.machine(),
+        'inputs': {
+            'candump': str(args.candump) if args.candump else 'synthetic',
+            'imu': str(args.imu) if args.imu else 'synthetic',
+            'nmea': str(args.nmea) if args.nmea else 'synthetic',
+            'repeat': args.repeat,
+        },
+        'benchmarks': benchmarks,
+    }
+
+    print(f"{'Benchmark':<24}{'msg/s':>12}{'p50 μs':>10}{'p99 μs':>10}{'max μs':>10}{'B/msg':>10}")
+    for bench in benchmarks:
+        latency = bench['latency_us']
+        print(f"{bench['name']:<24}{bench['messages_per_s']:>12.0f}{latency['p50']:>10.2f}"
+              f"{latency['p99']:>10.2f}{latency['max']:>10.1f}{bench['alloc']['net_bytes_per_message']:>10.1f}")
+
+    if args.output:
+        args.output.write_text(json.dumps(results, indent=2))
+        print(f"💾 Ergebnis gespeichert: {args.output}")
+
+    if args.baseline:
+        regressions = compare_with_baseline(results, json.loads(args.baseline.read_text()), args.tolerance)
+        if regressions:
+            for regression in regressions:
+                print(f"❌ Regression: {regression}")
+            return 1
+        print(f"✅ Keine Regression gegenüber {args.baseline} (Toleranz {args.tolerance:.0%})")
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())